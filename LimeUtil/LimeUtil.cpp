@@ -15,6 +15,7 @@
 #include <fstream>
 #include "ErrorReporting.h"
 #include "LMS64CProtocol.h"
+#include "ControlProfiler.h"
 
 using namespace lime;
 
@@ -27,6 +28,29 @@ int deviceCalSweep(
     const double bw,
     const std::string &dir,
     const std::string &chans);
+int deviceRecord(
+    const std::string &argStr,
+    const std::string &filename,
+    const double freq,
+    const double rate,
+    const double gain,
+    const double duration,
+    const std::string &fmt,
+    const std::string &chans);
+int devicePlay(
+    const std::string &argStr,
+    const std::string &filename,
+    const double freq,
+    double rate,
+    const double gain,
+    const std::string &fmt,
+    const std::string &chans,
+    const bool loop,
+    const double delay);
+int benchmarkFFT(const int fftSize, double duration);
+int benchmarkDSP(const int channels, double duration);
+int benchmarkSharedStream(const int readers, double duration);
+int benchmarkGraphDecimation(const int points, double duration);
 
 /***********************************************************************
  * print help
@@ -42,10 +66,15 @@ static int printHelp(void)
     std::cout << std::endl;
     std::cout << "  Advanced options:" << std::endl;
     std::cout << "    --args[=\"module=foo,serial=bar\"] \t Arguments for the options below" << std::endl;
-    std::cout << "    --update          \t\t\t Automatic firmware sync + flash" << std::endl;
+    std::cout << "    --update[=force]  \t\t\t Automatic firmware sync + flash, force also rewrites matching versions" << std::endl;
     std::cout << "    --fpga=\"filename\" \t\t\t Program FPGA gateware to flash" << std::endl;
     std::cout << "    --fw=\"filename\"   \t\t\t Program FX3  firmware to flash" << std::endl;
     std::cout << "    --timing          \t\t\t Time interfaces and operations" << std::endl;
+    std::cout << "    --profile[=\"filename\"]\t\t Count control transactions per operation, JSON to file or stdout" << std::endl;
+    std::cout << "    --fftbench[=size, default=16384]\t Benchmark FFT viewer processing without device, --duration per run" << std::endl;
+    std::cout << "    --dspbench[=channels, default=16]\t Benchmark host stream DSP stage without device, --duration" << std::endl;
+    std::cout << "    --shmbench[=readers, default=4]\t Benchmark shared memory stream readers without device, --duration" << std::endl;
+    std::cout << "    --graphbench[=points, default=4000000] Benchmark graph series decimation without device, --duration" << std::endl;
     std::cout << std::endl;
     std::cout << "  Calibrations sweep:" << std::endl;
     std::cout << "    --cal[=\"module=foo,serial=bar\"]  \t Calibrate device, optional device args..." << std::endl;
@@ -55,6 +84,21 @@ static int printHelp(void)
     std::cout << "    --bw[=bandwidth, default=30MHz]    \t Desired calibration bandwidth(Hz)" << std::endl;
     std::cout << "    --dir[=direction, default=BOTH]    \t Calibration direction, RX, TX, BOTH" << std::endl;
     std::cout << "    --chans[=channels, default=ALL]    \t Calibration channels, 0, 1, ALL" << std::endl;
+    std::cout << "    (all Rx and Tx paths are swept, results are stored to calibration cache)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  Record to file (SigMF):" << std::endl;
+    std::cout << "    --record=\"filename\"              \t Record RX samples, uses --args and --chans" << std::endl;
+    std::cout << "    --freq[=frequency]                 \t RF center frequency(Hz)" << std::endl;
+    std::cout << "    --rate[=sampleRate]                \t Sample rate(Hz)" << std::endl;
+    std::cout << "    --gain[=gain, default=30dB]        \t Receiver gain(dB)" << std::endl;
+    std::cout << "    --duration[=seconds, default=0]    \t Recording length, 0 - until Ctrl+C" << std::endl;
+    std::cout << "    --fmt[=format, default=CS16]       \t Sample format, CS16, CS12" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  Play from file (raw or SigMF):" << std::endl;
+    std::cout << "    --play=\"filename\"                \t Transmit file, uses --freq, --rate, --gain, --chans" << std::endl;
+    std::cout << "    --fmt[=format, default=CS16]       \t Raw file format, CS16, CS12, CF32" << std::endl;
+    std::cout << "    --loop                             \t Repeat file until Ctrl+C" << std::endl;
+    std::cout << "    --delay[=seconds, default=0]       \t Timestamped start relative to stream start" << std::endl;
     std::cout << std::endl;
     return EXIT_SUCCESS;
 }
@@ -154,7 +198,7 @@ static int makeDevice(void)
 /***********************************************************************
  * Program update (sync images and flash support)
  **********************************************************************/
-static int programUpdate(const std::string &argStr)
+static int programUpdate(const std::string &argStr, const bool force)
 {
     auto handles = ConnectionRegistry::findConnections(argStr);
     if(handles.size() == 0)
@@ -171,7 +215,7 @@ static int programUpdate(const std::string &argStr)
         return 0;
     };
 
-    auto status = conn->ProgramUpdate(true/*yes download*/, progCallback);
+    auto status = conn->ProgramUpdate(true/*yes download*/, progCallback, force);
 
     std::cout << std::endl;
     if(status == 0)
@@ -310,10 +354,15 @@ int main(int argc, char *argv[])
         {"find", optional_argument, 0, 'f'},
         {"make", optional_argument, 0, 'm'},
         {"args", optional_argument, 0, 'a'},
-        {"update",     no_argument, 0, 'u'},
+        {"update", optional_argument, 0, 'u'},
         {"fpga", required_argument, 0, 'g'},
         {"fw",   required_argument, 0, 'w'},
         {"timing",     no_argument, 0, 't'},
+        {"profile", optional_argument, 0, 'R'},
+        {"fftbench",optional_argument, 0, 'B'},
+        {"dspbench",optional_argument, 0, 'S'},
+        {"shmbench",optional_argument, 0, 'M'},
+        {"graphbench",optional_argument, 0, 'G'},
         {"cal",     optional_argument, 0, 'l'},
         {"start",   required_argument, 0, 's'},
         {"stop",    required_argument, 0, 'p'},
@@ -321,12 +370,27 @@ int main(int argc, char *argv[])
         {"bw",      required_argument, 0, 'b'},
         {"dir",     required_argument, 0, 'd'},
         {"chans",   required_argument, 0, 'c'},
+        {"record",  required_argument, 0, 'r'},
+        {"freq",    required_argument, 0, 'q'},
+        {"rate",    required_argument, 0, 'x'},
+        {"gain",    required_argument, 0, 'n'},
+        {"duration",required_argument, 0, 'o'},
+        {"fmt",     required_argument, 0, 'F'},
+        {"play",    required_argument, 0, 'P'},
+        {"loop",    no_argument,       0, 'L'},
+        {"delay",   required_argument, 0, 'D'},
         {0, 0, 0,  0}
     };
 
-    std::string argStr, dir("BOTH"), chans("ALL");
+    std::string argStr, dir("BOTH"), chans("ALL"), recordFile, playFile, fmt("CS16");
     double start(0.0), stop(0.0), step(1e6), bw(30e6);
-    bool testTiming(false), calSweep(false);
+    double freq(0.0), rate(0.0), gain(30.0), duration(0.0), delay(0.0);
+    bool testTiming(false), calSweep(false), loop(false), profile(false);
+    std::string profileFile;
+    int fftBenchSize(0);
+    int dspBenchChannels(0);
+    int shmBenchReaders(0);
+    int graphBenchPoints(0);
     int long_index = 0;
     int option = 0;
     while ((option = getopt_long_only(argc, argv, "", long_options, &long_index)) != -1)
@@ -340,10 +404,18 @@ int main(int argc, char *argv[])
         case 'a':
             if (optarg != NULL) argStr = optarg;
             break;
-        case 'u': return programUpdate(argStr);
+        case 'u': return programUpdate(argStr, optarg != NULL && std::string(optarg) == "force");
         case 'g': return programGateware(argStr);
         case 'w': return programFirmware(argStr);
         case 't': testTiming = true; break;
+        case 'R':
+            profile = true;
+            if (optarg != NULL) profileFile = optarg;
+            break;
+        case 'B': fftBenchSize = optarg != NULL ? std::stoi(optarg) : 16384; break;
+        case 'S': dspBenchChannels = optarg != NULL ? std::stoi(optarg) : 16; break;
+        case 'M': shmBenchReaders = optarg != NULL ? std::stoi(optarg) : 4; break;
+        case 'G': graphBenchPoints = optarg != NULL ? std::stoi(optarg) : 4000000; break;
         case 'l':
             calSweep = true;
             if (optarg != NULL) argStr = optarg;
@@ -354,12 +426,38 @@ int main(int argc, char *argv[])
         case 'b': if (optarg != NULL) bw = std::stod(optarg); break;
         case 'd': if (optarg != NULL) dir = optarg; break;
         case 'c': if (optarg != NULL) chans = optarg; break;
+        case 'r': if (optarg != NULL) recordFile = optarg; break;
+        case 'q': if (optarg != NULL) freq = std::stod(optarg); break;
+        case 'x': if (optarg != NULL) rate = std::stod(optarg); break;
+        case 'n': if (optarg != NULL) gain = std::stod(optarg); break;
+        case 'o': if (optarg != NULL) duration = std::stod(optarg); break;
+        case 'F': if (optarg != NULL) fmt = optarg; break;
+        case 'P': if (optarg != NULL) playFile = optarg; break;
+        case 'L': loop = true; break;
+        case 'D': if (optarg != NULL) delay = std::stod(optarg); break;
         }
     }
 
-    if (testTiming) return deviceTestTiming(argStr);
-    if (calSweep) return deviceCalSweep(argStr, start, stop, step, bw, dir, chans);
-
+    if (fftBenchSize != 0) return benchmarkFFT(fftBenchSize, duration);
+    if (dspBenchChannels != 0) return benchmarkDSP(dspBenchChannels, duration);
+    if (shmBenchReaders != 0) return benchmarkSharedStream(shmBenchReaders, duration);
+    if (graphBenchPoints != 0) return benchmarkGraphDecimation(graphBenchPoints, duration);
+
+    ControlProfiler::Enable(profile);
+    int status;
+    if (testTiming) status = deviceTestTiming(argStr);
+    else if (calSweep) status = deviceCalSweep(argStr, start, stop, step, bw, dir, chans);
+    else if (not recordFile.empty()) status = deviceRecord(argStr, recordFile, freq, rate, gain, duration, fmt, chans);
+    else if (not playFile.empty()) status = devicePlay(argStr, playFile, freq, rate, gain, fmt, chans, loop, delay);
     //unknown or unspecified options, do help...
-    return printHelp();
+    else return printHelp();
+
+    if (profile)
+    {
+        if (profileFile.empty())
+            std::cout << ControlProfiler::ExportJSON();
+        else if (ControlProfiler::ExportJSON(profileFile) != 0)
+            std::cout << GetLastErrorMessage() << std::endl;
+    }
+    return status;
 }
@@ -74,7 +74,7 @@ int deviceCalSweep(
     }
 
     //enable all channels in the matrix and set to the first antenna
-    for (const auto chanConfig : channelMatrix)
+    for (const auto &chanConfig : channelMatrix)
     {
         LMS_EnableChannel(device, chanConfig.first, chanConfig.second, true);
     }
@@ -82,6 +82,8 @@ int deviceCalSweep(
     //summary
     std::cout << "Cal sweep over [" << start/1e6 << ", " << stop/1e6 << ", " << step/1e6 << "] MHz, channels=" << chansStr << ", dir=" << dirStr << std::endl;
 
+    size_t calibrated = 0;
+    size_t failed = 0;
     for (double freq = start; freq <= stop; freq += step)
     {
         std::cout << "@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@" << std::endl;
@@ -89,33 +91,33 @@ int deviceCalSweep(
         std::cout << "@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@" << std::endl;
         std::cout << std::endl;
 
-        for (int path = 1; path < 3; path++)
+        //iterate through the matrix of channel options and every path
+        //(BAND1, BAND2 for Tx) (LNAH, LNAL, LNAW for Rx)
+        for (const auto &chanConfig : channelMatrix)
         {
-            //apply identical paths across channels
-            //(BAND1/BAND2 for Tx) (LNAL, LNAW for Rx)
-            for (int i = 0; i < LMS_GetNumChannels(device, LMS_CH_RX); i++)
-                LMS_SetAntenna(device, LMS_CH_RX, i, path+1);
-            for (int i = 0; i < LMS_GetNumChannels(device, LMS_CH_TX); i++)
-                LMS_SetAntenna(device, LMS_CH_TX, i, path);
-
-            //iterate through the matrix of channel options
-            for (const auto chanConfig : channelMatrix)
+            const int numPaths = chanConfig.first ? 2 : 3;
+            for (int path = 1; path <= numPaths; path++)
             {
-                if (LMS_SetLOFrequency(device, chanConfig.first, chanConfig.second, freq) != 0)
+                if (LMS_SetAntenna(device, chanConfig.first, chanConfig.second, path) != 0 ||
+                    LMS_SetLOFrequency(device, chanConfig.first, chanConfig.second, freq) != 0)
                 {
                     std::cerr << "Error tuning (skipping): " << LMS_GetLastErrorMessage() << std::endl;
+                    failed++;
                     continue;
                 }
                 if (LMS_Calibrate(device, chanConfig.first, chanConfig.second, bw, 0) != 0)
                 {
                     std::cerr << "Error calibrating (skipping): " << LMS_GetLastErrorMessage() << std::endl;
+                    failed++;
                     continue;
                 }
+                calibrated++;
             }
         }
         std::cout << std::endl;
     }
 
+    std::cout << "Calibrated " << calibrated << " entries, " << failed << " failed" << std::endl;
     std::cout << "Cleanup..." << std::endl;
     LMS_Close(device);
     return EXIT_SUCCESS;
@@ -0,0 +1,150 @@
+/**
+    @file LimeUtilDSPBench.cpp
+    @author Lime Microsystems
+    @brief Headless throughput benchmark of host stream DSP stage
+*/
+
+#include "StreamDSP.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <ciso646>
+
+using namespace lime;
+
+/** @brief Receive stream returning precomputed samples as fast as they are read
+*/
+class SyntheticSource : public IStreamChannel
+{
+public:
+    SyntheticSource(const size_t blockSize) : samples(2*blockSize), position(0), running(false)
+    {
+        //two tones and low level noise like pattern
+        for (size_t n = 0; n < blockSize; ++n)
+        {
+            const double a = 2*M_PI*0.1*n;
+            const double b = -2*M_PI*0.3*n;
+            samples[2*n] = int16_t(8000*std::cos(a) + 4000*std::cos(b) + (n*7919) % 64);
+            samples[2*n+1] = int16_t(8000*std::sin(a) + 4000*std::sin(b) + (n*104729) % 64);
+        }
+    }
+    int Start() override {running = true; return 0;}
+    int Stop() override {running = false; return 0;}
+    int Read(void* dst, const uint32_t count, Metadata* metadata, const int32_t timeout_ms) override
+    {
+        if (not running)
+            return 0;
+        const size_t n = std::min(size_t(count), samples.size()/2);
+        memcpy(dst, samples.data(), n*2*sizeof(int16_t));
+        metadata->timestamp = position;
+        position += n;
+        return n;
+    }
+    int Write(const void* samples, const uint32_t count, const Metadata* metadata, const int32_t timeout_ms) override {return -1;}
+    Info GetInfo() override {Info info; memset(&info, 0, sizeof(info)); return info;}
+
+    std::vector<int16_t> samples;
+    uint64_t position;
+    std::atomic<bool> running;
+};
+
+template<typename Kernel>
+static void benchmarkKernel(const char* name, const size_t count, Kernel kernel)
+{
+    const int iterations = 200;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        kernel();
+    auto t1 = std::chrono::steady_clock::now();
+    const double rate = count*double(iterations)/std::chrono::duration<double>(t1-t0).count();
+    std::cout << "  >>> " << name << ":" << (strlen(name) < 14 ? "\t\t" : "\t") << rate/1e6 << " MS/s,\t"
+        << 100/(rate/1e6) << " % of core per MS/s" << std::endl;
+}
+
+//whole stage with processing thread, all sub-streams read
+static void benchmarkStage(const char* name, const StreamDSP::Config &config, const double duration)
+{
+    SyntheticSource source(65536);
+    StreamDSP dsp(&source, config);
+    for (unsigned i = 0; i < config.channels; ++i)
+        dsp.GetChannel(i)->Start();
+    const size_t readSize = 4096;
+    std::vector<int16_t> buffer(2*readSize);
+    auto t0 = std::chrono::steady_clock::now();
+    auto t1 = t0;
+    while (std::chrono::duration<double>(t1-t0).count() < duration)
+    {
+        IStreamChannel::Metadata meta;
+        for (unsigned i = 0; i < config.channels; ++i)
+            dsp.GetChannel(i)->Read(buffer.data(), readSize, &meta, 100);
+        t1 = std::chrono::steady_clock::now();
+    }
+    for (unsigned i = 0; i < config.channels; ++i)
+        dsp.GetChannel(i)->Stop();
+    const StreamDSP::Stats stats = dsp.GetStats();
+    const double elapsed = std::chrono::duration<double>(t1-t0).count();
+    std::cout << "  >>> " << name << ":" << (strlen(name) < 14 ? "\t\t" : "\t") << stats.samplesIn/elapsed/1e6 << " MS/s input, "
+        << stats.samplesIn/stats.processTime/1e6 << " MS/s while processing, "
+        << dsp.GetChannelRate()/1e6 << " MS/s per channel, "
+        << stats.overruns << " overrun samples" << std::endl;
+}
+
+int benchmarkDSP(const int channels, double duration)
+{
+    if (channels < 1)
+    {
+        std::cerr << "Invalid channels count " << channels << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (duration <= 0)
+        duration = 2.0;
+    const unsigned decimation = 4;
+    std::cout << "Stream DSP, NCO, decimation " << decimation << ", " << channels << " channels" << std::endl;
+
+    //kernels on calling thread, rates in input samples
+    {
+        const size_t count = 16384;
+        std::vector<complex32f_t> in(count), out(2*count);
+        for (size_t n = 0; n < count; ++n)
+        {
+            in[n].i = std::cos(0.1*n);
+            in[n].q = std::sin(0.1*n);
+        }
+        std::vector<std::vector<complex32f_t>> channelOut(channels, std::vector<complex32f_t>(count/channels+1));
+        std::vector<complex32f_t*> channelPtrs;
+        for (auto &buf : channelOut)
+            channelPtrs.push_back(buf.data());
+        NCOMixer mixer(0.123);
+        CICDecimator cic(16);
+        HalfBandDecimator halfBand;
+        PolyphaseResampler downsampler(0.77);
+        PolyphaseResampler upsampler(1.3);
+        PolyphaseChannelizer channelizer(channels);
+        std::vector<int16_t> raw(2*count);
+        benchmarkKernel("convert", count, [&]{SamplesToFloat(raw.data(), StreamConfig::STREAM_12_BIT_IN_16, out.data(), count);});
+        benchmarkKernel("NCO mixer", count, [&]{mixer.Process(in.data(), out.data(), count);});
+        benchmarkKernel("CIC by 16", count, [&]{cic.Process(in.data(), count, out.data());});
+        benchmarkKernel("half-band", count, [&]{halfBand.Process(in.data(), count, out.data());});
+        benchmarkKernel("resample 0.77", count, [&]{downsampler.Process(in.data(), count, out.data());});
+        benchmarkKernel("resample 1.3", count, [&]{upsampler.Process(in.data(), count, out.data());});
+        if (channels > 1)
+            benchmarkKernel("channelizer", count, [&]{channelizer.Process(in.data(), count, channelPtrs.data());});
+    }
+
+    StreamDSP::Config config;
+    config.sampleRate = 30.72e6;
+    config.ncoFrequency = 1e6;
+    config.decimation = decimation;
+    config.channels = channels;
+    benchmarkStage("stage", config, duration);
+    //rate between hardware rates, served without CGEN change
+    config.outputRate = 0.77*config.sampleRate/(decimation*channels);
+    benchmarkStage("resampled", config, duration);
+    return EXIT_SUCCESS;
+}
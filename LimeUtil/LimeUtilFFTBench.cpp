@@ -0,0 +1,100 @@
+/**
+    @file LimeUtilFFTBench.cpp
+    @author Lime Microsystems
+    @brief Headless benchmark of FFT viewer spectrum processing
+*/
+
+#include "SpectrumPipeline.h"
+#include "FFTPlanCache.h"
+#include "windowFunction.h"
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <ciso646>
+
+using namespace lime;
+
+static const int blackmanHarris = 1;
+
+static double runPipeline(const int fftSize, const int workers, const double duration)
+{
+    //noise like samples, content does not change FFT speed
+    std::vector<complex16_t> samples(fftSize);
+    for (int i = 0; i < fftSize; ++i)
+    {
+        samples[i].i = int16_t((i*7919) % 4096 - 2048);
+        samples[i].q = int16_t((i*104729) % 4096 - 2048);
+    }
+    const complex16_t* frame[] = {samples.data()};
+
+    SpectrumPipeline pipeline(fftSize, 1, workers, 4*workers);
+    pipeline.SetWindow(blackmanHarris);
+    pipeline.SetAverageCount(50);
+    auto t0 = std::chrono::steady_clock::now();
+    auto t1 = t0;
+    while (std::chrono::duration<double>(t1-t0).count() < duration)
+    {
+        if (not pipeline.Push(frame))
+            std::this_thread::yield();
+        t1 = std::chrono::steady_clock::now();
+    }
+    pipeline.Flush();
+    t1 = std::chrono::steady_clock::now();
+    return pipeline.GetProcessedCount()/std::chrono::duration<double>(t1-t0).count();
+}
+
+int benchmarkFFT(const int fftSize, double duration)
+{
+    if (fftSize < 2)
+    {
+        std::cerr << "Invalid FFT size " << fftSize << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (duration <= 0)
+        duration = 2.0;
+    const int cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "Spectrum processing, FFT size " << fftSize << ", blackman-harris window, "
+        << cores << " cores" << std::endl;
+
+    //kernels of one frame on calling thread, without queueing
+    {
+        std::vector<complex16_t> samples(fftSize);
+        const std::vector<float> &window = GetWindowCoefficients(blackmanHarris, fftSize);
+        std::vector<float> power(fftSize, 0);
+        FFTPlan fftPlan(fftSize);
+        const int iterations = 1000;
+        double windowTime = 0, fftTime = 0, powerTime = 0;
+        for (int n = 0; n < iterations; ++n)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            ApplyWindow(samples.data(), window.data(), fftPlan.In(), fftSize);
+            auto t1 = std::chrono::steady_clock::now();
+            fftPlan.Execute();
+            auto t2 = std::chrono::steady_clock::now();
+            AccumulatePower(fftPlan.Out(), power.data(), fftSize);
+            PowerToDB(power.data(), power.data(), fftSize);
+            auto t3 = std::chrono::steady_clock::now();
+            windowTime += std::chrono::duration<double>(t1-t0).count();
+            fftTime += std::chrono::duration<double>(t2-t1).count();
+            powerTime += std::chrono::duration<double>(t3-t2).count();
+        }
+        std::cout << "  >>> window:		" << windowTime/iterations*1e6 << " us" << std::endl;
+        std::cout << "  >>> FFT:		" << fftTime/iterations*1e6 << " us" << std::endl;
+        std::cout << "  >>> power and dB:	" << powerTime/iterations*1e6 << " us" << std::endl;
+        std::cout << "  >>> single core:	" << iterations/(windowTime+fftTime+powerTime) << " FFT/s" << std::endl;
+    }
+
+    for (int workers = 1; workers <= cores; workers *= 2)
+    {
+        const double rate = runPipeline(fftSize, workers, duration);
+        std::cout << "  >>> workers " << workers << ":\t"
+            << rate << " FFT/s,\t" << rate/workers << " FFT/s per core,\t"
+            << rate*fftSize/1e6 << " MS/s" << std::endl;
+        if (workers < cores and workers*2 > cores)
+            workers = cores/2;
+    }
+    return EXIT_SUCCESS;
+}
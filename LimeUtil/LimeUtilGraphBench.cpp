@@ -0,0 +1,43 @@
+/**
+    @file LimeUtilGraphBench.cpp
+    @author Lime Microsystems
+    @brief Headless benchmark of graph series decimation
+*/
+
+#include "SeriesDecimation.h"
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <chrono>
+
+int benchmarkGraphDecimation(const int points, double duration)
+{
+    if (duration <= 0)
+        duration = 2.0;
+    const size_t count = points;
+    std::vector<float> xy(2*count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        xy[2*i] = i;
+        xy[2*i+1] = 1000*std::sin(i*0.001) + (i*7919 % 101) - 50;
+    }
+
+    std::vector<float> out;
+    size_t decimated = 0;
+    int iterations = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    auto t1 = t0;
+    while (std::chrono::duration<double>(t1-t0).count() < duration)
+    {
+        decimated = DecimateMinMax(xy.data(), count, 0, count, 1920, out);
+        ++iterations;
+        t1 = std::chrono::steady_clock::now();
+    }
+    const double elapsed = std::chrono::duration<double>(t1-t0).count()/iterations;
+
+    std::cout << "Decimated " << count << " points to " << decimated << " for 1920 columns" << std::endl;
+    std::cout << "  " << elapsed*1e3 << " ms per series, "
+        << count/elapsed/1e6 << " Mpoints/s" << std::endl;
+    return EXIT_SUCCESS;
+}
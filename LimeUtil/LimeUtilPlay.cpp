@@ -0,0 +1,162 @@
+/**
+    @file LimeUtilPlay.cpp
+    @author Lime Microsystems
+    @brief Transmit samples from raw or SigMF files
+*/
+
+#include "lime/LimeSuite.h"
+#include "StreamPlayer.h"
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <atomic>
+#include <ciso646>
+
+static std::atomic<bool> stopPlayback(false);
+
+static void sigIntHandler(int)
+{
+    stopPlayback = true;
+}
+
+int devicePlay(
+    const std::string &argStr,
+    const std::string &filename,
+    const double freq,
+    double rate,
+    const double gain,
+    const std::string &fmtStr,
+    const std::string &chansStr,
+    const bool loop,
+    const double delay)
+{
+    lime::StreamPlayer::Config config;
+    config.filename = filename;
+    config.loop = loop;
+    if (fmtStr == "CS16") config.format = lime::StreamPlayer::FORMAT_CS16;
+    else if (fmtStr == "CS12") config.format = lime::StreamPlayer::FORMAT_CS12;
+    else if (fmtStr == "CF32") config.format = lime::StreamPlayer::FORMAT_CF32;
+    else
+    {
+        std::cerr << "Unknown format --fmt=" << fmtStr << std::endl;
+        return EXIT_FAILURE;
+    }
+    config.channels = (chansStr == "ALL") ? 2 : 1;
+
+    lime::StreamPlayer player;
+    if (player.Open(config) != 0)
+    {
+        std::cerr << "Failed to open file: " << LMS_GetLastErrorMessage() << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (rate == 0.0)
+        rate = player.GetSampleRate();
+    if (freq == 0.0 || rate == 0.0)
+    {
+        std::cerr << "Unspecified --freq or --rate!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    lms_device_t *device(nullptr);
+    if (LMS_Open(&device, argStr.empty()?nullptr:argStr.c_str(), nullptr) != 0)
+    {
+        std::cerr << "Failed to open: " << LMS_GetLastErrorMessage() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<size_t> chans;
+    if (chansStr == "ALL")
+    {
+        for (unsigned i = 0; i < player.GetChannelsCount() && int(i) < LMS_GetNumChannels(device, LMS_CH_TX); i++)
+            chans.push_back(i);
+    }
+    else
+        chans.push_back(std::stoi(chansStr));
+
+    bool ok = (LMS_Init(device) == 0);
+    for (size_t i = 0; ok && i < chans.size(); i++)
+        ok = LMS_EnableChannel(device, LMS_CH_TX, chans[i], true) == 0;
+    ok = ok && (LMS_SetSampleRate(device, rate, 0) == 0);
+    for (size_t i = 0; ok && i < chans.size(); i++)
+    {
+        ok = ok && (LMS_SetLOFrequency(device, LMS_CH_TX, chans[i], freq) == 0);
+        ok = ok && (LMS_SetGaindB(device, LMS_CH_TX, chans[i], unsigned(gain)) == 0);
+    }
+    if (not ok)
+    {
+        std::cerr << "Failed to configure: " << LMS_GetLastErrorMessage() << std::endl;
+        LMS_Close(device);
+        return EXIT_FAILURE;
+    }
+
+    //stream format matching the file avoids per sample conversion
+    lms_stream_t streamTemplate;
+    streamTemplate.isTx = true;
+    streamTemplate.fifoSize = 1024*1024;
+    streamTemplate.throughputVsLatency = 1.0;
+    streamTemplate.dataFmt = lms_stream_t::LMS_FMT_I16;
+    lime::StreamConfig::StreamDataFormat streamFormat = lime::StreamConfig::STREAM_12_BIT_IN_16;
+    if (player.GetMeta().datatype == "cf32_le")
+    {
+        streamTemplate.dataFmt = lms_stream_t::LMS_FMT_F32;
+        streamFormat = lime::StreamConfig::STREAM_COMPLEX_FLOAT32;
+    }
+
+    std::vector<lms_stream_t> streams(chans.size(), streamTemplate);
+    std::vector<lime::IStreamChannel*> channels;
+    for (size_t i = 0; i < chans.size(); i++)
+    {
+        streams[i].channel = chans[i];
+        if (LMS_SetupStream(device, &streams[i]) != 0)
+        {
+            std::cerr << "Failed to setup stream: " << LMS_GetLastErrorMessage() << std::endl;
+            LMS_Close(device);
+            return EXIT_FAILURE;
+        }
+        channels.push_back((lime::IStreamChannel*)streams[i].handle);
+    }
+
+    for (auto &stream : streams)
+        LMS_StartStream(&stream);
+
+    std::cout << "Playing " << filename << " on " << chans.size() << " channel(s) at "
+        << rate/1e6 << " MSps, " << freq/1e6 << " MHz" << (loop ? " (looping, Ctrl+C to stop)" : "") << std::endl;
+
+    int status = EXIT_SUCCESS;
+    //timestamp counter restarts with the stream
+    if (player.Start(channels, streamFormat, delay > 0, uint64_t(delay*rate)) != 0)
+    {
+        std::cerr << "Failed to start playback: " << LMS_GetLastErrorMessage() << std::endl;
+        status = EXIT_FAILURE;
+    }
+
+    stopPlayback = false;
+    auto oldHandler = std::signal(SIGINT, sigIntHandler);
+    while (status == EXIT_SUCCESS && not stopPlayback && player.IsActive())
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        auto stats = player.GetStats();
+        std::cout << "  " << stats.samplesSent << " samples sent, "
+            << stats.loops << " loops, "
+            << stats.underruns << " underruns, "
+            << stats.latePackets << " late packets" << std::endl;
+    }
+    std::signal(SIGINT, oldHandler);
+    player.Stop();
+    auto stats = player.GetStats();
+
+    for (auto &stream : streams)
+    {
+        LMS_StopStream(&stream);
+        LMS_DestroyStream(device, &stream);
+    }
+
+    std::cout << "Sent " << stats.samplesSent << " samples per channel, "
+        << stats.underruns << " underruns, " << stats.latePackets << " late packets" << std::endl;
+    LMS_Close(device);
+    return status;
+}
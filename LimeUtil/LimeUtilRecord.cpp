@@ -0,0 +1,235 @@
+/**
+    @file LimeUtilRecord.cpp
+    @author Lime Microsystems
+    @brief Record received samples to SigMF files
+*/
+
+#include "lime/LimeSuite.h"
+#include "StreamRecorder.h"
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <csignal>
+#include <atomic>
+#include <ciso646>
+
+static std::atomic<bool> stopRecording(false);
+
+static void sigIntHandler(int)
+{
+    stopRecording = true;
+}
+
+int deviceRecord(
+    const std::string &argStr,
+    const std::string &filename,
+    const double freq,
+    const double rate,
+    const double gain,
+    const double duration,
+    const std::string &fmtStr,
+    const std::string &chansStr)
+{
+    if (freq == 0.0 || rate == 0.0)
+    {
+        std::cerr << "Unspecified --freq or --rate!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    lime::StreamRecorder::Config config;
+    lms_stream_t streamTemplate;
+    streamTemplate.isTx = false;
+    streamTemplate.fifoSize = 1024*1024;
+    streamTemplate.throughputVsLatency = 1.0;
+    if (fmtStr == "CS16")
+    {
+        config.format = lime::StreamRecorder::FORMAT_CS16;
+        streamTemplate.dataFmt = lms_stream_t::LMS_FMT_I16;
+    }
+    else if (fmtStr == "CS12")
+    {
+        config.format = lime::StreamRecorder::FORMAT_CS12;
+        streamTemplate.dataFmt = lms_stream_t::LMS_FMT_I12;
+    }
+    else
+    {
+        std::cerr << "Unknown format --fmt=" << fmtStr << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    lms_device_t *device(nullptr);
+    if (LMS_Open(&device, argStr.empty()?nullptr:argStr.c_str(), nullptr) != 0)
+    {
+        std::cerr << "Failed to open: " << LMS_GetLastErrorMessage() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<size_t> chans;
+    if (chansStr == "ALL")
+    {
+        for (int i = 0; i < LMS_GetNumChannels(device, LMS_CH_RX); i++)
+            chans.push_back(i);
+    }
+    else
+        chans.push_back(std::stoi(chansStr));
+
+    bool ok = (LMS_Init(device) == 0);
+    for (size_t i = 0; ok && i < chans.size(); i++)
+        ok = LMS_EnableChannel(device, LMS_CH_RX, chans[i], true) == 0;
+    ok = ok && (LMS_SetSampleRate(device, rate, 0) == 0);
+    for (size_t i = 0; ok && i < chans.size(); i++)
+    {
+        ok = ok && (LMS_SetLOFrequency(device, LMS_CH_RX, chans[i], freq) == 0);
+        ok = ok && (LMS_SetGaindB(device, LMS_CH_RX, chans[i], unsigned(gain)) == 0);
+    }
+    if (not ok)
+    {
+        std::cerr << "Failed to configure: " << LMS_GetLastErrorMessage() << std::endl;
+        LMS_Close(device);
+        return EXIT_FAILURE;
+    }
+
+    float_type actualRate(rate), actualFreq(freq);
+    unsigned actualGain(gain);
+    LMS_GetSampleRate(device, LMS_CH_RX, chans[0], &actualRate, nullptr);
+    LMS_GetLOFrequency(device, LMS_CH_RX, chans[0], &actualFreq);
+    LMS_GetGaindB(device, LMS_CH_RX, chans[0], &actualGain);
+
+    std::vector<lms_stream_t> streams(chans.size(), streamTemplate);
+    for (size_t i = 0; i < chans.size(); i++)
+    {
+        streams[i].channel = chans[i];
+        if (LMS_SetupStream(device, &streams[i]) != 0)
+        {
+            std::cerr << "Failed to setup stream: " << LMS_GetLastErrorMessage() << std::endl;
+            LMS_Close(device);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const lms_dev_info_t* info = LMS_GetDeviceInfo(device);
+    config.filename = filename;
+    config.channels = chans.size();
+    config.sampleRate = actualRate;
+    config.frequency = actualFreq;
+    config.gain = actualGain;
+    config.hw = info ? info->deviceName : "";
+
+    lime::StreamRecorder recorder;
+    if (recorder.Open(config) != 0)
+    {
+        std::cerr << "Failed to start recording: " << LMS_GetLastErrorMessage() << std::endl;
+        LMS_Close(device);
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Recording " << chans.size() << " channel(s) at " << actualRate/1e6 << " MSps, "
+        << actualFreq/1e6 << " MHz to " << filename << " (Ctrl+C to stop)" << std::endl;
+
+    const size_t samplesPerRead = 1360*8;
+    std::vector<std::vector<lime::complex16_t>> buffers(chans.size(), std::vector<lime::complex16_t>(samplesPerRead));
+    std::vector<const lime::complex16_t*> bufPtrs(chans.size());
+    for (size_t i = 0; i < chans.size(); i++)
+        bufPtrs[i] = buffers[i].data();
+
+    for (auto &stream : streams)
+        LMS_StartStream(&stream);
+
+    stopRecording = false;
+    auto oldHandler = std::signal(SIGINT, sigIntHandler);
+    const uint64_t samplesToRecord = (duration > 0) ? uint64_t(duration*actualRate) : 0;
+    uint64_t samplesRecorded = 0;
+    int status = EXIT_SUCCESS;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    while (not stopRecording)
+    {
+        //every channel is read until block is full, so channels stay aligned
+        uint64_t timestamp = 0;
+        for (size_t i = 0; i < streams.size() && not stopRecording; i++)
+        {
+            uint64_t channelTimestamp = 0;
+            size_t received = 0;
+            while (received < samplesPerRead && not stopRecording)
+            {
+                lms_stream_meta_t meta;
+                meta.waitForTimestamp = false;
+                meta.flushPartialPacket = false;
+                int ret = LMS_RecvStream(&streams[i], buffers[i].data() + received, samplesPerRead - received, &meta, 1000);
+                if (ret < 0)
+                {
+                    std::cerr << "Stream read failed: " << LMS_GetLastErrorMessage() << std::endl;
+                    stopRecording = true;
+                    status = EXIT_FAILURE;
+                    break;
+                }
+                if (ret == 0)
+                    continue;
+                if (received == 0)
+                    channelTimestamp = meta.timestamp;
+                else if (meta.timestamp != channelTimestamp + received)
+                    recorder.MarkEvent(channelTimestamp + received, "discontinuity: rx stream ch" + std::to_string(chans[i]));
+                received += ret;
+            }
+            if (i == 0)
+                timestamp = channelTimestamp;
+            else if (channelTimestamp != timestamp && not stopRecording)
+                recorder.MarkEvent(timestamp, "misaligned: ch" + std::to_string(chans[i]) + " block starts at " + std::to_string(channelTimestamp));
+        }
+        if (stopRecording)
+            continue;
+
+        const size_t count = samplesPerRead;
+        if (recorder.Write(bufPtrs.data(), count, timestamp) < 0)
+        {
+            std::cerr << "Recording failed: " << LMS_GetLastErrorMessage() << std::endl;
+            status = EXIT_FAILURE;
+            break;
+        }
+        samplesRecorded += count;
+        if (samplesToRecord > 0 && samplesRecorded >= samplesToRecord)
+            break;
+
+        auto t2 = std::chrono::high_resolution_clock::now();
+        if (t2 - t1 >= std::chrono::seconds(1))
+        {
+            t1 = t2;
+            for (size_t i = 0; i < streams.size(); i++)
+            {
+                lms_stream_status_t streamStatus;
+                if (LMS_GetStreamStatus(&streams[i], &streamStatus) != 0)
+                    continue;
+                if (streamStatus.overrun > 0)
+                    recorder.MarkEvent(timestamp, "overrun: rx fifo ch" + std::to_string(chans[i]));
+                if (streamStatus.droppedPackets > 0)
+                    recorder.MarkEvent(timestamp, "dropped packets: ch" + std::to_string(chans[i]));
+            }
+            auto stats = recorder.GetStats();
+            std::cout << "  " << stats.samplesWritten << " samples, "
+                << stats.bytesWritten/(1024*1024) << " MiB written, "
+                << stats.overruns << " disk overruns, "
+                << stats.events << " events" << std::endl;
+        }
+    }
+    std::signal(SIGINT, oldHandler);
+
+    for (auto &stream : streams)
+    {
+        LMS_StopStream(&stream);
+        LMS_DestroyStream(device, &stream);
+    }
+
+    if (recorder.Close() != 0)
+    {
+        std::cerr << "Failed to finish recording: " << LMS_GetLastErrorMessage() << std::endl;
+        status = EXIT_FAILURE;
+    }
+    auto stats = recorder.GetStats();
+    std::cout << "Recorded " << stats.samplesWritten << " samples per channel ("
+        << (stats.directIO ? "direct I/O" : "buffered I/O") << "), "
+        << stats.samplesDropped << " samples dropped in " << stats.overruns << " disk overruns" << std::endl;
+
+    LMS_Close(device);
+    return status;
+}
@@ -0,0 +1,146 @@
+/**
+    @file LimeUtilSharedBench.cpp
+    @author Lime Microsystems
+    @brief Throughput and latency benchmark of shared memory stream readers
+*/
+
+#include "SharedStream.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <ciso646>
+
+using namespace lime;
+
+struct ReaderResult
+{
+    uint64_t samples;
+    uint64_t lost;
+    unsigned overruns;
+    double latencyMin;
+    double latencyAvg;
+    double latencyMax;
+};
+
+/** @brief Publishes synthetic samples, at given rate or as fast as possible when 0.
+    Readers attach their own mapping of the ring by name, like separate processes would.
+*/
+static void benchmarkRun(const char* name, const int readers, const double rate, const double duration)
+{
+    const size_t blockSize = 4096;
+    const size_t ringSize = 1 << 20;
+    const std::string shm = "shmbench-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    SharedStreamPublisher publisher;
+    if (publisher.Open(shm, ringSize, StreamConfig::STREAM_12_BIT_IN_16, rate) != 0)
+        return;
+
+    //publish time of each block, readers compute latency of last read sample
+    const size_t timesCount = 4*ringSize/blockSize;
+    std::vector<std::atomic<int64_t>> publishTimes(timesCount);
+    std::atomic<bool> terminate(false);
+    std::vector<ReaderResult> results(readers);
+    std::vector<std::thread> threads;
+    std::atomic<int> started(0);
+    for (int r = 0; r < readers; ++r)
+    {
+        threads.push_back(std::thread([&, r]{
+            ReaderResult &result = results[r];
+            memset(&result, 0, sizeof(result));
+            result.latencyMin = 1e9;
+            SharedStreamReader reader;
+            if (reader.Open(shm) != 0)
+            {
+                started++;
+                return;
+            }
+            reader.Start();
+            started++;
+            std::vector<int16_t> buffer(2*blockSize);
+            double latencySum = 0;
+            uint64_t reads = 0;
+            while (not terminate.load())
+            {
+                IStreamChannel::Metadata meta;
+                meta.flags = 0;
+                const int count = reader.Read(buffer.data(), blockSize, &meta, 100);
+                if (count <= 0)
+                    continue;
+                const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+                const uint64_t last = meta.timestamp + count - 1;
+                const double latency = 1e6*(now - publishTimes[(last/blockSize) % timesCount].load())*
+                    std::chrono::steady_clock::period::num/std::chrono::steady_clock::period::den;
+                result.samples += count;
+                latencySum += latency;
+                result.latencyMin = std::min(result.latencyMin, latency);
+                result.latencyMax = std::max(result.latencyMax, latency);
+                ++reads;
+            }
+            result.lost = reader.GetLostCount();
+            result.overruns = reader.GetInfo().overrun;
+            result.latencyAvg = reads ? latencySum/reads : 0;
+            if (reads == 0)
+                result.latencyMin = 0;
+        }));
+    }
+    while (started.load() < readers)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    std::vector<int16_t> block(2*blockSize);
+    for (size_t n = 0; n < block.size(); ++n)
+        block[n] = int16_t(n*7919);
+    uint64_t published = 0;
+    double publishTime = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    auto t1 = t0;
+    while (std::chrono::duration<double>(t1-t0).count() < duration)
+    {
+        if (rate > 0)
+            std::this_thread::sleep_until(t0 + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(published/rate)));
+        const auto p0 = std::chrono::steady_clock::now();
+        publishTimes[(published/blockSize) % timesCount].store(p0.time_since_epoch().count());
+        publisher.Publish(block.data(), blockSize, published);
+        t1 = std::chrono::steady_clock::now();
+        publishTime += std::chrono::duration<double>(t1-p0).count();
+        published += blockSize;
+        //give readers a chance on machines with few cores
+        if (rate <= 0)
+            std::this_thread::yield();
+    }
+    terminate.store(true);
+    for (auto &t : threads)
+        t.join();
+
+    const double elapsed = std::chrono::duration<double>(t1-t0).count();
+    std::cout << "  >>> " << name << ": published " << published/elapsed/1e6 << " MS/s, "
+        << published/publishTime/1e6 << " MS/s while publishing" << std::endl;
+    for (int r = 0; r < readers; ++r)
+    {
+        const ReaderResult &result = results[r];
+        std::cout << "      reader " << r << ": " << result.samples/elapsed/1e6 << " MS/s, "
+            << result.lost << " lost samples in " << result.overruns << " overruns, latency "
+            << result.latencyMin << "/" << result.latencyAvg << "/" << result.latencyMax << " us min/avg/max" << std::endl;
+    }
+}
+
+int benchmarkSharedStream(const int readers, double duration)
+{
+    if (readers < 1)
+    {
+        std::cerr << "Invalid readers count " << readers << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (duration <= 0)
+        duration = 2.0;
+    std::cout << "Shared memory stream, " << readers << " readers, "
+        << std::thread::hardware_concurrency() << " cores" << std::endl;
+    benchmarkRun("unthrottled", readers, 0, duration);
+    benchmarkRun("30.72 MS/s", readers, 30.72e6, duration);
+    return EXIT_SUCCESS;
+}
@@ -10,6 +10,7 @@
 #include <LMS7002M.h>
 #include <iostream>
 #include <chrono>
+#include <vector>
 
 using namespace lime;
 
@@ -66,6 +67,20 @@ int deviceTestTiming(const std::string &argStr)
         std::cout << "  >>> SPI read register:\t" << (secsPerOp/1e-6) << " us" << std::endl;
     }
 
+    //time spi batch write, several packets which connection may pipeline
+    {
+        const size_t numIters(100);
+        const std::vector<uint16_t> addrs(64, 0x0000), values(64, 0x0000);
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIters; i++)
+        {
+            lms7->SPI_write_batch(addrs.data(), values.data(), addrs.size());
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        const auto secsPerOp = std::chrono::duration<double>(t1-t0).count()/numIters;
+        std::cout << "  >>> SPI write 64 registers:\t" << (secsPerOp/1e-6) << " us" << std::endl;
+    }
+
     //time NCO setting
     {
         const size_t numIters(1000);
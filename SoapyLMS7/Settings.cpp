@@ -52,6 +52,20 @@ SoapyLMS7::SoapyLMS7(const ConnectionHandle &handle, const SoapySDR::Kwargs &arg
     SoapySDR::logf(SOAPY_SDR_INFO, "Device name: %s", devInfo.deviceName.c_str());
     SoapySDR::logf(SOAPY_SDR_INFO, "Reference: %g MHz", _conn->GetReferenceClockRate()/1e6);
 
+    //per chip locks and per channel settings
+    _chipMutexes.reset(new std::recursive_mutex[numRFICs]);
+    _interps.reset(new int[numRFICs*2]);
+    _decims.reset(new int[numRFICs*2]);
+    _fixedRxSampRate.reset(new bool[numRFICs*2]);
+    _fixedTxSampRate.reset(new bool[numRFICs*2]);
+    for (int direction : {SOAPY_SDR_RX, SOAPY_SDR_TX})
+        _actualBw[direction].reset(new std::atomic<double>[numRFICs*2]);
+    for (size_t channel = 0; channel < numRFICs*2; channel++)
+    {
+        _interps[channel] = _decims[channel] = 0;
+        _actualBw[SOAPY_SDR_RX][channel] = _actualBw[SOAPY_SDR_TX][channel] = 0.0;
+    }
+
     //LMS7002M driver for each RFIC
     for (size_t i = 0; i < numRFICs; i++)
     {
@@ -89,6 +103,15 @@ SoapyLMS7::SoapyLMS7(const ConnectionHandle &handle, const SoapySDR::Kwargs &arg
     SoapySDR::logf(SOAPY_SDR_INFO, "LMS7002M calibration values caching %s", cacheEnable?"Enable":"Disable");
     for (auto rfic : _rfics) rfic->EnableValuesCache(cacheEnable);
 
+    //apply stored calibration values on retune instead of calibrating
+    //specify args[calibrationTable] == 1 to enable
+    const bool tableEnable = cacheEnable and args.count("calibrationTable") != 0 and std::stoi(args.at("calibrationTable")) != 0;
+    if (tableEnable)
+    {
+        SoapySDR::logf(SOAPY_SDR_INFO, "LMS7002M calibration table Enable");
+        for (auto rfic : _rfics) rfic->EnableCalibrationTable(true);
+    }
+
     //give all RFICs a default state
     double defaultClockRate = DEFAULT_CLOCK_RATE;
     if (args.count("clock")) defaultClockRate = std::stod(args.at("clock"));
@@ -115,8 +138,8 @@ SoapyLMS7::SoapyLMS7(const ConnectionHandle &handle, const SoapySDR::Kwargs &arg
 
     //reset flags for user calls
     _fixedClockRate = args.count("clock") != 0;
-    _fixedRxSampRate.clear();
-    _fixedTxSampRate.clear();
+    for (size_t channel = 0; channel < _rfics.size()*2; channel++)
+        _fixedRxSampRate[channel] = _fixedTxSampRate[channel] = false;
     _channelsToCal.clear();
 }
 
@@ -145,6 +168,21 @@ LMS7002M *SoapyLMS7::getRFIC(const size_t channel) const
     return rfic;
 }
 
+std::recursive_mutex &SoapyLMS7::getChipMutex(const size_t channel) const
+{
+    if (_rfics.size() <= channel/2)
+    {
+        throw std::out_of_range("SoapyLMS7::getChipMutex("+std::to_string(channel)+") out of range");
+    }
+    return _chipMutexes[channel/2];
+}
+
+void SoapyLMS7::_scheduleCal(const int direction, const size_t channel)
+{
+    std::lock_guard<std::mutex> lock(_channelsToCalMutex);
+    _channelsToCal.emplace(direction, channel);
+}
+
 /*******************************************************************
  * Identification API
  ******************************************************************/
@@ -216,7 +254,7 @@ std::vector<std::string> SoapyLMS7::listAntennas(const int direction, const size
 
 void SoapyLMS7::setAntenna(const int direction, const size_t channel, const std::string &name)
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyLMS7::setAntenna(%s, %d, %s)", dirName, int(channel), name.c_str());
     auto rfic = getRFIC(channel);
 
@@ -245,12 +283,12 @@ void SoapyLMS7::setAntenna(const int direction, const size_t channel, const std:
         rfic->SetBandTRF(band);
     }
 
-    _channelsToCal.emplace(direction, channel);
+    _scheduleCal(direction, channel);
 }
 
 std::string SoapyLMS7::getAntenna(const int direction, const size_t channel) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
 
     if (direction == SOAPY_SDR_RX)
@@ -290,7 +328,7 @@ bool SoapyLMS7::hasDCOffsetMode(const int direction, const size_t /*channel*/) c
 
 void SoapyLMS7::setDCOffsetMode(const int direction, const size_t channel, const bool automatic)
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
 
     if (direction == SOAPY_SDR_RX) rfic->SetRxDCRemoval(automatic);
@@ -298,7 +336,7 @@ void SoapyLMS7::setDCOffsetMode(const int direction, const size_t channel, const
 
 bool SoapyLMS7::getDCOffsetMode(const int direction, const size_t channel) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
 
     if (direction == SOAPY_SDR_RX) return rfic->GetRxDCRemoval();
@@ -313,7 +351,7 @@ bool SoapyLMS7::hasDCOffset(const int direction, const size_t /*channel*/) const
 
 void SoapyLMS7::setDCOffset(const int direction, const size_t channel, const std::complex<double> &offset)
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
 
     if (direction == SOAPY_SDR_TX) rfic->SetTxDCOffset(offset.real(), offset.imag());
@@ -321,7 +359,7 @@ void SoapyLMS7::setDCOffset(const int direction, const size_t channel, const std
 
 std::complex<double> SoapyLMS7::getDCOffset(const int direction, const size_t channel) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
 
     double I = 0.0, Q = 0.0;
@@ -336,7 +374,7 @@ bool SoapyLMS7::hasIQBalance(const int /*direction*/, const size_t /*channel*/)
 
 void SoapyLMS7::setIQBalance(const int direction, const size_t channel, const std::complex<double> &balance)
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
     const auto lmsDir = (direction == SOAPY_SDR_TX)?LMS7002M::Tx:LMS7002M::Rx;
 
@@ -348,7 +386,7 @@ void SoapyLMS7::setIQBalance(const int direction, const size_t channel, const st
 
 std::complex<double> SoapyLMS7::getIQBalance(const int direction, const size_t channel) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
     const auto lmsDir = (direction == SOAPY_SDR_TX)?LMS7002M::Tx:LMS7002M::Rx;
 
@@ -379,7 +417,7 @@ std::vector<std::string> SoapyLMS7::listGains(const int direction, const size_t
 
 void SoapyLMS7::setGain(const int direction, const size_t channel, const double value)
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
 
     //Distribute Rx gain from elements in the direction of RFE to RBB
     //This differs from the default gain distribution in that it
@@ -400,7 +438,7 @@ void SoapyLMS7::setGain(const int direction, const size_t channel, const double
 
 void SoapyLMS7::setGain(const int direction, const size_t channel, const std::string &name, const double value)
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyLMS7::setGain(%s, %d, %s, %g dB)", dirName, int(channel), name.c_str(), value);
     auto rfic = getRFIC(channel);
 
@@ -451,7 +489,7 @@ void SoapyLMS7::setGain(const int direction, const size_t channel, const std::st
 
 double SoapyLMS7::getGain(const int direction, const size_t channel, const std::string &name) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
 
     if (direction == SOAPY_SDR_RX and name == "LNA")
@@ -518,7 +556,7 @@ SoapySDR::ArgInfoList SoapyLMS7::getFrequencyArgsInfo(const int direction, const
 
 void SoapyLMS7::setFrequency(const int direction, const size_t channel, const std::string &name, const double frequency, const SoapySDR::Kwargs &args)
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
     const auto lmsDir = (direction == SOAPY_SDR_TX)?LMS7002M::Tx:LMS7002M::Rx;
     SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyLMS7::setFrequency(%s, %d, %s, %g MHz)", dirName, int(channel), name.c_str(), frequency/1e6);
@@ -530,7 +568,7 @@ void SoapyLMS7::setFrequency(const int direction, const size_t channel, const st
         if (targetRfFreq < 30e6) targetRfFreq = 30e6;
         if (targetRfFreq > 3.8e9) targetRfFreq = 3.8e9;
         rfic->SetFrequencySX(lmsDir, targetRfFreq);
-        _channelsToCal.emplace(direction, channel);
+        _scheduleCal(direction, channel);
         return;
     }
 
@@ -563,7 +601,7 @@ void SoapyLMS7::setFrequency(const int direction, const size_t channel, const st
 
 double SoapyLMS7::getFrequency(const int direction, const size_t channel, const std::string &name) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
     const auto lmsDir = (direction == SOAPY_SDR_TX)?LMS7002M::Tx:LMS7002M::Rx;
 
@@ -602,7 +640,7 @@ std::vector<std::string> SoapyLMS7::listFrequencies(const int /*direction*/, con
 
 SoapySDR::RangeList SoapyLMS7::getFrequencyRange(const int direction, const size_t channel, const std::string &name) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
     const auto lmsDir = (direction == SOAPY_SDR_TX)?LMS7002M::Tx:LMS7002M::Rx;
 
@@ -675,12 +713,12 @@ static double calculateClockRate(
 
 void SoapyLMS7::setSampleRate(const int direction, const size_t channel, const double rate)
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
 
     const auto lmsDir = (direction == SOAPY_SDR_TX)?LMS7002M::Tx:LMS7002M::Rx;
 
-    double clockRate = this->getMasterClockRate();
+    double clockRate = rfic->GetFrequencyCGEN();
     const double dspFactor = clockRate/rfic->GetReferenceClk_TSP(lmsDir);
 
     //select automatic clock rate
@@ -738,7 +776,7 @@ void SoapyLMS7::setSampleRate(const int direction, const size_t channel, const d
 
 double SoapyLMS7::getSampleRate(const int direction, const size_t channel) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
     const auto lmsDir = (direction == SOAPY_SDR_TX)?LMS7002M::Tx:LMS7002M::Rx;
 
@@ -747,17 +785,17 @@ double SoapyLMS7::getSampleRate(const int direction, const size_t channel) const
 
 std::vector<double> SoapyLMS7::_getEnumeratedRates(const int direction, const size_t channel) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
     const auto lmsDir = (direction == SOAPY_SDR_TX)?LMS7002M::Tx:LMS7002M::Rx;
     std::vector<double> rates;
 
-    const double clockRate = this->getMasterClockRate();
+    const double clockRate = rfic->GetFrequencyCGEN();
     const double dacFactor = clockRate/rfic->GetReferenceClk_TSP(LMS7002M::Tx);
     const double adcFactor = clockRate/rfic->GetReferenceClk_TSP(LMS7002M::Rx);
     const double dspRate = rfic->GetReferenceClk_TSP(lmsDir);
-    const bool fixedRx = _fixedRxSampRate.count(channel) != 0 and _fixedRxSampRate.at(channel);
-    const bool fixedTx = _fixedTxSampRate.count(channel) != 0 and _fixedTxSampRate.at(channel);
+    const bool fixedRx = _fixedRxSampRate[channel];
+    const bool fixedTx = _fixedTxSampRate[channel];
 
     //clock rate is fixed, only half-band chain is configurable
     if (_fixedClockRate)
@@ -850,7 +888,7 @@ void SoapyLMS7::setBandwidth(const int direction, const size_t channel, const do
 {
     if (bw == 0.0) return; //special ignore value
 
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyLMS7::setBandwidth(%s, %d, %g MHz)", dirName, int(channel), bw/1e6);
 
     //save dc offset mode
@@ -881,20 +919,16 @@ void SoapyLMS7::setBandwidth(const int direction, const size_t channel, const do
     //restore dc offset mode
     this->setDCOffsetMode(direction, channel, saveDcMode);
 
-    _channelsToCal.emplace(direction, channel);
+    _scheduleCal(direction, channel);
 }
 
 double SoapyLMS7::getBandwidth(const int direction, const size_t channel) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
-    try
-    {
-        return _actualBw.at(direction).at(channel);
-    }
-    catch (...)
-    {
+    //cached value, does not wait for chip lock
+    if (channel >= _rfics.size()*2 or (direction != SOAPY_SDR_RX and direction != SOAPY_SDR_TX))
         return 1.0;
-    }
+    const double bw = _actualBw[direction][channel];
+    return (bw == 0.0) ? 1.0 : bw;
 }
 
 SoapySDR::RangeList SoapyLMS7::getBandwidthRange(const int direction, const size_t channel) const
@@ -920,9 +954,11 @@ SoapySDR::RangeList SoapyLMS7::getBandwidthRange(const int direction, const size
 
 void SoapyLMS7::setMasterClockRate(const double rate)
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
-    for (auto rfic : _rfics)
+    for (size_t i = 0; i < _rfics.size(); i++)
     {
+        //one chip at a time, others remain accessible
+        std::unique_lock<std::recursive_mutex> lock(_chipMutexes[i]);
+        auto rfic = _rfics[i];
         //make tx rx rates equal
         rfic->Modify_SPI_Reg_bits(LMS7param(EN_ADCCLKH_CLKGN), 0);
         rfic->Modify_SPI_Reg_bits(LMS7param(CLKH_OV_CLKL_CGEN), 2);
@@ -933,7 +969,7 @@ void SoapyLMS7::setMasterClockRate(const double rate)
 
 double SoapyLMS7::getMasterClockRate(void) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(0));
     //assume same rate for all RFIC in this wrapper
     return _rfics.front()->GetFrequencyCGEN();
 }
@@ -1022,7 +1058,7 @@ SoapySDR::ArgInfo SoapyLMS7::getSensorInfo(const std::string &name) const
 
 std::string SoapyLMS7::readSensor(const std::string &name) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(0));
 
     if (name == "clock_locked")
     {
@@ -1059,7 +1095,7 @@ SoapySDR::ArgInfo SoapyLMS7::getSensorInfo(const int direction, const size_t cha
 
 std::string SoapyLMS7::readSensor(const int direction, const size_t channel, const std::string &name) const
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
     const auto lmsDir = (direction == SOAPY_SDR_TX)?LMS7002M::Tx:LMS7002M::Rx;
 
@@ -1201,11 +1237,13 @@ void SoapyLMS7::writeSetting(const std::string &key, const std::string &value)
 
     else if (key == "SAVE_CONFIG")
     {
+        std::unique_lock<std::recursive_mutex> lock(getChipMutex(0));
         auto rfic = getRFIC(0);
         rfic->SaveConfig(value.c_str());
     }
     else if (key == "LOAD_CONFIG")
     {
+        std::unique_lock<std::recursive_mutex> lock(getChipMutex(0));
         auto rfic = getRFIC(0);
         rfic->LoadConfig(value.c_str());
     }
@@ -1232,7 +1270,7 @@ SoapySDR::ArgInfoList SoapyLMS7::getSettingInfo(const int direction, const size_
 
 void SoapyLMS7::writeSetting(const int direction, const size_t channel, const std::string &key, const std::string &value)
 {
-    std::unique_lock<std::recursive_mutex> lock(_accessMutex);
+    std::unique_lock<std::recursive_mutex> lock(getChipMutex(channel));
     auto rfic = getRFIC(channel);
     const bool isTx = (direction == SOAPY_SDR_TX);
 
@@ -7,6 +7,8 @@
 #include <SoapySDR/Device.hpp>
 #include <ConnectionRegistry.h>
 #include <mutex>
+#include <atomic>
+#include <memory>
 #include <chrono>
 #include <map>
 #include <set>
@@ -164,8 +166,8 @@ public:
      * Sample Rate API
      ******************************************************************/
 
-    std::map<size_t, int> _interps;
-    std::map<size_t, int> _decims;
+    std::unique_ptr<int[]> _interps;
+    std::unique_ptr<int[]> _decims;
 
     void setSampleRate(const int direction, const size_t channel, const double rate);
 
@@ -177,16 +179,17 @@ public:
 
     //rate fixing flags applied when user makes a call
     //helps to determine flexible sample rate requirements
-    bool _fixedClockRate;
-    std::map<size_t, bool> _fixedRxSampRate;
-    std::map<size_t, bool> _fixedTxSampRate;
+    std::atomic<bool> _fixedClockRate;
+    std::unique_ptr<bool[]> _fixedRxSampRate;
+    std::unique_ptr<bool[]> _fixedTxSampRate;
     std::vector<double> _getEnumeratedRates(const int direction, const size_t channel) const;
 
     /*******************************************************************
      * Bandwidth API
      ******************************************************************/
 
-    std::map<int, std::map<size_t, double>> _actualBw;
+    //indexed by direction and channel, read without chip lock
+    std::unique_ptr<std::atomic<double>[]> _actualBw[2];
 
     void setBandwidth(const int direction, const size_t channel, const double bw);
 
@@ -284,6 +287,16 @@ private:
 
     lime::LMS7002M *getRFIC(const size_t channel) const;
     std::vector<lime::LMS7002M *> _rfics;
+
+    //Per chip lock, must be held while using getRFIC(channel).
+    //Settings of channels on different chips do not wait for each other.
+    std::recursive_mutex &getChipMutex(const size_t channel) const;
+    std::unique_ptr<std::recursive_mutex[]> _chipMutexes;
+
+    void _scheduleCal(const int direction, const size_t channel);
     std::set<std::pair<int, size_t>> _channelsToCal;
+    std::mutex _channelsToCalMutex;
+
+    //stream setup and control
     mutable std::recursive_mutex _accessMutex;
 };
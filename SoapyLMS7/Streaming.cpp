@@ -81,6 +81,18 @@ SoapySDR::ArgInfoList SoapyLMS7::getStreamArgsInfo(const int direction, const si
         argInfos.push_back(info);
     }
 
+    //decode workers
+    if (direction == SOAPY_SDR_RX)
+    {
+        SoapySDR::ArgInfo info;
+        info.value = "0";
+        info.key = "decodeWorkers";
+        info.name = "Decode Workers";
+        info.description = "Number of threads converting received packets, 0 - convert in transfer thread.";
+        info.type = SoapySDR::ArgInfo::INT;
+        argInfos.push_back(info);
+    }
+
     return argInfos;
 }
 
@@ -121,6 +133,11 @@ SoapySDR::Stream *SoapyLMS7::setupStream(
         {
             config.bufferLength = std::stoul(args.at("bufferLength"));
         }
+        //optional sample conversion threads
+        if (args.count("decodeWorkers") != 0)
+        {
+            config.decodeWorkers = std::stoul(args.at("decodeWorkers"));
+        }
         //optional packets latency, 0-maximum throughput, 1-lowest latency
         if (args.count("latency") != 0)
         {
@@ -143,7 +160,7 @@ SoapySDR::Stream *SoapyLMS7::setupStream(
     //calibrate these channels when activated
     for (const auto &ch : channelIDs)
     {
-        _channelsToCal.emplace(direction, ch);
+        _scheduleCal(direction, ch);
     }
 
     return (SoapySDR::Stream *)stream;
@@ -182,13 +199,21 @@ int SoapyLMS7::activateStream(
     //this is for the set-it-and-forget-it style of use case
     //where boards are configured, the stream is setup,
     //and the configuration is maintained throughout the run
-    while (not _channelsToCal.empty())
+    std::set<std::pair<int, size_t>> channelsToCal;
+    {
+        std::lock_guard<std::mutex> calLock(_channelsToCalMutex);
+        channelsToCal.swap(_channelsToCal);
+    }
+    for (const auto &dirCh : channelsToCal)
     {
-        auto dir  = _channelsToCal.begin()->first;
-        auto ch  = _channelsToCal.begin()->second;
-        if (dir == SOAPY_SDR_RX) getRFIC(ch)->CalibrateRx(_actualBw.at(dir).at(ch));
-        if (dir == SOAPY_SDR_TX) getRFIC(ch)->CalibrateTx(_actualBw.at(dir).at(ch));
-        _channelsToCal.erase(_channelsToCal.begin());
+        auto dir  = dirCh.first;
+        auto ch  = dirCh.second;
+        std::unique_lock<std::recursive_mutex> chipLock(getChipMutex(ch));
+        //calibration table already applied corrections on retune
+        auto rfic = getRFIC(ch);
+        if (rfic->IsCalibrationTableEnabled() and rfic->ApplyCalibrationTable(dir == SOAPY_SDR_TX, ch%2) == 0) continue;
+        if (dir == SOAPY_SDR_RX) rfic->CalibrateRx(_actualBw[dir][ch]);
+        if (dir == SOAPY_SDR_TX) rfic->CalibrateTx(_actualBw[dir][ch]);
     }
 
     //stream requests used with rx
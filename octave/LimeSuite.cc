@@ -3,6 +3,12 @@
 
 #include <vector>
 #include <string>
+#include <thread>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
 
 #include "LimeSuite.h"
 
@@ -24,13 +30,116 @@ struct complex16_t
 };
 
 bool WFMrunning = false;
-complex16_t* rxbuffers = NULL;
-complex16_t* txbuffers = NULL;
+vector<complex16_t> rxbuffers;
+vector<complex16_t> txbuffers;
+
+//! Background capture into preallocated buffers
+struct BackgroundCapture
+{
+    vector<unsigned> channels;
+    vector<vector<complex16_t> > buffers;
+    atomic<bool> stop;
+    future<int> result;
+};
+BackgroundCapture capture;
+
+void StopCapture()
+{
+    capture.stop = true;
+    if (capture.result.valid())
+        capture.result.wait();
+}
+
+/** @brief Converts 16 bit samples to normalized complex values
+    @param stride distance between destination values, channel count of matrix
+*/
+static void ToComplex(const complex16_t* src, Complex* dst, const int count, const int stride = 1)
+{
+    const double scale = 1.0/scaleFactor;
+    for (int i = 0; i < count; ++i)
+        dst[i*stride] = Complex(src[i].i*scale, src[i].q*scale);
+}
+
+//! Converts normalized complex values to 16 bit samples, out of range values are clipped
+static void FromComplex(const Complex* src, complex16_t* dst, const int count, const double scale)
+{
+    const double maxValue = 32767.0;
+    for (int i = 0; i < count; ++i)
+    {
+        const double i_sample = src[i].real()*scale;
+        const double q_sample = src[i].imag()*scale;
+        dst[i].i = i_sample > maxValue ? maxValue : (i_sample < -maxValue-1 ? -maxValue-1 : i_sample);
+        dst[i].q = q_sample > maxValue ? maxValue : (q_sample < -maxValue-1 ? -maxValue-1 : q_sample);
+    }
+}
+
+/** @brief Receives samples from channels, reading them in turns so that
+    FIFOs of all channels are drained evenly.
+    @param dst destination buffers for every channel
+    @param collected number of samples already in every buffer, updated
+    @return 0 on success, -1 on error or timeout
+*/
+static int ReceiveChannels(const vector<unsigned> &channels, complex16_t* const* dst, vector<int> &collected, const int count, const atomic<bool>* stop = NULL)
+{
+    const int timeout_ms = 1000;
+    lms_stream_meta_t meta;
+    bool done = false;
+    while (!done && !(stop && *stop))
+    {
+        done = true;
+        for (size_t c = 0; c < channels.size(); ++c)
+        {
+            lms_stream_t &stream = streamRx[channels[c]];
+            const int samplesToRead = min<int>(count-collected[c], stream.fifoSize/2);
+            if (samplesToRead <= 0)
+                continue;
+            const int samplesRead = LMS_RecvStream(&stream, dst[c]+collected[c], samplesToRead, &meta, timeout_ms);
+            if (samplesRead <= 0)
+                return -1;
+            collected[c] += samplesRead;
+            done &= collected[c] == count;
+        }
+    }
+    return 0;
+}
+
+/** @brief Parses optional channel list argument
+    @return selected channels, empty on error
+*/
+static vector<unsigned> GetChannels(const octave_value_list &args, const int index, const lms_stream_t* streams)
+{
+    vector<unsigned> channels;
+    if (args.length() > index)
+    {
+        const NDArray chArg = args(index).array_value();
+        for (int i = 0; i < chArg.numel(); ++i)
+        {
+            const int ch = chArg(i);
+            if (ch < 0 || ch >= maxChCnt || streams[ch].handle == 0)
+            {
+                octave_stdout << "Invalid channel number" << endl;
+                return vector<unsigned>();
+            }
+            channels.push_back(ch);
+        }
+    }
+    else
+    {
+        for (unsigned ch = 0; ch < maxChCnt; ch++)
+            if (streams[ch].handle != 0)
+            {
+                channels.push_back(ch);
+                break;
+            }
+    }
+    return channels;
+}
 
 void StopStream()
 {
     if(lmsDev == NULL)
         return;
+    StopCapture();
     for (int i = 0; i < maxChCnt; i++)
     {
         LMS_StopStream(&streamRx[i]);
@@ -236,15 +345,15 @@ DEFUN_DLD (LimeStartStreaming, args, nargout,
     {
         if (rx[i])
         {
-            if (!rxbuffers)
-                rxbuffers = new complex16_t[fifoSize/2];
+            if (rxbuffers.size() < size_t(fifoSize/2))
+                rxbuffers.resize(fifoSize/2);
             if(LMS_StartStream(&streamRx[i]) != 0)
                 octave_stdout << LMS_GetLastErrorMessage() << endl;
         }
         if (tx[i])
         {
-            if (!txbuffers)
-                txbuffers = new complex16_t[fifoSize/2];
+            if (txbuffers.size() < size_t(fifoSize/2))
+                txbuffers.resize(fifoSize/2);
             if(LMS_StartStream(&streamTx[i]) != 0)
                 octave_stdout << LMS_GetLastErrorMessage() << endl;
         }
@@ -268,14 +377,20 @@ DEFUN_DLD (LimeStopStreaming, args, nargout,
 }
 
 DEFUN_DLD (LimeReceiveSamples, args, ,
-"SIGNAL = LimeReceiveSamplesLarge( N, CH) - receive N samples from Rx channel CH.\n\
-CH parameter is optional, valid values are 0 and 1")
+"SIGNAL = LimeReceiveSamples( N, CH) - receive N samples from Rx channel CH.\n\
+CH parameter is optional, valid values are 0 and 1. When CH is a vector\n\
+of channels, SIGNAL is a matrix with row of N samples for every channel")
 {
-    if (!rxbuffers)
+    if (rxbuffers.empty())
     {
         octave_stdout << "Rx streaming not initialized" << endl;
         return octave_value(-1);
     }
+    if (capture.result.valid())
+    {
+        octave_stdout << "Background capture in progress, call LimeCaptureWait first" << endl;
+        return octave_value(-1);
+    }
 
     int nargin = args.length ();
     if (nargin != 2 && nargin != 1)
@@ -284,50 +399,33 @@ CH parameter is optional, valid values are 0 and 1")
         return octave_value_list ();
     }
     const int samplesToReceive = args(0).int_value ();
+    const vector<unsigned> channels = GetChannels(args, 1, streamRx);
+    if (channels.empty())
+        return octave_value(-1);
+    const int chCount = channels.size();
 
-    unsigned chIndex;
-    if (nargin == 2)
-    {
-        chIndex = args(1).int_value ();
-        if (chIndex >= maxChCnt)
-        {
-            octave_stdout << "Invalid channel number" << endl;
-            return octave_value(-1);
-        }
-    }
-    else
-    {
-        for (chIndex = 0; chIndex < maxChCnt; chIndex++)
-            if (streamRx[chIndex].handle != 0)
-                break;
-    }
-
-    Complex val=Complex(0.0,0.0);
-    ComplexRowVector iqdata( samplesToReceive, val ); // index 0 to N-1
+    //samples are read in chunks of library buffer size and converted directly into result
+    ComplexMatrix iqdata(chCount, samplesToReceive);
+    Complex* dst = iqdata.fortran_vec();
+    const int chunk = rxbuffers.size()/chCount;
+    vector<complex16_t*> buffers(chCount);
+    for (int c = 0; c < chCount; ++c)
+        buffers[c] = rxbuffers.data() + c*chunk;
 
-    const int timeout_ms = 1000;
-    lms_stream_meta_t meta;
-    int samplesCollected = 0;
-    int retries = 5;
-    while(samplesCollected < samplesToReceive && retries--)
-    {
-        int samplesToRead = 0;
-        if(samplesToReceive-samplesCollected > streamRx[chIndex].fifoSize/2)
-            samplesToRead = streamRx[chIndex].fifoSize/2;
-        else
-            samplesToRead = samplesToReceive-samplesCollected;
-        int samplesRead = LMS_RecvStream(&streamRx[chIndex], (void*)rxbuffers, samplesToRead, &meta, timeout_ms);
-        if (samplesRead < 0)
+    for (int pos = 0; pos < samplesToReceive; pos += chunk)
+    {
+        const int count = min(chunk, samplesToReceive-pos);
+        vector<int> collected(chCount, 0);
+        if (ReceiveChannels(channels, buffers.data(), collected, count) != 0)
         {
             octave_stdout << "Error reading samples" << endl;
             return octave_value(-1);
         }
-        for(int i=0; i<samplesRead; ++i)
-        {
-            iqdata(samplesCollected+i)=Complex(rxbuffers[i].i/scaleFactor,rxbuffers[i].q/scaleFactor);
-        }
-        samplesCollected += samplesRead;
+        for (int c = 0; c < chCount; ++c)
+            ToComplex(buffers[c], dst + c + pos*chCount, count, chCount);
     }
+    if (chCount == 1)
+        return octave_value(iqdata.row(0));
     return octave_value(iqdata);
 }
 
@@ -335,59 +433,141 @@ DEFUN_DLD (LimeTransmitSamples, args, ,
 "LimeTransmitSamples( SIGNAL, CH) - sends normalized complex SIGNAL to Tx cahnnel CH\n\
 CH parameter is optional, valid values are 0 and 1")
 {
-    if (!txbuffers)
+    if (txbuffers.empty())
     {
         octave_stdout << "Tx streaming not initialized" << endl;
         return octave_value(-1);
     }
 
     int nargin = args.length ();
-    int check=0;
     if (nargin != 2 && nargin != 1)
     {
         print_usage ();
         return octave_value_list ();
     }
 
-    int chIndex = 0;
-    if (nargin == 2)
+    const vector<unsigned> channels = GetChannels(args, 1, streamTx);
+    if (channels.size() != 1)
+        return octave_value(-1);
+    const int chIndex = channels[0];
+
+    const ComplexNDArray iqdata = args(0).complex_array_value();
+    const Complex* src = iqdata.data();
+    const int samplesCount = iqdata.numel();
+
+    const int timeout_ms = 1000;
+    lms_stream_meta_t meta;
+    meta.waitForTimestamp = false;
+    meta.timestamp = 0;
+    int samplesWrite = 0;
+    while (samplesWrite < samplesCount)
     {
-        chIndex = args(1).int_value ();
-        if (chIndex >= maxChCnt)
-        {
-            octave_stdout << "Invalid channel number" << endl;
+        const int count = min<int>(txbuffers.size(), samplesCount-samplesWrite);
+        FromComplex(src+samplesWrite, txbuffers.data(), count, scaleFactor);
+        const int sent = LMS_SendStream(&streamTx[chIndex], (const void*)txbuffers.data(), count, &meta, timeout_ms);
+        if (sent < 0)
             return octave_value(-1);
-        }
+        samplesWrite += sent;
+        if (sent < count)
+            break;
     }
-    else
+
+    return octave_value (samplesWrite);
+}
+
+DEFUN_DLD (LimeCaptureStart, args, ,
+"LimeCaptureStart( N, CH) - start receiving N samples from Rx channels CH in background.\n\
+Samples are stored to preallocated buffer, so Octave code does not need to keep up\n\
+with sample rate. CH parameter is optional, vector of channels 0 and 1")
+{
+    if (rxbuffers.empty())
     {
-        for (chIndex = 0; chIndex < maxChCnt; chIndex++)
-            if (streamTx[chIndex].handle != 0)
-                break;
+        octave_stdout << "Rx streaming not initialized" << endl;
+        return octave_value(-1);
+    }
+    int nargin = args.length ();
+    if (nargin != 2 && nargin != 1)
+    {
+        print_usage ();
+        return octave_value_list ();
     }
+    const int samplesToReceive = args(0).int_value ();
+    const vector<unsigned> channels = GetChannels(args, 1, streamRx);
+    if (channels.empty() || samplesToReceive <= 0)
+        return octave_value(-1);
 
-    ComplexRowVector    iqdata=args(0).complex_row_vector_value();
-    dim_vector          iqdataSize=iqdata.dims();
-    int samplesCount = iqdataSize(0) > iqdataSize(1) ? iqdataSize(0) : iqdataSize(1);
+    StopCapture();
+    capture.channels = channels;
+    capture.buffers.assign(channels.size(), vector<complex16_t>(samplesToReceive));
+    capture.stop = false;
+    capture.result = async(launch::async, [samplesToReceive]()
+    {
+        vector<complex16_t*> dst;
+        for (auto &buffer : capture.buffers)
+            dst.push_back(buffer.data());
+        vector<int> collected(capture.channels.size(), 0);
+        return ReceiveChannels(capture.channels, dst.data(), collected, samplesToReceive, &capture.stop);
+    });
+    return octave_value(0);
+}
 
-    for(int i=0; i < samplesCount; ++i)
+DEFUN_DLD (LimeCaptureWait, args, ,
+"SIGNAL = LimeCaptureWait( TIMEOUT) - wait for background capture to finish and return samples.\n\
+TIMEOUT [optional] - time in ms to wait, afterwards capture is stopped (default: wait until done).\n\
+SIGNAL has row of samples for every captured channel")
+{
+    if (!capture.result.valid())
+    {
+        octave_stdout << "Capture not started" << endl;
+        return octave_value(-1);
+    }
+    if (args.length() > 0)
     {
-        octave_value    iqdatum = scaleFactor*iqdata(i);
-        Complex iqdatum2 = iqdatum.complex_value();
-        short i_sample = iqdatum2.real(); //
-        short q_sample = iqdatum2.imag(); //
-        txbuffers[i].i = i_sample;
-        txbuffers[i].q = q_sample;
+        const int timeout_ms = args(0).int_value();
+        if (capture.result.wait_for(chrono::milliseconds(timeout_ms)) != future_status::ready)
+            octave_stdout << "Capture timeout, samples are incomplete" << endl;
     }
+    else
+        capture.result.wait();
+    StopCapture();
+    if (capture.result.get() != 0)
+        octave_stdout << "Error reading samples" << endl;
+
+    const int chCount = capture.buffers.size();
+    const int samplesCount = capture.buffers[0].size();
+    ComplexMatrix iqdata(chCount, samplesCount);
+    for (int c = 0; c < chCount; ++c)
+        ToComplex(capture.buffers[c].data(), iqdata.fortran_vec() + c, samplesCount, chCount);
+    capture.buffers.clear();
+    return octave_value(iqdata);
+}
 
-    const int timeout_ms = 1000;
-    lms_stream_meta_t meta;
-    meta.waitForTimestamp = false;
-    meta.timestamp = 0;
-    int samplesWrite = samplesCount;
-    samplesWrite = LMS_SendStream(&streamTx[chIndex], (const void*)txbuffers, samplesCount, &meta, timeout_ms);
+DEFUN_DLD (LimeBenchmarkConversion, args, ,
+"[TXRATE, RXRATE] = LimeBenchmarkConversion( N) - measure sample conversion speed.\n\
+N samples are converted to device format and back without device, rates in MS/s")
+{
+    if (args.length() != 1)
+    {
+        print_usage ();
+        return octave_value_list ();
+    }
+    const int samplesCount = args(0).int_value();
+    ComplexRowVector signal(samplesCount);
+    for (int i = 0; i < samplesCount; ++i)
+        signal(i) = Complex(cos(i*0.01), sin(i*0.01));
+    vector<complex16_t> buffer(samplesCount);
+    ComplexRowVector result(samplesCount);
 
-    return octave_value (samplesWrite);
+    auto t0 = chrono::high_resolution_clock::now();
+    FromComplex(signal.data(), buffer.data(), samplesCount, scaleFactor);
+    auto t1 = chrono::high_resolution_clock::now();
+    ToComplex(buffer.data(), result.fortran_vec(), samplesCount);
+    auto t2 = chrono::high_resolution_clock::now();
+
+    octave_value_list retval;
+    retval(0) = samplesCount/chrono::duration<double>(t1-t0).count()/1e6;
+    retval(1) = samplesCount/chrono::duration<double>(t2-t1).count()/1e6;
+    return retval;
 }
 
 DEFUN_DLD (LimeLoopWFMStart, args, ,
@@ -419,15 +599,7 @@ DEFUN_DLD (LimeLoopWFMStart, args, ,
         wfmBuffers[i] = new complex16_t[samplesCount];
 
     for (int ch = 0; ch < chCount; ch++)
-        for(int i=0; i < samplesCount; ++i)
-        {
-            octave_value    iqdatum = 2047*iqdata(i);
-            Complex iqdatum2 = iqdatum.complex_value();
-            float i_sample = iqdatum2.real(); //
-            float q_sample = iqdatum2.imag(); //
-            wfmBuffers[ch][i].i = i_sample;
-            wfmBuffers[ch][i].q = q_sample;
-        }
+        FromComplex(iqdata.data(), wfmBuffers[ch], samplesCount, 2047);
 
     LMS_UploadWFM(lmsDev, (const void**)wfmBuffers, chCount, samplesCount, 0);
     LMS_EnableTxWFM(lmsDev, 0, true);
@@ -462,16 +634,8 @@ void FreeResources()
         LMS_Close(lmsDev);
         lmsDev = NULL;
     }
-    if(rxbuffers)
-    {
-        delete rxbuffers;
-        rxbuffers = NULL;
-    }
-    if(txbuffers)
-    {
-        delete txbuffers;
-        txbuffers = NULL;
-    }
+    rxbuffers.clear();
+    txbuffers.clear();
 }
 
 class ResourceDeallocator
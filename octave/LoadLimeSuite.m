@@ -6,6 +6,9 @@ autoload('LimeStartStreaming', 'LimeSuite.oct')
 autoload('LimeStopStreaming', 'LimeSuite.oct')
 autoload('LimeReceiveSamples', 'LimeSuite.oct')
 autoload('LimeTransmitSamples', 'LimeSuite.oct')
+autoload('LimeCaptureStart', 'LimeSuite.oct')
+autoload('LimeCaptureWait', 'LimeSuite.oct')
+autoload('LimeBenchmarkConversion', 'LimeSuite.oct')
 autoload('LimeGetFIFOStatus', 'LimeSuite.oct')
 autoload('LimeLoopWFMStart', 'LimeSuite.oct')
 autoload('LimeLoopWFMStop', 'LimeSuite.oct')
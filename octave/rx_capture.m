@@ -0,0 +1,31 @@
+LoadLimeSuite
+
+%conversion speed, does not need device
+[txRate, rxRate] = LimeBenchmarkConversion(1024*1024*4)
+
+LimeInitialize();               % open first device
+
+LimeLoadConfig('trxTest.ini');  % load configuration from file
+                                % use LimeSuiteGUI to create configuration file
+
+readCnt = 1024*1024*4;      %samples to capture per channel (4M)
+fifoSize = 1024*1024        %set library FIFO size to 1 MSample
+
+LimeStartStreaming(fifoSize,["rx0"; "rx1"]); % start RX from channels 0 and 1
+
+%samples are collected in background, while script is free to do other work
+LimeCaptureStart(readCnt, [0 1]);
+tic
+samples = LimeCaptureWait(); % one row for every channel
+captureTime = toc
+
+%both channels in single call
+samples2 = LimeReceiveSamples(1024*64, [0 1]);
+
+LimeStopStreaming();      % stop streaming
+LimeDestroy();            % close device
+
+figure(1)
+plot(real(samples(1,:)));
+figure(2)
+plot(real(samples(2,:)));
@@ -9,6 +9,11 @@
 #include "VersionInfo.h"
 #include <assert.h>
 #include "FPGA_common.h"
+#include "StreamDSP.h"
+#include "SharedStream.h"
+#include <map>
+#include <memory>
+#include <mutex>
 
 using namespace std;
 
@@ -401,6 +406,18 @@ API_EXPORT int CALL_CONV LMS_EnableCalibCache(lms_device_t *dev, bool enable)
     return lms->EnableCalibCache(enable);
 }
 
+API_EXPORT int CALL_CONV LMS_EnableCalibTable(lms_device_t *dev, bool enable)
+{
+    if (dev == nullptr)
+    {
+        lime::ReportError(EINVAL, "Device cannot be NULL.");
+        return -1;
+    }
+
+    LMS7_Device* lms = (LMS7_Device*)dev;
+    return lms->EnableCalibTable(enable);
+}
+
 API_EXPORT int CALL_CONV LMS_GetChipTemperature(lms_device_t *dev, size_t ind, float_type *temp)
 {
     *temp = 0;
@@ -733,7 +750,7 @@ API_EXPORT int CALL_CONV LMS_GetNormalizedGain(lms_device_t *device, bool dir_tx
     }
 
     *gain = lms->GetNormalizedGain(dir_tx,chan);
-    if (gain < 0)
+    if (*gain < 0)
         return -1;
     return LMS_SUCCESS;
 }
@@ -754,12 +771,34 @@ API_EXPORT int CALL_CONV LMS_GetGaindB(lms_device_t *device, bool dir_tx, size_t
         return -1;
     }
 
-    *gain = lms->GetGain(dir_tx,chan);
-    if (gain < 0)
+    int ret = lms->GetGain(dir_tx,chan);
+    if (ret < 0)
         return -1;
+    *gain = ret;
     return LMS_SUCCESS;
 }
 
+static int CheckCalibrationArgs(LMS7_Device* lms, bool dir_tx, size_t chan)
+{
+    uint16_t val;
+    if (lms->ReadLMSReg(0x2F, &val))
+    {
+        return -1;
+    }
+    if (val == 0x3840)
+    {
+        lime::ReportError(EINVAL, "Feature is not available on this chip revision");
+        return -1;
+    }
+
+    if (chan >= lms->GetNumChannels(dir_tx))
+    {
+        lime::ReportError(EINVAL, "Invalid channel number.");
+        return -1;
+    }
+    return 0;
+}
+
 API_EXPORT int CALL_CONV LMS_Calibrate(lms_device_t *device, bool dir_tx, size_t chan, double bw, unsigned flags)
 {
     if (device == nullptr)
@@ -769,24 +808,134 @@ API_EXPORT int CALL_CONV LMS_Calibrate(lms_device_t *device, bool dir_tx, size_t
     }
 
     LMS7_Device* lms = (LMS7_Device*)device;
+    if (CheckCalibrationArgs(lms, dir_tx, chan) != 0)
+        return -1;
+    return lms->Calibrate(dir_tx, chan, bw, flags);
+}
 
-    uint16_t val;
-    if (lms->ReadLMSReg(0x2F, &val))
+API_EXPORT lms_calibration_t* CALL_CONV LMS_CalibrateAsync(lms_device_t *device, bool dir_tx, size_t chan, double bw, unsigned flags, lms_calibration_cb_t callback, void *userData)
+{
+    if (device == nullptr)
+    {
+        lime::ReportError(EINVAL, "Device cannot be NULL.");
+        return nullptr;
+    }
+
+    LMS7_Device* lms = (LMS7_Device*)device;
+    if (CheckCalibrationArgs(lms, dir_tx, chan) != 0)
+        return nullptr;
+
+    LMS7_Device::CalibrationCallback onFinish;
+    if (callback != nullptr)
+        onFinish = [callback, userData](int status, double duration_ms)
+        {
+            callback(status == 0 ? 0 : -1, duration_ms, userData);
+        };
+    return new std::shared_ptr<LMS7_Device::CalibrationTask>(lms->CalibrateAsync(dir_tx, chan, bw, flags, onFinish));
+}
+
+API_EXPORT int CALL_CONV LMS_WaitCalibration(lms_calibration_t *calibration, unsigned timeout_ms, double *duration_ms)
+{
+    if (calibration == nullptr)
     {
+        lime::ReportError(EINVAL, "Calibration handle cannot be NULL.");
         return -1;
     }
-    if (val == 0x3840)
+    auto task = *(std::shared_ptr<LMS7_Device::CalibrationTask>*)calibration;
+    if (!task->Wait(timeout_ms))
+        return 1;
+    if (duration_ms)
+        *duration_ms = task->GetDuration();
+    if (task->GetStatus() != 0)
     {
-        lime::ReportError(EINVAL, "Feature is not available on this chip revision");
+        lime::ReportError(task->GetStatus(), "%s", task->GetErrorMessage().c_str());
+        return -1;
+    }
+    return 0;
+}
+
+API_EXPORT int CALL_CONV LMS_CancelCalibration(lms_calibration_t *calibration)
+{
+    if (calibration == nullptr)
+    {
+        lime::ReportError(EINVAL, "Calibration handle cannot be NULL.");
+        return -1;
+    }
+    (*(std::shared_ptr<LMS7_Device::CalibrationTask>*)calibration)->Cancel();
+    return 0;
+}
+
+API_EXPORT int CALL_CONV LMS_DestroyCalibration(lms_calibration_t *calibration)
+{
+    if (calibration == nullptr)
+    {
+        lime::ReportError(EINVAL, "Calibration handle cannot be NULL.");
+        return -1;
+    }
+    delete (std::shared_ptr<LMS7_Device::CalibrationTask>*)calibration;
+    return 0;
+}
+
+API_EXPORT int CALL_CONV LMS_GetCalibrationStats(lms_device_t *device, bool dir_tx, size_t chan, lms_cal_stats_t *stats)
+{
+    if (device == nullptr)
+    {
+        lime::ReportError(EINVAL, "Device cannot be NULL.");
+        return -1;
+    }
+    if (stats == nullptr)
+    {
+        lime::ReportError(EINVAL, "Stats cannot be NULL.");
         return -1;
     }
 
+    LMS7_Device* lms = (LMS7_Device*)device;
     if (chan >= lms->GetNumChannels(dir_tx))
     {
         lime::ReportError(EINVAL, "Invalid channel number.");
         return -1;
     }
-    return lms->Calibrate(dir_tx, chan, bw, flags);
+    lime::LMS7002M::CalibrationStats calStats = lms->GetLMS(chan/2)->GetCalibrationStats(dir_tx);
+    stats->rssiReads = calStats.rssiReads;
+    stats->warmStart = calStats.warmStart;
+    stats->fullSearches = calStats.fullSearches;
+    return 0;
+}
+
+API_EXPORT int CALL_CONV LMS_SetCalibRSSI(lms_device_t *device, size_t chan, const lms_calib_rssi_t *config)
+{
+    if (device == nullptr)
+    {
+        lime::ReportError(EINVAL, "Device cannot be NULL.");
+        return -1;
+    }
+    if (config == nullptr || config->method > 2)
+    {
+        lime::ReportError(EINVAL, "Invalid RSSI estimator configuration.");
+        return -1;
+    }
+
+    LMS7_Device* lms = (LMS7_Device*)device;
+    if (chan >= lms->GetNumChannels(false))
+    {
+        lime::ReportError(EINVAL, "Invalid channel number.");
+        return -1;
+    }
+    lime::RSSIEstimator::Config estimator;
+    estimator.method = lime::RSSIEstimator::Method(config->method);
+    estimator.frequency = config->frequency;
+    if (config->windowSize)
+        estimator.windowSize = config->windowSize;
+    if (config->averages)
+        estimator.averages = config->averages;
+    if (config->skipSamples)
+        estimator.skipSamples = config->skipSamples;
+    if (estimator.method == lime::RSSIEstimator::FFT_BIN && (estimator.windowSize & (estimator.windowSize-1)))
+    {
+        lime::ReportError(EINVAL, "FFT window size must be power of two.");
+        return -1;
+    }
+    return lms->SetCalibRSSI(chan, config->calibrations, estimator);
 }
 
 API_EXPORT int CALL_CONV LMS_LoadConfig(lms_device_t *device, const char *filename)
@@ -1069,6 +1218,38 @@ API_EXPORT int CALL_CONV LMS_WriteParam(lms_device_t *device, struct LMS7Paramet
     return lms->WriteParam(param, val);
 }
 
+API_EXPORT int CALL_CONV LMS_ReadParams(lms_device_t *device, const struct LMS7Parameter *params, uint16_t *vals, size_t count)
+{
+    if (device == nullptr)
+    {
+        lime::ReportError(EINVAL, "Device cannot be NULL.");
+        return -1;
+    }
+    if (count != 0 && (params == nullptr || vals == nullptr))
+    {
+        lime::ReportError(EINVAL, "Parameters cannot be NULL.");
+        return -1;
+    }
+    LMS7_Device* lms = (LMS7_Device*)device;
+    return lms->ReadParams(params, vals, count);
+}
+
+API_EXPORT int CALL_CONV LMS_WriteParams(lms_device_t *device, const struct LMS7Parameter *params, const uint16_t *vals, size_t count)
+{
+    if (device == nullptr)
+    {
+        lime::ReportError(EINVAL, "Device cannot be NULL.");
+        return -1;
+    }
+    if (count != 0 && (params == nullptr || vals == nullptr))
+    {
+        lime::ReportError(EINVAL, "Parameters cannot be NULL.");
+        return -1;
+    }
+    LMS7_Device* lms = (LMS7_Device*)device;
+    return lms->WriteParams(params, vals, count);
+}
+
 API_EXPORT int CALL_CONV LMS_SetGFIRCoeff(lms_device_t * device, bool dir_tx, size_t chan, lms_gfir_t filt, const float_type* coef,size_t count)
 {
     if (device == nullptr)
@@ -1152,15 +1333,172 @@ API_EXPORT int CALL_CONV LMS_SetupStream(lms_device_t *device, lms_stream_t *str
     return lms->GetConnection(stream->channel)->SetupStream(stream->handle, config);
 }
 
+//host DSP stages by source stream handle
+static std::map<size_t, std::unique_ptr<lime::StreamDSP>> streamDSPs;
+static std::mutex streamDSPsLock;
+//shared memory publishers by source stream handle
+static std::map<size_t, std::unique_ptr<lime::SharedStreamPublisher>> publishers;
+static std::mutex publishersLock;
+
 API_EXPORT int CALL_CONV LMS_DestroyStream(lms_device_t *device, lms_stream_t *stream)
 {
     if(stream == nullptr)
         return lime::ReportError(EINVAL, "stream is NULL.");
 
+    {
+        std::lock_guard<std::mutex> lock(streamDSPsLock);
+        for (auto &dsp : streamDSPs)
+            for (size_t i = 0; i < dsp.second->GetChannelsCount(); ++i)
+                if (stream->handle == size_t(dsp.second->GetChannel(i)))
+                    return 0;
+        streamDSPs.erase(stream->handle);
+    }
+    {
+        std::lock_guard<std::mutex> lock(publishersLock);
+        publishers.erase(stream->handle);
+    }
     LMS7_Device* lms = (LMS7_Device*)device;
     return lms->GetConnection(stream->channel)->CloseStream(stream->handle);
 }
 
+API_EXPORT int CALL_CONV LMS_SetupStreamDSP(lms_device_t *device, lms_stream_t *stream, const lms_stream_dsp_t *config, lms_stream_t *subStreams)
+{
+    if (device == nullptr)
+        return lime::ReportError(EINVAL, "Device is NULL.");
+    if (stream == nullptr || stream->handle == 0 || config == nullptr || subStreams == nullptr)
+        return lime::ReportError(EINVAL, "Invalid stream DSP arguments.");
+    if (stream->isTx)
+        return lime::ReportError(EINVAL, "Stream DSP requires RX stream.");
+    if (config->decimation != 0 && !lime::StreamDSP::IsValidDecimation(config->decimation))
+        return lime::ReportError(ERANGE, "Stream DSP decimation must be 1 to 1024, even up to 2048 or multiple of 4 up to 4096.");
+    if (config->channels < 1 || config->channels > 4096)
+        return lime::ReportError(ERANGE, "Stream DSP channels must be 1 to 4096.");
+    if (config->decimation == 0 && config->sampleRate <= 0)
+        return lime::ReportError(EINVAL, "Stream DSP needs decimation or sample rate.");
+
+    LMS7_Device* lms = (LMS7_Device*)device;
+    lime::StreamDSP::Config dspConfig;
+    dspConfig.sampleRate = lms->GetRate(false, stream->channel);
+    if (dspConfig.sampleRate <= 0)
+        return lime::ReportError(EINVAL, "Failed to get stream sample rate.");
+    if (std::fabs(config->ncoFrequency) > dspConfig.sampleRate/2)
+        return lime::ReportError(ERANGE, "Stream DSP NCO frequency out of range.");
+    dspConfig.ncoFrequency = config->ncoFrequency;
+    dspConfig.channels = config->channels;
+    dspConfig.outputRate = config->sampleRate > 0 ? config->sampleRate : 0;
+    if (config->decimation == 0)
+        dspConfig.decimation = lime::StreamDSP::SelectDecimation(dspConfig.sampleRate, dspConfig.outputRate, dspConfig.channels);
+    else
+        dspConfig.decimation = config->decimation;
+    if (dspConfig.outputRate > 0)
+    {
+        const double ratio = dspConfig.outputRate*dspConfig.channels*dspConfig.decimation/dspConfig.sampleRate;
+        if (ratio < 0.5 || ratio > 2)
+            return lime::ReportError(ERANGE, "Stream DSP sample rate must be 0.5 to 2 times decimated rate.");
+    }
+    switch(stream->dataFmt)
+    {
+        case lms_stream_t::LMS_FMT_I16:
+            dspConfig.format = lime::StreamConfig::STREAM_12_BIT_IN_16;
+            break;
+        case lms_stream_t::LMS_FMT_I12:
+            dspConfig.format = lime::StreamConfig::STREAM_12_BIT_COMPRESSED;
+            break;
+        default:
+            dspConfig.format = lime::StreamConfig::STREAM_COMPLEX_FLOAT32;
+    }
+    if (stream->fifoSize != 0)
+        dspConfig.fifoSize = stream->fifoSize;
+
+    std::lock_guard<std::mutex> lock(streamDSPsLock);
+    if (streamDSPs.count(stream->handle))
+        return lime::ReportError(EBUSY, "Stream already has DSP stage.");
+    lime::StreamDSP* dsp = new lime::StreamDSP((lime::IStreamChannel*)stream->handle, dspConfig);
+    streamDSPs[stream->handle].reset(dsp);
+    for (size_t i = 0; i < dsp->GetChannelsCount(); ++i)
+    {
+        subStreams[i] = *stream;
+        subStreams[i].handle = size_t(dsp->GetChannel(i));
+    }
+    return 0;
+}
+
+static lime::StreamConfig::StreamDataFormat StreamFormat(const lms_stream_t *stream)
+{
+    switch(stream->dataFmt)
+    {
+        case lms_stream_t::LMS_FMT_I16:
+            return lime::StreamConfig::STREAM_12_BIT_IN_16;
+        case lms_stream_t::LMS_FMT_I12:
+            return lime::StreamConfig::STREAM_12_BIT_COMPRESSED;
+        default:
+            return lime::StreamConfig::STREAM_COMPLEX_FLOAT32;
+    }
+}
+
+API_EXPORT int CALL_CONV LMS_PublishStream(lms_device_t *device, lms_stream_t *stream, const char *name, size_t ringSize)
+{
+    if (device == nullptr)
+        return lime::ReportError(EINVAL, "Device is NULL.");
+    if (stream == nullptr || stream->handle == 0)
+        return lime::ReportError(EINVAL, "stream is NULL.");
+
+    std::lock_guard<std::mutex> lock(publishersLock);
+    publishers.erase(stream->handle);
+    if (name == nullptr)
+        return 0;
+    if (stream->isTx)
+        return lime::ReportError(EINVAL, "Only RX stream can be published.");
+
+    LMS7_Device* lms = (LMS7_Device*)device;
+    const double rate = lms->GetRate(false, stream->channel);
+    std::unique_ptr<lime::SharedStreamPublisher> publisher(new lime::SharedStreamPublisher());
+    if (publisher->Open(name, ringSize, StreamFormat(stream), rate) != 0)
+        return -1;
+    if (publisher->Attach((lime::IStreamChannel*)stream->handle) != 0)
+        return -1;
+    publishers[stream->handle] = std::move(publisher);
+    return 0;
+}
+
+API_EXPORT int CALL_CONV LMS_OpenSharedStream(const char *name, lms_stream_t *stream)
+{
+    if (name == nullptr || stream == nullptr)
+        return lime::ReportError(EINVAL, "Invalid shared stream arguments.");
+    lime::SharedStreamReader* reader = new lime::SharedStreamReader();
+    if (reader->Open(name) != 0)
+    {
+        delete reader;
+        return -1;
+    }
+    switch(reader->GetFormat())
+    {
+        case lime::StreamConfig::STREAM_12_BIT_IN_16:
+            stream->dataFmt = lms_stream_t::LMS_FMT_I16;
+            break;
+        case lime::StreamConfig::STREAM_12_BIT_COMPRESSED:
+            stream->dataFmt = lms_stream_t::LMS_FMT_I12;
+            break;
+        default:
+            stream->dataFmt = lms_stream_t::LMS_FMT_F32;
+    }
+    stream->handle = size_t(reader);
+    stream->isTx = false;
+    stream->channel = 0;
+    stream->fifoSize = reader->GetCapacity();
+    stream->throughputVsLatency = 0;
+    return 0;
+}
+
+API_EXPORT int CALL_CONV LMS_CloseSharedStream(lms_stream_t *stream)
+{
+    if (stream == nullptr || stream->handle == 0)
+        return lime::ReportError(EINVAL, "stream is NULL.");
+    delete (lime::SharedStreamReader*)stream->handle;
+    stream->handle = 0;
+    return 0;
+}
+
 API_EXPORT int CALL_CONV LMS_StartStream(lms_stream_t *stream)
 {
     if (stream==nullptr || stream->handle==0)
@@ -1261,15 +1599,15 @@ API_EXPORT int CALL_CONV LMS_GetStreamStatus(lms_stream_t *stream, lms_stream_st
         return -1;
     lime::IStreamChannel::Info info = channel->GetInfo();
 
-    status->active = false;
-    status->droppedPackets = 0;
+    status->active = info.active;
+    status->droppedPackets = info.droppedPackets;
     status->fifoFilledCount = info.fifoItemsCount;
     status->fifoSize = info.fifoSize;
     status->linkRate = info.linkRate;
-    status->overrun = 0;
-    status->underrun = 0;
-    status->sampleRate = 0;
-    status->timestamp = 0;
+    status->overrun = info.overrun;
+    status->underrun = info.underrun;
+    status->sampleRate = info.sampleRate;
+    status->timestamp = info.timestamp;
     return 0;
 }
 
@@ -15,9 +15,11 @@
 #include <iostream>
 #include <fstream>
 #include "ErrorReporting.h"
+#include "Logger.h"
 #include "MCU_BD.h"
 #include "FPGA_common.h"
 #include "LMS64CProtocol.h"
+#include "ControlProfiler.h"
 #include <assert.h>
 #include "ConnectionRegistry.h"
 #include "ADF4002.h"
@@ -69,6 +71,21 @@ LMS7_Device::LMS7_Device(LMS7_Device *obj) : connection(nullptr), lms_chip_id(0)
 
 LMS7_Device::~LMS7_Device()
 {
+    //background calibrations use chips, stop them first
+    std::vector<std::shared_ptr<CalibrationTask>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(chipLocksGuard);
+        for (auto &weakTask : calibrationTasks)
+            if (auto task = weakTask.lock())
+                tasks.push_back(task);
+        calibrationTasks.clear();
+    }
+    for (auto &task : tasks)
+    {
+        task->Cancel();
+        task->Wait();
+    }
+
     for (unsigned i = 0; i < this->lms_list.size();i++)
         delete this->lms_list[i];
 
@@ -343,6 +360,7 @@ size_t LMS7_Device::GetNumChannels(const bool tx) const
 
 int LMS7_Device::SetRate(double f_Hz, int oversample)
 {
+    lime::ControlProfiler::Scope profile("SetRate");
    int decim = 0;
    float_type nco_f=0;
    for (size_t i = 0; i < GetNumChannels(false);i++)
@@ -433,6 +451,7 @@ int LMS7_Device::SetRate(double f_Hz, int oversample)
 
 int LMS7_Device::SetRate(bool tx, double f_Hz, unsigned oversample)
 {
+    lime::ControlProfiler::Scope profile("SetRate");
     float_type tx_clock;
     float_type rx_clock;
     float_type cgen;
@@ -712,6 +731,7 @@ int LMS7_Device::SetRate(bool tx, double f_Hz, unsigned oversample)
 
 int LMS7_Device::SetRate(unsigned ch, double rxRate, double txRate, unsigned oversample)
 {
+    lime::ControlProfiler::Scope profile("SetRate");
     //TODO: low importance : implement this and expose via LimeSuite.h 
     return lime::ReportError(ERANGE, "Not implemented");;
 }
@@ -776,6 +796,8 @@ std::vector<std::string> LMS7_Device::GetPathNames(bool dir_tx, size_t chan) con
 
 int LMS7_Device::SetPath(bool tx, size_t chan, size_t path)
 {
+    lime::ControlProfiler::Scope profile("SetPath");
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
     lime::LMS7002M* lms = lms_list[chan / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (chan%2) + 1, true) != 0)
         return -1;
@@ -797,6 +819,7 @@ int LMS7_Device::SetPath(bool tx, size_t chan, size_t path)
 
 size_t LMS7_Device::GetPath(bool tx, size_t chan)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
     lime::LMS7002M* lms = lms_list[chan / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (chan%2) + 1, true) != 0)
         return -1;
@@ -898,6 +921,8 @@ lms_range_t LMS7_Device::GetTxPathBand(size_t path, size_t chan) const
 
 int LMS7_Device::SetLPF(bool tx,size_t chan, bool filt, bool en, float_type bandwidth)
 {
+    lime::ControlProfiler::Scope profile("SetLPF");
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
     if (filt)
     {
         if (tx)
@@ -956,6 +981,7 @@ lms_range_t LMS7_Device::GetLPFRange(bool tx, size_t chan, bool filt)
 
 int LMS7_Device::SetGFIRCoef(bool tx, size_t chan, lms_gfir_t filt, const float_type* coef,size_t count)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
     lime::LMS7002M* lms = lms_list[chan / 2];
     short gfir[120];
     int L;
@@ -1080,6 +1106,7 @@ int LMS7_Device::SetGFIRCoef(bool tx, size_t chan, lms_gfir_t filt, const float_
 
 int LMS7_Device::GetGFIRCoef(bool tx, size_t chan, lms_gfir_t filt, float_type* coef)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
     lime::LMS7002M* lms = lms_list[chan / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (chan%2) + 1, true) != 0)
        return -1;
@@ -1100,6 +1127,7 @@ int LMS7_Device::GetGFIRCoef(bool tx, size_t chan, lms_gfir_t filt, float_type*
 
 int LMS7_Device::SetGFIR(bool tx, size_t chan, lms_gfir_t filt, bool enabled)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
     lime::LMS7002M* lms = lms_list[chan / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (chan%2) + 1, true) != 0)
         return -1;
@@ -1154,6 +1182,8 @@ int LMS7_Device::SetNormalizedGain(bool dir_tx, size_t chan,double gain)
 
 int LMS7_Device::SetGain(bool dir_tx, size_t chan, unsigned gain)
 {
+    lime::ControlProfiler::Scope profile("SetGain");
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
     lime::LMS7002M* lms = lms_list[chan / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (chan%2) + 1, true) != 0)
         return -1;
@@ -1235,6 +1265,7 @@ double LMS7_Device::GetNormalizedGain(bool dir_tx, size_t chan)
 
 int LMS7_Device::GetGain(bool dir_tx, size_t chan)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
     lime::LMS7002M* lms = lms_list[chan / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (chan%2) + 1, true) != 0)
         return -1;
@@ -1283,6 +1314,7 @@ int LMS7_Device::GetGain(bool dir_tx, size_t chan)
 
 int LMS7_Device::SetTestSignal(bool dir_tx, size_t chan, lms_testsig_t sig, int16_t dc_i, int16_t dc_q)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
     lime::LMS7002M* lms = lms_list[chan / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (chan%2) + 1, true) != 0)
         return -1;
@@ -1332,6 +1364,7 @@ int LMS7_Device::SetTestSignal(bool dir_tx, size_t chan, lms_testsig_t sig, int1
 
 int LMS7_Device::GetTestSignal(bool dir_tx, size_t chan)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
     lime::LMS7002M* lms = lms_list[chan / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (chan%2) + 1, true) != 0)
         return -1;
@@ -1365,6 +1398,8 @@ int LMS7_Device::GetTestSignal(bool dir_tx, size_t chan)
 
 int LMS7_Device::SetNCOFreq(bool tx, size_t ch, const float_type *freq, float_type pho)
 {
+    lime::ControlProfiler::Scope profile("SetNCOFreq");
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(ch / 2));
     lime::LMS7002M* lms = lms_list[ch / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (ch%2) + 1, true) != 0)
         return -1;
@@ -1372,40 +1407,28 @@ int LMS7_Device::SetNCOFreq(bool tx, size_t ch, const float_type *freq, float_ty
     float_type rf_rate;
     GetRate(tx,ch,&rf_rate);
     rf_rate /=2;
-    if (freq != nullptr)
+    if (freq == nullptr)
+        return lms->SetNCOPhaseOffsetForMode0(tx, pho);
+
+    for (size_t i = 0; i < LMS_NCO_VAL_COUNT; i++)
     {
-        for (size_t i = 0; i < LMS_NCO_VAL_COUNT; i++)
-        {
-            if (freq[i] < 0 || freq[i] > rf_rate)
-            {
-                lime::ReportError(ERANGE, "NCO frequency is negative or outside of RF bandwidth range");
-                return -1;
-            }
-        if (lms->SetNCOFrequency(tx, i, freq[i]) != 0)
-                return -1;
-        }
-        if (tx)
-        {
-            if ((lms->Modify_SPI_Reg_bits(LMS7param(CMIX_BYP_TXTSP), 0, true) != 0)
-                || (lms->Modify_SPI_Reg_bits(LMS7param(SEL_TX), 0, true) != 0))
-                    return -1;
-            if (lms->Modify_SPI_Reg_bits(LMS7param(MODE_TX), 0, true) != 0)
-                    return -1;
-        }
-        else
+        if (freq[i] < 0 || freq[i] > rf_rate)
         {
-            if ((lms->Modify_SPI_Reg_bits(LMS7param(CMIX_BYP_RXTSP), 0, true) != 0)
-                || (lms->Modify_SPI_Reg_bits(LMS7param(SEL_RX), 0, true) != 0))
-                    return -1;
-            if (lms->Modify_SPI_Reg_bits(LMS7param(MODE_RX), 0, true) != 0)
-                    return -1;
+            lime::ReportError(ERANGE, "NCO frequency is negative or outside of RF bandwidth range");
+            return -1;
         }
     }
-    return lms->SetNCOPhaseOffsetForMode0(tx, pho);
+    if (lms->SetNCOFrequencies(tx, freq, LMS_NCO_VAL_COUNT, &pho) != 0)
+        return -1;
+    const LMS7Parameter txParams[] = {LMS7param(CMIX_BYP_TXTSP), LMS7param(SEL_TX), LMS7param(MODE_TX)};
+    const LMS7Parameter rxParams[] = {LMS7param(CMIX_BYP_RXTSP), LMS7param(SEL_RX), LMS7param(MODE_RX)};
+    const uint16_t values[] = {0, 0, 0};
+    return lms->Modify_SPI_Reg_bits_batch(tx ? txParams : rxParams, values, 3, true);
 }
 
 int LMS7_Device::SetNCO(bool tx,size_t ch,int ind,bool down)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(ch / 2));
     lime::LMS7002M* lms = lms_list[ch / 2];
     if ((!tx) && (lms->Get_SPI_Reg_bits(LMS7_MASK, true) != 0))
         down = !down;
@@ -1452,16 +1475,12 @@ int LMS7_Device::SetNCO(bool tx,size_t ch,int ind,bool down)
 
 int LMS7_Device::GetNCOFreq(bool tx, size_t ch, float_type *freq,float_type *pho)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(ch / 2));
     lime::LMS7002M* lms = lms_list[ch / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (ch%2) + 1, true) != 0)
         return -1;
     if (freq != nullptr)
-    {
-        for (size_t i = 0; i < LMS_NCO_VAL_COUNT; i++)
-        {
-            freq[i] = lms->GetNCOFrequency(tx,i,true);
-        }
-    }
+        return lms->GetNCOFrequencies(tx, freq, LMS_NCO_VAL_COUNT, pho, true);
 
     if (pho != nullptr)
     {
@@ -1474,54 +1493,31 @@ int LMS7_Device::GetNCOFreq(bool tx, size_t ch, float_type *freq,float_type *pho
 
 int LMS7_Device::SetNCOPhase(bool tx, size_t ch, const float_type *phase, float_type fcw)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(ch / 2));
     lime::LMS7002M* lms = lms_list[ch / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (ch%2) + 1, true) != 0)
         return -1;
 
-    if (phase != nullptr)
-    {
-        for (size_t i = 0; i < LMS_NCO_VAL_COUNT; i++)
-        {
-            if (lms->SetNCOPhaseOffset(tx,i,phase[i])!=0)
-                return -1;
-        }
-
-        if (tx)
-        {
-            if ((lms->Modify_SPI_Reg_bits(LMS7param(CMIX_BYP_TXTSP), 0, true) != 0)
-                || (lms->Modify_SPI_Reg_bits(LMS7param(SEL_TX), 0, true) != 0)
-                || (lms->Modify_SPI_Reg_bits(LMS7param(CMIX_SC_TXTSP), 0, true) != 0))
-                return -1;
-            if (lms->Modify_SPI_Reg_bits(LMS7param(MODE_TX), 1, true) != 0)
-                return -1;
-        }
-        else
-        {
-            if ((lms->Modify_SPI_Reg_bits(LMS7param(CMIX_BYP_RXTSP), 0, true) != 0)
-                || (lms->Modify_SPI_Reg_bits(LMS7param(SEL_RX), 0, true) != 0)
-                || (lms->Modify_SPI_Reg_bits(LMS7param(CMIX_SC_RXTSP), 0, true) != 0))
-                return -1;
-            if (lms->Modify_SPI_Reg_bits(LMS7param(MODE_RX), 1, true) != 0)
-                return -1;
-        }
-    }
+    if (phase == nullptr)
+        return lms->SetNCOFrequency(tx,0,fcw);
 
-    return lms->SetNCOFrequency(tx,0,fcw);
+    if (lms->SetNCOPhaseOffsets(tx, phase, LMS_NCO_VAL_COUNT, &fcw) != 0)
+        return -1;
+    const LMS7Parameter txParams[] = {LMS7param(CMIX_BYP_TXTSP), LMS7param(SEL_TX), LMS7param(CMIX_SC_TXTSP), LMS7param(MODE_TX)};
+    const LMS7Parameter rxParams[] = {LMS7param(CMIX_BYP_RXTSP), LMS7param(SEL_RX), LMS7param(CMIX_SC_RXTSP), LMS7param(MODE_RX)};
+    const uint16_t values[] = {0, 0, 0, 1};
+    return lms->Modify_SPI_Reg_bits_batch(tx ? txParams : rxParams, values, 4, true);
 }
 
 
 int LMS7_Device::GetNCOPhase(bool tx, size_t ch, float_type *phase,float_type *fcw)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(ch / 2));
     lime::LMS7002M* lms = lms_list[ch / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (ch%2) + 1, true) != 0)
         return -1;
     if (phase != nullptr)
-    {
-        for (size_t i = 0; i < LMS_NCO_VAL_COUNT; i++)
-        {
-            phase[i] = lms->GetNCOPhaseOffset_Deg(tx,i);
-        }
-    }
+        return lms->GetNCOPhaseOffsets(tx, phase, LMS_NCO_VAL_COUNT, fcw, true);
     if (fcw != nullptr)
         *fcw = lms->GetNCOFrequency(tx,0,true);
     return 0;
@@ -1529,6 +1525,7 @@ int LMS7_Device::GetNCOPhase(bool tx, size_t ch, float_type *phase,float_type *f
 
 int LMS7_Device::GetNCO(bool tx, size_t ch)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(ch / 2));
     lime::LMS7002M* lms = lms_list[ch / 2];
     if (lms->Modify_SPI_Reg_bits(LMS7param(MAC), (ch%2) + 1, true) != 0)
         return -2;
@@ -1552,33 +1549,138 @@ int LMS7_Device::GetNCO(bool tx, size_t ch)
 
 int LMS7_Device::Calibrate(bool dir_tx, size_t chan, double bw, unsigned flags)
 {
-    lime::LMS7002M* lms = lms_list[chan / 2];
+    return Calibrate(dir_tx, chan, bw, flags, nullptr);
+}
+
+int LMS7_Device::Calibrate(bool dir_tx, size_t chan, double bw, unsigned flags, const std::atomic<bool>* abort)
+{
+    lime::ControlProfiler::Scope profile("Calibrate");
     if (chan >= this->GetNumChannels(dir_tx))
     {
         lime::ReportError(EINVAL, "Invalid channel number.");
         return -1;
     }
+    lime::LMS7002M* lms = lms_list[chan / 2];
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
+    if (abort && abort->load())
+        return lime::ReportError(ECANCELED, "Calibration cancelled");
+    lms->SetCalibrationAbortFlag(abort);
     lms->EnableCalibrationByMCU((flags&1) == 0);
     lms->Modify_SPI_Reg_bits(LMS7param(MAC), (chan%2) + 1, true);
+    int status;
     if (dir_tx)
-        return lms->CalibrateTx(bw, false);
+        status = lms->CalibrateTx(bw, false);
+    else
+        status = lms->CalibrateRx(bw, false);
+    lms->SetCalibrationAbortFlag(nullptr);
+    return status;
+}
+
+std::recursive_mutex &LMS7_Device::GetChipLock(size_t chip)
+{
+    std::lock_guard<std::mutex> lock(chipLocksGuard);
+    return chipLocks[chip];
+}
+
+std::shared_ptr<LMS7_Device::CalibrationTask> LMS7_Device::CalibrateAsync(bool dir_tx, size_t chan, double bw, unsigned flags, CalibrationCallback callback)
+{
+    std::shared_ptr<CalibrationTask> task(new CalibrationTask());
+    CalibrationTask* t = task.get();
+    {
+        std::lock_guard<std::mutex> lock(chipLocksGuard);
+        for (auto iter = calibrationTasks.begin(); iter != calibrationTasks.end();)
+            iter = iter->expired() ? calibrationTasks.erase(iter) : iter + 1;
+        calibrationTasks.push_back(task);
+    }
+    //thread does not own the task, task destructor joins it
+    t->thread = std::thread([this, t, dir_tx, chan, bw, flags, callback]()
+    {
+        //chip lock is taken inside, wait for it is not counted
+        auto t1 = std::chrono::high_resolution_clock::now();
+        int status = Calibrate(dir_tx, chan, bw, flags, &t->abort);
+        double duration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t1).count();
+        std::string errorMessage = status != 0 ? lime::GetLastErrorMessage() : "";
+        //task is finished only after callback returns
+        if (callback)
+            callback(status, duration);
+        {
+            std::lock_guard<std::mutex> lock(t->lock);
+            t->status = status;
+            t->duration_ms = duration;
+            t->errorMessage = errorMessage;
+            t->finished = true;
+        }
+        t->finishedCond.notify_all();
+    });
+    return task;
+}
+
+LMS7_Device::CalibrationTask::CalibrationTask() :
+    finished(false),
+    status(0),
+    duration_ms(0),
+    abort(false)
+{
+}
+
+LMS7_Device::CalibrationTask::~CalibrationTask()
+{
+    if (thread.joinable())
+        thread.join();
+}
+
+void LMS7_Device::CalibrationTask::Cancel()
+{
+    abort.store(true);
+}
+
+bool LMS7_Device::CalibrationTask::Wait(int timeout_ms)
+{
+    std::unique_lock<std::mutex> lck(lock);
+    if (timeout_ms < 0)
+        finishedCond.wait(lck, [this]{return finished;});
     else
-        return lms->CalibrateRx(bw, false);
+        finishedCond.wait_for(lck, std::chrono::milliseconds(timeout_ms), [this]{return finished;});
+    return finished;
+}
+
+int LMS7_Device::CalibrationTask::GetStatus()
+{
+    std::lock_guard<std::mutex> lck(lock);
+    return status;
+}
+
+std::string LMS7_Device::CalibrationTask::GetErrorMessage()
+{
+    std::lock_guard<std::mutex> lck(lock);
+    return errorMessage;
+}
+
+double LMS7_Device::CalibrationTask::GetDuration()
+{
+    std::lock_guard<std::mutex> lck(lock);
+    return duration_ms;
 }
 
 int LMS7_Device::SetRxFrequency(size_t chan, double f_Hz)
 {
+    lime::ControlProfiler::Scope profile("SetRxFrequency");
     lime::LMS7002M* lms = lms_list[chan / 2];
     if (f_Hz < 30e6)
     {
-        if (lms->SetFrequencySX(false, 30e6) != 0)
-            return -1;
-        rx_channels[chan].cF_offset_nco = 30e6-f_Hz;
+        {
+            std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
+            if (lms->SetFrequencySX(false, 30e6) != 0)
+                return -1;
+            rx_channels[chan].cF_offset_nco = 30e6-f_Hz;
+        }
+        //SetRate() configures all chips, must not hold chip lock
         if (SetRate(false,GetRate(true,chan),2)!=0)
             return -1;
     }
     else
     {
+        std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
         if (rx_channels[chan].cF_offset_nco != 0)
             SetNCO(false,chan,-1,true);
         rx_channels[chan].cF_offset_nco = 0;
@@ -1590,6 +1692,7 @@ int LMS7_Device::SetRxFrequency(size_t chan, double f_Hz)
 
 float_type LMS7_Device::GetTRXFrequency(bool tx, size_t chan)
 {
+   std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
    lime::LMS7002M* lms = lms_list[chan / 2];
    double offset = tx ? tx_channels[chan].cF_offset_nco : rx_channels[chan].cF_offset_nco;
    return lms->GetFrequencySX(tx) - offset;
@@ -1597,17 +1700,23 @@ float_type LMS7_Device::GetTRXFrequency(bool tx, size_t chan)
 
 int LMS7_Device::SetTxFrequency(size_t chan, double f_Hz)
 {
+    lime::ControlProfiler::Scope profile("SetTxFrequency");
     lime::LMS7002M* lms = lms_list[chan / 2];
     if (f_Hz < 30e6)
     {
-        if (lms->SetFrequencySX(true, 30e6) != 0)
-            return -1;
-        tx_channels[chan].cF_offset_nco = 30e6-f_Hz;
+        {
+            std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
+            if (lms->SetFrequencySX(true, 30e6) != 0)
+                return -1;
+            tx_channels[chan].cF_offset_nco = 30e6-f_Hz;
+        }
+        //SetRate() configures all chips, must not hold chip lock
         if (SetRate(true,GetRate(true,chan),2)!=0)
             return -1;
     }
     else
     {
+        std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
         if (tx_channels[chan].cF_offset_nco != 0)
             SetNCO(true,chan,-1,false);
         tx_channels[chan].cF_offset_nco = 0;
@@ -1628,6 +1737,7 @@ lms_range_t LMS7_Device::GetFrequencyRange(bool tx) const
 
 int LMS7_Device::Init()
 {
+    lime::ControlProfiler::Scope profile("Init");
     struct regVal
     {
         uint16_t adr;
@@ -1646,33 +1756,65 @@ int LMS7_Device::Init()
         {0x040C, 0x00F8}
     };
 
+    initTiming.clear();
+    auto phaseStart = std::chrono::steady_clock::now();
+    auto phaseDone = [this, &phaseStart](const char* name)
+    {
+        auto now = std::chrono::steady_clock::now();
+        initTiming.push_back(std::make_pair(std::string(name), std::chrono::duration<double, std::milli>(now-phaseStart).count()));
+        lime::debug("LMS7_Device::Init %s %.1f ms", name, initTiming.back().second);
+        phaseStart = now;
+    };
+
     for (unsigned i = 0; i < lms_list.size(); i++)
     {
         lime::LMS7002M* lms = lms_list[i];
         if (lms->ResetChip() != 0)
             return -1;
-
-        lms->Modify_SPI_Reg_bits(LMS7param(MAC), 1);
+        phaseDone("reset");
+
+        //whole init table for both channels in one transaction,
+        //MAC changes inside the batch select channel registers
+        const uint16_t macA = (lms->SPI_read(0x0020) & ~0x3) | 1;
+        const uint16_t macB = (lms->SPI_read(0x0020) & ~0x3) | 2;
+        std::vector<uint16_t> addrs(1, 0x0020);
+        std::vector<uint16_t> values(1, macA);
         for (auto i : initVals)
-            lms->SPI_write(i.adr, i.val);
-
-        lms->Modify_SPI_Reg_bits(LMS7param(MAC), 2);
+        {
+            addrs.push_back(i.adr);
+            values.push_back(i.val);
+        }
+        addrs.push_back(0x0020);
+        values.push_back(macB);
         for (auto i : initVals)
             if (i.adr >= 0x100)
-                lms->SPI_write(i.adr, i.val);
+            {
+                addrs.push_back(i.adr);
+                values.push_back(i.val);
+            }
+        if (lms->SPI_write_batch(addrs.data(), values.data(), addrs.size()) != 0)
+            return -1;
         lms->EnableChannel(false, false);
         lms->EnableChannel(true, false);
 
         lms->Modify_SPI_Reg_bits(LMS7param(MAC), 1);
+        phaseDone("init table");
 
         if (lms->UploadAll()!=0)
             return -1;
+        phaseDone("upload");
     }
     return 0;
 }
 
+std::vector<std::pair<std::string, double>> LMS7_Device::GetInitTiming() const
+{
+    return initTiming;
+}
+
 int LMS7_Device::Reset()
 {
+    lime::ControlProfiler::Scope profile("Reset");
     for (unsigned i = 0; i < lms_list.size(); i++)
     {
         lime::LMS7002M* lms = lms_list[i];
@@ -1685,6 +1827,7 @@ int LMS7_Device::Reset()
 
 int LMS7_Device::EnableChannel(bool dir_tx, size_t chan, bool enabled)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
     lime::LMS7002M* lms = lms_list[chan / 2];
     if (chan >= this->GetNumChannels(dir_tx))
     {
@@ -1802,6 +1945,7 @@ int LMS7_Device::GetClockFreq(size_t clk_id, float_type *freq)
 
 int LMS7_Device::SetClockFreq(size_t clk_id, float_type freq)
 {
+    lime::ControlProfiler::Scope profile("SetClockFreq");
     lime::LMS7002M* lms = lms_list[lms_chip_id];
     switch (clk_id)
     {
@@ -1947,8 +2091,24 @@ int LMS7_Device::EnableCalibCache(bool enable)
     return 0;
 }
 
+int LMS7_Device::EnableCalibTable(bool enable)
+{
+    for (unsigned i = 0; i < lms_list.size(); i++)
+        if (lms_list[i]->EnableCalibrationTable(enable) != 0)
+            return -1;
+    return 0;
+}
+
+int LMS7_Device::SetCalibRSSI(size_t chan, unsigned calibrations, const lime::RSSIEstimator::Config &config)
+{
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(chan / 2));
+    lms_list[chan / 2]->SetStreamRSSI(calibrations, config);
+    return 0;
+}
+
 int LMS7_Device::GetChipTemperature(size_t ind, float_type *temp)
 {
+    std::lock_guard<std::recursive_mutex> lock(GetChipLock(this->lms_chip_id));
     *temp = lms_list[this->lms_chip_id]->GetTemperature();
     return 0;
 }
@@ -1990,18 +2150,22 @@ int LMS7_Device::WriteLMSReg(uint16_t address, uint16_t val)
     return lms_list.at(lms_chip_id)->SPI_write(address & 0xFFFF, val);
 }
 
-int LMS7_Device::ReadParam(struct LMS7Parameter param, uint16_t *val, bool forceReadFromChip)
+//! Registers containing read only registers, which values can change
+static bool IsVolatileRegister(const uint16_t address)
 {
-    //registers containing read only registers, which values can change
     const uint16_t readOnlyRegs[] = { 0, 1, 2, 3, 4, 5, 6, 0x002F, 0x008C, 0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x0123, 0x0209, 0x020A, 0x020B, 0x040E, 0x040F, 0x05C3, 0x05C4, 0x05C5, 0x05C6, 0x05C7, 0x05C8, 0x05C9, 0x05CA};
     for (unsigned i = 0; i < sizeof(readOnlyRegs) / sizeof(uint16_t); ++i)
     {
-        if (param.address == readOnlyRegs[i])
-        {
-            forceReadFromChip = true;
-            break;
-        }
+        if (address == readOnlyRegs[i])
+            return true;
     }
+    return false;
+}
+
+int LMS7_Device::ReadParam(struct LMS7Parameter param, uint16_t *val, bool forceReadFromChip)
+{
+    if (IsVolatileRegister(param.address))
+        forceReadFromChip = true;
     *val = lms_list.at(lms_chip_id)->Get_SPI_Reg_bits(param, forceReadFromChip);
     return LMS_SUCCESS;
 }
@@ -2011,6 +2175,40 @@ int LMS7_Device::WriteParam(struct LMS7Parameter param, uint16_t val)
     return lms_list.at(lms_chip_id)->Modify_SPI_Reg_bits(param, val);
 }
 
+int LMS7_Device::ReadParams(const struct LMS7Parameter *params, uint16_t *vals, size_t count, bool forceReadFromChip)
+{
+    lime::LMS7002M* lms = lms_list.at(lms_chip_id);
+    if (forceReadFromChip)
+        return lms->Get_SPI_Reg_bits_batch(params, vals, count, true);
+
+    //volatile registers from chip in one transaction, others from cache
+    std::vector<LMS7Parameter> chipParams;
+    std::vector<size_t> chipIndexes;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (IsVolatileRegister(params[i].address))
+        {
+            chipParams.push_back(params[i]);
+            chipIndexes.push_back(i);
+        }
+        else
+            vals[i] = lms->Get_SPI_Reg_bits(params[i], false);
+    }
+    if (chipParams.empty())
+        return LMS_SUCCESS;
+    std::vector<uint16_t> chipVals(chipParams.size());
+    if (lms->Get_SPI_Reg_bits_batch(chipParams.data(), chipVals.data(), chipParams.size(), true) != 0)
+        return -1;
+    for (size_t i = 0; i < chipIndexes.size(); ++i)
+        vals[chipIndexes[i]] = chipVals[i];
+    return LMS_SUCCESS;
+}
+
+int LMS7_Device::WriteParams(const struct LMS7Parameter *params, const uint16_t *vals, size_t count)
+{
+    return lms_list.at(lms_chip_id)->Modify_SPI_Reg_bits_batch(params, vals, count);
+}
+
 int LMS7_Device::SetActiveChip(unsigned ind)
 {
     if (ind >= this->GetNumChannels() / 2)
@@ -10,6 +10,11 @@
 #include "LMS7002M.h"
 #include "lime/LimeSuite.h"
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <functional>
 #include <vector>
 #include <map>
 #include <string>
@@ -31,11 +36,47 @@ class LIME_API LMS7_Device
         float_type sample_rate;
     };
 public:
+    //! Calibration running in background thread, see CalibrateAsync()
+    class LIME_API CalibrationTask
+    {
+    public:
+        CalibrationTask();
+        //! Waits for calibration thread to finish
+        ~CalibrationTask();
+        //! Requests calibration to stop at next stage
+        void Cancel();
+        /** @brief Waits for calibration to finish
+            @param timeout_ms maximum wait time, negative to wait until finished
+            @return true if calibration has finished
+        */
+        bool Wait(int timeout_ms = -1);
+        //! Calibration result, valid after Wait() returns true
+        int GetStatus();
+        //! Error message of failed calibration
+        std::string GetErrorMessage();
+        //! Calibration duration in milliseconds, excluding wait for chip
+        double GetDuration();
+    private:
+        friend class LMS7_Device;
+        std::thread thread;
+        std::mutex lock;
+        std::condition_variable finishedCond;
+        bool finished;
+        int status;
+        double duration_ms;
+        std::string errorMessage;
+        std::atomic<bool> abort;
+    };
+    //! Called from calibration thread when CalibrationTask finishes
+    typedef std::function<void(int status, double duration_ms)> CalibrationCallback;
+
     LMS7_Device(LMS7_Device *obj = nullptr);
     virtual ~LMS7_Device();
     virtual int SetConnection(lime::IConnection* conn);
     virtual lime::IConnection* GetConnection(unsigned chan =0);
     int Init();
+    //! Duration of last Init() phases in milliseconds
+    std::vector<std::pair<std::string, double>> GetInitTiming() const;
     int EnableChannel(bool dir_tx, size_t chan, bool enabled);
     int Reset();
     virtual size_t GetNumChannels(const bool tx=false) const;
@@ -73,6 +114,13 @@ public:
     int GetNCOPhase(bool tx,size_t ch, float_type * phase,float_type *fcw);
     int GetNCO(bool tx,size_t ch);
     int Calibrate(bool dir_tx, size_t chan, double bw, unsigned flags);
+    /** @brief Runs Calibrate() in background thread.
+        Calibrations of different chips run concurrently, calibrations of the
+        same chip are performed one after another.
+        @param callback optional function called when calibration finishes,
+        it must not wait for or destroy the returned task
+    */
+    std::shared_ptr<CalibrationTask> CalibrateAsync(bool dir_tx, size_t chan, double bw, unsigned flags, CalibrationCallback callback = nullptr);
     int Program(const char* data, size_t len, lms_prog_trg_t target, lms_prog_md_t mode, lime::IConnection::ProgrammingCallback callback);
     int ProgramUpdate(const bool download, lime::IConnection::ProgrammingCallback callback);
     int DACWrite(uint16_t val);
@@ -83,6 +131,8 @@ public:
     int Synchronize(bool toChip);
     int SetLogCallback(void(*func)(const char* cstr, const unsigned int type));
     int EnableCalibCache(bool enable);
+    int EnableCalibTable(bool enable);
+    int SetCalibRSSI(size_t chan, unsigned calibrations, const lime::RSSIEstimator::Config &config);
     int GetChipTemperature(size_t ind, float_type *temp);
     int LoadConfig(const char *filename);
     int SaveConfig(const char *filename);
@@ -90,6 +140,10 @@ public:
     int WriteLMSReg(uint16_t address, uint16_t val);
     int ReadParam(struct LMS7Parameter param, uint16_t *val, bool forceReadFromChip = false);
     int WriteParam(struct LMS7Parameter param, uint16_t val);
+    //! Reads multiple parameters, each register is read once
+    int ReadParams(const struct LMS7Parameter *params, uint16_t *vals, size_t count, bool forceReadFromChip = false);
+    //! Writes multiple parameters, values of the same register are merged
+    int WriteParams(const struct LMS7Parameter *params, const uint16_t *vals, size_t count);
     int SetActiveChip(unsigned ind);
     lime::LMS7002M* GetLMS(int index = -1);
     int UploadWFM(const void **samples, uint8_t chCount, int sample_count, lime::StreamConfig::StreamDataFormat fmt);
@@ -111,6 +165,17 @@ protected:
     int ConfigureGFIR(bool enabled,bool tx, float_type bandwidth,size_t ch);
     void _Initialize(lime::IConnection* conn);
     unsigned lms_chip_id;
+    std::vector<std::pair<std::string, double>> initTiming;
+    /** @brief Serializes access to one chip.
+        Held by calibrations and per channel settings, operations on
+        different chips do not wait for each other.
+    */
+    std::recursive_mutex &GetChipLock(size_t chip);
+    int Calibrate(bool dir_tx, size_t chan, double bw, unsigned flags, const std::atomic<bool>* abort);
+private:
+    std::mutex chipLocksGuard; //!< guards chipLocks and calibrationTasks
+    std::map<size_t, std::recursive_mutex> chipLocks;
+    std::vector<std::weak_ptr<CalibrationTask>> calibrationTasks;
 };
 
 #endif	/* LMS7_DEVICE_H */
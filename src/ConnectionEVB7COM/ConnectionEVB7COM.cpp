@@ -6,6 +6,7 @@
 
 #include "ConnectionEVB7COM.h"
 #include "ErrorReporting.h"
+#include "AsyncBlockIO.h"
 
 #include "string.h"
 #ifdef __unix__
@@ -19,11 +20,14 @@
 #include <stdlib.h>
 #include <iostream>
 #include <stdio.h>
+#include <sys/ioctl.h>
 #endif // LINUX
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
 
 static const int COM_RETRY_INTERVAL = 20; //ms
 static const int COM_TOTAL_TIMEOUT = 300; //ms
-static const int COM_BUFFER_LENGTH = 1024; //max buffer size for data
 
 using namespace lime;
 
@@ -177,7 +181,7 @@ int ConnectionEVB7COM::Open(const char *comName, int baudrate)
 		return NOERROR;
 	}
 #else
-    hComm = open(comName, O_RDWR | O_NOCTTY | O_SYNC);
+    hComm = open(comName, O_RDWR | O_NOCTTY | O_NONBLOCK);
     if(hComm < 0)
     {
 //        printf("%s",strerror(errno));
@@ -196,13 +200,15 @@ int ConnectionEVB7COM::Open(const char *comName, int baudrate)
     cfsetospeed(&tty, speed);
     cfsetispeed(&tty, speed);
 
-    tty.c_cflag = (tty.c_cflag & ~CSIZE) | CS8;
-    tty.c_iflag &= ~IGNBRK;
-    tty.c_iflag &= ~ICRNL;
+    //raw binary data
+    tty.c_cflag = (tty.c_cflag & ~(CSIZE | PARENB | CSTOPB)) | CS8;
+    tty.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL);
     tty.c_lflag = 0;
     tty.c_oflag = 0;
-    tty.c_cc[VMIN] = 0; // read non blocking
-    tty.c_cc[VTIME] = 5; // 0.5 seconds read timeout
+    //port is non blocking, waiting is done with poll(). VMIN=1 makes reads
+    //without data fail with EAGAIN, VMIN=0 would return 0 as at end of file
+    tty.c_cc[VMIN] = 1;
+    tty.c_cc[VTIME] = 0;
 
     tty.c_iflag &= ~(IXON | IXOFF | IXANY);
     tty.c_cflag |= (CLOCAL | CREAD);
@@ -212,6 +218,17 @@ int ConnectionEVB7COM::Open(const char *comName, int baudrate)
 //        MessageLog::getInstance()->write("Connection manager: error from tcsetattr\n", LOG_ERROR);
         return ReportError(errno, "error from tcgetattr");
     }
+    tcflush(hComm, TCIOFLUSH); //drop replies left from previous session
+
+#ifdef __linux__
+    //deliver received bytes immediately, not supported by all drivers
+    struct serial_struct serial;
+    if (ioctl(hComm, TIOCGSERIAL, &serial) == 0)
+    {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        ioctl(hComm, TIOCSSERIAL, &serial);
+    }
+#endif
 #endif
     return 0;
 }
@@ -228,47 +245,28 @@ int ConnectionEVB7COM::Write(const unsigned char *buffer, int length, int timeou
     {
         timeout_ms = COM_TOTAL_TIMEOUT;
     }
-    int retryCount = 0;
-    const int maxRetries = (timeout_ms/COM_RETRY_INTERVAL) > 1 ? (timeout_ms/COM_RETRY_INTERVAL) : 1;
-    bool status = false;
 #ifndef __unix__
-	unsigned long bytesWriten = 0;
-	m_osWOverlap.InternalHigh = 0;
+    const int maxRetries = (timeout_ms/COM_RETRY_INTERVAL) > 1 ? (timeout_ms/COM_RETRY_INTERVAL) : 1;
+    unsigned long totalBytesWriten = 0;
+    m_osWOverlap.InternalHigh = 0;
 
-	for(int i = 0; i<maxRetries && status == false; ++i)
+    for(int i = 0; i<maxRetries && totalBytesWriten < (unsigned long)length; ++i)
     {
-        if (!WriteFile(hComm, buffer, length , &bytesWriten, NULL))
-        {
-            status = false;
-        }
-        else
-            status = true;
-        ++retryCount;
+        unsigned long bytesWriten = 0;
+        if (WriteFile(hComm, buffer+totalBytesWriten, length-totalBytesWriten, &bytesWriten, NULL))
+            totalBytesWriten += bytesWriten;
     }
+    const int bytesWriten = totalBytesWriten;
 #else
-    long bytesWriten = 0;
-    for(int i = 0; i<maxRetries && bytesWriten == 0; ++i)
-    {
-        bytesWriten = write(hComm, buffer, length);
-        if(bytesWriten <= 0)
-        {
-//            if(bytesWriten < 0)
-//                MessageLog::getInstance()->write("COM PORT: error writing data\n", LOG_ERROR);
-//            if(bytesWriten == 0)
-//                MessageLog::getInstance()->write("COM PORT: data bytes sent 0\n", LOG_WARNING);
-            status = false;
-        }
-        else
-            status = true;
-        ++retryCount;
-    }
+    //waits for space in output buffer with poll() instead of retrying
+    int bytesWriten = PollWrite(hComm, (const char*)buffer, length, timeout_ms);
+    if(bytesWriten < 0)
+        bytesWriten = 0;
 #endif
-    if(bytesWriten == length)
-        status = true;
-    if(status == false);
+    if(bytesWriten != length)
         ReportError(EIO, "Failed to write data");
 
-	return bytesWriten;
+    return bytesWriten;
 }
 
 /** @brief Reads data from COM port
@@ -283,63 +281,25 @@ int ConnectionEVB7COM::Read(unsigned char *buffer, int length, int timeout_ms)
     {
         timeout_ms = COM_TOTAL_TIMEOUT;
     }
-    int retryCount = 0;
-    const int maxRetries = (timeout_ms/COM_RETRY_INTERVAL) > 1 ? (timeout_ms/COM_RETRY_INTERVAL) : 1;
-    bool status = false;
-
     memset(buffer, 0, length);
-	long bytesReaded = 0;
-	unsigned long totalBytesReaded = 0;
-	char cRawData[COM_BUFFER_LENGTH];
-	unsigned long bytesToRead = length;
-
-	memset(cRawData, '\0', sizeof(cRawData[0])*COM_BUFFER_LENGTH);
-
-	for(int i=0; i<maxRetries && status == false; ++i)
-    {
-        memset(cRawData, '\0', sizeof(cRawData[0])*COM_BUFFER_LENGTH);
 #ifndef __unix__
-
+    const int maxRetries = (timeout_ms/COM_RETRY_INTERVAL) > 1 ? (timeout_ms/COM_RETRY_INTERVAL) : 1;
+    unsigned long totalBytesReaded = 0;
+    for(int i=0; i<maxRetries && totalBytesReaded < (unsigned long)length; ++i)
+    {
+        //only remaining part, following bytes belong to next reply
         DWORD bytesReceived = 0;
-        if ( !ReadFile(hComm, cRawData, bytesToRead, &bytesReceived, NULL) )
-        {
-            status = false;
-        }
-
-        bytesReaded = bytesReceived;
+        if (ReadFile(hComm, buffer+totalBytesReaded, length-totalBytesReaded, &bytesReceived, NULL))
+            totalBytesReaded += bytesReceived;
+    }
 #else
-        bytesReaded = read(hComm, cRawData, bytesToRead);
-        if(bytesReaded <= 0)
-        {
-//            if(bytesReaded < 0)
-//                MessageLog::getInstance()->write("COM PORT: error reading data\n", LOG_ERROR);
-//            if(bytesReaded == 0)
-//                MessageLog::getInstance()->write("COM PORT: reading 0 bytes\n", LOG_WARNING);
-            status = false;
-        }
-#endif
-        retryCount++;
-
-        for(int j=0; j<bytesReaded; ++j)
-        {
-            buffer[totalBytesReaded+j] = cRawData[j];
-        }
-
-        totalBytesReaded += bytesReaded;
-        if(totalBytesReaded == bytesToRead)
-            status = true;
+    //data is read directly into caller's buffer, poll() wakes up as soon as bytes arrive
+    int totalBytesReaded = PollRead(hComm, (char*)buffer, length, timeout_ms);
+    if(totalBytesReaded < 0)
+    {
+        ReportError(errno, "Failed to read data");
+        totalBytesReaded = 0;
     }
-
-//    ss << " read(" << totalBytesReaded << "): ";
-//    for(unsigned int i=0; i<64; ++i)
-//        ss << int2hex(buffer[i], 1) << " ";
-//    ss <<  " - retries: " << retryCount-1 << endl;
-    //MessageLog::getInstance()->write(ss.str(), LOG_DATA);
-
-//	if(retryCount == maxRetries)
-//        MessageLog::getInstance()->write("COM PORT: read data timeout\n", LOG_WARNING);
-//
-//    if(totalBytesReaded > length)
-//        MessageLog::getInstance()->write("COM PORT: read data corrupted, received length > requested length\n", LOG_ERROR);
-	return totalBytesReaded;
+#endif
+    return totalBytesReaded;
 }
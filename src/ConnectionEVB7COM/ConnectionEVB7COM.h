@@ -40,6 +40,12 @@ private:
     int Write(const unsigned char *buffer, int length, int timeout_ms = 100);
     int Read(unsigned char *buffer, int length, int timeout_ms = 100);
 
+    //! serial stream keeps order of packets, checked with boardEmulator
+    int GetMaxPacketsInFlight(void) const
+    {
+        return 4;
+    }
+
     #ifndef __unix__
         HANDLE hComm;
         COMMTIMEOUTS m_ctmoNew;
@@ -1,4 +1,5 @@
 #include "ConnectionNovenaRF7.h"
+#include <cstring>
 
 using namespace lime;
 
@@ -61,10 +62,12 @@ int ConnectionNovenaRF7::StreamChannel::Write(const void* samples, const uint32_
 IStreamChannel::Info ConnectionNovenaRF7::StreamChannel::GetInfo()
 {
     Info stats;
+    memset(&stats,0,sizeof(stats));
     RingFIFO::BufferInfo info = fifo->GetInfo();
     stats.fifoSize = info.size;
     stats.fifoItemsCount = info.itemsFilled;
     stats.active = mActive;
+    stats.zeroCopy = false;
     if(config.isTx)
         stats.linkRate = 0;
     else
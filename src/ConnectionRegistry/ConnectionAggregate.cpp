@@ -0,0 +1,393 @@
+/**
+    @file ConnectionAggregate.cpp
+    @author Lime Microsystems
+    @brief Multiple connections combined into one time aligned receive stream
+*/
+
+#include "ConnectionAggregate.h"
+#include "ConnectionRegistry.h"
+#include "ErrorReporting.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ciso646>
+
+using namespace lime;
+
+//number of blocks buffered per channel between device thread and reader
+static const size_t queueBlocks = 64;
+
+ConnectionAggregate::ConnectionAggregate() :
+    mOwnsConnections(false),
+    mChannelsPerDevice(0),
+    mBlockSize(0),
+    mTerminate(false),
+    mStreaming(false)
+{
+    mAlignInfo.timestamp = 0;
+}
+
+ConnectionAggregate::~ConnectionAggregate()
+{
+    Close();
+}
+
+int ConnectionAggregate::Open(const std::vector<ConnectionHandle> &handles)
+{
+    Close();
+    if (handles.empty())
+        return ReportError(EINVAL, "No devices to aggregate");
+    std::vector<IConnection*> connections;
+    for (const auto &handle : handles)
+    {
+        IConnection* conn = ConnectionRegistry::makeConnection(handle);
+        if (conn == nullptr || not conn->IsOpen())
+        {
+            if (conn)
+                ConnectionRegistry::freeConnection(conn);
+            for (auto c : connections)
+                ConnectionRegistry::freeConnection(c);
+            return ReportError(ENODEV, "Failed to open %s", handle.serialize().c_str());
+        }
+        connections.push_back(conn);
+    }
+    mConnections = connections;
+    mOwnsConnections = true;
+    return 0;
+}
+
+int ConnectionAggregate::Attach(const std::vector<IConnection*> &connections)
+{
+    Close();
+    if (connections.empty())
+        return ReportError(EINVAL, "No devices to aggregate");
+    for (auto conn : connections)
+        if (conn == nullptr)
+            return ReportError(EINVAL, "Connection cannot be NULL");
+    mConnections = connections;
+    mOwnsConnections = false;
+    return 0;
+}
+
+void ConnectionAggregate::Close()
+{
+    Stop();
+    for (size_t i = 0; i < mStreamIDs.size(); ++i)
+        mConnections[i/mChannelsPerDevice]->CloseStream(mStreamIDs[i]);
+    mStreamIDs.clear();
+    mQueues.clear();
+    if (mOwnsConnections)
+        for (auto conn : mConnections)
+            ConnectionRegistry::freeConnection(conn);
+    mConnections.clear();
+    mOwnsConnections = false;
+    mChannelsPerDevice = 0;
+}
+
+size_t ConnectionAggregate::GetDevicesCount() const
+{
+    return mConnections.size();
+}
+
+IConnection* ConnectionAggregate::GetConnection(const size_t index) const
+{
+    return index < mConnections.size() ? mConnections[index] : nullptr;
+}
+
+size_t ConnectionAggregate::GetChannelsCount() const
+{
+    return mStreamIDs.size();
+}
+
+int ConnectionAggregate::SetupStreams(const unsigned channelsPerDevice, const StreamConfig::StreamDataFormat format, const size_t blockSize)
+{
+    if (mConnections.empty())
+        return ReportError(EINVAL, "No devices to aggregate");
+    if (format == StreamConfig::STREAM_COMPLEX_FLOAT32)
+        return ReportError(EINVAL, "Aggregate stream requires integer sample format");
+    if (channelsPerDevice == 0 || blockSize == 0)
+        return ReportError(EINVAL, "Invalid stream configuration");
+    Stop();
+    for (size_t i = 0; i < mStreamIDs.size(); ++i)
+        mConnections[i/mChannelsPerDevice]->CloseStream(mStreamIDs[i]);
+    mStreamIDs.clear();
+    mQueues.clear();
+
+    mChannelsPerDevice = channelsPerDevice;
+    mBlockSize = blockSize;
+    for (size_t dev = 0; dev < mConnections.size(); ++dev)
+    {
+        for (unsigned ch = 0; ch < channelsPerDevice; ++ch)
+        {
+            StreamConfig config;
+            config.isTx = false;
+            config.channelID = ch;
+            config.format = format;
+            config.linkFormat = (format == StreamConfig::STREAM_12_BIT_COMPRESSED) ? format : StreamConfig::STREAM_12_BIT_IN_16;
+            size_t streamID = 0;
+            if (mConnections[dev]->SetupStream(streamID, config) != 0)
+                return ReportError(EIO, "Device %i: failed to setup stream for channel %i", int(dev), int(ch));
+            mStreamIDs.push_back(streamID);
+
+            std::unique_ptr<ChannelQueue> queue(new ChannelQueue);
+            queue->offset = 0;
+            memset(&queue->stats, 0, sizeof(queue->stats));
+            for (size_t i = 0; i < queueBlocks; ++i)
+            {
+                std::unique_ptr<Block> block(new Block);
+                block->timestamp = 0;
+                block->size = 0;
+                block->samples.resize(blockSize);
+                queue->free.push_back(std::move(block));
+            }
+            mQueues.push_back(std::move(queue));
+        }
+    }
+    return 0;
+}
+
+int ConnectionAggregate::AlignTimestamps(const uint64_t timestamp)
+{
+    if (mConnections.empty())
+        return ReportError(EINVAL, "No devices to aggregate");
+    const double rate = mConnections[0]->GetHardwareTimestampRate();
+
+    //sample counters at the same moment, compensating read out delays
+    std::vector<int64_t> counters;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (auto conn : mConnections)
+    {
+        const double elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t0).count();
+        counters.push_back(int64_t(conn->GetHardwareTimestamp()) - int64_t(elapsed*rate));
+    }
+
+    const uint64_t target = timestamp != 0 ? timestamp : counters[0];
+    std::vector<int64_t> offsets;
+    for (size_t i = 0; i < counters.size(); ++i)
+    {
+        offsets.push_back(int64_t(target) - counters[i]);
+        lime::info("Aggregate: device %i timestamp offset %lli samples", int(i), (long long)offsets[i]);
+    }
+    mAlignInfo.timestamp = target;
+    mAlignInfo.offset = offsets;
+    return 0;
+}
+
+ConnectionAggregate::AlignInfo ConnectionAggregate::GetAlignInfo() const
+{
+    return mAlignInfo;
+}
+
+int ConnectionAggregate::Start()
+{
+    if (mStreamIDs.empty())
+        return ReportError(EINVAL, "Streams are not set up");
+    Stop();
+    for (size_t i = 0; i < mStreamIDs.size(); ++i)
+        if (mConnections[i/mChannelsPerDevice]->ControlStream(mStreamIDs[i], true) != 0)
+        {
+            for (size_t j = 0; j < i; ++j)
+                mConnections[j/mChannelsPerDevice]->ControlStream(mStreamIDs[j], false);
+            return ReportError(EIO, "Failed to start stream on device %i", int(i/mChannelsPerDevice));
+        }
+    mStreaming = true;
+
+    if (AlignTimestamps() != 0)
+    {
+        Stop();
+        return -1;
+    }
+
+    for (auto &queue : mQueues)
+    {
+        std::lock_guard<std::mutex> lock(queue->lock);
+        while (not queue->full.empty())
+        {
+            queue->free.push_back(std::move(queue->full.front()));
+            queue->full.pop_front();
+        }
+        if (queue->current)
+            queue->free.push_back(std::move(queue->current));
+        queue->offset = 0;
+        memset(&queue->stats, 0, sizeof(queue->stats));
+    }
+    mTerminate = false;
+    for (size_t dev = 0; dev < mConnections.size(); ++dev)
+        mThreads.push_back(std::thread(&ConnectionAggregate::DeviceLoop, this, dev));
+    return 0;
+}
+
+void ConnectionAggregate::Stop()
+{
+    mTerminate = true;
+    for (auto &queue : mQueues)
+        queue->hasData.notify_all();
+    for (auto &thread : mThreads)
+        thread.join();
+    mThreads.clear();
+    if (mStreaming)
+        for (size_t i = 0; i < mStreamIDs.size(); ++i)
+            mConnections[i/mChannelsPerDevice]->ControlStream(mStreamIDs[i], false);
+    mStreaming = false;
+}
+
+void ConnectionAggregate::DeviceLoop(const size_t device)
+{
+    IConnection* conn = mConnections[device];
+    const uint64_t alignedStart = mAlignInfo.timestamp;
+    const int64_t offset = mAlignInfo.offset[device];
+    std::vector<bool> aligned(mChannelsPerDevice, false);
+
+    while (not mTerminate)
+    {
+        for (unsigned ch = 0; ch < mChannelsPerDevice && not mTerminate; ++ch)
+        {
+            const size_t index = device*mChannelsPerDevice + ch;
+            ChannelQueue &queue = *mQueues[index];
+            std::unique_ptr<Block> block;
+            {
+                //reader holds at most one block, so there is always a free or full one
+                std::lock_guard<std::mutex> lock(queue.lock);
+                if (not queue.free.empty())
+                {
+                    block = std::move(queue.free.back());
+                    queue.free.pop_back();
+                }
+                else //reader is too slow, drop oldest data
+                {
+                    block = std::move(queue.full.front());
+                    queue.full.pop_front();
+                    ++queue.stats.overruns;
+                }
+            }
+
+            StreamMetadata meta;
+            const int ret = conn->ReadStream(mStreamIDs[index], block->samples.data(), mBlockSize, 100, meta);
+            block->size = ret > 0 ? ret : 0;
+            block->timestamp = meta.timestamp + offset;
+
+            //samples received before alignment carry old timestamps
+            if (not aligned[ch] && block->size > 0)
+            {
+                if (block->timestamp + block->size <= alignedStart)
+                    block->size = 0;
+                else
+                {
+                    const size_t skip = block->timestamp < alignedStart ? alignedStart - block->timestamp : 0;
+                    memmove(block->samples.data(), &block->samples[skip], (block->size-skip)*sizeof(complex16_t));
+                    block->size -= skip;
+                    block->timestamp += skip;
+                    aligned[ch] = true;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(queue.lock);
+            if (block->size > 0)
+            {
+                queue.full.push_back(std::move(block));
+                queue.hasData.notify_one();
+            }
+            else
+                queue.free.push_back(std::move(block));
+        }
+    }
+}
+
+bool ConnectionAggregate::NextBlock(ChannelQueue &queue, const int timeout_ms)
+{
+    std::unique_lock<std::mutex> lock(queue.lock);
+    if (queue.current)
+        queue.free.push_back(std::move(queue.current));
+    queue.offset = 0;
+    while (queue.full.empty())
+    {
+        if (mTerminate || queue.hasData.wait_for(lock, std::chrono::milliseconds(timeout_ms)) == std::cv_status::timeout)
+            if (queue.full.empty())
+                return false;
+    }
+    queue.current = std::move(queue.full.front());
+    queue.full.pop_front();
+    return true;
+}
+
+int ConnectionAggregate::Read(complex16_t* const* buffers, const size_t count, uint64_t &timestamp, const int timeout_ms)
+{
+    if (mQueues.empty())
+        return ReportError(EINVAL, "Streams are not set up");
+    auto t1 = std::chrono::high_resolution_clock::now();
+    size_t filled = 0;
+    while (filled < count)
+    {
+        const int elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - t1).count();
+        if (elapsed > timeout_ms)
+            break;
+
+        //every channel needs unread samples
+        bool ready = true;
+        for (auto &queue : mQueues)
+            if (not queue->current || queue->offset >= queue->current->size)
+                if (not NextBlock(*queue, timeout_ms - elapsed))
+                {
+                    ready = false;
+                    break;
+                }
+        if (not ready)
+            continue;
+
+        //align all channels to the latest first sample
+        uint64_t target = 0;
+        for (auto &queue : mQueues)
+            target = std::max(target, queue->current->timestamp + queue->offset);
+        const int64_t reference = mQueues[0]->current->timestamp + mQueues[0]->offset;
+        bool aligned = true;
+        for (auto &queue : mQueues)
+        {
+            const uint64_t position = queue->current->timestamp + queue->offset;
+            size_t skip = 0;
+            if (position < target)
+            {
+                skip = std::min<uint64_t>(target - position, queue->current->size - queue->offset);
+                queue->offset += skip;
+                if (queue->offset >= queue->current->size)
+                    aligned = false;
+            }
+            std::lock_guard<std::mutex> lock(queue->lock);
+            queue->stats.offset = int64_t(position) - reference;
+            queue->stats.alignDropped += skip;
+        }
+        if (not aligned)
+            continue;
+
+        //discontinuity, return samples collected so far
+        if (filled == 0)
+            timestamp = target;
+        else if (target != timestamp + filled)
+            break;
+
+        size_t samples = count - filled;
+        for (auto &queue : mQueues)
+            samples = std::min(samples, queue->current->size - queue->offset);
+        for (size_t i = 0; i < mQueues.size(); ++i)
+        {
+            ChannelQueue &queue = *mQueues[i];
+            memcpy(&buffers[i][filled], &queue.current->samples[queue.offset], samples*sizeof(complex16_t));
+            queue.offset += samples;
+            std::lock_guard<std::mutex> lock(queue.lock);
+            queue.stats.samplesRead += samples;
+        }
+        filled += samples;
+    }
+    return filled;
+}
+
+std::vector<ConnectionAggregate::ChannelStats> ConnectionAggregate::GetStats() const
+{
+    std::vector<ChannelStats> stats;
+    for (auto &queue : mQueues)
+    {
+        std::lock_guard<std::mutex> lock(queue->lock);
+        stats.push_back(queue->stats);
+    }
+    return stats;
+}
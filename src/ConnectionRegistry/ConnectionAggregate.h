@@ -0,0 +1,149 @@
+/**
+    @file ConnectionAggregate.h
+    @author Lime Microsystems
+    @brief Multiple connections combined into one time aligned receive stream
+*/
+
+#ifndef LIME_CONNECTION_AGGREGATE_H
+#define LIME_CONNECTION_AGGREGATE_H
+
+#include "LimeSuiteConfig.h"
+#include "IConnection.h"
+#include "dataTypes.h"
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+namespace lime
+{
+
+/** @brief Runs several boards as one multi-channel receiver.
+
+    Aggregate channel index is deviceIndex*channelsPerDevice + deviceChannel.
+    Stream timestamps are raw hardware counters of each device, so offset of
+    every counter to the common aggregate timeline is measured at start and
+    added to the received timestamps. Each device is read by its own thread
+    and Read() returns samples of all channels starting at the same timestamp.
+*/
+class LIME_API ConnectionAggregate
+{
+public:
+    //! Result of timestamp alignment
+    struct AlignInfo
+    {
+        uint64_t timestamp;             //!< aggregate timestamp at the moment of alignment
+        std::vector<int64_t> offset;    //!< per device value added to stream timestamps, in samples
+    };
+
+    //! Per channel stream statistics
+    struct ChannelStats
+    {
+        uint64_t samplesRead;           //!< samples returned by Read()
+        uint64_t alignDropped;          //!< samples discarded to align with other channels
+        unsigned overruns;              //!< blocks dropped because reader was too slow
+        int64_t offset;                 //!< last block timestamp offset against channel 0, in samples
+    };
+
+    ConnectionAggregate();
+    ~ConnectionAggregate();
+
+    /** @brief Creates connections from handles, connections are freed on Close()
+        @return 0 on success
+    */
+    int Open(const std::vector<ConnectionHandle> &handles);
+
+    /** @brief Uses already created connections, caller keeps ownership
+        @return 0 on success
+    */
+    int Attach(const std::vector<IConnection*> &connections);
+
+    //! Stops streaming and releases connections
+    void Close();
+
+    size_t GetDevicesCount() const;
+    IConnection* GetConnection(const size_t index) const;
+    size_t GetChannelsCount() const;
+
+    /** @brief Sets up receive streams on all devices
+        @param channelsPerDevice number of channels used on each device
+        @param format stream data format, must be integer format
+        @param blockSize samples read from device stream in one call
+        @return 0 on success
+    */
+    int SetupStreams(const unsigned channelsPerDevice, const StreamConfig::StreamDataFormat format = StreamConfig::STREAM_12_BIT_IN_16, const size_t blockSize = 4096);
+
+    /** @brief Measures offsets of device counters to common aggregate timeline
+        Counters are read one after another with GetHardwareTimestamp(), the host
+        time elapsed between calls is compensated. Device counters are not
+        modified, GetHardwareTimestamp() must report the counter of the stream
+        timestamps. Streams must be running for timestamps to advance.
+        Samples received before alignment are discarded by reader threads.
+        @param timestamp aggregate timestamp assigned to current time, 0 - counter of device 0
+        @return 0 on success
+    */
+    int AlignTimestamps(const uint64_t timestamp = 0);
+
+    //! Returns result of last AlignTimestamps()
+    AlignInfo GetAlignInfo() const;
+
+    /** @brief Starts device streams, aligns timestamps and starts reader threads
+        @return 0 on success
+    */
+    int Start();
+
+    //! Stops reader threads and device streams
+    void Stop();
+
+    /** @brief Reads time aligned samples of all channels
+        @param buffers destination buffer for each aggregate channel
+        @param count maximum number of samples per channel
+        @param [out] timestamp timestamp of the first returned sample
+        @param timeout_ms timeout in milliseconds
+        @return number of samples written to each buffer, less than count on
+        timeout or timestamp discontinuity
+    */
+    int Read(complex16_t* const* buffers, const size_t count, uint64_t &timestamp, const int timeout_ms = 1000);
+
+    std::vector<ChannelStats> GetStats() const;
+
+private:
+    struct Block
+    {
+        uint64_t timestamp;
+        size_t size;
+        std::vector<complex16_t> samples;
+    };
+
+    //! Bounded block queue between device thread and reader
+    struct ChannelQueue
+    {
+        std::deque<std::unique_ptr<Block>> full;
+        std::vector<std::unique_ptr<Block>> free;
+        std::unique_ptr<Block> current;     //!< block being consumed by reader
+        size_t offset;                      //!< samples of current block consumed
+        std::mutex lock;
+        std::condition_variable hasData;
+        ChannelStats stats;
+    };
+
+    void DeviceLoop(const size_t device);
+    bool NextBlock(ChannelQueue &queue, const int timeout_ms);
+
+    std::vector<IConnection*> mConnections;
+    bool mOwnsConnections;
+    unsigned mChannelsPerDevice;
+    size_t mBlockSize;
+    std::vector<size_t> mStreamIDs;
+    std::vector<std::unique_ptr<ChannelQueue>> mQueues;
+    std::vector<std::thread> mThreads;
+    std::atomic<bool> mTerminate;
+    bool mStreaming;
+    AlignInfo mAlignInfo;
+};
+
+}
+#endif
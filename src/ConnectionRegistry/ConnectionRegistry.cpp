@@ -9,6 +9,8 @@
 #include <mutex>
 #include <map>
 #include <memory>
+#include <future>
+#include <chrono>
 #include <iostream>
 #include <iso646.h> // alternative operators for visual c++: not, and, or...
 using namespace lime;
@@ -40,6 +42,115 @@ struct SharedConnection
 
 static std::map<std::string, std::shared_ptr<SharedConnection>> connectionCache;
 
+/*******************************************************************
+ * Enumeration cache
+ ******************************************************************/
+struct EnumerationCache
+{
+    EnumerationCache(void):
+        generation(0),
+        hotplugSupported(false),
+        hasHandles(false)
+    {
+        return;
+    }
+    unsigned long long generation; //incremented when results are dropped
+    bool hotplugSupported;
+    bool hasHandles;
+    std::chrono::steady_clock::time_point updated;
+    std::vector<ConnectionHandle> handles; //results for empty hint
+    std::map<std::string, std::vector<ConnectionHandle>> hinted; //results by serialized hint
+};
+
+//results of entries without hotplug notifications are reused only briefly
+static const std::chrono::seconds unnotifiedCacheLifetime(1);
+
+//separate from registry mutex, entries lock it from hotplug callbacks
+static std::mutex &cacheMutex(void)
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+static std::map<std::string, EnumerationCache> enumerationCache;
+
+static void dropCachedResults(EnumerationCache &cache)
+{
+    cache.generation++;
+    cache.hasHandles = false;
+    cache.handles.clear();
+    cache.hinted.clear();
+}
+
+static std::string hintKey(const ConnectionHandle &hint)
+{
+    ConnectionHandle key(hint);
+    key.module.clear(); //entry is already selected
+    return key.serialize();
+}
+
+/*!
+ * Look for cached enumeration results of registry entry.
+ * A hint which is a complete handle from previous enumeration
+ * is answered from the results for empty hint.
+ * \param [out] generation cache generation to store new results with
+ * \return true when results were found
+ */
+static bool cacheLookup(const std::string &name, const ConnectionHandle &hint, std::vector<ConnectionHandle> &handles, unsigned long long &generation)
+{
+    const std::string key = hintKey(hint);
+    std::lock_guard<std::mutex> lock(cacheMutex());
+    auto &cache = enumerationCache[name];
+    if (not cache.hotplugSupported and (cache.hasHandles or not cache.hinted.empty())
+        and std::chrono::steady_clock::now() - cache.updated > unnotifiedCacheLifetime)
+        dropCachedResults(cache);
+    generation = cache.generation;
+
+    if (cache.hasHandles)
+    {
+        if (key.empty())
+        {
+            handles = cache.handles;
+            return true;
+        }
+        for (const auto &handle : cache.handles)
+        {
+            if (handle.serialize() != key) continue;
+            handles.assign(1, handle);
+            return true;
+        }
+    }
+    auto iter = cache.hinted.find(key);
+    if (iter == cache.hinted.end()) return false;
+    handles = iter->second;
+    return true;
+}
+
+static void cacheStore(const std::string &name, const ConnectionHandle &hint, const std::vector<ConnectionHandle> &handles, const unsigned long long generation)
+{
+    const std::string key = hintKey(hint);
+    std::lock_guard<std::mutex> lock(cacheMutex());
+    auto &cache = enumerationCache[name];
+    //devices changed during enumeration, results may be stale
+    if (cache.generation != generation) return;
+
+    if (not cache.hasHandles and cache.hinted.empty())
+        cache.updated = std::chrono::steady_clock::now();
+    if (key.empty())
+    {
+        cache.handles = handles;
+        cache.hasHandles = true;
+    }
+    else cache.hinted[key] = handles;
+}
+
+static std::vector<ConnectionHandle> enumerateEntry(const std::string &name, ConnectionRegistryEntry *entry, const ConnectionHandle &hint, const unsigned long long generation)
+{
+    auto handles = entry->enumerate(hint);
+    cacheStore(name, hint, handles, generation);
+    return handles;
+}
+
 /*******************************************************************
  * Registry implementation
  ******************************************************************/
@@ -48,16 +159,32 @@ std::vector<ConnectionHandle> ConnectionRegistry::findConnections(const Connecti
     __loadAllConnections();
     std::lock_guard<std::mutex> lock(registryMutex());
 
-    std::vector<ConnectionHandle> results;
+    //entries without cached results are enumerated in parallel
+    std::vector<std::string> names;
+    std::vector<std::vector<ConnectionHandle>> entryHandles;
+    std::vector<std::future<std::vector<ConnectionHandle>>> pending;
     for (const auto &entry : registryEntries)
     {
         //filter by module name when specified
         if (not hint.module.empty() and hint.module != entry.first) continue;
 
-        for (auto handle : entry.second->enumerate(hint))
+        names.push_back(entry.first);
+        entryHandles.emplace_back();
+        pending.emplace_back();
+        unsigned long long generation;
+        if (cacheLookup(entry.first, hint, entryHandles.back(), generation)) continue;
+        pending.back() = std::async(std::launch::async, &enumerateEntry, entry.first, entry.second, hint, generation);
+    }
+
+    //collect in registry order
+    std::vector<ConnectionHandle> results;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (pending[i].valid()) entryHandles[i] = pending[i].get();
+        for (auto handle : entryHandles[i])
         {
             //insert the module name, which can be filtered on in makeConnection()
-            handle.module = entry.first;
+            handle.module = names[i];
             results.push_back(handle);
         }
     }
@@ -76,7 +203,10 @@ IConnection *ConnectionRegistry::makeConnection(const ConnectionHandle &handle)
         //filter by module name when specified
         if (not handle.module.empty() and handle.module != entry.first) continue;
 
-        const auto r = entry.second->enumerate(handle);
+        std::vector<ConnectionHandle> r;
+        unsigned long long generation;
+        if (not cacheLookup(entry.first, handle, r, generation))
+            r = enumerateEntry(entry.first, entry.second, handle, generation);
         if (r.empty()) continue;
 
         auto realHandle = r.front(); //just pick the first
@@ -99,7 +229,10 @@ IConnection *ConnectionRegistry::makeConnection(const ConnectionHandle &handle)
             catch (...)
             {
                 //factory failed, erase entry and re-throw
+                //device may be gone, so enumerate it again next time
                 connectionCache.erase(realHandle.serialize());
+                std::lock_guard<std::mutex> cacheLock(cacheMutex());
+                dropCachedResults(enumerationCache[entry.first]);
                 throw;
             }
         }
@@ -153,10 +286,28 @@ ConnectionRegistryEntry::ConnectionRegistryEntry(const std::string &name):
 {
     std::lock_guard<std::mutex> lock(registryMutex());
     registryEntries[_name] = this;
+    std::lock_guard<std::mutex> cacheLock(cacheMutex());
+    enumerationCache.erase(_name);
 }
 
 ConnectionRegistryEntry::~ConnectionRegistryEntry(void)
 {
     std::lock_guard<std::mutex> lock(registryMutex());
     registryEntries.erase(_name);
+    std::lock_guard<std::mutex> cacheLock(cacheMutex());
+    enumerationCache.erase(_name);
+}
+
+void ConnectionRegistryEntry::hotplugEvent(void)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex());
+    dropCachedResults(enumerationCache[_name]);
+}
+
+void ConnectionRegistryEntry::setHotplugSupported(const bool supported)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex());
+    auto &cache = enumerationCache[_name];
+    cache.hotplugSupported = supported;
+    dropCachedResults(cache);
 }
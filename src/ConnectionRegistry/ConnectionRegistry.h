@@ -28,6 +28,8 @@ public:
     /*!
      * Discovery identifiers that can be used to create a connection.
      * The hint may contain a connection type, serial number, ip address, etc.
+     * Registry entries are enumerated in parallel and the results are cached,
+     * see ConnectionRegistryEntry::hotplugEvent().
      * \param hint an optional connection handle with some fields filled-in
      * \return a list of handles which can be used to make a connection
      */
@@ -93,6 +95,22 @@ public:
      */
     virtual IConnection *make(const ConnectionHandle &handle) = 0;
 
+protected:
+
+    /*!
+     * Drop cached enumeration results of this entry.
+     * Entries which detect device arrival and removal
+     * call this from their hotplug notification.
+     */
+    void hotplugEvent(void);
+
+    /*!
+     * When hotplug is supported enumeration results are kept
+     * until hotplugEvent() is called, otherwise the results
+     * are reused only for a short time (one second).
+     */
+    void setHotplugSupported(const bool supported);
+
 private:
     std::string _name;
 };
@@ -35,7 +35,8 @@ StreamConfig::StreamConfig(void):
     performanceLatency(0.5),
     bufferLength(0),
     format(STREAM_12_BIT_IN_16),
-    linkFormat(STREAM_12_BIT_IN_16)
+    linkFormat(STREAM_12_BIT_IN_16),
+    decodeWorkers(0)
 {
     return;
 }
@@ -248,7 +249,7 @@ int IConnection::ProgramRead(char *buffer, const size_t length, const int index,
     return -1;
 }
 
-int IConnection::ProgramUpdate(const bool download, ProgrammingCallback callback)
+int IConnection::ProgramUpdate(const bool download, ProgrammingCallback callback, const bool force)
 {
     return 0;
 }
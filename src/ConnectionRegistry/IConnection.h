@@ -158,6 +158,12 @@ struct LIME_API StreamConfig
      * Default: STREAM_12_BIT_IN_16
      */
     StreamDataFormat linkFormat;
+
+    /*!
+     * Number of threads converting received packets to samples.
+     * Default: 0, samples are converted by the transfer thread
+     */
+    unsigned decodeWorkers;
 };
 
 /*!
@@ -513,12 +519,15 @@ public:
      *
      * - If the board has a programmable flash for firmware and gateware,
      *   then up-to-date images will be written to the flash on the board.
+     *   Images with versions matching the running ones are skipped unless
+     *   force is set, which rewrites possibly corrupted flash contents.
      *
      * @param download true to enable downloading missing images
      * @param callback callback for progress reporting or early termination
+     * @param force true to write images even when versions match
      * @return 0-success
      */
-    virtual int ProgramUpdate(const bool download = true, ProgrammingCallback callback = 0);
+    virtual int ProgramUpdate(const bool download = true, ProgrammingCallback callback = 0, const bool force = false);
 
     /***********************************************************************
      * GPIO API
@@ -640,6 +649,12 @@ public:
         float linkRate;
         int droppedPackets;
         uint64_t timestamp;
+        //! true when transfers use kernel mapped buffers (no user/kernel copy)
+        bool zeroCopy;
+        //! received blocks waiting for decode workers
+        int decodeQueue;
+        //! decoded blocks waiting for earlier blocks to complete
+        int reorderQueue;
     };
     IStreamChannel(){};
     IStreamChannel(IConnection* port, StreamConfig conf){};
@@ -652,6 +667,7 @@ public:
         enum
         {
             SYNC_TIMESTAMP = 1,
+            DROPPED_SAMPLES = 2, //!< samples before returned ones were lost
         };
         uint64_t timestamp;
         uint32_t flags;
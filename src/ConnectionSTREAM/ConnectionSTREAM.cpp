@@ -15,6 +15,8 @@
 #include <fstream>
 #include <thread>
 #include <chrono>
+#include <mutex>
+#include <map>
 
 using namespace std;
 
@@ -75,6 +77,7 @@ ConnectionSTREAM::ConnectionSTREAM(void *arg, const std::string &vidpid, const s
     dev_handle = nullptr;
     ctx = (libusb_context *)arg;
 #endif
+    auto t0 = std::chrono::steady_clock::now();
     if (this->Open(vidpid, serial, index) != 0)
         lime::error(GetLastErrorMessage());
 
@@ -88,9 +91,21 @@ ConnectionSTREAM::ConnectionSTREAM(void *arg, const std::string &vidpid, const s
     }
 
     this->VersionCheck();
+    auto t1 = std::chrono::steady_clock::now();
 
     if (info.device == LMS_DEV_LIMESDR || info.device == LMS_DEV_LIMESDR_USB_SP || info.device == LMS_DEV_LMS7002M_ULTIMATE_EVB)
-        DetectRefClk();
+    {
+        //reference clock is fixed for a board, measure it only once per process
+        double refClk = GetCachedRefClk(info);
+        if (refClk > 0)
+        {
+            this->SetReferenceClockRate(refClk);
+            lime::info("Reference clock %1.3f MHz (previously detected)", refClk/1e6);
+        }
+        else if ((refClk = DetectRefClk()) > 0)
+            SetCachedRefClk(info, refClk);
+    }
+    auto t2 = std::chrono::steady_clock::now();
 
     GetChipVersion();
     //must configure synthesizer before using LimeSDR
@@ -110,11 +125,60 @@ ConnectionSTREAM::ConnectionSTREAM(void *arg, const std::string &vidpid, const s
             lime::warning("Failed to configure Si5351C");
             return;
         }
-        status = si5351module->UploadConfiguration();
-        if (status != Si5351C::SUCCESS)
-            lime::warning("Failed to upload Si5351C configuration");
-        std::this_thread::sleep_for(std::chrono::milliseconds(10)); //some settle time
+        //board was already configured by previous session
+        if (si5351module->IsConfigurationLoaded())
+            lime::debug("Si5351C configuration unchanged, upload skipped");
+        else
+        {
+            status = si5351module->UploadConfiguration();
+            if (status != Si5351C::SUCCESS)
+                lime::warning("Failed to upload Si5351C configuration");
+            std::this_thread::sleep_for(std::chrono::milliseconds(10)); //some settle time
+        }
     }
+    auto t3 = std::chrono::steady_clock::now();
+    lime::debug("ConnectionSTREAM startup: open %.1f ms, reference clock %.1f ms, clock generator %.1f ms",
+        std::chrono::duration<double, std::milli>(t1-t0).count(),
+        std::chrono::duration<double, std::milli>(t2-t1).count(),
+        std::chrono::duration<double, std::milli>(t3-t2).count());
+}
+
+static std::mutex &refClkCacheLock()
+{
+    static std::mutex lock;
+    return lock;
+}
+
+//detected reference clocks, key is board serial number and hardware, firmware versions
+static std::map<std::string, double> &refClkCache()
+{
+    static std::map<std::string, double> cache;
+    return cache;
+}
+
+static std::string refClkKey(const LMS64CProtocol::LMSinfo &info)
+{
+    return std::to_string(info.boardSerialNumber) + ":" + std::to_string(info.hardware) + ":" + std::to_string(info.firmware);
+}
+
+/** @brief Returns reference clock detected for the same board earlier in this process
+    @return reference clock in Hz, 0 if not available
+*/
+double ConnectionSTREAM::GetCachedRefClk(const LMSinfo &info)
+{
+    if (info.boardSerialNumber == 0)
+        return 0;
+    std::lock_guard<std::mutex> lock(refClkCacheLock());
+    auto iter = refClkCache().find(refClkKey(info));
+    return iter == refClkCache().end() ? 0 : iter->second;
+}
+
+void ConnectionSTREAM::SetCachedRefClk(const LMSinfo &info, const double refClk)
+{
+    if (info.boardSerialNumber == 0)
+        return;
+    std::lock_guard<std::mutex> lock(refClkCacheLock());
+    refClkCache()[refClkKey(info)] = refClk;
 }
 
 double ConnectionSTREAM::DetectRefClk(void)
@@ -109,7 +109,7 @@ public:
     virtual int UpdateExternalDataRate(const size_t channel, const double txRate, const double rxRate) override;
     virtual int UpdateExternalDataRate(const size_t channel, const double txRate, const double rxRate, const double txPhase, const double rxPhase) override;
     virtual int ProgramWrite(const char *buffer, const size_t length, const int programmingMode, const int device, ProgrammingCallback callback) override;
-    int ProgramUpdate(const bool download, ProgrammingCallback callback);
+    int ProgramUpdate(const bool download, ProgrammingCallback callback, const bool force);
     int ReadRawStreamData(char* buffer, unsigned length, int epIndex, int timeout_ms = 100)override;
 protected:
     virtual void ReceivePacketsLoop(Streamer* args) override;
@@ -127,10 +127,15 @@ protected:
     virtual int FinishDataSending(const char* buffer, uint32_t length, int contextHandle);
     virtual void AbortSending(int ep);
 
+    virtual char* AllocateStreamBuffer(const uint32_t length, bool &deviceMemory);
+    virtual void FreeStreamBuffer(char* buffer, const uint32_t length, const bool deviceMemory);
+
     int ResetStreamBuffers() override;
     eConnectionType GetType(void) {return USB_PORT;}
 
     double DetectRefClk(void);
+    double GetCachedRefClk(const LMSinfo &info);
+    void SetCachedRefClk(const LMSinfo &info, const double refClk);
 
     USBTransferContext contexts[USB_MAX_CONTEXTS];
     USBTransferContext contextsToSend[USB_MAX_CONTEXTS];
@@ -184,6 +189,10 @@ protected:
     std::thread mUSBProcessingThread;
     void handle_libusb_events();
     std::atomic<bool> mProcessUSBEvents;
+    void RegisterHotplug();
+    static int LIBUSB_CALL HotplugCallback(libusb_context *ctx, libusb_device *device, libusb_hotplug_event event, void *user_data);
+    libusb_hotplug_callback_handle mHotplugHandle;
+    bool mHotplugRegistered;
 #endif
 };
 
@@ -21,6 +21,34 @@ void ConnectionSTREAMEntry::handle_libusb_events()
         if(r != 0) lime::error("error libusb_handle_events %s", libusb_strerror(libusb_error(r)));
     }
 }
+
+/** @brief Drops cached enumeration results when any USB device is attached or removed.
+    Called from libusb event handling thread.
+*/
+int LIBUSB_CALL ConnectionSTREAMEntry::HotplugCallback(libusb_context *ctx, libusb_device *device, libusb_hotplug_event event, void *user_data)
+{
+    ConnectionSTREAMEntry* entry = static_cast<ConnectionSTREAMEntry*>(user_data);
+    entry->hotplugEvent();
+    return 0; //keep callback registered
+}
+
+void ConnectionSTREAMEntry::RegisterHotplug()
+{
+    mHotplugRegistered = false;
+    if (libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG) == 0)
+        return;
+    int r = libusb_hotplug_register_callback(ctx,
+        libusb_hotplug_event(LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT),
+        libusb_hotplug_flag(0), LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY,
+        HotplugCallback, this, &mHotplugHandle);
+    if (r != LIBUSB_SUCCESS)
+    {
+        lime::warning("libusb hotplug registration failed: %s", libusb_strerror(libusb_error(r)));
+        return;
+    }
+    mHotplugRegistered = true;
+    setHotplugSupported(true);
+}
 #endif // __UNIX__
 
 //! make a static-initialized entry in the registry
@@ -41,6 +69,7 @@ ConnectionSTREAMEntry::ConnectionSTREAMEntry(void):
     libusb_set_debug(ctx, 3); //set verbosity level to 3, as suggested in the documentation
     mProcessUSBEvents.store(true);
     mUSBProcessingThread = std::thread(&ConnectionSTREAMEntry::handle_libusb_events, this);
+    RegisterHotplug();
 #endif
 }
 
@@ -54,12 +83,15 @@ ConnectionSTREAMEntry::ConnectionSTREAMEntry(const std::string entryName):
     libusb_set_debug(ctx, 3); //set verbosity level to 3, as suggested in the documentation
     mProcessUSBEvents.store(true);
     mUSBProcessingThread = std::thread(&ConnectionSTREAMEntry::handle_libusb_events, this);
+    RegisterHotplug();
 #endif
 }
 
 ConnectionSTREAMEntry::~ConnectionSTREAMEntry(void)
 {
 #ifdef __unix__
+    if (mHotplugRegistered)
+        libusb_hotplug_deregister_callback(ctx, mHotplugHandle);
     mProcessUSBEvents.store(false);
     mUSBProcessingThread.join();
     libusb_exit(ctx);
@@ -99,7 +99,7 @@ static bool programmingCallbackStream(
     return callback(bsent, btotal, msg.c_str());
 }
 
-int ConnectionSTREAM::ProgramUpdate(const bool download, IConnection::ProgrammingCallback callback)
+int ConnectionSTREAM::ProgramUpdate(const bool download, IConnection::ProgrammingCallback callback, const bool force)
 {
     const auto info = this->GetInfo();
     const auto &entry = lookupImageEntry(info);
@@ -110,10 +110,23 @@ int ConnectionSTREAM::ProgramUpdate(const bool download, IConnection::Programmin
         return lime::ReportError("Unsupported hardware connected: %s[HW=%d]", GetDeviceName(info.device), info.hardware);
     }
 
+    //images already running on the board are not flashed again unless forced
+    const bool updateFirmware = force or info.firmware != entry.fw_ver;
+    const auto fpgaInfo = this->GetFPGAInfo();
+    const bool updateGateware = force or fpgaInfo.gatewareVersion != entry.gw_ver
+        or fpgaInfo.gatewareRevision != entry.gw_rev;
+    if (not updateFirmware and not updateGateware)
+    {
+        if (callback) callback(1, 1, "Firmware and gateware are up to date");
+        return 0;
+    }
+
     //download images when missing
     if (download)
     {
-        const std::vector<std::string> images = {entry.fw_img, entry.gw_rbf};
+        std::vector<std::string> images;
+        if (updateFirmware) images.push_back(entry.fw_img);
+        if (updateGateware) images.push_back(entry.gw_rbf);
         for (const auto &image : images)
         {
             if (not lime::locateImageResource(image).empty()) continue;
@@ -126,6 +139,7 @@ int ConnectionSTREAM::ProgramUpdate(const bool download, IConnection::Programmin
     }
 
     //load firmware into flash
+    if (updateFirmware)
     {
         //open file
         std::ifstream file;
@@ -150,6 +164,7 @@ int ConnectionSTREAM::ProgramUpdate(const bool download, IConnection::Programmin
     }
 
     //load gateware into flash
+    if (updateGateware)
     {
         //open file
         std::ifstream file;
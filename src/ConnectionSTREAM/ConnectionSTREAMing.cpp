@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <complex>
 #include <ciso646>
+#include <new>
 #include <FPGA_common.h>
 #include "ErrorReporting.h"
 #include "Logger.h"
@@ -205,6 +206,47 @@ int ConnectionSTREAM::ReadRawStreamData(char* buffer, unsigned length, int epInd
     return totalBytesReceived;
 }
 
+/** @brief Allocates memory for streaming transfers
+    On Linux the memory is mapped from usbfs, so bulk transfers are done without
+    copying data between kernel and user space. Falls back to ordinary memory
+    when kernel or libusb does not support it.
+    @param length number of bytes to allocate
+    @param deviceMemory returns true if buffer is mapped from usbfs
+    @return buffer pointer, nullptr on failure
+*/
+char* ConnectionSTREAM::AllocateStreamBuffer(const uint32_t length, bool &deviceMemory)
+{
+    deviceMemory = false;
+#if defined(__unix__) && defined(LIBUSB_API_VERSION) && (LIBUSB_API_VERSION >= 0x01000105)
+    if(dev_handle != nullptr)
+    {
+        unsigned char* buffer = libusb_dev_mem_alloc(dev_handle, length);
+        if(buffer != nullptr)
+        {
+            deviceMemory = true;
+            return (char*)buffer;
+        }
+    }
+#endif
+    return new (std::nothrow) char[length]();
+}
+
+/** @brief Releases memory allocated by AllocateStreamBuffer()
+*/
+void ConnectionSTREAM::FreeStreamBuffer(char* buffer, const uint32_t length, const bool deviceMemory)
+{
+    if(buffer == nullptr)
+        return;
+#if defined(__unix__) && defined(LIBUSB_API_VERSION) && (LIBUSB_API_VERSION >= 0x01000105)
+    if(deviceMemory)
+    {
+        libusb_dev_mem_free(dev_handle, (unsigned char*)buffer, length);
+        return;
+    }
+#endif
+    delete [] buffer;
+}
+
 /** @brief Function dedicated for receiving data samples from board
     @param stream a pointer to an active receiver stream
 */
@@ -220,7 +262,6 @@ void ConnectionSTREAM::ReceivePacketsLoop(Streamer* stream)
     const uint32_t bufferSize = packetsToBatch*sizeof(FPGA_DataPacket);
     const uint8_t buffersCount = 16;
     vector<int> handles(buffersCount, 0);
-    vector<char>buffers(buffersCount*bufferSize, 0);
     vector<StreamChannel::Frame> chFrames;
     try
     {
@@ -231,6 +272,17 @@ void ConnectionSTREAM::ReceivePacketsLoop(Streamer* stream)
         ReportError("Error allocating Rx buffers, not enough memory");
         return;
     }
+    bool zeroCopy = false;
+    char* buffers = AllocateStreamBuffer(buffersCount*bufferSize, zeroCopy);
+    if(buffers == nullptr)
+    {
+        ReportError("Error allocating Rx buffers, not enough memory");
+        return;
+    }
+    stream->rxZeroCopy.store(zeroCopy);
+
+    //optional decode workers, transfers are resubmitted without waiting for conversion
+    std::unique_ptr<RxDecodePipeline> decoder = stream->CreateRxDecoder(bufferSize);
 
     for (int i = 0; i<buffersCount; ++i)
         handles[i] = this->BeginDataReading(&buffers[i*bufferSize], bufferSize, ep);
@@ -307,6 +359,8 @@ void ConnectionSTREAM::ReceivePacketsLoop(Streamer* stream)
             }
             prevTs = pkt[pktIndex].counter;
             stream->rxLastTimestamp.store(prevTs);
+            if (decoder)
+                continue;
             //parse samples
             vector<complex16_t*> dest(chCount);
             for(uint8_t c=0; c<chCount; ++c)
@@ -323,6 +377,8 @@ void ConnectionSTREAM::ReceivePacketsLoop(Streamer* stream)
                     stream->mRxStreams[ch]->overflow++;
             }
         }
+        if (decoder)
+            stream->SubmitRxPackets(decoder.get(), (const FPGA_DataPacket*)&buffers[bi*bufferSize], bytesReceived / sizeof(FPGA_DataPacket));
         // Re-submit this request to keep the queue full
         handles[bi] = this->BeginDataReading(&buffers[bi*bufferSize], bufferSize, ep);
         bi = (bi + 1) & (buffersCount-1);
@@ -353,6 +409,8 @@ void ConnectionSTREAM::ReceivePacketsLoop(Streamer* stream)
     }
     resetTxFlags.notify_one();
     txReset.join();
+    FreeStreamBuffer(buffers, buffersCount*bufferSize, zeroCopy);
+    stream->rxZeroCopy.store(false);
     stream->rxDataRate_Bps.store(0);
 }
 
@@ -376,17 +434,20 @@ void ConnectionSTREAM::TransmitPacketsLoop(Streamer* stream)
     vector<int> handles(buffersCount, 0);
     vector<bool> bufferUsed(buffersCount, 0);
     vector<complex16_t> samples[maxChannelCount];
-    vector<char> buffers;
     try
     {
         for(int i=0; i<chCount; ++i)
             samples[i].resize(maxSamplesBatch);
-        buffers.resize(buffersCount*bufferSize, 0);
     }
     catch (const std::bad_alloc& ex) //not enough memory for buffers
     {
         return lime::error("Error allocating Tx buffers, not enough memory");
     }
+    bool zeroCopy = false;
+    char* buffers = AllocateStreamBuffer(buffersCount*bufferSize, zeroCopy);
+    if(buffers == nullptr)
+        return lime::error("Error allocating Tx buffers, not enough memory");
+    stream->txZeroCopy.store(zeroCopy);
 
     long totalBytesSent = 0;
     auto t1 = chrono::high_resolution_clock::now();
@@ -478,6 +539,8 @@ void ConnectionSTREAM::TransmitPacketsLoop(Streamer* stream)
         }
         bi = (bi + 1) & (buffersCount-1);
     }
+    FreeStreamBuffer(buffers, buffersCount*bufferSize, zeroCopy);
+    stream->txZeroCopy.store(false);
     stream->txRunning.store(false);
     stream->txDataRate_Bps.store(0);
 }
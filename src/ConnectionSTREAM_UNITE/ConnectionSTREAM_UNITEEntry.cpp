@@ -18,7 +18,8 @@ static ConnectionSTREAM_UNITEEntry STREAM_UNITEEntry;
 ConnectionSTREAM_UNITEEntry::ConnectionSTREAM_UNITEEntry(void):
     ConnectionSTREAMEntry("STREAM+UNITE")
 {
-
+    //serial ports are listed too, USB hotplug events do not cover them
+    setHotplugSupported(false);
 }
 
 ConnectionSTREAM_UNITEEntry::~ConnectionSTREAM_UNITEEntry(void)
@@ -21,6 +21,7 @@
 #include <LMS7002M.h>
 #include <ciso646>
 #include "Logger.h"
+#include "AsyncBlockIO.h"
 
 #include <thread>
 #include <chrono>
@@ -281,11 +282,9 @@ int ConnectionXillybus::Write(const unsigned char *buffer, const int length, int
         }
         CloseHandle(vOverlapped.hEvent);
 #else
-        int bytesSent;
-        if ((bytesSent  = write(hWrite, buffer+ totalBytesWritten, bytesToWrite))<0)
+        int bytesSent = PollWrite(hWrite, (const char*)buffer + totalBytesWritten, bytesToWrite, timeout_ms);
+        if (bytesSent < 0)
         {
-            if(errno == EINTR || errno == EAGAIN)
-                 continue;
             ReportError(errno);
             return totalBytesWritten;
         }
@@ -356,11 +355,9 @@ int ConnectionXillybus::Read(unsigned char *buffer, const int length, int timeou
         }
         CloseHandle(vOverlapped.hEvent);
 #else
-        int bytesReceived;
-        if ((bytesReceived = read(hRead, buffer+ totalBytesReaded, bytesToRead))<0)
+        int bytesReceived = PollRead(hRead, (char*)buffer + totalBytesReaded, bytesToRead, timeout_ms);
+        if (bytesReceived < 0)
         {
-           if(errno == EINTR || errno == EAGAIN)
-               continue;
            ReportError(errno);
            return totalBytesReaded;
         }
@@ -438,11 +435,10 @@ int ConnectionXillybus::ReceiveData(char *buffer, int length, int epIndex, int t
         }
         CloseHandle(vOverlapped.hEvent);
 #else
-        int bytesReceived;
-        if ((bytesReceived = read(hReadStream[epIndex], buffer+ totalBytesReaded, bytesToRead))<0)
+        //wait for data with poll() instead of spinning on EAGAIN
+        int bytesReceived = PollRead(hReadStream[epIndex], buffer + totalBytesReaded, bytesToRead, timeout_ms);
+        if (bytesReceived < 0)
         {
-            if(errno == EINTR || errno == EAGAIN)
-                continue;
             ReportError(errno);
             return totalBytesReaded;
         }
@@ -539,11 +535,10 @@ int ConnectionXillybus::SendData(const char *buffer, int length, int epIndex, in
         }
         CloseHandle(vOverlapped.hEvent);
 #else
-        int bytesSent;
-        if ((bytesSent  = write(hWriteStream[epIndex], buffer+ totalBytesWritten, bytesToWrite))<0)
+        //wait for space with poll() instead of spinning on EAGAIN
+        int bytesSent = PollWrite(hWriteStream[epIndex], buffer + totalBytesWritten, bytesToWrite, timeout_ms);
+        if (bytesSent < 0)
         {
-            if(errno == EINTR || errno == EAGAIN)
-                continue;
             ReportError(errno);
             return totalBytesWritten;
         }
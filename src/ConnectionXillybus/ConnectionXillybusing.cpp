@@ -16,6 +16,7 @@
 #include <FPGA_common.h>
 #include <ErrorReporting.h>
 #include "Logger.h"
+#include "AsyncBlockIO.h"
 
 using namespace std;
 using namespace lime;
@@ -206,7 +207,13 @@ void ConnectionXillybus::ReceivePacketsLoop(Streamer* stream)
 
     const uint8_t packetsToBatch = stream->rxBatchSize*2;
     const uint32_t bufferSize = packetsToBatch*sizeof(FPGA_DataPacket);
-    vector<char>buffers(bufferSize, 0);
+    //device reads run in background, next batches are read while this one is decoded
+    AsyncBlockReader reader([this, epIndex](char* buffer, int length, int timeout_ms)
+        {
+            return this->ReceiveData(buffer, length, epIndex, timeout_ms);
+        }, bufferSize, 3);
+    //optional decode workers, next batch is read without waiting for conversion
+    std::unique_ptr<RxDecodePipeline> decoder = stream->CreateRxDecoder(bufferSize);
     vector<StreamChannel::Frame> chFrames;
     try
     {
@@ -247,11 +254,13 @@ void ConnectionXillybus::ReceivePacketsLoop(Streamer* stream)
 
     int resetFlagsDelay = 128;
     uint64_t prevTs = 0;
+    reader.Start();
     while (stream->terminateRx.load() == false)
     {
-        int32_t bytesReceived = 0;
-
-        bytesReceived = this->ReceiveData(&buffers[0], bufferSize, epIndex, 1000);
+        const char* buffer = nullptr;
+        int32_t bytesReceived = reader.Acquire(buffer, 1000);
+        if (bytesReceived < 0)
+            bytesReceived = 0;
         totalBytesReceived += bytesReceived;
         if (bytesReceived != int32_t(bufferSize)) //data should come in full sized packets
             for(auto value: stream->mRxStreams)
@@ -260,7 +269,7 @@ void ConnectionXillybus::ReceivePacketsLoop(Streamer* stream)
         bool txLate=false;
         for (uint8_t pktIndex = 0; pktIndex < bytesReceived / sizeof(FPGA_DataPacket); ++pktIndex)
         {
-            const FPGA_DataPacket* pkt = (FPGA_DataPacket*)&buffers[0];
+            const FPGA_DataPacket* pkt = (const FPGA_DataPacket*)buffer;
             const uint8_t byte0 = pkt[pktIndex].reserved[0];
             if ((byte0 & (1 << 3)) != 0 && !txLate) //report only once per batch
             {
@@ -289,6 +298,8 @@ void ConnectionXillybus::ReceivePacketsLoop(Streamer* stream)
             }
             prevTs = pkt[pktIndex].counter;
             stream->rxLastTimestamp.store(pkt[pktIndex].counter);
+            if (decoder)
+                continue;
             //parse samples
             vector<complex16_t*> dest(chCount);
             for(uint8_t c=0; c<chCount; ++c)
@@ -306,6 +317,9 @@ void ConnectionXillybus::ReceivePacketsLoop(Streamer* stream)
             }
         }
 
+        if (decoder)
+            stream->SubmitRxPackets(decoder.get(), (const FPGA_DataPacket*)buffer, bytesReceived / sizeof(FPGA_DataPacket));
+
         t2 = chrono::high_resolution_clock::now();
         auto timePeriod = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
         if (timePeriod >= 1000)
@@ -319,7 +333,9 @@ void ConnectionXillybus::ReceivePacketsLoop(Streamer* stream)
             totalBytesReceived = 0;
             stream->rxDataRate_Bps.store((uint32_t)dataRate);
         }
+        reader.Release();
     }
+    reader.Stop();
     AbortReading(epIndex);
     resetTxFlags.notify_one();
     txReset.join();
@@ -344,12 +360,15 @@ void ConnectionXillybus::TransmitPacketsLoop(Streamer* stream)
     const uint32_t popTimeout_ms = 500;
     const int maxSamplesBatch = (packed ? 1360:1020)/chCount;
     vector<complex16_t> samples[maxChannelCount];
-    vector<char> buffers;
+    //device writes run in background, next batch is packed while previous ones are sent
+    AsyncBlockWriter writer([this, epIndex](const char* buffer, int length, int timeout_ms)
+        {
+            return this->SendData(buffer, length, epIndex, timeout_ms);
+        }, bufferSize, 3);
     try
     {
         for(int i=0; i<chCount; ++i)
             samples[i].resize(maxSamplesBatch);
-        buffers.resize(bufferSize, 0);
     }
     catch (const std::bad_alloc& ex) //not enough memory for buffers
     {
@@ -357,18 +376,23 @@ void ConnectionXillybus::TransmitPacketsLoop(Streamer* stream)
         return;
     }
 
-    long totalBytesSent = 0;
+    uint64_t totalBytesSent = 0;
+    uint32_t failedWrites = 0;
     auto t1 = chrono::high_resolution_clock::now();
     auto t2 = t1;
 
+    writer.Start();
     while (stream->terminateTx.load() != true)
     {
         int i=0;
+        char* buffer = writer.Acquire(popTimeout_ms);
+        if (buffer == nullptr)
+            continue;
 
         while(i<packetsToBatch)
         {
             IStreamChannel::Metadata meta;
-            FPGA_DataPacket* pkt = reinterpret_cast<FPGA_DataPacket*>(&buffers[0]);
+            FPGA_DataPacket* pkt = reinterpret_cast<FPGA_DataPacket*>(buffer);
             for(int ch=0; ch<chCount; ++ch)
             {
                 int samplesPopped = stream->mTxStreams[ch]->Read(samples[ch].data(), maxSamplesBatch, &meta, popTimeout_ms);
@@ -398,22 +422,25 @@ void ConnectionXillybus::TransmitPacketsLoop(Streamer* stream)
             ++i;
         }
 
-        uint32_t bytesSent = this->SendData(&buffers[0], bufferSize, epIndex, 1000);
-        if (bytesSent != bufferSize){
+        if (i < packetsToBatch) //early termination, batch is incomplete
+            break;
+        writer.Commit(bufferSize);
+        if (writer.GetFailedWrites() != failedWrites)
+        {
+            failedWrites = writer.GetFailedWrites();
             for (auto value : stream->mTxStreams)
-		value->overflow++;
+                value->overflow++;
         }
-        else
-            totalBytesSent += bytesSent;
 
         t2 = chrono::high_resolution_clock::now();
         auto timePeriod = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
         if (timePeriod >= 1000)
         {
             //total number of bytes sent per second
-            float dataRate = 1000.0*totalBytesSent / timePeriod;
+            const uint64_t bytesSent = writer.GetBytesTransferred();
+            float dataRate = 1000.0*(bytesSent - totalBytesSent) / timePeriod;
             stream->txDataRate_Bps.store(dataRate);
-            totalBytesSent = 0;
+            totalBytesSent = bytesSent;
             t1 = t2;
 #ifndef NDEBUG
             printf("Tx: %.3f MB/s\n", dataRate / 1000000.0);
@@ -422,6 +449,7 @@ void ConnectionXillybus::TransmitPacketsLoop(Streamer* stream)
     }
 
     // Wait for all the queued requests to be cancelled
+    writer.Stop();
     AbortSending(epIndex);
     stream->txRunning.store(false);
     stream->txDataRate_Bps.store(0);
@@ -261,6 +261,9 @@ void Connection_uLimeSDR::ReceivePacketsLoop(Connection_uLimeSDR::Streamer* stre
         return;
     }
 
+    //optional decode workers, transfers are resubmitted without waiting for conversion
+    std::unique_ptr<RxDecodePipeline> decoder = stream->CreateRxDecoder(bufferSize);
+
     for (int i = 0; i<buffersCount; ++i)
         handles[i] = this->BeginDataReading(&buffers[i*bufferSize], bufferSize);
 
@@ -338,6 +341,8 @@ void Connection_uLimeSDR::ReceivePacketsLoop(Connection_uLimeSDR::Streamer* stre
             }
             prevTs = pkt[pktIndex].counter;
             stream->rxLastTimestamp.store(pkt[pktIndex].counter);
+            if (decoder)
+                continue;
             //parse samples
             vector<complex16_t*> dest(chCount);
             for(uint8_t c=0; c<chCount; ++c)
@@ -354,6 +359,8 @@ void Connection_uLimeSDR::ReceivePacketsLoop(Connection_uLimeSDR::Streamer* stre
                     droppedSamples += samplesCount-samplesPushed;
             }
         }
+        if (decoder)
+            stream->SubmitRxPackets(decoder.get(), (const FPGA_DataPacket*)&buffers[bi*bufferSize], bytesReceived / sizeof(FPGA_DataPacket));
         // Re-submit this request to keep the queue full
         handles[bi] = this->BeginDataReading(&buffers[bi*bufferSize], bufferSize);
         bi = (bi + 1) & (buffersCount-1);
@@ -0,0 +1,101 @@
+/**
+    @file FFTPlanCache.cpp
+    @author Lime Microsystems
+    @brief Shared cache of kiss_fft plans and work buffers
+*/
+
+#include "FFTPlanCache.h"
+#include <map>
+#include <vector>
+#include <mutex>
+#include <utility>
+#include <ciso646>
+
+using namespace lime;
+
+struct FFTPlan::Entry
+{
+    Entry(const int size, const bool inverse) :
+        size(size),
+        inverse(inverse),
+        cfg(kiss_fft_alloc(size, inverse ? 1 : 0, nullptr, nullptr)),
+        in(size),
+        out(size)
+    {
+    }
+    ~Entry()
+    {
+        kiss_fft_free(cfg);
+    }
+    const int size;
+    const bool inverse;
+    kiss_fft_cfg cfg;
+    std::vector<kiss_fft_cpx> in;
+    std::vector<kiss_fft_cpx> out;
+};
+
+//idle plans, key is size and direction
+typedef std::map<std::pair<int, bool>, std::vector<FFTPlan::Entry*>> PlanMap;
+
+static std::mutex &CacheLock()
+{
+    static std::mutex lock;
+    return lock;
+}
+
+static PlanMap &Cache()
+{
+    static PlanMap cache;
+    return cache;
+}
+
+FFTPlan::FFTPlan(const int size, const bool inverse) :
+    mEntry(nullptr)
+{
+    {
+        std::lock_guard<std::mutex> lock(CacheLock());
+        auto &idle = Cache()[std::make_pair(size, inverse)];
+        if (not idle.empty())
+        {
+            mEntry = idle.back();
+            idle.pop_back();
+        }
+    }
+    if (mEntry == nullptr)
+        mEntry = new Entry(size, inverse);
+}
+
+FFTPlan::~FFTPlan()
+{
+    std::lock_guard<std::mutex> lock(CacheLock());
+    Cache()[std::make_pair(mEntry->size, mEntry->inverse)].push_back(mEntry);
+}
+
+kiss_fft_cpx* FFTPlan::In() const
+{
+    return mEntry->in.data();
+}
+
+kiss_fft_cpx* FFTPlan::Out() const
+{
+    return mEntry->out.data();
+}
+
+int FFTPlan::Size() const
+{
+    return mEntry->size;
+}
+
+void FFTPlan::Execute()
+{
+    kiss_fft(mEntry->cfg, mEntry->in.data(), mEntry->out.data());
+}
+
+void FFTPlan::ClearCache()
+{
+    std::lock_guard<std::mutex> lock(CacheLock());
+    for (auto &sizePlans : Cache())
+        for (auto entry : sizePlans.second)
+            delete entry;
+    Cache().clear();
+}
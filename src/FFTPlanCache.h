@@ -0,0 +1,51 @@
+/**
+    @file FFTPlanCache.h
+    @author Lime Microsystems
+    @brief Shared cache of kiss_fft plans and work buffers
+*/
+
+#ifndef LIME_FFT_PLAN_CACHE_H
+#define LIME_FFT_PLAN_CACHE_H
+
+#include "LimeSuiteConfig.h"
+#include "kiss_fft.h"
+
+namespace lime
+{
+
+/** @brief FFT plan with input and output buffers taken from shared cache.
+
+    Plans are kept per size and direction, constructing FFTPlan reuses an idle
+    plan when available instead of calling kiss_fft_alloc() and allocating
+    buffers. Each object is used by one thread at a time, any number of objects
+    of the same size may exist concurrently.
+*/
+class LIME_API FFTPlan
+{
+public:
+    FFTPlan(const int size, const bool inverse = false);
+    ~FFTPlan();
+
+    //! Input samples buffer, Size() elements
+    kiss_fft_cpx* In() const;
+    //! Output bins buffer, Size() elements
+    kiss_fft_cpx* Out() const;
+    int Size() const;
+
+    //! Transforms In() to Out()
+    void Execute();
+
+    //! Releases idle plans
+    static void ClearCache();
+
+    //! Cached plan state, opaque to users
+    struct Entry;
+
+private:
+    FFTPlan(const FFTPlan&);
+    FFTPlan &operator=(const FFTPlan&);
+    Entry* mEntry;
+};
+
+}
+#endif
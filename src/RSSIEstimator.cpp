@@ -0,0 +1,142 @@
+/**
+    @file RSSIEstimator.cpp
+    @author Lime Microsystems
+    @brief Host RSSI estimate from a burst of streamed samples
+*/
+
+#include "RSSIEstimator.h"
+#include "IConnection.h"
+#include "dataTypes.h"
+#include "ErrorReporting.h"
+#include "FFTPlanCache.h"
+#include "windowFunction.h"
+#include <algorithm>
+#include <cmath>
+#include <ciso646>
+
+using namespace lime;
+
+static const int blackmanHarris = 1;
+static const long readTimeout_ms = 500;
+
+RSSIEstimator::Config::Config() :
+    method(POWER),
+    frequency(0),
+    sampleRate(1),
+    windowSize(4096),
+    averages(1),
+    skipSamples(8192)
+{
+}
+
+static unsigned WindowSize(const RSSIEstimator::Config &config)
+{
+    return std::max(config.windowSize, 16u);
+}
+
+RSSIEstimator::RSSIEstimator(const Config &cfg) :
+    config(cfg),
+    window(GetWindowCoefficients(blackmanHarris, WindowSize(cfg)))
+{
+    config.windowSize = WindowSize(cfg);
+    config.averages = std::max(config.averages, 1u);
+    if (config.sampleRate <= 0)
+        config.sampleRate = 1;
+    buffer.resize(2*std::max(config.windowSize, 1024u));
+    windowSum = 0;
+    for (float w : window)
+        windowSum += w;
+}
+
+const RSSIEstimator::Config &RSSIEstimator::GetConfig() const
+{
+    return config;
+}
+
+double RSSIEstimator::Estimate(const complex16_t* samples)
+{
+    const unsigned N = config.windowSize;
+    if (config.method == GOERTZEL)
+    {
+        //complex input, recursion coefficient is real so I and Q run together
+        const double w = 2*M_PI*config.frequency/config.sampleRate;
+        const double coef = 2*std::cos(w);
+        double s1i = 0, s1q = 0, s2i = 0, s2q = 0;
+        for (unsigned n = 0; n < N; ++n)
+        {
+            const double si = window[n]*samples[n].i + coef*s1i - s2i;
+            const double sq = window[n]*samples[n].q + coef*s1q - s2q;
+            s2i = s1i; s2q = s1q;
+            s1i = si; s1q = sq;
+        }
+        //y = s1 - e^(-jw)*s2
+        const double yi = s1i - (std::cos(w)*s2i + std::sin(w)*s2q);
+        const double yq = s1q - (std::cos(w)*s2q - std::sin(w)*s2i);
+        return std::sqrt(yi*yi + yq*yq)/windowSum;
+    }
+    else if (config.method == FFT_BIN)
+    {
+        FFTPlan plan(N);
+        kiss_fft_cpx* in = plan.In();
+        for (unsigned n = 0; n < N; ++n)
+        {
+            in[n].r = window[n]*samples[n].i;
+            in[n].i = window[n]*samples[n].q;
+        }
+        plan.Execute();
+        int bin = int(std::lround(config.frequency/config.sampleRate*N)) % int(N);
+        if (bin < 0)
+            bin += N;
+        const kiss_fft_cpx &out = plan.Out()[bin];
+        return std::sqrt(double(out.r)*out.r + double(out.i)*out.i)/windowSum;
+    }
+    int64_t sum = 0;
+    for (unsigned n = 0; n < N; ++n)
+        sum += int32_t(samples[n].i)*samples[n].i + int32_t(samples[n].q)*samples[n].q;
+    return std::sqrt(double(sum)/N);
+}
+
+int RSSIEstimator::Measure(IConnection* port, const size_t streamID, double &amplitude, const unsigned averageCount)
+{
+    const unsigned averages = averageCount ? averageCount : config.averages;
+    const size_t bufferSamples = buffer.size()/2;
+    complex16_t* samples = (complex16_t*)buffer.data();
+
+    //start clears FIFO of running stream, samples received after it are newer than last change
+    int status = port->ControlStream(streamID, true);
+    if (status != 0)
+        return status;
+    for (size_t skipped = 0; skipped < config.skipSamples; )
+    {
+        StreamMetadata meta;
+        const size_t count = std::min(bufferSamples, config.skipSamples - skipped);
+        const int received = port->ReadStream(streamID, samples, count, readTimeout_ms, meta);
+        if (received <= 0)
+            return ReportError(ETIMEDOUT, "RSSI estimator: no samples received");
+        skipped += received;
+    }
+
+    double power = 0;
+    for (unsigned a = 0; a < averages; ++a)
+    {
+        for (unsigned received = 0; received < config.windowSize; )
+        {
+            StreamMetadata meta;
+            const int count = port->ReadStream(streamID, samples + received, config.windowSize - received, readTimeout_ms, meta);
+            if (count <= 0)
+                return ReportError(ETIMEDOUT, "RSSI estimator: no samples received");
+            received += count;
+        }
+        const double estimate = Estimate(samples);
+        power += estimate*estimate;
+    }
+    amplitude = std::sqrt(power/averages);
+    return 0;
+}
+
+uint32_t RSSIEstimator::AmplitudeToRSSI(const double amplitude)
+{
+    //12 bit full scale 2048 maps to 0x10000, chip RSSI 0x0B000 is about -3 dBFS
+    const double rssi = amplitude*32;
+    return rssi < 0x3FFFF ? uint32_t(rssi) : 0x3FFFF;
+}
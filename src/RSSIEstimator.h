@@ -0,0 +1,82 @@
+/**
+    @file RSSIEstimator.h
+    @author Lime Microsystems
+    @brief Host RSSI estimate from a burst of streamed samples
+*/
+
+#ifndef LIME_RSSI_ESTIMATOR_H
+#define LIME_RSSI_ESTIMATOR_H
+
+#include "LimeSuiteConfig.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lime
+{
+
+class IConnection;
+struct complex16_t;
+
+/** @brief Measures signal amplitude from received samples instead of chip RSSI.
+
+    One measurement restarts the stream to drop samples received before the
+    last register change, skips settling samples and averages power of
+    several windows. Amplitude is either RMS of all samples or magnitude of
+    single tone, computed by Goertzel filter or FFT bin with Blackman-Harris
+    window. Samples are 12 bit values in 16 bit integers.
+*/
+class LIME_API RSSIEstimator
+{
+public:
+    enum Method
+    {
+        POWER,      //!< RMS amplitude of all samples
+        GOERTZEL,   //!< tone amplitude at frequency, any frequency
+        FFT_BIN,    //!< tone amplitude of FFT bin nearest to frequency
+    };
+
+    struct Config
+    {
+        Config();
+        Method method;
+        double frequency;       //!< tone frequency for GOERTZEL and FFT_BIN, units of sampleRate
+        double sampleRate;      //!< 1 when frequency is given in cycles per sample
+        unsigned windowSize;    //!< samples per estimate, power of two for FFT_BIN
+        unsigned averages;      //!< estimates averaged in one measurement
+        unsigned skipSamples;   //!< samples dropped after stream restart
+    };
+
+    RSSIEstimator(const Config &config = Config());
+    const Config &GetConfig() const;
+
+    /** @brief Amplitude of one window
+        @param samples config.windowSize samples
+        @return amplitude in sample units
+    */
+    double Estimate(const complex16_t* samples);
+
+    /** @brief Reads fresh samples from stream and averages estimates
+        @param port connection of stream, started by this call
+        @param streamID stream set up with STREAM_12_BIT_IN_16 format
+        @param amplitude[out] RMS of window amplitudes
+        @param averages windows averaged, 0 for config.averages
+        @return 0 on success
+    */
+    int Measure(IConnection* port, const size_t streamID, double &amplitude, const unsigned averages = 0);
+
+    /** @brief Converts amplitude to scale of chip RSSI, full scale tone is about 0x10000.
+        Relative thresholds of calibration searches hold, absolute values differ
+        from chip RSSI by its filtering and averaging.
+    */
+    static uint32_t AmplitudeToRSSI(const double amplitude);
+
+private:
+    Config config;
+    const std::vector<float> &window;
+    double windowSum; //!< tone amplitude gain of window
+    std::vector<int16_t> buffer;
+};
+
+}
+#endif
@@ -0,0 +1,95 @@
+/**
+@file	SeriesDecimation.cpp
+@author Lime Microsystems
+@brief	Min/max decimation of graph series to display resolution
+*/
+
+#include "SeriesDecimation.h"
+
+//index of first point with X not less than x
+static size_t LowerBound(const float* valuesXY, const size_t count, const double x)
+{
+    size_t first = 0;
+    size_t length = count;
+    while (length > 0)
+    {
+        const size_t half = length/2;
+        if (valuesXY[2*(first+half)] < x)
+        {
+            first += half+1;
+            length -= half+1;
+        }
+        else
+            length = half;
+    }
+    return first;
+}
+
+static inline void AddPoint(const float* valuesXY, const size_t index, std::vector<float> &out)
+{
+    out.push_back(valuesXY[2*index]);
+    out.push_back(valuesXY[2*index+1]);
+}
+
+size_t DecimateMinMax(const float* valuesXY, const size_t count, const double x1, const double x2, const int columns, std::vector<float> &out)
+{
+    out.clear();
+    if (columns <= 0 || x2 <= x1 || count <= size_t(2*columns+2))
+        return 0;
+    for (size_t i = 1; i < count; ++i)
+        if (valuesXY[2*i] < valuesXY[2*(i-1)])
+            return 0;
+
+    const size_t first = LowerBound(valuesXY, count, x1);
+    size_t last = LowerBound(valuesXY, count, x2);
+    while (last < count && valuesXY[2*last] <= x2)
+        ++last;
+    const size_t begin = first > 0 ? first-1 : 0;
+    const size_t end = last < count ? last+1 : count;
+
+    //zoomed in, visible points already fit
+    if (end-begin <= size_t(2*columns+2))
+    {
+        out.assign(valuesXY+2*begin, valuesXY+2*end);
+        return end-begin;
+    }
+
+    out.reserve(2*(2*columns+2));
+    if (begin < first)
+        AddPoint(valuesXY, begin, out);
+    const double scale = columns/(x2-x1);
+    int column = -1;
+    size_t minIndex = 0;
+    size_t maxIndex = 0;
+    for (size_t i = first; i < last; ++i)
+    {
+        int c = int((valuesXY[2*i]-x1)*scale);
+        if (c >= columns)
+            c = columns-1;
+        const float y = valuesXY[2*i+1];
+        if (c != column)
+        {
+            if (column >= 0)
+            {
+                AddPoint(valuesXY, minIndex < maxIndex ? minIndex : maxIndex, out);
+                if (minIndex != maxIndex)
+                    AddPoint(valuesXY, minIndex < maxIndex ? maxIndex : minIndex, out);
+            }
+            column = c;
+            minIndex = maxIndex = i;
+        }
+        else if (y < valuesXY[2*minIndex+1])
+            minIndex = i;
+        else if (y > valuesXY[2*maxIndex+1])
+            maxIndex = i;
+    }
+    if (column >= 0)
+    {
+        AddPoint(valuesXY, minIndex < maxIndex ? minIndex : maxIndex, out);
+        if (minIndex != maxIndex)
+            AddPoint(valuesXY, minIndex < maxIndex ? maxIndex : minIndex, out);
+    }
+    if (last < end)
+        AddPoint(valuesXY, last, out);
+    return out.size()/2;
+}
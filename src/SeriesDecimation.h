@@ -0,0 +1,33 @@
+/**
+@file	SeriesDecimation.h
+@author Lime Microsystems
+@brief	Min/max decimation of graph series to display resolution
+*/
+
+#ifndef OGL_SERIES_DECIMATION_H
+#define OGL_SERIES_DECIMATION_H
+
+#include "LimeSuiteConfig.h"
+#include <vector>
+#include <cstddef>
+
+/**
+	@brief Reduces series to minimum and maximum of each pixel column.
+
+	Only points within visible X range are taken, plus one point on each side
+	so lines continue to the view edges. Each column keeps its lowest and
+	highest point in original order, so envelope of the signal and peaks are
+	drawn exactly as with all points. Output has at most 2*columns+2 points.
+
+	@param valuesXY interleaved X and Y values, X must not decrease
+	@param count number of XY pairs
+	@param x1 visible area start
+	@param x2 visible area end
+	@param columns width of visible area in pixels
+	@param out decimated interleaved X and Y values
+	@return number of XY pairs in out, 0 if series should be drawn unchanged:
+	X is not increasing (constellation) or series already fits
+*/
+LIME_API size_t DecimateMinMax(const float* valuesXY, const size_t count, const double x1, const double x2, const int columns, std::vector<float> &out);
+
+#endif
@@ -0,0 +1,481 @@
+/**
+    @file SharedStream.cpp
+    @author Lime Microsystems
+    @brief Receive stream shared with other processes through POSIX shared memory
+*/
+
+#include "SharedStream.h"
+#include "ErrorReporting.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <ciso646>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+using namespace lime;
+
+static const uint32_t sharedStreamMagic = 0x4C534852; //"LSHR"
+static const uint32_t sharedStreamVersion = 2;
+//header is followed by chunk descriptions and samples
+static const size_t headerSize = 256;
+
+/** @brief Layout at the start of shared memory ring.
+    Samples [committed-capacity, committed) are valid unless reserved has
+    already moved past them, readers check reserved after copying. When
+    timestamps jump, publisher continues at the next chunk, so all samples
+    of a chunk share one timestamp offset.
+*/
+struct lime::SharedStreamHeader
+{
+    std::atomic<uint32_t> magic; //!< set last, when ring is initialized
+    uint32_t version;
+    uint32_t format;
+    uint32_t sampleSize;
+    uint64_t capacity;          //!< ring size in samples, power of two
+    uint64_t chunkSize;         //!< samples sharing one timestamp offset
+    double sampleRate;
+    std::atomic<uint32_t> active;
+    std::atomic<uint32_t> droppedPackets;
+    std::atomic<uint32_t> sequence; //!< incremented after each publish, futex word
+    std::atomic<uint64_t> reserved; //!< end of samples being written
+    std::atomic<uint64_t> committed;//!< end of samples available to readers
+};
+
+static std::string SharedMemoryName(const std::string &name)
+{
+    return "/limesuite-" + name;
+}
+
+static size_t SampleSize(const StreamConfig::StreamDataFormat format)
+{
+    return format == StreamConfig::STREAM_COMPLEX_FLOAT32 ? 2*sizeof(float) : 2*sizeof(int16_t);
+}
+
+//! Samples of one chunk, written before samples are committed
+struct SharedStreamChunk
+{
+    std::atomic<uint64_t> offset;   //!< timestamp - index of samples
+    std::atomic<uint64_t> end;      //!< index after last sample, below chunk end when timestamps jump after it
+};
+
+//chunk descriptions follow header
+static SharedStreamChunk* Chunks(const SharedStreamHeader* header)
+{
+    return (SharedStreamChunk*)((char*)header + headerSize);
+}
+
+static size_t SamplesOffset(const uint64_t capacity, const uint64_t chunkSize)
+{
+    const size_t chunksSize = capacity/chunkSize*sizeof(SharedStreamChunk);
+    return (headerSize + chunksSize + 63)/64*64;
+}
+
+static void WakeReaders(SharedStreamHeader* header)
+{
+#ifdef __linux__
+    syscall(SYS_futex, &header->sequence, FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+//! Waits until sequence changes from given value or timeout passes
+static void WaitForPublish(const SharedStreamHeader* header, const uint32_t sequence, const std::chrono::microseconds timeout)
+{
+#ifdef __linux__
+    //limited wait in case wake up is missed because of producer restart
+    const auto wait = std::min(timeout, std::chrono::microseconds(10000));
+    struct timespec ts;
+    ts.tv_sec = wait.count()/1000000;
+    ts.tv_nsec = (wait.count()%1000000)*1000;
+    syscall(SYS_futex, &header->sequence, FUTEX_WAIT, sequence, &ts, nullptr, 0);
+#else
+    std::this_thread::sleep_for(std::min(timeout, std::chrono::microseconds(100)));
+#endif
+}
+
+/***********************************************************************
+ * Publisher
+ **********************************************************************/
+SharedStreamPublisher::SharedStreamPublisher() :
+    header(nullptr),
+    mappedSize(0),
+    samples(nullptr),
+    sampleSize(0),
+    source(nullptr),
+    terminate(false)
+{
+}
+
+SharedStreamPublisher::~SharedStreamPublisher()
+{
+    Close();
+}
+
+int SharedStreamPublisher::Open(const std::string &name, const size_t capacity, const StreamConfig::StreamDataFormat format, const double sampleRate)
+{
+    Close();
+#ifdef _WIN32
+    return ReportError(ENOTSUP, "Shared memory streams are not supported on this platform");
+#else
+    uint64_t ringSize = 4096;
+    while (ringSize < capacity)
+        ringSize *= 2;
+    const uint64_t chunkSize = std::min(uint64_t(1024), ringSize/16);
+    sampleSize = SampleSize(format);
+    const size_t samplesOffset = SamplesOffset(ringSize, chunkSize);
+    const size_t size = samplesOffset + ringSize*sampleSize;
+
+    const std::string shm = SharedMemoryName(name);
+    shm_unlink(shm.c_str());
+    int fd = shm_open(shm.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+        return ReportError(errno, "Failed to create shared memory %s: %s", shm.c_str(), strerror(errno));
+    if (ftruncate(fd, size) != 0)
+    {
+        const int err = errno;
+        close(fd);
+        shm_unlink(shm.c_str());
+        return ReportError(err, "Failed to resize shared memory %s: %s", shm.c_str(), strerror(err));
+    }
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED)
+    {
+        const int err = errno;
+        shm_unlink(shm.c_str());
+        return ReportError(err, "Failed to map shared memory %s: %s", shm.c_str(), strerror(err));
+    }
+
+    //new object is zero filled, which is valid initial state of atomics
+    header = (SharedStreamHeader*)mem;
+    header->version = sharedStreamVersion;
+    header->format = format;
+    header->sampleSize = sampleSize;
+    header->capacity = ringSize;
+    header->chunkSize = chunkSize;
+    header->sampleRate = sampleRate;
+    header->active.store(1);
+    header->magic.store(sharedStreamMagic, std::memory_order_release);
+    samples = (char*)mem + samplesOffset;
+    mappedSize = size;
+    shmName = shm;
+    return 0;
+#endif
+}
+
+void SharedStreamPublisher::Close()
+{
+    Detach();
+#ifndef _WIN32
+    if (header == nullptr)
+        return;
+    header->active.store(0);
+    header->sequence.fetch_add(1, std::memory_order_release);
+    WakeReaders(header);
+    munmap(header, mappedSize);
+    shm_unlink(shmName.c_str());
+#endif
+    header = nullptr;
+    samples = nullptr;
+}
+
+void SharedStreamPublisher::Publish(const void* data, const size_t count, uint64_t timestamp)
+{
+    if (header == nullptr)
+        return;
+    const uint64_t capacity = header->capacity;
+    const uint64_t chunkSize = header->chunkSize;
+    const uint64_t chunks = capacity/chunkSize;
+    SharedStreamChunk* chunkInfo = Chunks(header);
+    const char* src = (const char*)data;
+    uint64_t end = header->committed.load(std::memory_order_relaxed);
+
+    //pieces of half ring, so readers at the tail can still complete their copy
+    for (size_t done = 0; done < count; )
+    {
+        const size_t n = std::min(size_t(capacity/2), count - done);
+        uint64_t start = end;
+        //timestamps jump, rest of the last chunk is left unused
+        if (start % chunkSize != 0
+            and chunkInfo[(start/chunkSize) % chunks].offset.load(std::memory_order_relaxed) != timestamp - start)
+            start += chunkSize - start % chunkSize;
+        end = start + n;
+        header->reserved.store(end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const size_t index = start & (capacity-1);
+        const size_t first = std::min(size_t(capacity - index), n);
+        memcpy(samples + index*sampleSize, src, first*sampleSize);
+        memcpy(samples, src + first*sampleSize, (n-first)*sampleSize);
+        for (uint64_t chunk = start/chunkSize; chunk <= (end-1)/chunkSize; ++chunk)
+        {
+            chunkInfo[chunk % chunks].offset.store(timestamp - start, std::memory_order_relaxed);
+            chunkInfo[chunk % chunks].end.store(std::min(end, (chunk+1)*chunkSize), std::memory_order_relaxed);
+        }
+
+        header->committed.store(end, std::memory_order_release);
+        header->sequence.fetch_add(1, std::memory_order_release);
+        src += n*sampleSize;
+        timestamp += n;
+        done += n;
+    }
+    WakeReaders(header);
+}
+
+int SharedStreamPublisher::Attach(IStreamChannel* stream)
+{
+    Detach();
+    if (header == nullptr)
+        return ReportError(EINVAL, "Shared stream is not open");
+    int status = stream->Start();
+    if (status != 0)
+        return status;
+    source = stream;
+    terminate.store(false);
+    publishThread = std::thread(&SharedStreamPublisher::PublishLoop, this);
+    return 0;
+}
+
+void SharedStreamPublisher::Detach()
+{
+    if (source == nullptr)
+        return;
+    terminate.store(true);
+    publishThread.join();
+    source->Stop();
+    source = nullptr;
+}
+
+uint64_t SharedStreamPublisher::GetPublishedCount() const
+{
+    return header ? header->committed.load() : 0;
+}
+
+void SharedStreamPublisher::PublishLoop()
+{
+    const size_t blockSize = std::min(size_t(16384), size_t(header->capacity/4));
+    std::vector<char> buffer(blockSize*sampleSize);
+    while (not terminate.load())
+    {
+        IStreamChannel::Metadata meta;
+        meta.flags = 0;
+        meta.timestamp = 0;
+        const int count = source->Read(buffer.data(), blockSize, &meta, 100);
+        if (count <= 0)
+            continue;
+        header->droppedPackets.store(source->GetInfo().droppedPackets, std::memory_order_relaxed);
+        Publish(buffer.data(), count, meta.timestamp);
+    }
+}
+
+/***********************************************************************
+ * Reader
+ **********************************************************************/
+SharedStreamReader::SharedStreamReader() :
+    header(nullptr),
+    mappedSize(0),
+    samples(nullptr),
+    sampleSize(0),
+    position(0),
+    active(false),
+    overruns(0),
+    lost(0)
+{
+}
+
+SharedStreamReader::~SharedStreamReader()
+{
+    Close();
+}
+
+int SharedStreamReader::Open(const std::string &name)
+{
+    Close();
+#ifdef _WIN32
+    return ReportError(ENOTSUP, "Shared memory streams are not supported on this platform");
+#else
+    const std::string shm = SharedMemoryName(name);
+    int fd = shm_open(shm.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return ReportError(errno, "Failed to open shared memory %s: %s", shm.c_str(), strerror(errno));
+    struct stat st;
+    if (fstat(fd, &st) != 0 or size_t(st.st_size) < headerSize)
+    {
+        close(fd);
+        return ReportError(EINVAL, "Shared memory %s is not a stream", shm.c_str());
+    }
+    void* mem = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED)
+        return ReportError(errno, "Failed to map shared memory %s: %s", shm.c_str(), strerror(errno));
+
+    const SharedStreamHeader* hdr = (const SharedStreamHeader*)mem;
+    const size_t samplesOffset = SamplesOffset(hdr->capacity, std::max(uint64_t(1), hdr->chunkSize));
+    if (hdr->magic.load(std::memory_order_acquire) != sharedStreamMagic
+        or hdr->version != sharedStreamVersion
+        or size_t(st.st_size) < samplesOffset + hdr->capacity*hdr->sampleSize)
+    {
+        munmap(mem, st.st_size);
+        return ReportError(EINVAL, "Shared memory %s is not a compatible stream", shm.c_str());
+    }
+    header = hdr;
+    mappedSize = st.st_size;
+    samples = (const char*)mem + samplesOffset;
+    sampleSize = hdr->sampleSize;
+    active = false;
+    overruns = 0;
+    lost = 0;
+    return 0;
+#endif
+}
+
+void SharedStreamReader::Close()
+{
+#ifndef _WIN32
+    if (header)
+        munmap((void*)header, mappedSize);
+#endif
+    header = nullptr;
+    samples = nullptr;
+    active = false;
+}
+
+StreamConfig::StreamDataFormat SharedStreamReader::GetFormat() const
+{
+    return header ? StreamConfig::StreamDataFormat(header->format) : StreamConfig::STREAM_12_BIT_IN_16;
+}
+
+double SharedStreamReader::GetSampleRate() const
+{
+    return header ? header->sampleRate : 0;
+}
+
+size_t SharedStreamReader::GetCapacity() const
+{
+    return header ? header->capacity : 0;
+}
+
+uint64_t SharedStreamReader::GetLostCount() const
+{
+    return lost;
+}
+
+int SharedStreamReader::Start()
+{
+    if (header == nullptr)
+        return ReportError(EINVAL, "Shared stream is not open");
+    position = header->committed.load(std::memory_order_acquire);
+    active = true;
+    return 0;
+}
+
+int SharedStreamReader::Stop()
+{
+    active = false;
+    return 0;
+}
+
+int SharedStreamReader::Read(void* dest, const uint32_t count, Metadata* metadata, const int32_t timeout_ms)
+{
+    if (header == nullptr or not active)
+        return ReportError(EINVAL, "Shared stream is not started");
+    const uint64_t capacity = header->capacity;
+    const uint64_t chunkSize = header->chunkSize;
+    const uint64_t chunks = capacity/chunkSize;
+    const SharedStreamChunk* chunkInfo = Chunks(header);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    uint32_t flags = 0;
+    while (true)
+    {
+        uint64_t available;
+        while (true)
+        {
+            const uint32_t sequence = header->sequence.load(std::memory_order_acquire);
+            const uint64_t end = header->committed.load(std::memory_order_acquire);
+            //chunk timestamp offset is overwritten with the first sample of the chunk
+            if (end - (position - position % chunkSize) > capacity)
+            {
+                const uint64_t resync = end - capacity/2;
+                lost += resync - position;
+                position = resync;
+                ++overruns;
+                flags |= Metadata::DROPPED_SAMPLES;
+            }
+            //unused rest of chunk before timestamp jump
+            if (position < end and position >= chunkInfo[(position/chunkSize) % chunks].end.load(std::memory_order_relaxed))
+                position += chunkSize - position % chunkSize;
+            available = end - position;
+            if (available >= count)
+                break;
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline or not header->active.load(std::memory_order_relaxed))
+                break;
+            WaitForPublish(header, sequence, std::chrono::duration_cast<std::chrono::microseconds>(deadline - now));
+        }
+        size_t n = std::min(uint64_t(count), available);
+        if (n == 0)
+            return 0;
+
+        //samples of one read share timestamp offset, stop at the next jump
+        const uint64_t offset = chunkInfo[(position/chunkSize) % chunks].offset.load(std::memory_order_relaxed);
+        uint64_t segmentEnd = chunkInfo[(position/chunkSize) % chunks].end.load(std::memory_order_relaxed);
+        while (segmentEnd < position + n and segmentEnd % chunkSize == 0
+            and chunkInfo[(segmentEnd/chunkSize) % chunks].offset.load(std::memory_order_relaxed) == offset)
+            segmentEnd = chunkInfo[(segmentEnd/chunkSize) % chunks].end.load(std::memory_order_relaxed);
+        n = std::min(uint64_t(n), segmentEnd - position);
+
+        const size_t index = position & (capacity-1);
+        const size_t first = std::min(size_t(capacity - index), n);
+        memcpy(dest, samples + index*sampleSize, first*sampleSize);
+        memcpy((char*)dest + first*sampleSize, samples, (n-first)*sampleSize);
+        const uint64_t timestamp = offset + position;
+
+        //producer may have overwritten the samples while they were copied
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t reserved = header->reserved.load(std::memory_order_relaxed);
+        if (reserved - (position - position % chunkSize) > capacity)
+            continue;
+
+        position += n;
+        if (metadata)
+        {
+            metadata->timestamp = timestamp;
+            metadata->flags |= flags;
+        }
+        return n;
+    }
+}
+
+int SharedStreamReader::Write(const void* samples, const uint32_t count, const Metadata* metadata, const int32_t timeout_ms)
+{
+    return ReportError(EPERM, "Shared streams are receive only");
+}
+
+IStreamChannel::Info SharedStreamReader::GetInfo()
+{
+    Info info;
+    memset(&info, 0, sizeof(info));
+    if (header == nullptr)
+        return info;
+    const uint64_t end = header->committed.load(std::memory_order_acquire);
+    info.sampleRate = header->sampleRate;
+    info.fifoSize = header->capacity;
+    info.fifoItemsCount = active ? std::min(end - position, uint64_t(header->capacity)) : 0;
+    info.overrun = overruns;
+    info.active = active and header->active.load();
+    info.droppedPackets = header->droppedPackets.load(std::memory_order_relaxed);
+    info.timestamp = end;
+    return info;
+}
@@ -0,0 +1,122 @@
+/**
+    @file SharedStream.h
+    @author Lime Microsystems
+    @brief Receive stream shared with other processes through POSIX shared memory
+*/
+
+#ifndef LIME_SHARED_STREAM_H
+#define LIME_SHARED_STREAM_H
+
+#include "LimeSuiteConfig.h"
+#include "IConnection.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <cstdint>
+
+namespace lime
+{
+
+struct SharedStreamHeader;
+
+/** @brief Writes samples into shared memory ring read by any number of readers.
+
+    The ring is lock-free with a single producer. Publishing never waits for
+    readers and does no work per reader. Each reader keeps its own read
+    position, and a reader that falls more than the ring size behind loses
+    samples and is told so. Shared memory object is named "/limesuite-<name>".
+*/
+class LIME_API SharedStreamPublisher
+{
+public:
+    SharedStreamPublisher();
+    ~SharedStreamPublisher();
+
+    /** @brief Creates shared memory ring, existing ring of the same name is replaced
+        @param capacity ring size in samples, rounded up to power of two
+        @return 0 on success
+    */
+    int Open(const std::string &name, const size_t capacity, const StreamConfig::StreamDataFormat format, const double sampleRate);
+
+    //! Stops publishing thread, marks ring inactive and removes the shared memory name
+    void Close();
+
+    /** @brief Appends samples to ring, never blocks
+        @param timestamp timestamp of the first sample
+    */
+    void Publish(const void* samples, const size_t count, const uint64_t timestamp);
+
+    /** @brief Starts source stream and thread publishing everything read from it
+        @param source receive stream in format given to Open(), not owned
+        @return 0 on success
+    */
+    int Attach(IStreamChannel* source);
+
+    //! Stops publishing thread and source stream
+    void Detach();
+
+    uint64_t GetPublishedCount() const;
+
+private:
+    SharedStreamPublisher(const SharedStreamPublisher&);
+    SharedStreamPublisher& operator=(const SharedStreamPublisher&);
+    void PublishLoop();
+
+    std::string shmName;
+    SharedStreamHeader* header;
+    size_t mappedSize;
+    char* samples;
+    size_t sampleSize;
+    IStreamChannel* source;
+    std::atomic<bool> terminate;
+    std::thread publishThread;
+};
+
+/** @brief Reads samples published by SharedStreamPublisher, possibly in another process.
+
+    Reader is an IStreamChannel, so it can be read by LMS_RecvStream().
+    Start() begins reading at the newest published sample. When samples were
+    lost, Read() sets Metadata::DROPPED_SAMPLES and GetInfo() counts the event
+    in overrun. droppedPackets of GetInfo() is reported by producer's source stream.
+*/
+class LIME_API SharedStreamReader : public IStreamChannel
+{
+public:
+    SharedStreamReader();
+    ~SharedStreamReader();
+
+    //! Maps ring of given name read-only, @return 0 on success
+    int Open(const std::string &name);
+    void Close();
+
+    StreamConfig::StreamDataFormat GetFormat() const;
+    double GetSampleRate() const;
+    size_t GetCapacity() const;
+    //! Samples skipped because reader was too slow
+    uint64_t GetLostCount() const;
+
+    int Start() override;
+    int Stop() override;
+    /** @brief Copies samples from ring
+        Waits until count samples are available, returns available ones on timeout.
+    */
+    int Read(void* samples, const uint32_t count, Metadata* metadata, const int32_t timeout_ms = 100) override;
+    int Write(const void* samples, const uint32_t count, const Metadata* metadata, const int32_t timeout_ms = 100) override;
+    Info GetInfo() override;
+
+private:
+    SharedStreamReader(const SharedStreamReader&);
+    SharedStreamReader& operator=(const SharedStreamReader&);
+
+    const SharedStreamHeader* header;
+    size_t mappedSize;
+    const char* samples;
+    size_t sampleSize;
+    uint64_t position;
+    bool active;
+    unsigned overruns;
+    uint64_t lost;
+};
+
+}
+#endif
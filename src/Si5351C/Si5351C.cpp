@@ -334,6 +334,33 @@ Si5351C::Status Si5351C::UploadConfiguration()
     return SUCCESS;
 }
 
+/** @brief Compares chip registers with configuration prepared by ConfigureClocks()
+    @return true if the chip already runs the same configuration
+*/
+bool Si5351C::IsConfigurationLoaded()
+{
+    if (!device || device->IsOpen() == false)
+        return false;
+
+    std::string regs;
+    regs.push_back(3);
+    for (int i = 15; i <= 92; ++i)
+        regs.push_back(i);
+    for (int i = 149; i <= 170; ++i)
+        regs.push_back(i);
+
+    std::string values(regs);
+    if (device->ReadI2C(addrSi5351, regs.size(), values) != 0 || values.size() < regs.size())
+        return false;
+    for (size_t i = 0; i < regs.size(); ++i)
+        if ((unsigned char)values[i] != m_newConfiguration[(unsigned char)regs[i]])
+            return false;
+
+    //PLLs must be locked
+    StatusBits stat = GetStatusBits();
+    return stat.sys_init == 0 && stat.lol_a == 0 && stat.lol_b == 0;
+}
+
 // ---------------------------------------------------------------------------
 /**
     @brief Sets connection manager to use for data transferring Si5351C
@@ -82,6 +82,7 @@ public:
     void SetClock(unsigned char id, unsigned long fOut_Hz, bool enabled = true, bool inverted = false);
 
     Status UploadConfiguration();
+    bool IsConfigurationLoaded();
     Status ConfigureClocks();
 	void Reset();
 
@@ -0,0 +1,256 @@
+/**
+    @file SpectrumPipeline.cpp
+    @author Lime Microsystems
+    @brief Multi-threaded averaged power spectrum of sample frames
+*/
+
+#include "SpectrumPipeline.h"
+#include "FFTPlanCache.h"
+#include "windowFunction.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ciso646>
+
+using namespace lime;
+
+void lime::ApplyWindow(const complex16_t* samples, const float* window, kiss_fft_cpx* out, const int count)
+{
+    const complex16_t* __restrict in = samples;
+    kiss_fft_cpx* __restrict dst = out;
+    if (window == nullptr)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            dst[i].r = in[i].i;
+            dst[i].i = in[i].q;
+        }
+        return;
+    }
+    const float* __restrict w = window;
+    for (int i = 0; i < count; ++i)
+    {
+        dst[i].r = in[i].i * w[i];
+        dst[i].i = in[i].q * w[i];
+    }
+}
+
+void lime::AccumulatePower(const kiss_fft_cpx* bins, float* accumulator, const int count)
+{
+    const kiss_fft_cpx* __restrict in = bins;
+    float* __restrict acc = accumulator;
+    //negative frequencies first
+    const int half = count/2 + 1;
+    const int negative = count - half;
+    for (int i = 0; i < negative; ++i)
+        acc[i] += in[half+i].r * in[half+i].r + in[half+i].i * in[half+i].i;
+    for (int i = 0; i < half; ++i)
+        acc[negative+i] += in[i].r * in[i].r + in[i].i * in[i].i;
+}
+
+void lime::PowerToDB(const float* power, float* dB, const int count, const float offset)
+{
+    //log2(x) = exponent + log2(m), m in [1,2)
+    //log2(m) = 2/ln(2)*atanh(t), t = (m-1)/(m+1) in [0,1/3)
+    const float dBPerOctave = 10*0.30102999566f;
+    for (int i = 0; i < count; ++i)
+    {
+        const float x = power[i];
+        uint32_t bits;
+        memcpy(&bits, &x, sizeof(bits));
+        const float exponent = float(int((bits >> 23) & 0xFF) - 127);
+        bits = (bits & 0x007FFFFF) | 0x3F800000;
+        float m;
+        memcpy(&m, &bits, sizeof(m));
+        const float t = (m - 1) / (m + 1);
+        const float t2 = t*t;
+        const float atanh = t*(1 + t2*(1.0f/3 + t2*(1.0f/5 + t2*(1.0f/7 + t2*(1.0f/9)))));
+        const float log2x = exponent + 2.88539008178f*atanh;
+        dB[i] = x > 0 ? dBPerOctave*log2x - offset : -300;
+    }
+}
+
+SpectrumPipeline::SpectrumPipeline(const int fftSize, const int channels, int workersCount, int frameBuffers) :
+    fftSize(fftSize),
+    channels(channels),
+    busyFrames(0),
+    stop(false),
+    accumulator(fftSize*channels, 0),
+    accumulated(0),
+    averageCount(1),
+    generation(0),
+    window(nullptr),
+    spectrum(fftSize*channels, 0),
+    spectrumReady(false),
+    processed(0),
+    dropped(0)
+{
+    if (workersCount <= 0)
+        workersCount = std::max(1, int(std::thread::hardware_concurrency()) - 1);
+    if (frameBuffers <= 0)
+        frameBuffers = 2*workersCount;
+    frames.resize(frameBuffers);
+    for (auto &frame : frames)
+    {
+        frame.resize(fftSize*channels);
+        freeFrames.push_back(&frame);
+    }
+    for (int i = 0; i < workersCount; ++i)
+        workers.push_back(std::thread(&SpectrumPipeline::WorkerLoop, this));
+}
+
+SpectrumPipeline::~SpectrumPipeline()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        stop = true;
+    }
+    queueCond.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void SpectrumPipeline::SetWindow(const int func)
+{
+    const float* coefs = func == 0 ? nullptr : GetWindowCoefficients(func, fftSize).data();
+    std::lock_guard<std::mutex> lock(accumulatorLock);
+    window = coefs;
+    ++generation;
+    accumulated = 0;
+    std::fill(accumulator.begin(), accumulator.end(), 0);
+}
+
+void SpectrumPipeline::SetAverageCount(const int count)
+{
+    std::lock_guard<std::mutex> lock(accumulatorLock);
+    averageCount = std::max(1, count);
+    ++generation;
+    accumulated = 0;
+    std::fill(accumulator.begin(), accumulator.end(), 0);
+}
+
+bool SpectrumPipeline::Push(const complex16_t* const* samples)
+{
+    std::vector<complex16_t>* frame;
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        if (freeFrames.empty())
+        {
+            ++dropped;
+            return false;
+        }
+        frame = freeFrames.back();
+        freeFrames.pop_back();
+    }
+    for (int ch = 0; ch < channels; ++ch)
+        memcpy(&(*frame)[ch*fftSize], samples[ch], fftSize*sizeof(complex16_t));
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        queuedFrames.push_back(frame);
+    }
+    queueCond.notify_one();
+    return true;
+}
+
+bool SpectrumPipeline::GetSpectrum(std::vector<float>* bins, const int timeout_ms)
+{
+    std::unique_lock<std::mutex> lock(accumulatorLock);
+    if (not spectrumCond.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]{return spectrumReady;}))
+        return false;
+    for (int ch = 0; ch < channels; ++ch)
+        bins[ch].assign(spectrum.begin() + ch*fftSize, spectrum.begin() + (ch+1)*fftSize);
+    spectrumReady = false;
+    return true;
+}
+
+void SpectrumPipeline::Flush()
+{
+    std::unique_lock<std::mutex> lock(queueLock);
+    idleCond.wait(lock, [this]{return queuedFrames.empty() and busyFrames == 0;});
+}
+
+int SpectrumPipeline::GetWorkersCount() const
+{
+    return workers.size();
+}
+
+uint64_t SpectrumPipeline::GetProcessedCount() const
+{
+    return processed.load();
+}
+
+uint64_t SpectrumPipeline::GetDroppedCount() const
+{
+    return dropped.load();
+}
+
+void SpectrumPipeline::WorkerLoop()
+{
+    FFTPlan fftPlan(fftSize);
+    //power of all channels, summed into accumulator in one step
+    std::vector<float> power(fftSize*channels);
+    while (true)
+    {
+        std::vector<complex16_t>* frame;
+        {
+            std::unique_lock<std::mutex> lock(queueLock);
+            queueCond.wait(lock, [this]{return stop or not queuedFrames.empty();});
+            if (stop)
+                return;
+            frame = queuedFrames.front();
+            queuedFrames.pop_front();
+            ++busyFrames;
+        }
+
+        const float* frameWindow;
+        unsigned frameGeneration;
+        {
+            std::lock_guard<std::mutex> lock(accumulatorLock);
+            frameWindow = window;
+            frameGeneration = generation;
+        }
+        std::fill(power.begin(), power.end(), 0);
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            ApplyWindow(&(*frame)[ch*fftSize], frameWindow, fftPlan.In(), fftSize);
+            fftPlan.Execute();
+            AccumulatePower(fftPlan.Out(), &power[ch*fftSize], fftSize);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queueLock);
+            freeFrames.push_back(frame);
+        }
+
+        bool ready = false;
+        {
+            std::lock_guard<std::mutex> lock(accumulatorLock);
+            //settings changed while processing
+            if (frameGeneration == generation)
+            {
+                for (size_t i = 0; i < power.size(); ++i)
+                    accumulator[i] += power[i];
+                if (++accumulated >= averageCount)
+                {
+                    const float scale = 1.0f / (float(accumulated)*fftSize*fftSize);
+                    for (size_t i = 0; i < accumulator.size(); ++i)
+                    {
+                        spectrum[i] = accumulator[i] * scale;
+                        accumulator[i] = 0;
+                    }
+                    accumulated = 0;
+                    spectrumReady = ready = true;
+                }
+            }
+        }
+        ++processed;
+        if (ready)
+            spectrumCond.notify_all();
+
+        {
+            std::lock_guard<std::mutex> lock(queueLock);
+            --busyFrames;
+        }
+        idleCond.notify_all();
+    }
+}
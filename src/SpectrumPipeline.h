@@ -0,0 +1,122 @@
+/**
+    @file SpectrumPipeline.h
+    @author Lime Microsystems
+    @brief Multi-threaded averaged power spectrum of sample frames
+*/
+
+#ifndef LIME_SPECTRUM_PIPELINE_H
+#define LIME_SPECTRUM_PIPELINE_H
+
+#include "LimeSuiteConfig.h"
+#include "kiss_fft.h"
+#include "dataTypes.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace lime
+{
+
+/** @brief Multiplies samples by window, result is FFT input.
+    Plain loops over restrict pointers, vectorized by the compiler
+    according to ENABLE_SIMD_FLAGS.
+    @param window coefficients, nullptr for rectangular window
+*/
+LIME_API void ApplyWindow(const complex16_t* samples, const float* window, kiss_fft_cpx* out, const int count);
+
+/** @brief Adds squared magnitudes of FFT output to accumulator.
+    Bins are reordered from negative to positive frequencies, like in FFT viewer:
+    accumulator[0] corresponds to bin count/2+1.
+*/
+LIME_API void AccumulatePower(const kiss_fft_cpx* bins, float* accumulator, const int count);
+
+/** @brief Converts linear power to dB: 10*log10(power)-offset.
+    Uses polynomial log approximation, error below 0.0001 dB.
+    Non positive power gives -300. In place conversion is allowed.
+*/
+LIME_API void PowerToDB(const float* power, float* dB, const int count, const float offset = 0);
+
+/** @brief Averaged power spectrum of frames computed by worker threads.
+
+    Acquisition thread copies frames of fftSize samples per channel with Push(),
+    worker threads window them, run FFT and accumulate power. When averageCount
+    frames are accumulated, normalized spectrum becomes available by GetSpectrum().
+    Frames are dropped when all frame buffers are in use, so acquisition never
+    waits for processing.
+*/
+class LIME_API SpectrumPipeline
+{
+public:
+    /**
+        @param fftSize samples per frame and channel
+        @param channels number of channels in frame
+        @param workers number of FFT threads, 0 for number of cores minus one
+        @param frameBuffers frames that can be queued, 0 for twice the workers
+    */
+    SpectrumPipeline(const int fftSize, const int channels, int workers = 0, int frameBuffers = 0);
+    ~SpectrumPipeline();
+
+    //! Window function ID as in GenerateWindowCoefficients(), restarts averaging
+    void SetWindow(const int func);
+    //! Number of frames averaged in one spectrum, restarts averaging
+    void SetAverageCount(const int count);
+
+    /** @brief Queues frame for processing, samples are copied.
+        @param samples array of channels pointers, fftSize samples each
+        @return false if frame was dropped
+    */
+    bool Push(const complex16_t* const* samples);
+
+    /** @brief Takes latest averaged spectrum.
+        @param bins array of channels vectors, resized to fftSize, linear power
+        @param timeout_ms time to wait for new spectrum, 0 to poll
+        @return true if new spectrum was taken
+    */
+    bool GetSpectrum(std::vector<float>* bins, const int timeout_ms = 0);
+
+    //! Blocks until all queued frames are processed
+    void Flush();
+
+    int GetWorkersCount() const;
+    uint64_t GetProcessedCount() const;
+    uint64_t GetDroppedCount() const;
+
+private:
+    SpectrumPipeline(const SpectrumPipeline&);
+    SpectrumPipeline& operator=(const SpectrumPipeline&);
+    void WorkerLoop();
+
+    const int fftSize;
+    const int channels;
+    //frame holds fftSize samples of each channel, one after another
+    std::vector<std::vector<complex16_t>> frames;
+    std::vector<std::vector<complex16_t>*> freeFrames;
+    std::deque<std::vector<complex16_t>*> queuedFrames;
+    int busyFrames;
+    bool stop;
+    std::mutex queueLock;
+    std::condition_variable queueCond;
+    std::condition_variable idleCond;
+
+    //averaging state, guarded by accumulatorLock
+    std::mutex accumulatorLock;
+    std::condition_variable spectrumCond;
+    std::vector<float> accumulator;
+    int accumulated;
+    int averageCount;
+    unsigned generation;
+    const float* window;
+    std::vector<float> spectrum;
+    bool spectrumReady;
+
+    std::atomic<uint64_t> processed;
+    std::atomic<uint64_t> dropped;
+    std::vector<std::thread> workers;
+};
+
+}
+#endif
@@ -0,0 +1,757 @@
+/**
+    @file StreamDSP.cpp
+    @author Lime Microsystems
+    @brief Host digital down-converter and polyphase channelizer for receive streams
+*/
+
+#include "StreamDSP.h"
+#include "FFTPlanCache.h"
+#include "ErrorReporting.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <ciso646>
+
+using namespace lime;
+
+//source samples converted in one step, bounds work buffer size
+static const size_t processChunk = 8192;
+
+static size_t SampleSize(const StreamConfig::StreamDataFormat format)
+{
+    return format == StreamConfig::STREAM_COMPLEX_FLOAT32 ? 2*sizeof(float) : 2*sizeof(int16_t);
+}
+
+static float IntegerFullScale(const StreamConfig::StreamDataFormat format)
+{
+    return format == StreamConfig::STREAM_12_BIT_COMPRESSED ? 2047.0f : 32767.0f;
+}
+
+/** @brief Windowed sinc lowpass, Blackman-Harris window, unity gain at DC
+    @param cutoff cutoff frequency in cycles per sample
+*/
+static std::vector<double> DesignLowpass(const int taps, const double cutoff)
+{
+    std::vector<double> h(taps);
+    const double center = (taps-1)/2.0;
+    double sum = 0;
+    for (int i = 0; i < taps; ++i)
+    {
+        const double t = i - center;
+        const double sinc = t == 0 ? 2*cutoff : std::sin(2*M_PI*cutoff*t)/(M_PI*t);
+        //window spans taps+1 points so that end taps are not zero
+        const double x = 2*M_PI*(i+1)/(taps+1);
+        const double window = 0.35875 - 0.48829*std::cos(x) + 0.14128*std::cos(2*x) - 0.01168*std::cos(3*x);
+        h[i] = sinc*window;
+        sum += h[i];
+    }
+    for (auto &coef : h)
+        coef /= sum;
+    return h;
+}
+
+void lime::SamplesToFloat(const void* samples, const StreamConfig::StreamDataFormat format, complex32f_t* out, const size_t count)
+{
+    complex32f_t* __restrict dst = out;
+    if (format == StreamConfig::STREAM_COMPLEX_FLOAT32)
+    {
+        memcpy(dst, samples, count*sizeof(complex32f_t));
+        return;
+    }
+    const int16_t* __restrict src = (const int16_t*)samples;
+    const float scale = 1.0f/IntegerFullScale(format);
+    for (size_t n = 0; n < count; ++n)
+    {
+        dst[n].i = src[2*n]*scale;
+        dst[n].q = src[2*n+1]*scale;
+    }
+}
+
+void lime::FloatToSamples(const complex32f_t* samples, const StreamConfig::StreamDataFormat format, void* out, const size_t count)
+{
+    const complex32f_t* __restrict src = samples;
+    if (format == StreamConfig::STREAM_COMPLEX_FLOAT32)
+    {
+        memcpy(out, src, count*sizeof(complex32f_t));
+        return;
+    }
+    int16_t* __restrict dst = (int16_t*)out;
+    const float fullScale = IntegerFullScale(format);
+    for (size_t n = 0; n < count; ++n)
+    {
+        const float i = std::min(std::max(src[n].i*fullScale, -fullScale), fullScale);
+        const float q = std::min(std::max(src[n].q*fullScale, -fullScale), fullScale);
+        dst[2*n] = int16_t(std::lrint(i));
+        dst[2*n+1] = int16_t(std::lrint(q));
+    }
+}
+
+/***********************************************************************
+ * NCO mixer
+ **********************************************************************/
+NCOMixer::NCOMixer(const double frequency) :
+    steps(blockSize),
+    phase(0)
+{
+    SetFrequency(frequency);
+}
+
+void NCOMixer::SetFrequency(const double freq)
+{
+    frequency = freq - std::floor(freq);
+    for (int k = 0; k < blockSize; ++k)
+    {
+        const double angle = 2*M_PI*std::fmod(frequency*k, 1.0);
+        steps[k].i = std::cos(angle);
+        steps[k].q = std::sin(angle);
+    }
+}
+
+void NCOMixer::Process(const complex32f_t* in, complex32f_t* out, const size_t count)
+{
+    const complex32f_t* __restrict step = steps.data();
+    for (size_t offset = 0; offset < count; offset += blockSize)
+    {
+        const size_t n = std::min(count - offset, size_t(blockSize));
+        const float ri = std::cos(2*M_PI*phase);
+        const float rq = std::sin(2*M_PI*phase);
+        const complex32f_t* src = in + offset;
+        complex32f_t* dst = out + offset;
+        for (size_t k = 0; k < n; ++k)
+        {
+            const float ci = step[k].i*ri - step[k].q*rq;
+            const float cq = step[k].i*rq + step[k].q*ri;
+            const float xi = src[k].i;
+            const float xq = src[k].q;
+            dst[k].i = xi*ci - xq*cq;
+            dst[k].q = xi*cq + xq*ci;
+        }
+        phase += frequency*n;
+        phase -= std::floor(phase);
+    }
+}
+
+/***********************************************************************
+ * CIC decimator
+ **********************************************************************/
+//fixed point scale of CIC input, leaves 64-21 bits for growth
+static const float cicInputScale = 1 << 20;
+
+CICDecimator::CICDecimator(const int factor, const int stages) :
+    factor(factor),
+    stages(std::min(stages, int(maxStages))),
+    phase(0)
+{
+    for (int s = 0; s < maxStages; ++s)
+        integI[s] = integQ[s] = combI[s] = combQ[s] = 0;
+    scale = 1.0f/(cicInputScale*std::pow(float(factor), float(this->stages)));
+}
+
+size_t CICDecimator::Process(const complex32f_t* in, const size_t count, complex32f_t* out)
+{
+    //integrators are sequential, I and Q chains are independent
+    size_t produced = 0;
+    for (size_t n = 0; n < count; ++n)
+    {
+        uint64_t vi = uint64_t(int64_t(std::lrint(in[n].i*cicInputScale)));
+        uint64_t vq = uint64_t(int64_t(std::lrint(in[n].q*cicInputScale)));
+        for (int s = 0; s < stages; ++s)
+        {
+            vi = integI[s] += vi;
+            vq = integQ[s] += vq;
+        }
+        if (++phase < factor)
+            continue;
+        phase = 0;
+        for (int s = 0; s < stages; ++s)
+        {
+            const uint64_t di = vi - combI[s];
+            const uint64_t dq = vq - combQ[s];
+            combI[s] = vi;
+            combQ[s] = vq;
+            vi = di;
+            vq = dq;
+        }
+        out[produced].i = float(int64_t(vi))*scale;
+        out[produced].q = float(int64_t(vq))*scale;
+        ++produced;
+    }
+    return produced;
+}
+
+/***********************************************************************
+ * Half-band decimator
+ **********************************************************************/
+HalfBandDecimator::HalfBandDecimator(int taps)
+{
+    taps = std::max(3, (taps+1)/4*4-1);
+    const std::vector<double> h = DesignLowpass(taps, 0.25);
+    const int center = (taps-1)/2;
+    //even offsets are zero by design, only center and odd offsets are used
+    double sum = 0;
+    for (int d = 1; d <= center; d += 2)
+    {
+        coefs.push_back(h[center+d]);
+        sum += 2*h[center+d];
+    }
+    //make passband gain exactly 1 with center tap 0.5
+    for (auto &coef : coefs)
+        coef *= 0.5/sum;
+    held = taps-1;
+    work.assign(held, complex32f_t{0, 0});
+}
+
+size_t HalfBandDecimator::Process(const complex32f_t* in, const size_t count, complex32f_t* out)
+{
+    const int center = int(coefs.size())*2 - 1;
+    const size_t taps = 2*center + 1;
+    const size_t total = held + count;
+    if (work.size() < total)
+        work.resize(total);
+    memcpy(&work[held], in, count*sizeof(complex32f_t));
+    if (total < taps)
+    {
+        held = total;
+        return 0;
+    }
+    const size_t outputs = (total - taps)/2 + 1;
+
+    const complex32f_t* __restrict w = work.data();
+    complex32f_t* __restrict dst = out;
+    for (size_t n = 0; n < outputs; ++n)
+    {
+        dst[n].i = 0.5f*w[2*n+center].i;
+        dst[n].q = 0.5f*w[2*n+center].q;
+    }
+    for (size_t k = 0; k < coefs.size(); ++k)
+    {
+        const float g = coefs[k];
+        const complex32f_t* __restrict a = w + center - (2*k+1);
+        const complex32f_t* __restrict b = w + center + (2*k+1);
+        for (size_t n = 0; n < outputs; ++n)
+        {
+            dst[n].i += g*(a[2*n].i + b[2*n].i);
+            dst[n].q += g*(a[2*n].q + b[2*n].q);
+        }
+    }
+
+    const size_t consumed = 2*outputs;
+    held = total - consumed;
+    memmove(work.data(), &work[consumed], held*sizeof(complex32f_t));
+    return outputs;
+}
+
+/***********************************************************************
+ * Resampler
+ **********************************************************************/
+PolyphaseResampler::PolyphaseResampler(const double ratio, const int filterTaps) :
+    ratio(ratio),
+    taps(std::max(1, (filterTaps + lanes - 1)/lanes)*lanes),
+    rows((phases+1)*taps, 0)
+{
+    //prototype at phases times input rate, transition band is about 8/taps wide,
+    //it ends above output Nyquist, so only its top part aliases into the edge of output band
+    const double cutoff = std::max(0.05, 0.5*std::min(1.0, ratio) - 2.0/taps);
+    const int length = phases*taps;
+    const std::vector<double> h = DesignLowpass(length, cutoff/phases);
+    //x[n-j] is multiplied by h[j*phases+p], window element m is x[n-(taps-1-m)]
+    for (int p = 0; p <= phases; ++p)
+        for (int m = 0; m < taps; ++m)
+        {
+            const int index = (taps-1-m)*phases + p;
+            rows[p*taps + m] = index < length ? h[index]*phases : 0;
+        }
+    held = taps-1;
+    work.assign(held, complex32f_t{0, 0});
+    position = taps-1;
+}
+
+double PolyphaseResampler::GetRatio() const
+{
+    return ratio;
+}
+
+size_t PolyphaseResampler::Process(const complex32f_t* in, const size_t count, complex32f_t* out)
+{
+    const size_t total = held + count;
+    if (work.size() < total)
+        work.resize(total);
+    memcpy(&work[held], in, count*sizeof(complex32f_t));
+
+    const double step = 1.0/ratio;
+    size_t produced = 0;
+    while (size_t(position) < total)
+    {
+        const size_t n = size_t(position);
+        const double phase = (position - n)*phases;
+        const int p = int(phase);
+        const float a = phase - p;
+        const float* __restrict r0 = &rows[p*taps];
+        const float* __restrict r1 = r0 + taps;
+        const complex32f_t* __restrict w = &work[n + 1 - taps];
+        //independent partial sums, so the compiler can vectorize without reassociating
+        float accI[lanes] = {0};
+        float accQ[lanes] = {0};
+        for (int m = 0; m < taps; m += lanes)
+            for (int k = 0; k < lanes; ++k)
+            {
+                const float c = r0[m+k] + a*(r1[m+k] - r0[m+k]);
+                accI[k] += c*w[m+k].i;
+                accQ[k] += c*w[m+k].q;
+            }
+        for (int k = 1; k < lanes; ++k)
+        {
+            accI[0] += accI[k];
+            accQ[0] += accQ[k];
+        }
+        out[produced].i = accI[0];
+        out[produced].q = accQ[0];
+        ++produced;
+        position += step;
+    }
+
+    //keep samples needed by next output window
+    const size_t consumed = size_t(position) + 1 - taps;
+    held = total - consumed;
+    memmove(work.data(), &work[consumed], held*sizeof(complex32f_t));
+    position -= consumed;
+    return produced;
+}
+
+/***********************************************************************
+ * Polyphase channelizer
+ **********************************************************************/
+PolyphaseChannelizer::PolyphaseChannelizer(const int channels, const int tapsPerBranch) :
+    channels(channels),
+    tapsPerBranch(tapsPerBranch),
+    fft(new FFTPlan(channels)),
+    twiddle(channels)
+{
+    const int taps = channels*tapsPerBranch;
+    const std::vector<double> h = DesignLowpass(taps, 0.5/channels);
+    //window element j is multiplied by h[taps-1-j]
+    prototype.resize(taps);
+    for (int j = 0; j < taps; ++j)
+        prototype[j] = h[taps-1-j];
+    //channel output is rotated by one sample because window ends at current sample
+    for (int k = 0; k < channels; ++k)
+    {
+        twiddle[k].i = std::cos(-2*M_PI*k/channels);
+        twiddle[k].q = std::sin(-2*M_PI*k/channels);
+    }
+    held = taps-1;
+    work.assign(held, complex32f_t{0, 0});
+}
+
+PolyphaseChannelizer::~PolyphaseChannelizer()
+{
+}
+
+int PolyphaseChannelizer::GetChannelsCount() const
+{
+    return channels;
+}
+
+size_t PolyphaseChannelizer::Process(const complex32f_t* in, const size_t count, complex32f_t* const* out)
+{
+    const size_t taps = prototype.size();
+    const size_t total = held + count;
+    if (work.size() < total)
+        work.resize(total);
+    memcpy(&work[held], in, count*sizeof(complex32f_t));
+    if (total < taps)
+    {
+        held = total;
+        return 0;
+    }
+    const size_t outputs = (total - taps)/channels + 1;
+
+    const float* __restrict h = prototype.data();
+    const complex32f_t* __restrict tw = twiddle.data();
+    for (size_t n = 0; n < outputs; ++n)
+    {
+        //fold branches, then one FFT gives all channels
+        const complex32f_t* __restrict w = &work[n*channels];
+        kiss_fft_cpx* __restrict u = fft->In();
+        for (int r = 0; r < channels; ++r)
+        {
+            u[r].r = h[r]*w[r].i;
+            u[r].i = h[r]*w[r].q;
+        }
+        for (int p = 1; p < tapsPerBranch; ++p)
+        {
+            const float* __restrict hp = h + p*channels;
+            const complex32f_t* __restrict wp = w + p*channels;
+            for (int r = 0; r < channels; ++r)
+            {
+                u[r].r += hp[r]*wp[r].i;
+                u[r].i += hp[r]*wp[r].q;
+            }
+        }
+        fft->Execute();
+        const kiss_fft_cpx* __restrict bins = fft->Out();
+        for (int k = 0; k < channels; ++k)
+        {
+            out[k][n].i = bins[k].r*tw[k].i - bins[k].i*tw[k].q;
+            out[k][n].q = bins[k].r*tw[k].q + bins[k].i*tw[k].i;
+        }
+    }
+
+    const size_t consumed = outputs*channels;
+    held = total - consumed;
+    memmove(work.data(), &work[consumed], held*sizeof(complex32f_t));
+    return outputs;
+}
+
+/***********************************************************************
+ * Sub-stream
+ **********************************************************************/
+class StreamDSP::Channel : public IStreamChannel
+{
+public:
+    Channel(StreamDSP* owner, const size_t fifoSize, const double timestampStep) :
+        owner(owner),
+        fifo(fifoSize),
+        head(0),
+        filled(0),
+        tailTimestamp(0),
+        timestampStep(timestampStep),
+        overruns(0),
+        active(false)
+    {}
+
+    int Start() override
+    {
+        return owner->StartChannel(this);
+    }
+
+    int Stop() override
+    {
+        return owner->StopChannel(this);
+    }
+
+    int Read(void* samples, const uint32_t count, Metadata* metadata, const int32_t timeout_ms) override
+    {
+        std::unique_lock<std::mutex> lock(fifoLock);
+        hasData.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&]{return filled >= count;});
+        const size_t n = std::min(size_t(count), filled);
+        if (metadata)
+            metadata->timestamp = std::llround(tailTimestamp - filled*timestampStep);
+        const size_t first = std::min(n, fifo.size() - head);
+        const size_t sampleSize = SampleSize(owner->config.format);
+        FloatToSamples(&fifo[head], owner->config.format, samples, first);
+        FloatToSamples(&fifo[0], owner->config.format, (char*)samples + first*sampleSize, n - first);
+        head = (head + n) % fifo.size();
+        filled -= n;
+        return n;
+    }
+
+    int Write(const void* samples, const uint32_t count, const Metadata* metadata, const int32_t timeout_ms) override
+    {
+        return ReportError(EPERM, "DSP sub-streams are receive only");
+    }
+
+    Info GetInfo() override
+    {
+        Info info;
+        memset(&info, 0, sizeof(info));
+        if (owner->source)
+        {
+            const Info sourceInfo = owner->source->GetInfo();
+            info.linkRate = sourceInfo.linkRate;
+            info.droppedPackets = sourceInfo.droppedPackets;
+        }
+        std::lock_guard<std::mutex> lock(fifoLock);
+        info.sampleRate = owner->GetChannelRate();
+        info.fifoSize = fifo.size();
+        info.fifoItemsCount = filled;
+        info.overrun = overruns;
+        info.active = active;
+        info.timestamp = std::llround(tailTimestamp);
+        return info;
+    }
+
+    //! Queues samples, oldest samples are dropped when FIFO is full
+    void Push(const complex32f_t* samples, size_t count, const double timestamp)
+    {
+        {
+            std::lock_guard<std::mutex> lock(fifoLock);
+            if (not active)
+                return;
+            tailTimestamp = timestamp + count*timestampStep;
+            if (count > fifo.size())
+            {
+                overruns += count - fifo.size();
+                samples += count - fifo.size();
+                count = fifo.size();
+            }
+            const size_t space = fifo.size() - filled;
+            if (count > space)
+            {
+                overruns += count - space;
+                head = (head + count - space) % fifo.size();
+                filled -= count - space;
+            }
+            size_t tail = (head + filled) % fifo.size();
+            const size_t first = std::min(count, fifo.size() - tail);
+            memcpy(&fifo[tail], samples, first*sizeof(complex32f_t));
+            memcpy(&fifo[0], samples + first, (count - first)*sizeof(complex32f_t));
+            filled += count;
+        }
+        hasData.notify_one();
+    }
+
+    bool SetActive(const bool enable)
+    {
+        std::lock_guard<std::mutex> lock(fifoLock);
+        const bool changed = active != enable;
+        active = enable;
+        head = filled = 0;
+        return changed;
+    }
+
+    unsigned GetOverruns()
+    {
+        std::lock_guard<std::mutex> lock(fifoLock);
+        return overruns;
+    }
+
+private:
+    StreamDSP* owner;
+    std::mutex fifoLock;
+    std::condition_variable hasData;
+    std::vector<complex32f_t> fifo;
+    size_t head;
+    size_t filled;
+    double tailTimestamp;             //!< timestamp of next pushed sample
+    const double timestampStep;
+    unsigned overruns;
+    bool active;
+};
+
+/***********************************************************************
+ * DSP stage
+ **********************************************************************/
+StreamDSP::Config::Config() :
+    sampleRate(0),
+    ncoFrequency(0),
+    decimation(1),
+    channels(1),
+    outputRate(0),
+    tapsPerBranch(12),
+    format(StreamConfig::STREAM_12_BIT_IN_16),
+    fifoSize(1024*1024)
+{
+}
+
+//! half-band stages used for factors of 2 and 4 of decimation
+static unsigned HalfBandCount(const unsigned decimation)
+{
+    unsigned count = 0;
+    while (count < 2 and decimation % (2u << count) == 0)
+        ++count;
+    return count;
+}
+
+StreamDSP::StreamDSP(IStreamChannel* source, const Config &cfg) :
+    source(source),
+    config(cfg),
+    timestampValid(false),
+    nextTimestamp(0),
+    outTimestamp(0),
+    activeChannels(0),
+    terminate(false)
+{
+    config.decimation = std::max(1u, config.decimation);
+    config.channels = std::max(1u, config.channels);
+    if (config.sampleRate > 0)
+        mixer.SetFrequency(-config.ncoFrequency/config.sampleRate);
+
+    //CIC does the bulk of high decimations, half-bands flatten its passband droop
+    const unsigned halfBandCount = HalfBandCount(config.decimation);
+    if (config.decimation >> halfBandCount > 1)
+        cic.reset(new CICDecimator(config.decimation >> halfBandCount));
+    for (unsigned i = 0; i < halfBandCount; ++i)
+        halfBands.push_back(std::unique_ptr<HalfBandDecimator>(new HalfBandDecimator()));
+    double ratio = 1;
+    if (config.outputRate > 0 and config.sampleRate > 0)
+        ratio = config.outputRate*config.channels*config.decimation/config.sampleRate;
+    if (std::fabs(ratio - 1) > 1e-12)
+        resampler.reset(new PolyphaseResampler(ratio));
+    else
+        config.outputRate = 0;
+    if (config.channels > 1)
+        channelizer.reset(new PolyphaseChannelizer(config.channels, config.tapsPerBranch));
+
+    channelStep = config.decimation*config.channels/ratio;
+    const size_t fifoSize = std::max(config.fifoSize, size_t(1));
+    //decimated and resampled chunk, with samples held by filters
+    const size_t chunkOut = size_t((double(processChunk)/config.decimation + 4)*ratio) + 4;
+    for (unsigned i = 0; i < config.channels; ++i)
+    {
+        outputs.push_back(std::unique_ptr<Channel>(new Channel(this, fifoSize, channelStep)));
+        channelBufs.push_back(std::vector<complex32f_t>(chunkOut/config.channels + 4));
+    }
+    buffer.resize(std::max(processChunk, chunkOut));
+    memset(&stats, 0, sizeof(stats));
+}
+
+StreamDSP::~StreamDSP()
+{
+    std::lock_guard<std::mutex> lock(startLock);
+    if (activeChannels == 0)
+        return;
+    terminate.store(true);
+    if (readThread.joinable())
+        readThread.join();
+    if (source)
+        source->Stop();
+}
+
+size_t StreamDSP::GetChannelsCount() const
+{
+    return outputs.size();
+}
+
+IStreamChannel* StreamDSP::GetChannel(const size_t index)
+{
+    return index < outputs.size() ? outputs[index].get() : nullptr;
+}
+
+double StreamDSP::GetChannelFrequency(const size_t index) const
+{
+    const int channels = config.channels;
+    const int k = int(index) <= (channels-1)/2 ? int(index) : int(index) - channels;
+    return config.ncoFrequency + k*GetChannelRate();
+}
+
+double StreamDSP::GetChannelRate() const
+{
+    if (config.outputRate > 0)
+        return config.outputRate;
+    return config.sampleRate/(double(config.decimation)*config.channels);
+}
+
+unsigned StreamDSP::SelectDecimation(const double sampleRate, const double outputRate, const unsigned channels)
+{
+    unsigned decimation = 1;
+    while (decimation < 4096 and sampleRate/(2*decimation) >= outputRate*channels)
+        decimation *= 2;
+    return decimation;
+}
+
+bool StreamDSP::IsValidDecimation(const unsigned decimation)
+{
+    //wrapping CIC integrators keep exact values up to factor 1024 with 4 stages
+    return decimation >= 1 and decimation >> HalfBandCount(decimation) <= 1024;
+}
+
+void StreamDSP::Process(const void* samples, const size_t count, const uint64_t timestamp)
+{
+    std::lock_guard<std::mutex> lock(processLock);
+    auto t0 = std::chrono::steady_clock::now();
+    //lost source samples shift output timestamps
+    if (not timestampValid)
+        outTimestamp = timestamp;
+    else if (timestamp != nextTimestamp)
+        outTimestamp += double(int64_t(timestamp - nextTimestamp));
+    timestampValid = true;
+    nextTimestamp = timestamp + count;
+
+    const size_t sampleSize = SampleSize(config.format);
+    std::vector<complex32f_t*> channelPtrs(channelBufs.size());
+    for (size_t i = 0; i < channelBufs.size(); ++i)
+        channelPtrs[i] = channelBufs[i].data();
+
+    for (size_t offset = 0; offset < count; offset += processChunk)
+    {
+        size_t n = std::min(count - offset, processChunk);
+        SamplesToFloat((const char*)samples + offset*sampleSize, config.format, buffer.data(), n);
+        if (config.ncoFrequency != 0)
+            mixer.Process(buffer.data(), buffer.data(), n);
+        if (cic)
+            n = cic->Process(buffer.data(), n, buffer.data());
+        for (auto &halfBand : halfBands)
+            n = halfBand->Process(buffer.data(), n, buffer.data());
+        if (resampler)
+            n = resampler->Process(buffer.data(), n, buffer.data());
+        if (channelizer)
+        {
+            n = channelizer->Process(buffer.data(), n, channelPtrs.data());
+            for (size_t i = 0; i < outputs.size(); ++i)
+                outputs[i]->Push(channelPtrs[i], n, outTimestamp);
+        }
+        else
+            outputs[0]->Push(buffer.data(), n, outTimestamp);
+        outTimestamp += n*channelStep;
+        stats.samplesOut += n;
+    }
+    stats.samplesIn += count;
+    stats.processTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+StreamDSP::Stats StreamDSP::GetStats() const
+{
+    Stats result;
+    {
+        std::lock_guard<std::mutex> lock(processLock);
+        result = stats;
+    }
+    result.overruns = 0;
+    for (auto &output : outputs)
+        result.overruns += output->GetOverruns();
+    return result;
+}
+
+int StreamDSP::StartChannel(Channel* channel)
+{
+    std::lock_guard<std::mutex> lock(startLock);
+    if (not channel->SetActive(true))
+        return 0;
+    if (activeChannels++ > 0 or source == nullptr)
+        return 0;
+    {
+        std::lock_guard<std::mutex> processGuard(processLock);
+        timestampValid = false;
+    }
+    int status = source->Start();
+    if (status != 0)
+    {
+        --activeChannels;
+        channel->SetActive(false);
+        return status;
+    }
+    terminate.store(false);
+    readThread = std::thread(&StreamDSP::ReadLoop, this);
+    return 0;
+}
+
+int StreamDSP::StopChannel(Channel* channel)
+{
+    std::lock_guard<std::mutex> lock(startLock);
+    if (not channel->SetActive(false))
+        return 0;
+    if (--activeChannels > 0 or source == nullptr)
+        return 0;
+    terminate.store(true);
+    readThread.join();
+    return source->Stop();
+}
+
+void StreamDSP::ReadLoop()
+{
+    //enough samples for several outputs of each channel
+    const size_t blockSize = std::max(processChunk, size_t(64)*config.decimation*config.channels);
+    std::vector<char> samples(blockSize*SampleSize(config.format));
+    while (not terminate.load())
+    {
+        IStreamChannel::Metadata meta;
+        meta.flags = 0;
+        meta.timestamp = 0;
+        const int count = source->Read(samples.data(), blockSize, &meta, 100);
+        if (count > 0)
+            Process(samples.data(), count, meta.timestamp);
+    }
+}
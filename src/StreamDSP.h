@@ -0,0 +1,257 @@
+/**
+    @file StreamDSP.h
+    @author Lime Microsystems
+    @brief Host digital down-converter and polyphase channelizer for receive streams
+*/
+
+#ifndef LIME_STREAM_DSP_H
+#define LIME_STREAM_DSP_H
+
+#include "LimeSuiteConfig.h"
+#include "IConnection.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace lime
+{
+
+class FFTPlan;
+
+//! Complex sample used by host DSP, full scale is 1.0
+struct complex32f_t
+{
+    float i;
+    float q;
+};
+
+/** @brief Converts stream samples to complex float of full scale 1.0.
+    STREAM_12_BIT_IN_16 full scale is 32767, STREAM_12_BIT_COMPRESSED is 2047.
+*/
+LIME_API void SamplesToFloat(const void* samples, const StreamConfig::StreamDataFormat format, complex32f_t* out, const size_t count);
+
+//! Converts complex float samples to stream format, integer formats are saturated
+LIME_API void FloatToSamples(const complex32f_t* samples, const StreamConfig::StreamDataFormat format, void* out, const size_t count);
+
+/** @brief Frequency shift by numerically controlled oscillator.
+    Rotation factors of a block are exact phase steps multiplied by one
+    oscillator value per block, so phase error does not accumulate and the
+    per sample loop is a plain complex multiply vectorized by the compiler.
+*/
+class LIME_API NCOMixer
+{
+public:
+    //! @param frequency shift in cycles per sample, negative moves signal down
+    NCOMixer(const double frequency = 0);
+    void SetFrequency(const double frequency);
+    void Process(const complex32f_t* in, complex32f_t* out, const size_t count);
+private:
+    static const int blockSize = 256;
+    std::vector<complex32f_t> steps;
+    double phase;
+    double frequency;
+};
+
+/** @brief Cascaded integrator-comb decimator.
+    Integrators use wrapping 64 bit fixed point, so arbitrarily long streams
+    keep exact values. Gain is normalized to 1 at DC. With 4 stages factor
+    must not exceed 1024.
+*/
+class LIME_API CICDecimator
+{
+public:
+    CICDecimator(const int factor, const int stages = 4);
+    //! @return number of samples written to out, at most count/factor+1
+    size_t Process(const complex32f_t* in, const size_t count, complex32f_t* out);
+private:
+    static const int maxStages = 6;
+    const int factor;
+    const int stages;
+    int phase;
+    uint64_t integI[maxStages];
+    uint64_t integQ[maxStages];
+    uint64_t combI[maxStages];
+    uint64_t combQ[maxStages];
+    float scale;
+};
+
+/** @brief Half-band lowpass and decimation by 2.
+    Only non zero taps are evaluated and symmetric pairs are summed first.
+    Passband up to 0.2 of input rate.
+*/
+class LIME_API HalfBandDecimator
+{
+public:
+    //! @param taps filter length, 4k-1
+    HalfBandDecimator(const int taps = 31);
+    size_t Process(const complex32f_t* in, const size_t count, complex32f_t* out);
+private:
+    std::vector<float> coefs; //!< taps at odd offsets from center
+    std::vector<complex32f_t> work;
+    size_t held;
+};
+
+/** @brief Arbitrary ratio resampler.
+    Polyphase filter with phases finer than output spacing, coefficients of
+    the two nearest phases are linearly interpolated (Farrow form of first
+    order). Lowpass cutoff follows the lower of input and output Nyquist,
+    passband is flat up to 6/taps of input rate below it. Cost is about 3*taps
+    multiply-adds per output sample; with 64 taps on AVX2 Xeon it takes 3-5%
+    of one core per MS/s of input, LimeUtil --dspbench measures it.
+*/
+class LIME_API PolyphaseResampler
+{
+public:
+    /** @param ratio output rate divided by input rate, 0.5 to 2
+        @param taps filter length at input rate, rounded up to multiple of 8
+    */
+    PolyphaseResampler(const double ratio, const int taps = 64);
+    //! @return number of samples written to out, at most count*ratio+2
+    size_t Process(const complex32f_t* in, const size_t count, complex32f_t* out);
+    double GetRatio() const;
+private:
+    static const int phases = 128;
+    static const int lanes = 8;
+    const double ratio;
+    const int taps; //!< multiple of lanes
+    //row p holds coefficients of phase p for window in reverse order, phases+1 rows
+    std::vector<float> rows;
+    std::vector<complex32f_t> work;
+    size_t held;
+    double position; //!< time of next output relative to work[0]
+};
+
+/** @brief M channel critically sampled polyphase filter bank.
+    Channel k is centered at k/M of input rate (channels above M/2 are negative
+    frequencies) and output at 1/M of input rate. Prototype lowpass has
+    M*tapsPerBranch taps and cutoff at channel edge, so signals at channel edges
+    alias into the neighbour channel.
+*/
+class LIME_API PolyphaseChannelizer
+{
+public:
+    PolyphaseChannelizer(const int channels, const int tapsPerBranch = 12);
+    ~PolyphaseChannelizer();
+    /** @param out array of channels buffers, each receives count/channels+1 samples at most
+        @return number of samples written to each channel
+    */
+    size_t Process(const complex32f_t* in, const size_t count, complex32f_t* const* out);
+    int GetChannelsCount() const;
+private:
+    PolyphaseChannelizer(const PolyphaseChannelizer&);
+    PolyphaseChannelizer& operator=(const PolyphaseChannelizer&);
+    const int channels;
+    const int tapsPerBranch;
+    std::unique_ptr<FFTPlan> fft;
+    std::vector<float> prototype; //!< reversed, aligned with work window
+    std::vector<complex32f_t> twiddle;
+    std::vector<complex32f_t> work;
+    size_t held;
+};
+
+/** @brief Host DSP stage turning one receive stream into low rate sub-streams.
+
+    Source samples are mixed by NCO, decimated by CIC and half-band stages,
+    optionally resampled to rate not reachable by hardware and split by
+    polyphase channelizer. Each channel is an IStreamChannel, so it is
+    read like hardware streams, for example by LMS_RecvStream().
+    Starting any channel starts the source stream and processing thread,
+    stopping the last one stops them. Sub-stream timestamps are in source
+    sample units, rounded when resampling, filter delays are not compensated.
+*/
+class LIME_API StreamDSP
+{
+public:
+    struct Config
+    {
+        Config();
+        double sampleRate;          //!< source sample rate in Hz
+        double ncoFrequency;        //!< offset in Hz moved to 0 Hz by mixer
+        unsigned decimation;        //!< applied before channelizer, factors of 2 and 4 use half-bands, see IsValidDecimation()
+        unsigned channels;          //!< channelizer outputs, 1 - no channelizer
+        double outputRate;          //!< sub-stream rate in Hz, resampled after decimation, 0 - no resampling
+        unsigned tapsPerBranch;     //!< channelizer prototype length per channel
+        StreamConfig::StreamDataFormat format; //!< source and sub-stream sample format
+        size_t fifoSize;            //!< samples buffered per sub-stream
+    };
+
+    //! Processing statistics
+    struct Stats
+    {
+        uint64_t samplesIn;         //!< source samples processed
+        uint64_t samplesOut;        //!< samples produced per channel
+        unsigned overruns;          //!< sub-stream samples lost because FIFO was full, all channels
+        double processTime;         //!< seconds spent in Process()
+    };
+
+    /** @brief Largest decimation that keeps rate for channelizer above requested
+        @return power of two decimation, resampler ratio is then 0.5 to 1
+    */
+    static unsigned SelectDecimation(const double sampleRate, const double outputRate, const unsigned channels = 1);
+
+    /** @brief Checks that CIC part of decimation, left after up to two
+        half-bands, does not exceed 1024: decimation up to 1024, even up to
+        2048 or multiple of 4 up to 4096
+    */
+    static bool IsValidDecimation(const unsigned decimation);
+
+    /** @param source receive stream, not owned, may be nullptr when
+        samples are supplied only by Process()
+    */
+    StreamDSP(IStreamChannel* source, const Config &config);
+    ~StreamDSP();
+
+    size_t GetChannelsCount() const;
+    IStreamChannel* GetChannel(const size_t index);
+    //! Center of channel relative to source center frequency in Hz
+    double GetChannelFrequency(const size_t index) const;
+    double GetChannelRate() const;
+
+    /** @brief Processes source samples and queues results into channels.
+        Called by processing thread, may be called directly when there is no source.
+        @param samples source samples in Config::format
+        @param timestamp timestamp of the first sample
+    */
+    void Process(const void* samples, const size_t count, const uint64_t timestamp);
+
+    Stats GetStats() const;
+
+private:
+    class Channel;
+    StreamDSP(const StreamDSP&);
+    StreamDSP& operator=(const StreamDSP&);
+    int StartChannel(Channel* channel);
+    int StopChannel(Channel* channel);
+    void ReadLoop();
+
+    IStreamChannel* source;
+    Config config;
+    NCOMixer mixer;
+    std::unique_ptr<CICDecimator> cic;
+    std::vector<std::unique_ptr<HalfBandDecimator>> halfBands;
+    std::unique_ptr<PolyphaseResampler> resampler;
+    std::unique_ptr<PolyphaseChannelizer> channelizer;
+    std::vector<std::unique_ptr<Channel>> outputs;
+    double channelStep;             //!< source samples per channel sample
+
+    //work buffers and state guarded by processLock
+    mutable std::mutex processLock;
+    std::vector<complex32f_t> buffer;
+    std::vector<std::vector<complex32f_t>> channelBufs;
+    bool timestampValid;
+    uint64_t nextTimestamp;         //!< expected timestamp of next source sample
+    double outTimestamp;            //!< source timestamp of next channel sample
+    Stats stats;
+
+    std::mutex startLock;
+    int activeChannels;
+    std::atomic<bool> terminate;
+    std::thread readThread;
+};
+
+}
+#endif
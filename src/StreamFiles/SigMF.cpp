@@ -0,0 +1,280 @@
+/**
+    @file SigMF.cpp
+    @author Lime Microsystems
+    @brief SigMF metadata (.sigmf-meta) description of sample recordings
+*/
+
+#include "SigMF.h"
+#include "ErrorReporting.h"
+#include "VersionInfo.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <ciso646>
+
+using namespace lime;
+
+static const char* dataExt = ".sigmf-data";
+static const char* metaExt = ".sigmf-meta";
+
+static std::string JsonString(const std::string &str)
+{
+    std::string out("\"");
+    for (const char c : str)
+    {
+        switch (c)
+        {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if ((unsigned char)c < 0x20)
+            {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            }
+            else
+                out += c;
+        }
+    }
+    return out + "\"";
+}
+
+static std::string JsonUnescape(const std::string &str)
+{
+    std::string out;
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+        if (str[i] != '\\' || i+1 >= str.size())
+        {
+            out += str[i];
+            continue;
+        }
+        switch (str[++i])
+        {
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u':
+            if (i+4 < str.size())
+                out += char(strtol(str.substr(i+1, 4).c_str(), nullptr, 16));
+            i += 4;
+            break;
+        default: out += str[i];
+        }
+    }
+    return out;
+}
+
+/** @brief Finds value of given key within JSON object text
+    @return true if key was found
+*/
+static bool JsonValue(const std::string &text, const std::string &key, std::string &value)
+{
+    const size_t keyPos = text.find("\"" + key + "\"");
+    if (keyPos == std::string::npos)
+        return false;
+    size_t pos = text.find(':', keyPos + key.size() + 2);
+    if (pos == std::string::npos)
+        return false;
+    pos = text.find_first_not_of(" \t\r\n", pos+1);
+    if (pos == std::string::npos)
+        return false;
+    if (text[pos] == '"')
+    {
+        size_t end = pos+1;
+        while (end < text.size() && text[end] != '"')
+            end += (text[end] == '\\') ? 2 : 1;
+        value = JsonUnescape(text.substr(pos+1, end-pos-1));
+    }
+    else
+    {
+        const size_t end = text.find_first_of(",}] \t\r\n", pos);
+        value = text.substr(pos, end-pos);
+    }
+    return true;
+}
+
+/** @brief Splits JSON array of flat objects into object texts
+*/
+static std::vector<std::string> JsonObjects(const std::string &text, const std::string &key)
+{
+    std::vector<std::string> objects;
+    const size_t keyPos = text.find("\"" + key + "\"");
+    if (keyPos == std::string::npos)
+        return objects;
+    size_t pos = text.find('[', keyPos);
+    const size_t end = text.find(']', pos);
+    while (pos != std::string::npos && pos < end)
+    {
+        const size_t objStart = text.find('{', pos);
+        if (objStart == std::string::npos || objStart > end)
+            break;
+        const size_t objEnd = text.find('}', objStart);
+        if (objEnd == std::string::npos)
+            break;
+        objects.push_back(text.substr(objStart, objEnd-objStart+1));
+        pos = objEnd+1;
+    }
+    return objects;
+}
+
+SigMFMeta::Capture::Capture() :
+    sampleStart(0), globalIndex(0), frequency(0), gain(0)
+{
+}
+
+SigMFMeta::Annotation::Annotation() :
+    sampleStart(0), sampleCount(0), timestamp(0), dropped(0)
+{
+}
+
+SigMFMeta::SigMFMeta() :
+    datatype("ci16_le"), sampleRate(0), numChannels(1), sampleBits(16)
+{
+}
+
+size_t SigMFMeta::FrameSize() const
+{
+    const size_t sampleSize = (datatype.compare(0, 2, "cf") == 0) ? 8 : 4;
+    return sampleSize*numChannels;
+}
+
+int SigMFMeta::Save(const std::string &filename) const
+{
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::trunc);
+    if (not file.good())
+        return ReportError(errno, "Failed to create %s", filename.c_str());
+
+    file << std::setprecision(15);
+    file << "{" << std::endl;
+    file << "    \"global\": {" << std::endl;
+    file << "        \"core:datatype\": " << JsonString(datatype) << "," << std::endl;
+    file << "        \"core:version\": \"0.0.1\"," << std::endl;
+    file << "        \"core:sample_rate\": " << sampleRate << "," << std::endl;
+    file << "        \"core:num_channels\": " << numChannels << "," << std::endl;
+    if (not hw.empty())
+        file << "        \"core:hw\": " << JsonString(hw) << "," << std::endl;
+    if (not description.empty())
+        file << "        \"core:description\": " << JsonString(description) << "," << std::endl;
+    file << "        \"core:recorder\": " << JsonString("LimeSuite " + GetLibraryVersion()) << "," << std::endl;
+    file << "        \"limesuite:sample_bits\": " << sampleBits << std::endl;
+    file << "    }," << std::endl;
+
+    file << "    \"captures\": [";
+    for (size_t i = 0; i < captures.size(); ++i)
+    {
+        const Capture &c = captures[i];
+        file << (i ? "," : "") << std::endl;
+        file << "        {" << std::endl;
+        file << "            \"core:sample_start\": " << c.sampleStart << "," << std::endl;
+        file << "            \"core:global_index\": " << c.globalIndex << "," << std::endl;
+        file << "            \"core:frequency\": " << c.frequency << "," << std::endl;
+        if (not c.datetime.empty())
+            file << "            \"core:datetime\": " << JsonString(c.datetime) << "," << std::endl;
+        file << "            \"limesuite:gain\": " << c.gain << std::endl;
+        file << "        }";
+    }
+    file << std::endl << "    ]," << std::endl;
+
+    file << "    \"annotations\": [";
+    for (size_t i = 0; i < annotations.size(); ++i)
+    {
+        const Annotation &a = annotations[i];
+        file << (i ? "," : "") << std::endl;
+        file << "        {" << std::endl;
+        file << "            \"core:sample_start\": " << a.sampleStart << "," << std::endl;
+        file << "            \"core:sample_count\": " << a.sampleCount << "," << std::endl;
+        file << "            \"core:comment\": " << JsonString(a.comment) << "," << std::endl;
+        file << "            \"limesuite:timestamp\": " << a.timestamp << "," << std::endl;
+        file << "            \"limesuite:dropped\": " << a.dropped << std::endl;
+        file << "        }";
+    }
+    file << std::endl << "    ]" << std::endl;
+    file << "}" << std::endl;
+
+    if (not file.good())
+        return ReportError(EIO, "Failed to write %s", filename.c_str());
+    return 0;
+}
+
+int SigMFMeta::Load(const std::string &filename)
+{
+    std::ifstream file(filename.c_str());
+    if (not file.good())
+        return ReportError(ENOENT, "Failed to open %s", filename.c_str());
+    std::stringstream ss;
+    ss << file.rdbuf();
+    const std::string text = ss.str();
+
+    std::string value;
+    const size_t globalEnd = text.find('}');
+    const std::string global = text.substr(0, globalEnd);
+    if (not JsonValue(global, "core:datatype", datatype))
+        return ReportError(EINVAL, "%s: missing core:datatype", filename.c_str());
+    if (datatype != "ci16_le" && datatype != "cf32_le")
+        return ReportError(EINVAL, "%s: unsupported datatype %s", filename.c_str(), datatype.c_str());
+    sampleRate = JsonValue(global, "core:sample_rate", value) ? std::stod(value) : 0;
+    numChannels = JsonValue(global, "core:num_channels", value) ? std::stoul(value) : 1;
+    sampleBits = JsonValue(global, "limesuite:sample_bits", value) ? std::stoul(value) : 16;
+    if (not JsonValue(global, "core:hw", hw))
+        hw.clear();
+    if (not JsonValue(global, "core:description", description))
+        description.clear();
+
+    captures.clear();
+    for (const auto &obj : JsonObjects(text, "captures"))
+    {
+        Capture c;
+        if (JsonValue(obj, "core:sample_start", value)) c.sampleStart = std::stoull(value);
+        if (JsonValue(obj, "core:global_index", value)) c.globalIndex = std::stoull(value);
+        if (JsonValue(obj, "core:frequency", value)) c.frequency = std::stod(value);
+        if (JsonValue(obj, "limesuite:gain", value)) c.gain = std::stod(value);
+        JsonValue(obj, "core:datetime", c.datetime);
+        captures.push_back(c);
+    }
+
+    annotations.clear();
+    for (const auto &obj : JsonObjects(text, "annotations"))
+    {
+        Annotation a;
+        if (JsonValue(obj, "core:sample_start", value)) a.sampleStart = std::stoull(value);
+        if (JsonValue(obj, "core:sample_count", value)) a.sampleCount = std::stoull(value);
+        if (JsonValue(obj, "limesuite:timestamp", value)) a.timestamp = std::stoull(value);
+        if (JsonValue(obj, "limesuite:dropped", value)) a.dropped = std::stoull(value);
+        JsonValue(obj, "core:comment", a.comment);
+        annotations.push_back(a);
+    }
+    return 0;
+}
+
+std::string SigMFMeta::CurrentDatetime()
+{
+    char buf[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buf;
+}
+
+void SigMFMeta::FileNames(const std::string &name, std::string &dataFile, std::string &metaFile)
+{
+    std::string base = name;
+    for (const char* ext : {dataExt, metaExt})
+    {
+        const size_t len = strlen(ext);
+        if (base.size() > len && base.compare(base.size()-len, len, ext) == 0)
+        {
+            base.resize(base.size()-len);
+            break;
+        }
+    }
+    dataFile = base + dataExt;
+    metaFile = base + metaExt;
+}
@@ -0,0 +1,82 @@
+/**
+    @file SigMF.h
+    @author Lime Microsystems
+    @brief SigMF metadata (.sigmf-meta) description of sample recordings
+*/
+
+#ifndef LIME_SIGMF_H
+#define LIME_SIGMF_H
+
+#include "LimeSuiteConfig.h"
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace lime
+{
+
+/** @brief Subset of SigMF core namespace used by LimeSuite recordings.
+    Samples of all channels are interleaved in the data file.
+*/
+struct LIME_API SigMFMeta
+{
+    SigMFMeta();
+
+    //! Segment of continuous samples
+    struct Capture
+    {
+        Capture();
+        uint64_t sampleStart;   //!< index of first sample in the data file
+        uint64_t globalIndex;   //!< hardware timestamp of first sample
+        double frequency;       //!< RF center frequency in Hz
+        double gain;            //!< receiver gain in dB
+        std::string datetime;   //!< ISO-8601 UTC time
+    };
+
+    //! Event associated with data file position
+    struct Annotation
+    {
+        Annotation();
+        uint64_t sampleStart;   //!< index of sample in the data file
+        uint64_t sampleCount;
+        uint64_t timestamp;     //!< hardware timestamp of event
+        uint64_t dropped;       //!< number of samples lost
+        std::string comment;
+    };
+
+    std::string datatype;       //!< "ci16_le" or "cf32_le"
+    double sampleRate;
+    unsigned numChannels;
+    unsigned sampleBits;        //!< significant bits of integer samples
+    std::string hw;
+    std::string description;
+    std::vector<Capture> captures;
+    std::vector<Annotation> annotations;
+
+    //! Size of one sample of all channels in bytes
+    size_t FrameSize() const;
+
+    /** @brief Writes metadata to file
+        @param filename .sigmf-meta file name
+        @return 0 on success
+    */
+    int Save(const std::string &filename) const;
+
+    /** @brief Reads metadata from file
+        Only the fields listed in this structure are extracted.
+        @param filename .sigmf-meta file name
+        @return 0 on success
+    */
+    int Load(const std::string &filename);
+
+    //! Returns current time as ISO-8601 string
+    static std::string CurrentDatetime();
+
+    /** @brief Splits recording name into data and metadata file names
+        Accepts base name or name of either file.
+    */
+    static void FileNames(const std::string &name, std::string &dataFile, std::string &metaFile);
+};
+
+}
+#endif
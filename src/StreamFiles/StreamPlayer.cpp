@@ -0,0 +1,359 @@
+/**
+    @file StreamPlayer.cpp
+    @author Lime Microsystems
+    @brief Transmission of recorded samples from memory mapped files
+*/
+
+#include "StreamPlayer.h"
+#include "ErrorReporting.h"
+#include "Logger.h"
+#include "dataTypes.h"
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <ciso646>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace lime;
+
+//full scale of 12 bit integer samples used by the stream formats
+static const float intFullScale = 2047.0f;
+//CS16 files use full 16 bit range, integer stream samples are 12 bit
+static const int cs16Scale = 16;
+
+StreamPlayer::Config::Config() :
+    format(FORMAT_CS16),
+    channels(1),
+    loop(false),
+    chunkSize(1360*4)
+{
+}
+
+StreamPlayer::StreamPlayer() :
+    mFormat(FORMAT_CS16),
+    mFrameSize(0),
+    mSampleSize(0),
+    mFileSamples(0),
+    mMapped(nullptr),
+    mMappedSize(0),
+#ifdef _WIN32
+    mFileHandle(INVALID_HANDLE_VALUE),
+    mMapHandle(nullptr),
+#else
+    mFd(-1),
+#endif
+    mStreamFormat(StreamConfig::STREAM_12_BIT_IN_16),
+    mUseTimestamp(false),
+    mStartTimestamp(0),
+    mTerminate(false),
+    mActive(false),
+    mSamplesSent(0),
+    mTimestamp(0),
+    mLoops(0),
+    mUnderruns(0),
+    mLatePackets(0)
+{
+}
+
+StreamPlayer::~StreamPlayer()
+{
+    Close();
+}
+
+int StreamPlayer::Open(const Config &config)
+{
+    Close();
+    mConfig = config;
+    if (mConfig.chunkSize == 0)
+        mConfig.chunkSize = Config().chunkSize;
+
+    //SigMF recording if metadata file accompanies the data
+    std::string dataFile, metaFile;
+    SigMFMeta::FileNames(config.filename, dataFile, metaFile);
+    if (std::ifstream(metaFile.c_str()).good())
+    {
+        if (mMeta.Load(metaFile) != 0)
+            return -1;
+        mFormat = (mMeta.datatype == "cf32_le") ? FORMAT_CF32 :
+            (mMeta.sampleBits == 12 ? FORMAT_CS12 : FORMAT_CS16);
+    }
+    else
+    {
+        dataFile = config.filename;
+        mMeta = SigMFMeta();
+        mFormat = config.format;
+        mMeta.datatype = (mFormat == FORMAT_CF32) ? "cf32_le" : "ci16_le";
+        mMeta.sampleBits = (mFormat == FORMAT_CS12) ? 12 : (mFormat == FORMAT_CS16 ? 16 : 32);
+        mMeta.numChannels = config.channels;
+    }
+    if (mMeta.numChannels == 0)
+        return ReportError(EINVAL, "Invalid channels count");
+    mFrameSize = mMeta.FrameSize();
+    mSampleSize = mFrameSize/mMeta.numChannels;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(dataFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return ReportError(ENOENT, "Failed to open %s", dataFile.c_str());
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    mFileHandle = file;
+    mMappedSize = size_t(fileSize.QuadPart);
+    if (mMappedSize >= mFrameSize)
+    {
+        mMapHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mMapHandle != nullptr)
+            mMapped = (const char*)MapViewOfFile(mMapHandle, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    mFd = open(dataFile.c_str(), O_RDONLY);
+    if (mFd < 0)
+        return ReportError(errno, "Failed to open %s", dataFile.c_str());
+    struct stat st;
+    fstat(mFd, &st);
+    mMappedSize = st.st_size;
+    if (mMappedSize >= mFrameSize)
+    {
+        void* ptr = mmap(nullptr, mMappedSize, PROT_READ, MAP_SHARED, mFd, 0);
+        if (ptr != MAP_FAILED)
+        {
+            mMapped = (const char*)ptr;
+            madvise(ptr, mMappedSize, MADV_SEQUENTIAL);
+        }
+    }
+#endif
+    if (mMapped == nullptr)
+    {
+        Close();
+        return ReportError(EINVAL, "Failed to map %s, file is empty or not accessible", dataFile.c_str());
+    }
+    mFileSamples = mMappedSize/mFrameSize;
+    if (mMappedSize % mFrameSize != 0)
+        lime::warning("%s: file size is not multiple of %i byte frame, ignoring trailing bytes", dataFile.c_str(), int(mFrameSize));
+    lime::info("Playing %s: %llu samples, %i channel(s)", dataFile.c_str(), (unsigned long long)mFileSamples, int(mMeta.numChannels));
+    return 0;
+}
+
+void StreamPlayer::Close()
+{
+    Stop();
+#ifdef _WIN32
+    if (mMapped)
+        UnmapViewOfFile(mMapped);
+    if (mMapHandle)
+        CloseHandle(mMapHandle);
+    if (mFileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(mFileHandle);
+    mMapHandle = nullptr;
+    mFileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (mMapped)
+        munmap((void*)mMapped, mMappedSize);
+    if (mFd >= 0)
+        close(mFd);
+    mFd = -1;
+#endif
+    mMapped = nullptr;
+    mMappedSize = 0;
+    mFileSamples = 0;
+}
+
+bool StreamPlayer::IsOpen() const
+{
+    return mMapped != nullptr;
+}
+
+unsigned StreamPlayer::GetChannelsCount() const
+{
+    return mMeta.numChannels;
+}
+
+double StreamPlayer::GetSampleRate() const
+{
+    return mMeta.sampleRate;
+}
+
+const SigMFMeta &StreamPlayer::GetMeta() const
+{
+    return mMeta;
+}
+
+int StreamPlayer::Start(const std::vector<IStreamChannel*> &channels, const StreamConfig::StreamDataFormat streamFormat,
+    const bool useTimestamp, const uint64_t startTimestamp)
+{
+    if (not IsOpen())
+        return ReportError(EINVAL, "No file opened for playback");
+    if (channels.empty() || channels.size() > mMeta.numChannels)
+        return ReportError(EINVAL, "File has %i channel(s), requested playback to %i", int(mMeta.numChannels), int(channels.size()));
+    Stop();
+
+    mChannels = channels;
+    mStreamFormat = streamFormat;
+    mUseTimestamp = useTimestamp;
+    mStartTimestamp = startTimestamp;
+    const size_t streamSampleSize = (streamFormat == StreamConfig::STREAM_COMPLEX_FLOAT32) ? 2*sizeof(float) : sizeof(complex16_t);
+    mChunks.assign(channels.size(), std::vector<char>(mConfig.chunkSize*streamSampleSize));
+    mSamplesSent = 0;
+    mLoops = 0;
+    mUnderruns = 0;
+    mLatePackets = 0;
+    mTimestamp = startTimestamp;
+    for (auto ch : mChannels)
+        ch->GetInfo(); //reset counters
+    mTerminate = false;
+    mActive = true;
+    mThread = std::thread(&StreamPlayer::PlaybackLoop, this);
+    return 0;
+}
+
+void StreamPlayer::Stop()
+{
+    mTerminate = true;
+    if (mThread.joinable())
+        mThread.join();
+    mActive = false;
+}
+
+bool StreamPlayer::IsActive() const
+{
+    return mActive;
+}
+
+StreamPlayer::Stats StreamPlayer::GetStats()
+{
+    UpdateChannelStats();
+    Stats stats;
+    stats.samplesSent = mSamplesSent;
+    stats.fileSamples = mFileSamples;
+    stats.loops = mLoops;
+    stats.underruns = mUnderruns;
+    stats.latePackets = mLatePackets;
+    stats.lastTimestamp = mTimestamp;
+    stats.active = mActive;
+    return stats;
+}
+
+void StreamPlayer::UpdateChannelStats()
+{
+    //counters are shared by all channels of a stream, take the largest
+    unsigned underruns = 0;
+    unsigned late = 0;
+    for (auto ch : mChannels)
+    {
+        IStreamChannel::Info info = ch->GetInfo();
+        underruns = std::max(underruns, unsigned(info.underrun));
+        late = std::max(late, unsigned(info.droppedPackets));
+    }
+    mUnderruns += underruns;
+    mLatePackets += late;
+}
+
+/** @brief Returns samples of one channel in stream format.
+    Points directly into mapped file when no conversion is needed.
+*/
+const void* StreamPlayer::ChannelData(const unsigned ch, const uint64_t first, const size_t count)
+{
+    const char* src = mMapped + first*mFrameSize + ch*mSampleSize;
+    const bool streamFloat = (mStreamFormat == StreamConfig::STREAM_COMPLEX_FLOAT32);
+    const bool fileFloat = (mFormat == FORMAT_CF32);
+    //integer streams carry 12 bit samples, 16 bit files are scaled down
+    const bool rescale = not streamFloat and mFormat == FORMAT_CS16;
+    const size_t stride = mMeta.numChannels;
+
+    if (stride == 1 && streamFloat == fileFloat && not rescale)
+        return src;
+
+    char* dest = mChunks[ch].data();
+    if (rescale)
+    {
+        const complex16_t* in = (const complex16_t*)src;
+        complex16_t* out = (complex16_t*)dest;
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i].i = in[i*stride].i/cs16Scale;
+            out[i].q = in[i*stride].q/cs16Scale;
+        }
+    }
+    else if (fileFloat == streamFloat)
+    {
+        for (size_t i = 0; i < count; ++i)
+            memcpy(dest + i*mSampleSize, src + i*mFrameSize, mSampleSize);
+    }
+    else if (fileFloat)
+    {
+        const float* in = (const float*)src;
+        complex16_t* out = (complex16_t*)dest;
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i].i = int16_t(in[2*i*stride]*intFullScale);
+            out[i].q = int16_t(in[2*i*stride+1]*intFullScale);
+        }
+    }
+    else
+    {
+        const complex16_t* in = (const complex16_t*)src;
+        float* out = (float*)dest;
+        const float scale = (mFormat == FORMAT_CS12) ? 1.0f/intFullScale : 1.0f/32767.0f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[2*i] = in[i*stride].i*scale;
+            out[2*i+1] = in[i*stride].q*scale;
+        }
+    }
+    return dest;
+}
+
+void StreamPlayer::PlaybackLoop()
+{
+    const size_t streamSampleSize = (mStreamFormat == StreamConfig::STREAM_COMPLEX_FLOAT32) ? 2*sizeof(float) : sizeof(complex16_t);
+    uint64_t position = 0;
+    uint64_t timestamp = mStartTimestamp;
+    const bool syncTimestamp = mUseTimestamp;
+
+    while (not mTerminate)
+    {
+        if (position >= mFileSamples)
+        {
+            if (not mConfig.loop)
+                break;
+            ++mLoops;
+            position = 0;
+        }
+        const size_t count = std::min<uint64_t>(mConfig.chunkSize, mFileSamples-position);
+
+        for (unsigned ch = 0; ch < mChannels.size() && not mTerminate; ++ch)
+        {
+            const char* data = (const char*)ChannelData(ch, position, count);
+            IStreamChannel::Metadata meta;
+            meta.timestamp = timestamp;
+            meta.flags = syncTimestamp ? IStreamChannel::Metadata::SYNC_TIMESTAMP : 0;
+            size_t written = 0;
+            while (written < count && not mTerminate)
+            {
+                const int ret = mChannels[ch]->Write(data + written*streamSampleSize, count-written, &meta, 100);
+                if (ret < 0)
+                {
+                    lime::error("Playback: stream write failed");
+                    mTerminate = true;
+                    break;
+                }
+                written += ret;
+                meta.timestamp += ret;
+            }
+        }
+        position += count;
+        timestamp += count;
+        mSamplesSent += count;
+        mTimestamp = timestamp;
+    }
+    mActive = false;
+}
@@ -0,0 +1,143 @@
+/**
+    @file StreamPlayer.h
+    @author Lime Microsystems
+    @brief Transmission of recorded samples from memory mapped files
+*/
+
+#ifndef LIME_STREAM_PLAYER_H
+#define LIME_STREAM_PLAYER_H
+
+#include "LimeSuiteConfig.h"
+#include "SigMF.h"
+#include "IConnection.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+namespace lime
+{
+
+/** @brief Streams sample file to transmitter channels.
+
+    The file is memory mapped and handed to IStreamChannel::Write() in chunks,
+    single channel files in stream format are written directly from the
+    mapping. Multi-channel files are de-interleaved chunk by chunk into small
+    per channel buffers, the file is never loaded to the heap. Integer streams
+    carry 12 bit samples, so CS16 files are scaled down chunk by chunk as well.
+    Raw interleaved files and SigMF recordings (.sigmf-meta next to data file)
+    are supported.
+*/
+class LIME_API StreamPlayer
+{
+public:
+    enum SampleFormat
+    {
+        FORMAT_CS16,    //!< 16 bit integer samples, scaled to 12 bits for integer streams
+        FORMAT_CS12,    //!< 12 bit integer samples stored in 16 bits
+        FORMAT_CF32,    //!< 32 bit float samples, normalized to [-1,1]
+    };
+
+    struct Config
+    {
+        Config();
+        std::string filename;       //!< raw data file or SigMF recording name
+        SampleFormat format;        //!< raw file format, SigMF uses metadata
+        unsigned channels;          //!< raw file channels count, SigMF uses metadata
+        bool loop;                  //!< restart from beginning at the end of file
+        size_t chunkSize;           //!< samples per channel in one Write() call
+    };
+
+    struct Stats
+    {
+        uint64_t samplesSent;       //!< samples (of each channel) written to channels
+        uint64_t fileSamples;       //!< samples of each channel in file
+        unsigned loops;             //!< number of restarts from beginning of file
+        unsigned underruns;         //!< transmitter FIFO underrun events
+        unsigned latePackets;       //!< packets dropped due to late timestamp
+        uint64_t lastTimestamp;     //!< timestamp of the next sample to be sent
+        bool active;
+    };
+
+    StreamPlayer();
+    ~StreamPlayer();
+
+    /** @brief Maps file to memory
+        @return 0 on success
+    */
+    int Open(const Config &config);
+
+    //! Stops playback and unmaps file
+    void Close();
+
+    bool IsOpen() const;
+
+    //! Number of interleaved channels in file
+    unsigned GetChannelsCount() const;
+
+    //! Sample rate from SigMF metadata, 0 if unknown
+    double GetSampleRate() const;
+
+    //! SigMF metadata, describes raw files as well
+    const SigMFMeta &GetMeta() const;
+
+    /** @brief Starts playback thread
+        @param channels transmit channels, file channels are assigned in order
+        @param streamFormat data format the channels were configured with
+        @param useTimestamp transmit first sample at startTimestamp
+        @param startTimestamp hardware timestamp of the first sample
+        @return 0 on success
+    */
+    int Start(const std::vector<IStreamChannel*> &channels, const StreamConfig::StreamDataFormat streamFormat,
+        const bool useTimestamp = false, const uint64_t startTimestamp = 0);
+
+    //! Stops playback thread
+    void Stop();
+
+    //! Returns true while samples are being sent
+    bool IsActive() const;
+
+    /** @brief Polls transmitter status and returns playback statistics
+        Underrun and late packet counters are collected from the channels
+        GetInfo(), which resets them.
+    */
+    Stats GetStats();
+
+private:
+    void PlaybackLoop();
+    const void* ChannelData(const unsigned ch, const uint64_t first, const size_t count);
+    void UpdateChannelStats();
+
+    Config mConfig;
+    SigMFMeta mMeta;
+    SampleFormat mFormat;
+    size_t mFrameSize;
+    size_t mSampleSize;
+    uint64_t mFileSamples;
+
+    const char* mMapped;
+    size_t mMappedSize;
+#ifdef _WIN32
+    void* mFileHandle;
+    void* mMapHandle;
+#else
+    int mFd;
+#endif
+
+    std::vector<IStreamChannel*> mChannels;
+    StreamConfig::StreamDataFormat mStreamFormat;
+    bool mUseTimestamp;
+    uint64_t mStartTimestamp;
+    std::vector<std::vector<char>> mChunks;
+    std::thread mThread;
+    std::atomic<bool> mTerminate;
+    std::atomic<bool> mActive;
+    std::atomic<uint64_t> mSamplesSent;
+    std::atomic<uint64_t> mTimestamp;
+    std::atomic<unsigned> mLoops;
+    unsigned mUnderruns;
+    unsigned mLatePackets;
+};
+
+}
+#endif
@@ -0,0 +1,425 @@
+/**
+    @file StreamRecorder.cpp
+    @author Lime Microsystems
+    @brief Recording of received samples to SigMF files
+*/
+
+#include "StreamRecorder.h"
+#include "ErrorReporting.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ciso646>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+using namespace lime;
+
+//alignment of buffers, file offsets and write sizes required for direct I/O
+static const size_t ioAlignment = 4096;
+//CS16 files use full 16 bit range, integer stream samples are 12 bit
+static const int cs16Scale = 16;
+
+static void* AlignedAlloc(size_t size)
+{
+#ifdef _MSC_VER
+    return _aligned_malloc(size, ioAlignment);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, ioAlignment, size) != 0)
+        return nullptr;
+    return ptr;
+#endif
+}
+
+static void AlignedFree(void* ptr)
+{
+#ifdef _MSC_VER
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+StreamRecorder::Config::Config() :
+    channels(1),
+    format(FORMAT_CS16),
+    sampleRate(0),
+    frequency(0),
+    gain(0),
+    bufferSize(4*1024*1024),
+    buffersCount(2),
+    directIO(true)
+{
+}
+
+StreamRecorder::StreamRecorder() :
+    mFrameSize(0),
+    mActive(-1),
+    mTerminate(false),
+    mWriteError(0),
+    mSampleIndex(0),
+    mNextTimestamp(0),
+    mDropStart(0),
+    mDropCount(0),
+    mFirstWrite(true),
+    mOpen(false),
+    mDirectIO(false),
+    mFd(-1),
+    mFile(nullptr),
+    mBytesWritten(0),
+    mSamplesDropped(0),
+    mOverruns(0)
+{
+}
+
+StreamRecorder::~StreamRecorder()
+{
+    Close();
+}
+
+int StreamRecorder::Open(const Config &config)
+{
+    if (mOpen)
+        return ReportError(EBUSY, "Recording already in progress");
+    if (config.channels == 0)
+        return ReportError(EINVAL, "Recording requires at least one channel");
+
+    mConfig = config;
+    mConfig.buffersCount = std::max(2u, config.buffersCount);
+    SigMFMeta::FileNames(config.filename, mDataFile, mMetaFile);
+
+    mMeta = SigMFMeta();
+    mMeta.datatype = "ci16_le";
+    mMeta.sampleBits = (config.format == FORMAT_CS12) ? 12 : 16;
+    mMeta.sampleRate = config.sampleRate;
+    mMeta.numChannels = config.channels;
+    mMeta.hw = config.hw;
+    mFrameSize = mMeta.FrameSize();
+
+    //buffer must hold whole frames and be multiple of direct I/O block size
+    size_t granularity = ioAlignment;
+    while (granularity % mFrameSize != 0)
+        granularity += ioAlignment;
+    const size_t bufferSize = std::max(granularity, ((config.bufferSize+granularity-1)/granularity)*granularity);
+    mConfig.bufferSize = bufferSize;
+
+    mDirectIO = false;
+#ifdef __unix__
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+    if (config.directIO)
+    {
+        mFd = open(mDataFile.c_str(), flags | O_DIRECT, 0644);
+        mDirectIO = (mFd >= 0);
+    }
+#endif
+    if (mFd < 0)
+        mFd = open(mDataFile.c_str(), flags, 0644);
+    if (mFd < 0)
+        return ReportError(errno, "Failed to create %s", mDataFile.c_str());
+#else
+    mFile = fopen(mDataFile.c_str(), "wb");
+    if (mFile == nullptr)
+        return ReportError(errno, "Failed to create %s", mDataFile.c_str());
+#endif
+
+    mBuffers.clear();
+    mFreeBuffers.clear();
+    mFullBuffers.clear();
+    for (unsigned i = 0; i < mConfig.buffersCount; ++i)
+    {
+        Buffer buf;
+        buf.used = 0;
+        buf.data = (char*)AlignedAlloc(bufferSize);
+        if (buf.data == nullptr)
+        {
+            for (auto &b : mBuffers)
+                AlignedFree(b.data);
+            mBuffers.clear();
+            WriteFile(nullptr, 0, true);
+            return ReportError(ENOMEM, "Failed to allocate recording buffers");
+        }
+        mBuffers.push_back(buf);
+        mFreeBuffers.push_back(i);
+    }
+    mActive = mFreeBuffers.front();
+    mFreeBuffers.pop_front();
+
+    mSampleIndex = 0;
+    mNextTimestamp = 0;
+    mDropCount = 0;
+    mSamplesDropped = 0;
+    mOverruns = 0;
+    mBytesWritten = 0;
+    mWriteError = 0;
+    mFirstWrite = true;
+    mTerminate = false;
+    mOpen = true;
+    mWriterThread = std::thread(&StreamRecorder::WriterLoop, this);
+    lime::info("Recording to %s (%s)", mDataFile.c_str(), mDirectIO ? "direct I/O" : "buffered I/O");
+    return 0;
+}
+
+int StreamRecorder::Close()
+{
+    if (not mOpen)
+        return 0;
+
+    if (mDropCount > 0)
+    {
+        MarkEvent(mDropStart, "overrun: disk write backpressure", mDropCount);
+        std::unique_lock<std::mutex> lck(mLock);
+        ++mOverruns;
+        mDropCount = 0;
+    }
+    {
+        std::unique_lock<std::mutex> lck(mLock);
+        if (mActive >= 0 && mBuffers[mActive].used > 0)
+            mFullBuffers.push_back(mActive);
+        else if (mActive >= 0)
+            mFreeBuffers.push_back(mActive);
+        mActive = -1;
+        mTerminate = true;
+    }
+    mBufferReady.notify_one();
+    mWriterThread.join();
+
+    WriteFile(nullptr, 0, true);
+    for (auto &b : mBuffers)
+        AlignedFree(b.data);
+    mBuffers.clear();
+    mOpen = false;
+
+    int status = mMeta.Save(mMetaFile);
+    if (mWriteError != 0)
+        return ReportError(mWriteError, "Failed to write %s", mDataFile.c_str());
+    return status;
+}
+
+bool StreamRecorder::IsOpen() const
+{
+    return mOpen;
+}
+
+int StreamRecorder::Write(const complex16_t* const* samples, const size_t count, const uint64_t timestamp)
+{
+    if (not mOpen)
+        return ReportError(EPERM, "Recording is not open");
+
+    if (mFirstWrite)
+    {
+        mFirstWrite = false;
+        NewCapture(timestamp);
+    }
+    else if (timestamp != mNextTimestamp && mDropCount == 0)
+    {
+        //samples were lost before reaching recorder
+        const uint64_t lost = (timestamp > mNextTimestamp) ? timestamp - mNextTimestamp : 0;
+        MarkEvent(mNextTimestamp, "discontinuity: stream timestamp gap", lost);
+        NewCapture(timestamp);
+    }
+    mNextTimestamp = timestamp + count;
+
+    size_t done = 0;
+    while (done < count)
+    {
+        if (mActive < 0 && AcquireBuffer() != 0)
+        {
+            //no free buffers, disk is not keeping up
+            if (mDropCount == 0)
+                mDropStart = timestamp + done;
+            std::unique_lock<std::mutex> lck(mLock);
+            mDropCount += count - done;
+            mSamplesDropped += count - done;
+            return done;
+        }
+        if (mDropCount > 0)
+        {
+            MarkEvent(mDropStart, "overrun: disk write backpressure", mDropCount);
+            {
+                std::unique_lock<std::mutex> lck(mLock);
+                ++mOverruns;
+                mDropCount = 0;
+            }
+            NewCapture(timestamp + done);
+        }
+
+        Buffer &buf = mBuffers[mActive];
+        const size_t frames = std::min(count - done, (mConfig.bufferSize - buf.used)/mFrameSize);
+        int16_t* dest = (int16_t*)(buf.data + buf.used);
+        const int scale = (mConfig.format == FORMAT_CS16) ? cs16Scale : 1;
+        for (size_t i = 0; i < frames; ++i)
+            for (unsigned ch = 0; ch < mConfig.channels; ++ch)
+            {
+                *dest++ = samples[ch][done+i].i*scale;
+                *dest++ = samples[ch][done+i].q*scale;
+            }
+        buf.used += frames*mFrameSize;
+        done += frames;
+        mSampleIndex += frames;
+
+        if (buf.used == mConfig.bufferSize && SubmitBuffer() != 0)
+            return -1;
+    }
+    return done;
+}
+
+void StreamRecorder::MarkEvent(const uint64_t timestamp, const std::string &comment, const uint64_t dropped)
+{
+    SigMFMeta::Annotation event;
+    event.sampleStart = mSampleIndex;
+    event.sampleCount = 0;
+    event.timestamp = timestamp;
+    event.dropped = dropped;
+    event.comment = comment;
+    std::unique_lock<std::mutex> lck(mLock);
+    mMeta.annotations.push_back(event);
+}
+
+void StreamRecorder::SetCaptureInfo(const uint64_t timestamp, const double frequency, const double gain)
+{
+    mConfig.frequency = frequency;
+    mConfig.gain = gain;
+    if (not mFirstWrite)
+        NewCapture(timestamp);
+}
+
+StreamRecorder::Stats StreamRecorder::GetStats() const
+{
+    std::unique_lock<std::mutex> lck(mLock);
+    Stats stats;
+    stats.bytesWritten = mBytesWritten.load();
+    stats.samplesWritten = stats.bytesWritten/(mFrameSize ? mFrameSize : 1);
+    stats.samplesDropped = mSamplesDropped;
+    stats.overruns = mOverruns + (mDropCount > 0 ? 1 : 0);
+    stats.events = mMeta.annotations.size();
+    stats.directIO = mDirectIO;
+    return stats;
+}
+
+void StreamRecorder::NewCapture(const uint64_t timestamp)
+{
+    //replace empty segment instead of adding new one
+    if (not mMeta.captures.empty() && mMeta.captures.back().sampleStart == mSampleIndex)
+        mMeta.captures.pop_back();
+    SigMFMeta::Capture capture;
+    capture.sampleStart = mSampleIndex;
+    capture.globalIndex = timestamp;
+    capture.frequency = mConfig.frequency;
+    capture.gain = mConfig.gain;
+    capture.datetime = SigMFMeta::CurrentDatetime();
+    mMeta.captures.push_back(capture);
+}
+
+int StreamRecorder::AcquireBuffer()
+{
+    std::unique_lock<std::mutex> lck(mLock);
+    if (mFreeBuffers.empty())
+        return -1;
+    mActive = mFreeBuffers.front();
+    mFreeBuffers.pop_front();
+    mBuffers[mActive].used = 0;
+    return 0;
+}
+
+int StreamRecorder::SubmitBuffer()
+{
+    {
+        std::unique_lock<std::mutex> lck(mLock);
+        if (mWriteError != 0)
+            return ReportError(mWriteError, "Failed to write %s", mDataFile.c_str());
+        mFullBuffers.push_back(mActive);
+        mActive = -1;
+        if (not mFreeBuffers.empty())
+        {
+            mActive = mFreeBuffers.front();
+            mFreeBuffers.pop_front();
+            mBuffers[mActive].used = 0;
+        }
+    }
+    mBufferReady.notify_one();
+    return 0;
+}
+
+void StreamRecorder::WriterLoop()
+{
+    std::unique_lock<std::mutex> lck(mLock);
+    while (true)
+    {
+        while (mFullBuffers.empty() && not mTerminate)
+            mBufferReady.wait(lck);
+        if (mFullBuffers.empty())
+            break;
+        const int index = mFullBuffers.front();
+        mFullBuffers.pop_front();
+        const bool lastWrite = mTerminate && mFullBuffers.empty();
+        lck.unlock();
+
+        const Buffer &buf = mBuffers[index];
+        int status = WriteFile(buf.data, buf.used, lastWrite);
+
+        lck.lock();
+        if (status != 0 && mWriteError == 0)
+        {
+            mWriteError = status;
+            lime::error("Recording: failed to write %s", mDataFile.c_str());
+        }
+        mFreeBuffers.push_back(index);
+    }
+}
+
+/** @brief Writes data to recording file, closes file when called with null data
+    @param lastWrite length may not be multiple of direct I/O block size
+*/
+int StreamRecorder::WriteFile(const char* data, size_t length, bool lastWrite)
+{
+#ifdef __unix__
+    if (mFd < 0)
+        return EBADF;
+    if (data == nullptr)
+    {
+        close(mFd);
+        mFd = -1;
+        return 0;
+    }
+#ifdef O_DIRECT
+    if (mDirectIO && lastWrite && (length % ioAlignment) != 0)
+        fcntl(mFd, F_SETFL, fcntl(mFd, F_GETFL) & ~O_DIRECT);
+#endif
+    while (length > 0)
+    {
+        ssize_t ret = write(mFd, data, length);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return errno;
+        }
+        data += ret;
+        length -= ret;
+        mBytesWritten += ret;
+    }
+    return 0;
+#else
+    FILE* file = (FILE*)mFile;
+    if (file == nullptr)
+        return EBADF;
+    if (data == nullptr)
+    {
+        fclose(file);
+        mFile = nullptr;
+        return 0;
+    }
+    size_t ret = fwrite(data, 1, length, file);
+    mBytesWritten += ret;
+    return ret == length ? 0 : EIO;
+#endif
+}
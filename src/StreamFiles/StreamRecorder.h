@@ -0,0 +1,150 @@
+/**
+    @file StreamRecorder.h
+    @author Lime Microsystems
+    @brief Recording of received samples to SigMF files
+*/
+
+#ifndef LIME_STREAM_RECORDER_H
+#define LIME_STREAM_RECORDER_H
+
+#include "LimeSuiteConfig.h"
+#include "SigMF.h"
+#include "dataTypes.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace lime
+{
+
+/** @brief Writes multi-channel sample stream to SigMF recording.
+
+    Samples are interleaved into a set of aligned buffers (double buffered by
+    default) which are written to disk by a separate thread, using direct I/O
+    when supported by the file system. Write() never blocks on disk: when all
+    buffers are waiting to be written incoming samples are dropped and the gap
+    is recorded as an overrun annotation and a new capture segment.
+*/
+class LIME_API StreamRecorder
+{
+public:
+    enum SampleFormat
+    {
+        FORMAT_CS16,    //!< 16 bit integer samples, 12 bit stream samples scaled to full range
+        FORMAT_CS12,    //!< 12 bit integer samples stored in 16 bits
+    };
+
+    struct Config
+    {
+        Config();
+        std::string filename;   //!< recording name, SigMF extensions are appended
+        unsigned channels;
+        SampleFormat format;
+        double sampleRate;
+        double frequency;
+        double gain;
+        std::string hw;
+        size_t bufferSize;      //!< size of single write buffer in bytes
+        unsigned buffersCount;  //!< number of write buffers (2 - double buffering)
+        bool directIO;          //!< bypass page cache when possible
+    };
+
+    struct Stats
+    {
+        uint64_t samplesWritten;    //!< samples (of each channel) stored to file
+        uint64_t samplesDropped;    //!< samples lost due to disk backpressure
+        uint64_t bytesWritten;
+        unsigned overruns;          //!< number of disk backpressure events
+        unsigned events;            //!< number of annotations
+        bool directIO;              //!< direct I/O is active
+    };
+
+    StreamRecorder();
+    ~StreamRecorder();
+
+    /** @brief Creates recording files and starts writer thread
+        @return 0 on success
+    */
+    int Open(const Config &config);
+
+    /** @brief Finishes writing buffered data and stores metadata
+        @return 0 on success
+    */
+    int Close();
+
+    bool IsOpen() const;
+
+    /** @brief Appends samples to recording, does not block on disk writes
+        @param samples array of per channel buffers of 12 bit stream samples
+        @param count number of samples in each channel buffer
+        @param timestamp hardware timestamp of first sample
+        @return number of samples accepted, samples not accepted are reported
+        as overrun, -1 on error
+    */
+    int Write(const complex16_t* const* samples, const size_t count, const uint64_t timestamp);
+
+    /** @brief Adds annotation at current recording position
+        @param timestamp hardware timestamp of event
+        @param comment event description
+        @param dropped number of samples lost, if applicable
+    */
+    void MarkEvent(const uint64_t timestamp, const std::string &comment, const uint64_t dropped = 0);
+
+    /** @brief Starts new capture segment with changed RF settings
+        @param timestamp hardware timestamp of the next written sample
+    */
+    void SetCaptureInfo(const uint64_t timestamp, const double frequency, const double gain);
+
+    //! Can be called from other thread than Write()
+    Stats GetStats() const;
+
+private:
+    struct Buffer
+    {
+        char* data;
+        size_t used;
+    };
+
+    void WriterLoop();
+    int SubmitBuffer();
+    int AcquireBuffer();
+    void NewCapture(const uint64_t timestamp);
+    int WriteFile(const char* data, size_t length, bool lastWrite);
+
+    Config mConfig;
+    SigMFMeta mMeta;
+    std::string mDataFile;
+    std::string mMetaFile;
+    size_t mFrameSize;
+
+    std::vector<Buffer> mBuffers;
+    std::deque<int> mFreeBuffers;
+    std::deque<int> mFullBuffers;
+    int mActive;
+    mutable std::mutex mLock; //!< buffer queues, statistics and annotations
+    std::condition_variable mBufferReady;
+    std::thread mWriterThread;
+    bool mTerminate;
+    int mWriteError;
+
+    uint64_t mSampleIndex;
+    uint64_t mNextTimestamp;
+    uint64_t mDropStart;
+    uint64_t mDropCount;
+    bool mFirstWrite;
+    bool mOpen;
+    bool mDirectIO;
+    int mFd;
+    void* mFile;
+
+    std::atomic<uint64_t> mBytesWritten;
+    uint64_t mSamplesDropped;
+    unsigned mOverruns;
+};
+
+}
+#endif
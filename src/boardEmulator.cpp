@@ -18,6 +18,7 @@ using namespace std;
 using namespace lime;
 
 bool stopApplication = false;
+bool verbose = true; //print every packet, disable with -q for timing measurements
 
 int ProcessLMS64C(const uint8_t *input, uint8_t *output);
 
@@ -29,6 +30,8 @@ void ApplicationStopHandler(int s)
 
 int main(int argc, char** argv)
 {
+	if(argc > 1 && strcmp(argv[1], "-q") == 0)
+		verbose = false;
 	struct sigaction sigIntHandler;
 	sigIntHandler.sa_handler = ApplicationStopHandler;
 	sigemptyset(&sigIntHandler.sa_mask);
@@ -84,7 +87,8 @@ int main(int argc, char** argv)
 		timeinfo = localtime(&rawtime);
 		strftime(timeBuf, 80, "[%H:%M:%S] ", timeinfo);
 
-		printf("%s Received: %i\n", timeBuf, bread);
+		if(verbose)
+			printf("%s Received: %i\n", timeBuf, bread);
 		for(int i=0; i<bread; ++i)
 		{
 			inputBuf.push_back(tempbuf[i]);
@@ -100,7 +104,8 @@ int main(int argc, char** argv)
 				time(&rawtime);
 				timeinfo = localtime(&rawtime);
 				strftime(timeBuf, 80, "[%H:%M:%S] ", timeinfo);
-				printf("%s Transmitted: %i\n", timeBuf, bwrite);
+				if(verbose)
+					printf("%s Transmitted: %i\n", timeBuf, bwrite);
 				inputBuf.clear();
 			}
 		}
@@ -139,7 +144,8 @@ uint16_t ReadRegister(const uint16_t addr)
 
 int ProcessLMS64C(const uint8_t *input, uint8_t *output)
 {
-	printf("Got cmd: %i\n", input[0]);
+	if(verbose)
+		printf("Got cmd: %i\n", input[0]);
 	const int hs = 8; //header size
 	const int bufSize = 64;
 	memset(output, 0, bufSize);
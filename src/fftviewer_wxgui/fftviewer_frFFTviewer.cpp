@@ -3,11 +3,10 @@
 #include <vector>
 #include "OpenGLGraph.h"
 #include <LMSBoards.h>
-#include "kiss_fft.h"
+#include "SpectrumPipeline.h"
 #include "IConnection.h"
 #include "dataTypes.h"
 #include "LMS7002M.h"
-#include "windowFunction.h"
 #include <fstream>
 #include "lms7suiteEvents.h"
 
@@ -297,12 +296,7 @@ void fftviewer_frFFTviewer::OnUpdatePlots(wxThreadEvent& event)
         if (chkFreezeFFT->IsChecked() == false)
         {
             for (int ch = 0; ch<2; ++ch)
-            {
-                for (int s = 0; s < fftSize; ++s)
-                {
-                    streamData.fftBins[ch][s] = (streamData.fftBins[ch][s] != 0 ? (10 * log10(streamData.fftBins[ch][s])) - dbOffset : -300);
-                }
-            }
+                PowerToDB(&streamData.fftBins[ch][0], &streamData.fftBins[ch][0], streamData.fftBins[ch].size(), dbOffset);
             mFFTpanel->series[0]->AssignValues(&fftFreqAxis[0], &streamData.fftBins[0][0], fftSize);
             mFFTpanel->series[1]->AssignValues(&fftFreqAxis[0], &streamData.fftBins[1][0], fftSize);
         }
@@ -344,9 +338,6 @@ void fftviewer_frFFTviewer::StreamingLoop(fftviewer_frFFTviewer* pthis, const un
         if (pthis->cmbChannelVisibility->GetSelection() == 1)
             ch_offset = 1;
     }
-    vector<float> wndCoef;
-    GenerateWindowCoefficients(wndFunction, fftSize, wndCoef, 1);
-
     lime::complex16_t** buffers;
 
     DataToGUI localDataResults;
@@ -393,9 +384,10 @@ void fftviewer_frFFTviewer::StreamingLoop(fftviewer_frFFTviewer* pthis, const un
             LMS_SetupStream(pthis->lmsControl, &pthis->txStreams[i]);
     }
 
-    kiss_fft_cfg m_fftCalcPlan = kiss_fft_alloc(fftSize, 0, 0, 0);
-    kiss_fft_cpx* m_fftCalcIn = new kiss_fft_cpx[fftSize];
-    kiss_fft_cpx* m_fftCalcOut = new kiss_fft_cpx[fftSize];
+    //windowing, FFT and averaging run in worker threads, this thread only acquires
+    lime::SpectrumPipeline spectrum(fftSize, channelsCount);
+    spectrum.SetWindow(wndFunction);
+    spectrum.SetAverageCount(avgCount);
 
     for(int i=0; i<channelsCount; ++i)
     {
@@ -410,110 +402,77 @@ void fftviewer_frFFTviewer::StreamingLoop(fftviewer_frFFTviewer* pthis, const un
     pthis->mStreamRunning.store(true);
     lms_stream_meta_t meta;
     meta.waitForTimestamp = true;
-    int fftCounter = 0;
+    int framesCounter = 0;
 
     while (pthis->stopProcessing.load() == false)
     {
-        do
+        uint32_t samplesPopped[cMaxChCount];
+        uint64_t ts[cMaxChCount];
+        for(int i=0; i<channelsCount; ++i)
         {
-            uint32_t samplesPopped[cMaxChCount];
-            uint64_t ts[cMaxChCount];
-            for(int i=0; i<channelsCount; ++i)
-            {
-                samplesPopped[i] = LMS_RecvStream(&pthis->rxStreams[i], &buffers[i][0], fftSize, &meta, 1000);
-                ts[i] = meta.timestamp + fifoSize/4;
-            }
+            samplesPopped[i] = LMS_RecvStream(&pthis->rxStreams[i], &buffers[i][0], fftSize, &meta, 1000);
+            ts[i] = meta.timestamp + fifoSize/4;
+        }
 
-            for(int i=0; runTx && i<channelsCount; ++i)
-            {
-                meta.timestamp = ts[i];
-                meta.waitForTimestamp = true;
-                LMS_SendStream(&pthis->txStreams[i], &buffers[i][0], samplesPopped[i], &meta, 1000);
-            }
+        for(int i=0; runTx && i<channelsCount; ++i)
+        {
+            meta.timestamp = ts[i];
+            meta.waitForTimestamp = true;
+            LMS_SendStream(&pthis->txStreams[i], &buffers[i][0], samplesPopped[i], &meta, 1000);
+        }
 
-            if(pthis->captureSamples.load())
+        if(pthis->captureSamples.load())
+        {
+            for(int ch=0; ch<channelsCount; ++ch)
             {
-                for(int ch=0; ch<channelsCount; ++ch)
-                {
-                    uint32_t samplesToCopy = samplesPopped[ch] < samplesToCapture[ch] ? samplesPopped[ch] : samplesToCapture[ch];
-                    if(samplesToCopy <= 0)
-                        break;
-                    memcpy(captureBuffer[ch].data(), buffers[ch], samplesPopped[ch]*sizeof(complex16_t));
-                    samplesToCapture[ch] -= samplesPopped[ch];
-                }
+                uint32_t samplesToCopy = samplesPopped[ch] < samplesToCapture[ch] ? samplesPopped[ch] : samplesToCapture[ch];
+                if(samplesToCopy <= 0)
+                    break;
+                memcpy(captureBuffer[ch].data(), buffers[ch], samplesPopped[ch]*sizeof(complex16_t));
+                samplesToCapture[ch] -= samplesPopped[ch];
             }
+        }
+
+        //frames are dropped when workers are busy, stream keeps running
+        bool resultsReady;
+        if (fftEnabled)
+        {
+            spectrum.Push(buffers);
+            resultsReady = pthis->updateGUI.load() && spectrum.GetSpectrum(localDataResults.fftBins);
+        }
+        else
+            resultsReady = ++framesCounter >= avgCount && pthis->updateGUI.load();
 
+        if (resultsReady && pthis->stopProcessing.load() == false)
+        {
+            //time domain display shows latest buffer
             for (int ch = 0; ch < channelsCount; ++ch)
             {
-                //take only first buffer for time domain display
-                //reset fftBins for accumulation
-                for (unsigned i = 0; fftCounter==0 && i < fftSize; ++i)
+                for (unsigned i = 0; i < fftSize; ++i)
                 {
-                    if (fftEnabled)
-                        localDataResults.fftBins[ch][i] = 0;
                     localDataResults.samplesI[ch][i] = buffers[ch][i].i;
                     localDataResults.samplesQ[ch][i] = buffers[ch][i].q;
                 }
-                if (fftEnabled)
-                {
-                    if (wndFunction == 0)
-                    {
-                        for (unsigned i = 0; i < fftSize; ++i)
-                        {
-                            m_fftCalcIn[i].r = buffers[ch][i].i;
-                            m_fftCalcIn[i].i = buffers[ch][i].q;
-                        }
-                    }
-                    else
-                    {
-                        for (unsigned i = 0; i < fftSize; ++i)
-                        {
-                            m_fftCalcIn[i].r = buffers[ch][i].i * wndCoef[i];
-                            m_fftCalcIn[i].i = buffers[ch][i].q * wndCoef[i];
-                        }
-                    }
-
-                    kiss_fft(m_fftCalcPlan, m_fftCalcIn, m_fftCalcOut);
-
-                    int output_index = 0;
-                    for (unsigned i = fftSize / 2 + 1; i < fftSize; ++i)
-                        localDataResults.fftBins[ch][output_index++] += m_fftCalcOut[i].r * m_fftCalcOut[i].r + m_fftCalcOut[i].i * m_fftCalcOut[i].i;
-                    for (unsigned i = 0; i < fftSize / 2 + 1; ++i)
-                        localDataResults.fftBins[ch][output_index++] += m_fftCalcOut[i].r * m_fftCalcOut[i].r + m_fftCalcOut[i].i * m_fftCalcOut[i].i;
-                }
             }
-        } while (++fftCounter < avgCount && pthis->stopProcessing.load() == false);
+            pthis->streamData = localDataResults;
+            wxThreadEvent* evt = new wxThreadEvent;
+            evt->SetEventObject(pthis);
+            pthis->updateGUI.store(false);
+            pthis->QueueEvent(evt);
 
-        if (fftCounter >= avgCount && pthis->updateGUI.load() == true)
-        {
-            //shift fft
-            if (fftEnabled)
-            {
-                for(int ch=0; ch<channelsCount; ++ch)
-                {
-                    for (unsigned s = 0; s < fftSize; ++s)
-                    {
-                        const float div = (float)fftCounter*fftSize*fftSize;
-                        localDataResults.fftBins[ch][s] /= div;
-                    }
-                }
-            }
-            if(pthis->stopProcessing.load() == false)
+            framesCounter = 0;
+            fftEnabled = pthis->enableFFT.load();
+            int avgCountSelection = pthis->averageCount.load();
+            if (avgCountSelection != avgCount)
             {
-                pthis->streamData = localDataResults;
-                wxThreadEvent* evt = new wxThreadEvent;
-                evt->SetEventObject(pthis);
-                pthis->updateGUI.store(false);
-                pthis->QueueEvent(evt);
+                avgCount = avgCountSelection;
+                spectrum.SetAverageCount(avgCount);
             }
-            fftCounter = 0;
-            fftEnabled = pthis->enableFFT.load();
-            avgCount = pthis->averageCount.load();
             int wndFunctionSelection = pthis->windowFunctionID.load();
             if(wndFunctionSelection != wndFunction)
             {
                 wndFunction = wndFunctionSelection;
-                GenerateWindowCoefficients(wndFunction, fftSize, wndCoef, 1);
+                spectrum.SetWindow(wndFunction);
             }
         }
     }
@@ -557,7 +516,6 @@ void fftviewer_frFFTviewer::StreamingLoop(fftviewer_frFFTviewer* pthis, const un
         }
     }
 
-    kiss_fft_free(m_fftCalcPlan);
     pthis->stopProcessing.store(true);
     pthis->mStreamRunning.store(false);
     for(int i=0; i<channelsCount; ++i)
@@ -575,8 +533,6 @@ void fftviewer_frFFTviewer::StreamingLoop(fftviewer_frFFTviewer* pthis, const un
     for (int i = 0; i < channelsCount; ++i)
         delete [] buffers[i];
     delete [] buffers;
-    delete [] m_fftCalcIn;
-    delete [] m_fftCalcOut;
 }
 
 wxString fftviewer_frFFTviewer::printDataRate(float dataRate)
@@ -500,6 +500,134 @@ API_EXPORT int CALL_CONV LMS_SetGFIRLPF(lms_device_t *device, bool dir_tx,
 API_EXPORT int CALL_CONV LMS_Calibrate(lms_device_t *device, bool dir_tx,
                                         size_t chan, double bw, unsigned flags);
 
+/**Handle of calibration running in background, see LMS_CalibrateAsync()*/
+typedef void lms_calibration_t;
+
+/**
+ * Function called from calibration thread when calibration finishes.
+ * It must not call LMS_WaitCalibration() or LMS_DestroyCalibration() for the
+ * finished calibration, the calibration is complete after callback returns.
+ *
+ * @param status        0 on success, (-1) on failure or cancellation
+ * @param duration_ms   calibration duration in milliseconds
+ * @param userData      pointer passed to LMS_CalibrateAsync()
+ */
+typedef void (*lms_calibration_cb_t)(int status, double duration_ms, void *userData);
+
+/**
+ * Start automatic calibration of specified RX/TX channel in background thread,
+ * see LMS_Calibrate(). Calibrations of channels on different RF chips run
+ * concurrently, calibrations on the same chip are performed one after another.
+ *
+ * @param   device      Device handle previously obtained by LMS_Open().
+ * @param   dir_tx      Select RX or TX
+ * @param   chan        channel index
+ * @param   bw          bandwidth
+ * @param   flags       additional calibration flags (normally should be 0)
+ * @param   callback    optional function called on completion (can be NULL)
+ * @param   userData    pointer passed to callback
+ *
+ * @return  calibration handle, NULL on failure.
+ *          Handle must be released with LMS_DestroyCalibration()
+ */
+API_EXPORT lms_calibration_t* CALL_CONV LMS_CalibrateAsync(lms_device_t *device,
+                        bool dir_tx, size_t chan, double bw, unsigned flags,
+                        lms_calibration_cb_t callback, void *userData);
+
+/**
+ * Wait for background calibration to finish
+ *
+ * @param   calibration handle obtained by LMS_CalibrateAsync()
+ * @param   timeout_ms  maximum wait time in milliseconds
+ * @param[out] duration_ms calibration duration in milliseconds (can be NULL)
+ *
+ * @return  1 if calibration is still running, calibration result otherwise:
+ *          0 on success, (-1) on failure or cancellation
+ */
+API_EXPORT int CALL_CONV LMS_WaitCalibration(lms_calibration_t *calibration,
+                                unsigned timeout_ms, double *duration_ms);
+
+/**
+ * Request background calibration to stop. Calibration stops at the next stage,
+ * restores chip registers and finishes with failure.
+ *
+ * @param   calibration handle obtained by LMS_CalibrateAsync()
+ *
+ * @return  0 on success, (-1) on failure
+ */
+API_EXPORT int CALL_CONV LMS_CancelCalibration(lms_calibration_t *calibration);
+
+/**
+ * Wait for background calibration to finish and release its handle
+ *
+ * @param   calibration handle obtained by LMS_CalibrateAsync()
+ *
+ * @return  0 on success, (-1) on failure
+ */
+API_EXPORT int CALL_CONV LMS_DestroyCalibration(lms_calibration_t *calibration);
+
+/**Search statistics of the last calibration*/
+typedef struct
+{
+    unsigned rssiReads;     ///<Number of RSSI measurements performed
+    bool warmStart;         ///<Searches started from cached results of near frequency
+    unsigned fullSearches;  ///<Seeded searches that had to be repeated over full range
+}lms_cal_stats_t;
+
+/**
+ * Get search statistics of the last LMS_Calibrate() in given direction performed
+ * on RF chip of the specified channel. When calibration cache is enabled
+ * (LMS_EnableCalibCache()) searches start from results of near frequencies and
+ * need fewer measurements.
+ *
+ * @param   device      Device handle previously obtained by LMS_Open().
+ * @param   dir_tx      Select RX or TX
+ * @param   chan        channel index
+ * @param[out] stats    calibration statistics
+ *
+ * @return  0 on success, (-1) on failure
+ */
+API_EXPORT int CALL_CONV LMS_GetCalibrationStats(lms_device_t *device, bool dir_tx, size_t chan, lms_cal_stats_t *stats);
+
+#define LMS_CALIB_RSSI_TX        0x0001  ///<LMS_Calibrate() of TX
+#define LMS_CALIB_RSSI_RX        0x0002  ///<LMS_Calibrate() of RX
+#define LMS_CALIB_RSSI_TX_FILTER 0x0004  ///<TX LPF tuning of LMS_SetLPFBW()
+#define LMS_CALIB_RSSI_RX_FILTER 0x0008  ///<RX LPF tuning of LMS_SetLPFBW()
+
+/**RSSI estimation from streamed samples, see LMS_SetCalibRSSI()*/
+typedef struct
+{
+    ///Calibrations using the estimator, LMS_CALIB_RSSI_* flags, 0 for chip RSSI
+    uint32_t calibrations;
+    ///0 - RMS of all samples, 1 - Goertzel filter at frequency, 2 - FFT bin nearest to frequency
+    uint32_t method;
+    ///Tone frequency offset from RX LO (Hz) for Goertzel and FFT methods
+    float_type frequency;
+    ///Samples per estimate, power of two for FFT method, 0 for default (4096)
+    uint32_t windowSize;
+    ///Estimates averaged per measurement, 0 for default (1)
+    uint32_t averages;
+    ///Samples dropped after each register change, 0 for default (8192)
+    uint32_t skipSamples;
+}lms_calib_rssi_t;
+
+/**
+ * Selects how calibrations of RF chip of the specified channel measure
+ * signal. By default chip RSSI registers are read over control interface
+ * after fixed delay for each search point. Selected calibrations instead read
+ * a short burst of RX samples and estimate amplitude on host, which needs
+ * fewer control transactions. Applies to calibrations performed by host, the
+ * RX stream of the calibrated channel must not be set up by application
+ * during calibration, otherwise chip RSSI is used.
+ *
+ * @param   device      Device handle previously obtained by LMS_Open().
+ * @param   chan        channel index
+ * @param   config      estimator configuration
+ *
+ * @return  0 on success, (-1) on failure
+ */
+API_EXPORT int CALL_CONV LMS_SetCalibRSSI(lms_device_t *device, size_t chan, const lms_calib_rssi_t *config);
+
 /**
  * Load LMS chip configuration from a file
  *
@@ -715,6 +843,35 @@ API_EXPORT int CALL_CONV LMS_ReadParam(lms_device_t *device,
 API_EXPORT int CALL_CONV LMS_WriteParam(lms_device_t *device,
                                       struct LMS7Parameter param, uint16_t val);
 
+/**
+ * Read multiple device parameters. Parameters of the same register are
+ * read with a single register access, registers are read in one transaction.
+ *
+ * @param device    Device handle previously obtained by LMS_Open().
+ * @param params    Array of parameters.
+ * @param vals      Array for current parameter values.
+ * @param count     Number of parameters.
+ *
+ * @return  0 on success, (-1) on failure
+ */
+API_EXPORT int CALL_CONV LMS_ReadParams(lms_device_t *device,
+                const struct LMS7Parameter *params, uint16_t *vals, size_t count);
+
+/**
+ * Write multiple device parameters. Values of parameters in the same register
+ * are merged and each register is written once. Parameters are applied in
+ * order, so parameters following a change of MAC address the selected channel.
+ *
+ * @param device    Device handle previously obtained by LMS_Open().
+ * @param params    Array of parameters.
+ * @param vals      Array of parameter values to write.
+ * @param count     Number of parameters.
+ *
+ * @return  0 on success, (-1) on failure
+ */
+API_EXPORT int CALL_CONV LMS_WriteParams(lms_device_t *device,
+          const struct LMS7Parameter *params, const uint16_t *vals, size_t count);
+
 /**
  * Configure LMS GFIR using specified filter coefficients. Maximum number of
  * coefficients is 40 for GFIR1 and GFIR2, and 120 for GFIR3.
@@ -973,6 +1130,22 @@ API_EXPORT int CALL_CONV LMS_GPIODirWrite(lms_device_t *dev, const uint8_t* buff
  */
 API_EXPORT int CALL_CONV LMS_EnableCalibCache(lms_device_t *dev, bool enable);
 
+/**
+ * Enables or disables calibration table mode. In table mode DC/IQ corrections
+ * stored in calibration cache are applied whenever LO frequency or antenna
+ * changes, interpolating between nearest calibrated frequencies, so retuning
+ * needs no calibration. Cache entries are loaded when table is enabled,
+ * they can be created with LimeUtil --cal sweep. When table has no entry
+ * near the new frequency, corrections are left unchanged and the miss is
+ * logged and kept as last error message, but retuning still succeeds.
+ *
+ * @param   dev         Device handle previously obtained by LMS_Open().
+ * @param   enable      true to enable calibration table
+ *
+ * @return 0 on success, (-1) on failure
+ */
+API_EXPORT int CALL_CONV LMS_EnableCalibTable(lms_device_t *dev, bool enable);
+
 /**
  * Read LMS7 chip internal temperature sensor
  *
@@ -1155,6 +1328,87 @@ API_EXPORT int CALL_CONV LMS_SendStream(lms_stream_t *stream,
                             const void *samples,size_t sample_count,
                             const lms_stream_meta_t *meta, unsigned timeout_ms);
 
+/**Host DSP stage configuration, see LMS_SetupStreamDSP()*/
+typedef struct
+{
+    ///Frequency offset (Hz) moved to 0 Hz by host NCO mixer
+    float_type ncoFrequency;
+    /**Decimation before channelizer, 0 to select from sampleRate. 1 to 1024,
+     * even values up to 2048 or multiples of 4 up to 4096.*/
+    uint32_t decimation;
+    ///Number of channelizer sub-streams, 1 for no channelizer
+    uint32_t channels;
+    /**Sub-stream sample rate (Hz), 0 for rate/(decimation*channels).
+     * Other rates are produced by host resampler, after decimation it may
+     * change rate by factor 0.5 to 2. Rates between hardware rates can be
+     * used without retuning CGEN, which also affects the other direction.*/
+    float_type sampleRate;
+}lms_stream_dsp_t;
+
+/**
+ * Attaches host DSP stage to RX stream: NCO mixer, CIC/half-band decimation
+ * and polyphase channelizer. Each sub-stream is read with LMS_RecvStream() in
+ * the same data format as the source stream. Starting any sub-stream starts
+ * the source stream, which must not be read directly while sub-streams run.
+ *
+ * Sub-stream k is centered at ncoFrequency + k*subStreamRate, sub-streams
+ * above channels/2 are negative frequencies. Timestamps count
+ * source stream samples. The stage is freed by LMS_DestroyStream() of the
+ * source stream, LMS_DestroyStream() of sub-streams does nothing.
+ *
+ * @param device        Device handle previously obtained by LMS_Open().
+ * @param stream        RX stream previously initialized with LMS_SetupStream().
+ * @param config        DSP configuration.
+ * @param subStreams    array of config->channels streams, initialized with handles.
+ *
+ * @return 0 on success, (-1) on failure
+ */
+API_EXPORT int CALL_CONV LMS_SetupStreamDSP(lms_device_t *device, lms_stream_t *stream,
+                            const lms_stream_dsp_t *config, lms_stream_t *subStreams);
+
+/**
+ * Publishes RX stream to shared memory, where any number of processes can
+ * read it with LMS_OpenSharedStream(). Samples are read from the stream by
+ * a publishing thread, which never waits for readers. The stream is started
+ * and must not be read directly while published.
+ *
+ * Shared memory is available on POSIX systems only.
+ *
+ * @param device        Device handle previously obtained by LMS_Open().
+ * @param stream        RX stream previously initialized with LMS_SetupStream().
+ * @param name          shared stream name, NULL to stop publishing.
+ * @param ringSize      shared ring size in samples, rounded up to power of two.
+ *
+ * @return 0 on success, (-1) on failure
+ */
+API_EXPORT int CALL_CONV LMS_PublishStream(lms_device_t *device, lms_stream_t *stream,
+                            const char *name, size_t ringSize);
+
+/**
+ * Opens stream published with LMS_PublishStream(), possibly by another
+ * process. The stream is read with LMS_RecvStream() and has its own read
+ * position, it starts at the newest sample when LMS_StartStream() is called.
+ * Timestamps are those of the published stream. When the reader is slower
+ * than the stream, samples are skipped and counted in overrun of
+ * LMS_GetStreamStatus().
+ *
+ * @param name      shared stream name.
+ * @param stream    stream structure to initialize, data format and FIFO size
+ *                  are set from the shared stream.
+ *
+ * @return 0 on success, (-1) on failure
+ */
+API_EXPORT int CALL_CONV LMS_OpenSharedStream(const char *name, lms_stream_t *stream);
+
+/**
+ * Closes stream opened with LMS_OpenSharedStream().
+ *
+ * @param stream    stream previously opened with LMS_OpenSharedStream().
+ *
+ * @return 0 on success, (-1) on failure
+ */
+API_EXPORT int CALL_CONV LMS_CloseSharedStream(lms_stream_t *stream);
+
 /**
  * Uploads waveform to on board memory for later use
  * @param device        Device handle previously obtained by LMS_Open().
@@ -1230,6 +1484,9 @@ API_EXPORT int CALL_CONV LMS_Program(lms_device_t *device, const char *data, siz
 /**
  * Automatically update device firmware
  *
+ * Images with versions matching the ones running on the board are skipped,
+ * use LMS_Program() to rewrite them.
+ *
  * @param dev       Device handle previously obtained by LMS_Open().
  * @param download  True to download missing images from the web.
  * @param callback  callback function for monitoring progress
@@ -36,15 +36,23 @@ void LMS7002_WXGUI::UpdateControlsByMap(wxPanel* panel, lms_device_t* lmsControl
     wxClassInfo *labelInfo = wxClassInfo::FindClass(_("wxStaticText"));
     wxClassInfo *radioBtnInfo = wxClassInfo::FindClass(_("wxRadioButton"));
 
+    //read all registers of the panel in one transaction
+    std::vector<LMS7Parameter> params;
+    for (auto idParam : wndId2param)
+        params.push_back(idParam.second);
+    std::vector<uint16_t> values(params.size(), 0);
+    LMS7_Device* lms = (LMS7_Device*)lmsControl;
+    lms->ReadParams(params.data(), values.data(), params.size(), true);
+
+    size_t index = 0;
     for (auto idParam : wndId2param)
     {
+        value = values[index++];
         wnd = idParam.first;
         if (wnd == nullptr)
             continue;
         wndClass = wnd->GetClassInfo();
 
-        LMS7_Device* lms = (LMS7_Device*)lmsControl;
-        lms->ReadParam(idParam.second, &value, true);
         //cast window to specific control, to set value, or set selection
         if (wndClass->IsKindOf(cmbInfo))
         {
@@ -161,20 +161,18 @@ void lms7002_pnlRFE_view::UpdateGUI()
     LMS7002_WXGUI::UpdateControlsByMap(this, lmsControl, wndId2Enum);
 
     uint16_t value;
-    LMS_ReadParam(lmsControl,LMS7param(G_LNA_RFE),&value);
-    cmbG_LNA_RFE->SetSelection( value2index(value, g_lna_rfe_IndexValuePairs));
-
-    LMS_ReadParam(lmsControl,LMS7param(G_TIA_RFE),&value);
-    cmbG_TIA_RFE->SetSelection( value2index(value, g_tia_rfe_IndexValuePairs));
-
-    LMS_ReadParam(lmsControl,LMS7param(DCOFFI_RFE),&value);
-    int16_t dcvalue = value & 0x3F;
-    if((value & 0x40) != 0)
+    const LMS7Parameter params[] = {LMS7param(G_LNA_RFE), LMS7param(G_TIA_RFE), LMS7param(DCOFFI_RFE), LMS7param(DCOFFQ_RFE)};
+    uint16_t values[4] = {0};
+    LMS_ReadParams(lmsControl, params, values, 4);
+    cmbG_LNA_RFE->SetSelection( value2index(values[0], g_lna_rfe_IndexValuePairs));
+    cmbG_TIA_RFE->SetSelection( value2index(values[1], g_tia_rfe_IndexValuePairs));
+
+    int16_t dcvalue = values[2] & 0x3F;
+    if((values[2] & 0x40) != 0)
         dcvalue *= -1;
     cmbDCOFFI_RFE->SetValue(dcvalue);
-    LMS_ReadParam(lmsControl,LMS7param(DCOFFQ_RFE),&value);
-    dcvalue = value & 0x3F;
-    if((value & 0x40) != 0)
+    dcvalue = values[3] & 0x3F;
+    if((values[3] & 0x40) != 0)
         dcvalue *= -1;
     cmbDCOFFQ_RFE->SetValue(dcvalue);
 
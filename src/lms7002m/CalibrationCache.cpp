@@ -366,6 +366,81 @@ int CalibrationCache::GetDC_IQ_Interp(uint32_t boardId, double frequency, uint8_
     return 0;
 }
 
+int CalibrationCache::GetDC_IQ_Nearest(uint32_t boardId, double frequency, double maxDistance, uint8_t channel, bool transmitter, int band_lna, int *dcI, int *dcQ, int *gainI, int *gainQ, int *phaseOffset, double *foundFrequency)
+{
+    std::vector<double> closeFreqs;
+
+    auto lambda_callback = [](void *data, int argc, char **argv, char **azColName)
+    {
+        std::vector<double> *data_freqs = (std::vector<double>*)data;
+        if(data != nullptr)
+        {
+            if (argc > 0 && argv[0] != nullptr)
+                data_freqs->push_back(double(std::stoll(argv[0])));
+            return 0;
+        }
+        return 1;
+    };
+
+    char* zErrMsg = 0;
+    stringstream query;
+    query << "SELECT frequency FROM LMS7002M_DC_IQ where "<<
+"boardID="<<boardId<<
+" AND frequency >= "<<std::llrint(frequency - maxDistance)<<
+" AND frequency <= "<<std::llrint(frequency + maxDistance)<<
+" AND channel="<<(int)channel<<
+" AND transmitter="<<(transmitter?1:0)<<
+" AND band_lna="<<band_lna<<
+" ORDER BY abs(frequency - "<<std::llrint(frequency)<<") LIMIT 1;";
+
+    int rc = sqlite3_exec(db, query.str().c_str(), lambda_callback, &closeFreqs, &zErrMsg);
+    if( rc != SQLITE_OK )
+    {
+        lime::error("SQL error: %s", zErrMsg);
+        ReportError("SQL error: %s", zErrMsg);
+        sqlite3_free(zErrMsg);
+        return -1;
+    }
+    if (closeFreqs.empty()) return ReportError(
+        "GetDC_IQ_Nearest(%g MHz, ch=%d, tx=%d): no matches within %g MHz",
+        frequency/1e6, int(channel), transmitter, maxDistance/1e6);
+    if (foundFrequency)
+        *foundFrequency = closeFreqs.front();
+    return GetDC_IQ(boardId, closeFreqs.front(), channel, transmitter, band_lna, dcI, dcQ, gainI, gainQ, phaseOffset);
+}
+
+int CalibrationCache::ForEachDC_IQ(uint32_t boardId, const DC_IQ_Callback &callback)
+{
+    auto lambda_callback = [](void *data, int argc, char **argv, char **azColName)
+    {
+        const DC_IQ_Callback *cb = (const DC_IQ_Callback*)data;
+        if(cb == nullptr || argc < 9)
+            return 1;
+        int values[9] = {0};
+        for (int i = 1; i < 9; i++) //frequency does not fit int
+            values[i] = argv[i] != nullptr ? std::stoi(argv[i]) : 0;
+        (*cb)(argv[0] != nullptr ? double(std::stoll(argv[0])) : 0,
+            values[1], values[2] != 0, values[3],
+            values[4], values[5], values[6], values[7], values[8]);
+        return 0;
+    };
+
+    char* zErrMsg = 0;
+    stringstream query;
+    query << "SELECT frequency, channel, transmitter, band_lna, dcI, dcQ, gainI, gainQ, phaseOffset FROM LMS7002M_DC_IQ where "<<
+"boardID="<<boardId<<";";
+
+    int rc = sqlite3_exec(db, query.str().c_str(), lambda_callback, (void*)&callback, &zErrMsg);
+    if( rc != SQLITE_OK )
+    {
+        lime::error("SQL error: %s", zErrMsg);
+        ReportError("SQL error: %s", zErrMsg);
+        sqlite3_free(zErrMsg);
+        return -1;
+    }
+    return 0;
+}
+
 int CalibrationCache::InsertFilter_RC(uint32_t boardId, double bandwidth, uint8_t channel, bool transmitter, int filter_id, int rcal, int ccal, int cfb)
 {
     char* zErrMsg = 0;
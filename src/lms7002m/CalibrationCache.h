@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <list>
 #include <sstream>
+#include <functional>
 #include <sqlite3.h>
 namespace lime
 {
@@ -20,6 +21,10 @@ public:
     int InsertDC_IQ(uint32_t boardId, double frequency, uint8_t channel, bool transmitter, int band_lna, int dcI, int dcQ, int gainI, int gainQ, int phaseOffset);
     int GetDC_IQ(uint32_t boardId, double frequency, uint8_t channel, bool transmitter, int band_lna, int *dcI, int *dcQ, int *gainI, int *gainQ, int *phaseOffset);
     int GetDC_IQ_Interp(uint32_t boardId, double frequency, uint8_t channel, bool transmitter, int band_lna, int *dcI, int *dcQ, int *gainI, int *gainQ, int *phaseOffset);
+    typedef std::function<void(double frequency, uint8_t channel, bool transmitter, int band_lna, int dcI, int dcQ, int gainI, int gainQ, int phaseOffset)> DC_IQ_Callback;
+    //! Calls callback with every DC/IQ entry of the board
+    int ForEachDC_IQ(uint32_t boardId, const DC_IQ_Callback &callback);
+    int GetDC_IQ_Nearest(uint32_t boardId, double frequency, double maxDistance, uint8_t channel, bool transmitter, int band_lna, int *dcI, int *dcQ, int *gainI, int *gainQ, int *phaseOffset, double *foundFrequency = nullptr);
 
     int InsertFilter_RC(uint32_t boardId, double bandwidth, uint8_t channel, bool transmitter, int filter_id, int rcal, int ccal, int cfb = 0);
     int GetFilter_RC(uint32_t boardId, double bandwidth, uint8_t channel, bool transmitter, int filter_id, int *rcal, int *ccal, int *cfb = nullptr);
@@ -0,0 +1,98 @@
+/**
+    @file CalibrationTable.cpp
+    @author Lime Microsystems
+    @brief In memory table of DC/IQ corrections for applying on retune
+*/
+
+#include "CalibrationTable.h"
+#include "CalibrationCache.h"
+#include <cmath>
+#include <ciso646>
+
+using namespace lime;
+
+int CalibrationTable::Load(CalibrationCache* cache, uint32_t boardId)
+{
+    Clear();
+    return cache->ForEachDC_IQ(boardId, [this](double frequency, uint8_t channel, bool transmitter, int band_lna, int dcI, int dcQ, int gainI, int gainQ, int phaseOffset)
+    {
+        Entry entry;
+        //Rx DC is stored as 7 bit sign-magnitude register value
+        if (not transmitter)
+        {
+            dcI = (dcI & 0x3f) * (dcI & 0x40 ? -1 : 1);
+            dcQ = (dcQ & 0x3f) * (dcQ & 0x40 ? -1 : 1);
+        }
+        entry.dcI = dcI;
+        entry.dcQ = dcQ;
+        entry.gainI = gainI;
+        entry.gainQ = gainQ;
+        //12 bit two's complement register value
+        entry.phaseOffset = int16_t(uint16_t(phaseOffset) << 4) >> 4;
+        Insert(frequency, channel, transmitter, band_lna, entry);
+    });
+}
+
+void CalibrationTable::Insert(double frequency, uint8_t channel, bool transmitter, int band_lna, const Entry &entry)
+{
+    mEntries[Key(channel, transmitter, band_lna)][frequency] = entry;
+}
+
+void CalibrationTable::Clear()
+{
+    mEntries.clear();
+}
+
+size_t CalibrationTable::Size() const
+{
+    size_t count = 0;
+    for (const auto &path : mEntries)
+        count += path.second.size();
+    return count;
+}
+
+static int Interpolate(double x, double x0, int y0, double x1, int y1)
+{
+    return int(std::lrint(y0 + (y1 - y0)*(x - x0)/(x1 - x0)));
+}
+
+bool CalibrationTable::Lookup(double frequency, uint8_t channel, bool transmitter, int band_lna, Entry &result, double maxDistance) const
+{
+    auto path = mEntries.find(Key(channel, transmitter, band_lna));
+    if (path == mEntries.end() or path->second.empty())
+        return false;
+    const auto &freqs = path->second;
+
+    //first entry not below frequency and the one before it
+    auto above = freqs.lower_bound(frequency);
+    auto below = above;
+    bool hasBelow = false;
+    if (below != freqs.begin())
+    {
+        --below;
+        hasBelow = frequency - below->first <= maxDistance;
+    }
+    const bool hasAbove = above != freqs.end() and above->first - frequency <= maxDistance;
+
+    if (hasAbove and above->first == frequency)
+        result = above->second;
+    else if (hasAbove and hasBelow)
+    {
+        const double f0 = below->first;
+        const double f1 = above->first;
+        const Entry &e0 = below->second;
+        const Entry &e1 = above->second;
+        result.dcI = Interpolate(frequency, f0, e0.dcI, f1, e1.dcI);
+        result.dcQ = Interpolate(frequency, f0, e0.dcQ, f1, e1.dcQ);
+        result.gainI = Interpolate(frequency, f0, e0.gainI, f1, e1.gainI);
+        result.gainQ = Interpolate(frequency, f0, e0.gainQ, f1, e1.gainQ);
+        result.phaseOffset = Interpolate(frequency, f0, e0.phaseOffset, f1, e1.phaseOffset);
+    }
+    else if (hasAbove)
+        result = above->second;
+    else if (hasBelow)
+        result = below->second;
+    else
+        return false;
+    return true;
+}
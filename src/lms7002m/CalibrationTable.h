@@ -0,0 +1,60 @@
+/**
+    @file CalibrationTable.h
+    @author Lime Microsystems
+    @brief In memory table of DC/IQ corrections for applying on retune
+*/
+
+#ifndef LIME_CALIBRATION_TABLE_H
+#define LIME_CALIBRATION_TABLE_H
+
+#include "LimeSuiteConfig.h"
+#include <stdint.h>
+#include <cstddef>
+#include <map>
+#include <tuple>
+
+namespace lime
+{
+class CalibrationCache;
+
+/** @brief DC/IQ corrections of one board indexed by channel, direction,
+    path and frequency.
+
+    Entries are loaded from CalibrationCache (built for example by
+    LimeUtil --cal sweep). Lookup interpolates between the nearest entries
+    below and above requested frequency, so retuning needs no database
+    access or searching. All values are signed integers.
+*/
+class LIME_API CalibrationTable
+{
+public:
+    struct Entry
+    {
+        int dcI;
+        int dcQ;
+        int gainI;
+        int gainQ;
+        int phaseOffset;
+    };
+
+    //! Replaces table contents with all DC/IQ entries of the board
+    int Load(CalibrationCache* cache, uint32_t boardId);
+
+    void Insert(double frequency, uint8_t channel, bool transmitter, int band_lna, const Entry &entry);
+    void Clear();
+    size_t Size() const;
+
+    /** @brief Finds corrections for given frequency
+        @param maxDistance entries further than this from frequency are not used
+        @param [out] result interpolated corrections
+        @return true if at least one entry was within maxDistance
+    */
+    bool Lookup(double frequency, uint8_t channel, bool transmitter, int band_lna, Entry &result, double maxDistance = 10e6) const;
+
+private:
+    typedef std::tuple<uint8_t, bool, int> Key;
+    std::map<Key, std::map<double, Entry>> mEntries;
+};
+
+}
+#endif
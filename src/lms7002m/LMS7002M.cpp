@@ -20,6 +20,8 @@
 #include <algorithm>
 #include "LMS7002M_RegistersMap.h"
 #include "CalibrationCache.h"
+#include "CalibrationTable.h"
+#include "ControlProfiler.h"
 #include <math.h>
 #include <assert.h>
 #include <chrono>
@@ -128,12 +130,22 @@ It requires IConnection to be set by SetConnection() to communicate with chip
 LMS7002M::LMS7002M() :
     useCache(0),
     mValueCache(new CalibrationCache()),
+    mCalibrationTable(new CalibrationTable()),
+    mCalibrationTableEnabled(false),
+    mCalibrationRunning(false),
+    mStreamRSSICalibrations(0),
+    mStreamRSSIActive(false),
+    mStreamRSSIStreamID(0),
+    mStreamRSSI(nullptr),
     mRegistersMap(new LMS7002M_RegistersMap()),
     controlPort(nullptr),
     mdevIndex(0),
     mSelfCalDepth(0)
 {
     mCalibrationByMCU = true;
+    mCalibrationAbort = nullptr;
+    mCalibrationSeed.valid = false;
+    mActiveCalibrationStats = &mCalibrationStats[0];
 
     //memory intervals for registers tests and calibration algorithms
     MemorySectionAddresses[LimeLight][0] = 0x0020;
@@ -208,6 +220,7 @@ LMS7002M::~LMS7002M()
 {
     delete mcuControl;
     delete mRegistersMap;
+    delete mCalibrationTable;
 }
 
 void LMS7002M::SetActiveChannel(const Channel ch)
@@ -371,6 +384,7 @@ int LMS7002M::EnableChannel(const bool isTx, const bool enable)
 */
 int LMS7002M::ResetChip()
 {
+    ControlProfiler::Scope profile("ResetChip");
     checkConnection();
 
     int status = controlPort->DeviceReset(mdevIndex);
@@ -574,6 +588,7 @@ int LMS7002M::LoadConfigLegacyFile(const char* filename)
 */
 int LMS7002M::LoadConfig(const char* filename)
 {
+    ControlProfiler::Scope profile("LoadConfig");
 	ifstream f(filename);
     if (f.good() == false) //file not found
     {
@@ -989,6 +1004,8 @@ int LMS7002M::SetPathRFE(PathRFE path)
     //update external band-selection to match
     this->UpdateExternalBandSelect();
 
+    if (mCalibrationTableEnabled and not mCalibrationRunning)
+        ApplyCalibrationTable(false, this->GetActiveChannel(false) == ChB ? 1 : 0);
     return 0;
 }
 
@@ -1010,6 +1027,8 @@ int LMS7002M::SetBandTRF(const int band)
     //update external band-selection to match
     this->UpdateExternalBandSelect();
 
+    if (mCalibrationTableEnabled and not mCalibrationRunning)
+        ApplyCalibrationTable(true, this->GetActiveChannel(false) == ChB ? 1 : 0);
     return 0;
 }
 
@@ -1082,30 +1101,20 @@ float_type LMS7002M::GetReferenceClk_TSP(bool tx)
 */
 int LMS7002M::SetFrequencyCGEN(const float_type freq_Hz, const bool retainNCOfrequencies, CGEN_details* output)
 {
+    ControlProfiler::Scope profile("SetFrequencyCGEN");
     stringstream ss;
     LMS7002M_SelfCalState state(this);
     float_type dFvco;
     float_type dFrac;
     int16_t iHdiv;
 
-    //remember NCO frequencies
-    Channel chBck = this->GetActiveChannel();
-    vector<vector<float_type> > rxNCO(2);
-    vector<vector<float_type> > txNCO(2);
-    bool rxModeNCO = false;
-    bool txModeNCO = false;
+    //NCO frequency control words are rescaled to keep frequencies
+    float_type rxRefClkOld = 0;
+    float_type txRefClkOld = 0;
     if(retainNCOfrequencies)
     {
-        rxModeNCO = Get_SPI_Reg_bits(LMS7param(MODE_RX), true);
-        txModeNCO = Get_SPI_Reg_bits(LMS7param(MODE_TX), true);
-        for (int ch = 0; ch < 2; ++ch)
-        {
-            this->SetActiveChannel((ch == 0)?ChA:ChB);
-            for (int i = 0; i < 16 && rxModeNCO == 0; ++i)
-                rxNCO[ch].push_back(GetNCOFrequency(LMS7002M::Rx, i, false));
-            for (int i = 0; i < 16 && txModeNCO == 0; ++i)
-                txNCO[ch].push_back(GetNCOFrequency(LMS7002M::Tx, i, false));
-        }
+        rxRefClkOld = GetReferenceClk_TSP(Rx);
+        txRefClkOld = GetReferenceClk_TSP(Tx);
     }
     //VCO frequency selection according to F_CLKH
     vector<float_type> vcoFreqs;
@@ -1147,16 +1156,41 @@ int LMS7002M::SetFrequencyCGEN(const float_type freq_Hz, const bool retainNCOfre
         output->success = true;
     }
 
-    //recalculate NCO
-    for (int ch = 0; ch < 2 && retainNCOfrequencies; ++ch)
+    //recalculate NCO of both channels in one transaction
+    if(retainNCOfrequencies)
     {
-        this->SetActiveChannel((ch == 0)?ChA:ChB);
-        for (int i = 0; i < 16 && rxModeNCO == 0; ++i)
-            SetNCOFrequency(LMS7002M::Rx, i, rxNCO[ch][i]);
-        for (int i = 0; i < 16 && txModeNCO == 0; ++i)
-            SetNCOFrequency(LMS7002M::Tx, i, txNCO[ch][i]);
+        const uint16_t macAddr = LMS7param(MAC).address;
+        const uint16_t macReg = SPI_read(macAddr);
+        const float_type ratio[2] = {rxRefClkOld/GetReferenceClk_TSP(Rx), txRefClkOld/GetReferenceClk_TSP(Tx)};
+        std::vector<uint16_t> addrs;
+        std::vector<uint16_t> values;
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            addrs.push_back(macAddr);
+            values.push_back((macReg & ~0x3) | (ch+1));
+            for (int dir = 0; dir < 2; ++dir)
+            {
+                const uint16_t addr = dir == 0 ? 0x0440 : 0x0240;
+                //only FCW mode uses 16 frequencies
+                if (mRegistersMap->GetValue(ch, addr) & 0x1)
+                    continue;
+                for (int i = 0; i < 16; ++i)
+                {
+                    const uint32_t fcw = (uint32_t(mRegistersMap->GetValue(ch, addr+2+i*2)) << 16) | mRegistersMap->GetValue(ch, addr+3+i*2);
+                    const float_type newFcw = fcw*ratio[dir];
+                    if (newFcw >= 2147483648.0) //above Nyquist, keep
+                        continue;
+                    addrs.push_back(addr+2+i*2);
+                    values.push_back(uint32_t(newFcw) >> 16);
+                    addrs.push_back(addr+3+i*2);
+                    values.push_back(uint32_t(newFcw) & 0xFFFF);
+                }
+            }
+        }
+        addrs.push_back(macAddr);
+        values.push_back(macReg);
+        SPI_write_batch(addrs.data(), values.data(), addrs.size());
     }
-    this->SetActiveChannel(chBck);
 #ifndef NDEBUG
     printf("CGEN: Freq=%g MHz, VCO=%g GHz, INT=%i, FRAC=%i, DIV_OUTCH_CGEN=%i\n", freq_Hz/1e6, dFvco/1e9, gINT, gFRAC, iHdiv);
 #endif // NDEBUG
@@ -1202,6 +1236,7 @@ bool LMS7002M::GetSXLocked(bool tx)
 */
 int LMS7002M::TuneVCO(VCO_Module module) // 0-cgen, 1-SXR, 2-SXT
 {
+    ControlProfiler::Scope profile("TuneVCO");
     auto settlingTime = chrono::microseconds(50); //can be lower
     struct CSWInteval
     {
@@ -1385,6 +1420,132 @@ int LMS7002M::Modify_SPI_Reg_bits(const uint16_t address, const uint8_t msb, con
     return SPI_write(address, spiDataReg); //write modified data back to SPI reg
 }
 
+/** @brief Returns values of multiple parameters
+    Each distinct register is read only once, registers read from chip are
+    read in a single transaction.
+    @param params LMS7002M control parameters
+    @param [out] values parameter values
+    @param count number of parameters
+    @param fromChip read directly from chip
+    @return 0-success, other-failure
+*/
+int LMS7002M::Get_SPI_Reg_bits_batch(const LMS7Parameter* params, uint16_t* values, size_t count, bool fromChip)
+{
+    std::vector<uint16_t> addrs;
+    for (size_t i = 0; i < count; ++i)
+        if (std::find(addrs.begin(), addrs.end(), params[i].address) == addrs.end())
+            addrs.push_back(params[i].address);
+
+    std::vector<uint16_t> regs(addrs.size());
+    if (fromChip and controlPort)
+    {
+        //MCU accessed registers can not be batched
+        std::vector<uint16_t> batchAddrs;
+        for (auto addr : addrs)
+            if (addr != 0x0640 and addr != 0x0641)
+                batchAddrs.push_back(addr);
+        std::vector<uint16_t> batchData(batchAddrs.size());
+        if (not batchAddrs.empty())
+        {
+            int status = SPI_read_batch(batchAddrs.data(), batchData.data(), batchAddrs.size());
+            if (status != 0)
+                return status;
+        }
+        for (size_t i = 0, j = 0; i < addrs.size(); ++i)
+        {
+            if (addrs[i] == 0x0640 or addrs[i] == 0x0641)
+                regs[i] = SPI_read(addrs[i], true);
+            else
+                regs[i] = batchData[j++];
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < addrs.size(); ++i)
+            regs[i] = SPI_read(addrs[i], false);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto &param = params[i];
+        const uint16_t reg = regs[std::find(addrs.begin(), addrs.end(), param.address) - addrs.begin()];
+        values[i] = (reg & (~(~0<<(param.msb+1)))) >> param.lsb;
+    }
+    return 0;
+}
+
+/** @brief Changes multiple parameters
+    Parameters of the same register are merged and each register is written
+    once. Changing MAC selects register space for following parameters, so
+    parameters after it are written in a separate batch.
+    @param params LMS7002M control parameters
+    @param values new parameter values
+    @param count number of parameters
+    @param fromChip read initial values directly from chip
+    @return 0-success, other-failure
+*/
+int LMS7002M::Modify_SPI_Reg_bits_batch(const LMS7Parameter* params, const uint16_t* values, size_t count, bool fromChip)
+{
+    const uint16_t macAddr = LMS7param(MAC).address;
+    size_t start = 0;
+    while (start < count)
+    {
+        //parameters up to and including next change of MAC register
+        size_t end = start;
+        while (end < count and params[end].address != macAddr)
+            ++end;
+        if (end < count)
+            ++end;
+
+        std::vector<uint16_t> addrs;
+        std::vector<uint16_t> regs;
+        for (size_t i = start; i < end; ++i)
+        {
+            if (params[i].address == 0x0640 or params[i].address == 0x0641)
+                continue;
+            if (std::find(addrs.begin(), addrs.end(), params[i].address) == addrs.end())
+                addrs.push_back(params[i].address);
+        }
+        regs.resize(addrs.size());
+        if (not addrs.empty() and fromChip and controlPort)
+        {
+            int status = SPI_read_batch(addrs.data(), regs.data(), addrs.size());
+            if (status != 0)
+                return status;
+        }
+        else
+        {
+            for (size_t i = 0; i < addrs.size(); ++i)
+                regs[i] = SPI_read(addrs[i], false);
+        }
+
+        for (size_t i = start; i < end; ++i)
+        {
+            const auto &param = params[i];
+            if (param.address == 0x0640 or param.address == 0x0641)
+            {
+                //written through MCU, one at a time
+                int status = Modify_SPI_Reg_bits(param, values[i], fromChip);
+                if (status != 0)
+                    return status;
+                continue;
+            }
+            uint16_t &reg = regs[std::find(addrs.begin(), addrs.end(), param.address) - addrs.begin()];
+            const uint16_t mask = (~(~0 << (param.msb - param.lsb + 1))) << param.lsb;
+            reg = (reg & ~mask) | ((values[i] << param.lsb) & mask);
+        }
+
+        if (not addrs.empty())
+        {
+            int status = SPI_write_batch(addrs.data(), regs.data(), addrs.size());
+            if (status != 0)
+                return status;
+        }
+        start = end;
+    }
+    return 0;
+}
+
 /** @brief Modifies given registers with values applied using masks
     @param addr array of register addresses
     @param masks array of applied masks
@@ -1421,6 +1582,7 @@ int LMS7002M::Modify_SPI_Reg_mask(const uint16_t *addr, const uint16_t *masks, c
 */
 int LMS7002M::SetFrequencySX(bool tx, float_type freq_Hz, SX_details* output)
 {
+    ControlProfiler::Scope profile("SetFrequencySX");
     stringstream ss; //VCO tuning report
     const char* vcoNames[] = {"VCOL", "VCOM", "VCOH"};
     checkConnection();
@@ -1546,6 +1708,9 @@ int LMS7002M::SetFrequencySX(bool tx, float_type freq_Hz, SX_details* output)
 
     if (canDeliverFrequency == false)
         return ReportError(EINVAL, "SetFrequencySX%s(%g MHz) - cannot deliver frequency\n%s", tx?"T":"R", freq_Hz / 1e6, ss.str().c_str());
+    //frequency is set, table miss is only reported
+    if (mCalibrationTableEnabled and not mCalibrationRunning)
+        ApplyCalibrationTable(tx);
     return 0;
 }
 
@@ -1722,6 +1887,158 @@ float_type LMS7002M::GetNCOPhaseOffset_Deg(bool tx, uint8_t index)
     return angle;
 }
 
+/** @brief Sets frequencies of NCOs 0..count-1 of active channel
+    All frequency control words are calculated from one TSP reference clock
+    reading and written in a single transaction.
+    @param tx transmitter or receiver selection
+    @param freq_Hz NCO frequencies
+    @param count number of frequencies, up to 16
+    @param phaseOffset_deg if not null, phase offset used in FCW mode
+    @return 0-success, other-failure
+*/
+int LMS7002M::SetNCOFrequencies(bool tx, const float_type* freq_Hz, uint8_t count, const float_type* phaseOffset_deg)
+{
+    if(count > 16)
+        return ReportError(ERANGE, "SetNCOFrequencies(count = %d) - count out of range [0, 16]", int(count));
+    const float_type refClk_Hz = GetReferenceClk_TSP(tx);
+    const uint16_t addr = tx ? 0x0240 : 0x0440;
+    std::vector<uint16_t> addrs;
+    std::vector<uint16_t> values;
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        if(freq_Hz[i] < 0 || freq_Hz[i]/refClk_Hz > 0.5)
+            return ReportError(ERANGE, "SetNCOFrequencies(index = %d) - Frequency(%g MHz) out of range [0-%g) MHz", int(i), freq_Hz[i]/1e6, refClk_Hz/2e6);
+        const uint32_t fcw = uint32_t((freq_Hz[i]/refClk_Hz)*4294967296);
+        addrs.push_back(addr+2+i*2);
+        values.push_back(fcw >> 16);
+        addrs.push_back(addr+3+i*2);
+        values.push_back(fcw);
+    }
+    if (phaseOffset_deg)
+    {
+        addrs.push_back(addr+1);
+        values.push_back(uint16_t(65536*(*phaseOffset_deg / 360)));
+    }
+    if (addrs.empty())
+        return 0;
+    return SPI_write_batch(addrs.data(), values.data(), addrs.size());
+}
+
+/** @brief Returns frequencies of NCOs 0..count-1 of active channel
+    @param tx transmitter or receiver selection
+    @param [out] freq_Hz NCO frequencies
+    @param count number of frequencies, up to 16
+    @param [out] phaseOffset_deg if not null, phase offset used in FCW mode
+    @param fromChip read registers from chip in one transaction or from local registers
+    @return 0-success, other-failure
+*/
+int LMS7002M::GetNCOFrequencies(bool tx, float_type* freq_Hz, uint8_t count, float_type* phaseOffset_deg, bool fromChip)
+{
+    if(count > 16)
+        return ReportError(ERANGE, "GetNCOFrequencies(count = %d) - count out of range [0, 16]", int(count));
+    const float_type refClk_Hz = GetReferenceClk_TSP(tx);
+    const uint16_t addr = tx ? 0x0240 : 0x0440;
+    std::vector<uint16_t> addrs;
+    for (uint16_t i = 0; i < 2*count; ++i)
+        addrs.push_back(addr+2+i);
+    addrs.push_back(addr+1);
+    std::vector<uint16_t> values(addrs.size());
+    if (fromChip)
+    {
+        int status = SPI_read_batch(addrs.data(), values.data(), addrs.size());
+        if (status != 0)
+            return status;
+    }
+    else
+    {
+        for (size_t i = 0; i < addrs.size(); ++i)
+            values[i] = SPI_read(addrs[i], false);
+    }
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        const uint32_t fcw = (uint32_t(values[2*i]) << 16) | values[2*i+1];
+        freq_Hz[i] = refClk_Hz*(fcw/4294967296.0);
+    }
+    if (phaseOffset_deg)
+        *phaseOffset_deg = 360*values.back()/65536.0;
+    return 0;
+}
+
+/** @brief Sets phase offsets of NCOs 0..count-1 of active channel in one transaction
+    @param tx transmitter or receiver selection
+    @param angle_deg phase offsets in degrees
+    @param count number of phase offsets, up to 16
+    @param freq_Hz if not null, NCO frequency used in PHO mode
+    @return 0-success, other-failure
+*/
+int LMS7002M::SetNCOPhaseOffsets(bool tx, const float_type* angle_deg, uint8_t count, const float_type* freq_Hz)
+{
+    if(count > 16)
+        return ReportError(ERANGE, "SetNCOPhaseOffsets(count = %d) - count out of range [0, 16]", int(count));
+    const uint16_t addr = tx ? 0x0240 : 0x0440;
+    std::vector<uint16_t> addrs;
+    std::vector<uint16_t> values;
+    if (freq_Hz)
+    {
+        const float_type refClk_Hz = GetReferenceClk_TSP(tx);
+        if(*freq_Hz < 0 || *freq_Hz/refClk_Hz > 0.5)
+            return ReportError(ERANGE, "SetNCOPhaseOffsets - Frequency(%g MHz) out of range [0-%g) MHz", *freq_Hz/1e6, refClk_Hz/2e6);
+        const uint32_t fcw = uint32_t((*freq_Hz/refClk_Hz)*4294967296);
+        addrs.push_back(addr+2);
+        values.push_back(fcw >> 16);
+        addrs.push_back(addr+3);
+        values.push_back(fcw);
+    }
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        addrs.push_back(addr+4+i);
+        values.push_back(uint16_t(65536*(angle_deg[i] / 360)));
+    }
+    if (addrs.empty())
+        return 0;
+    return SPI_write_batch(addrs.data(), values.data(), addrs.size());
+}
+
+/** @brief Returns phase offsets of NCOs 0..count-1 of active channel
+    @param tx transmitter or receiver selection
+    @param [out] angle_deg phase offsets in degrees
+    @param count number of phase offsets, up to 16
+    @param [out] freq_Hz if not null, NCO frequency used in PHO mode
+    @param fromChip read registers from chip in one transaction or from local registers
+    @return 0-success, other-failure
+*/
+int LMS7002M::GetNCOPhaseOffsets(bool tx, float_type* angle_deg, uint8_t count, float_type* freq_Hz, bool fromChip)
+{
+    if(count > 16)
+        return ReportError(ERANGE, "GetNCOPhaseOffsets(count = %d) - count out of range [0, 16]", int(count));
+    const uint16_t addr = tx ? 0x0240 : 0x0440;
+    std::vector<uint16_t> addrs;
+    addrs.push_back(addr+2);
+    addrs.push_back(addr+3);
+    for (uint8_t i = 0; i < count; ++i)
+        addrs.push_back(addr+4+i);
+    std::vector<uint16_t> values(addrs.size());
+    if (fromChip)
+    {
+        int status = SPI_read_batch(addrs.data(), values.data(), addrs.size());
+        if (status != 0)
+            return status;
+    }
+    else
+    {
+        for (size_t i = 0; i < addrs.size(); ++i)
+            values[i] = SPI_read(addrs[i], false);
+    }
+    for (uint8_t i = 0; i < count; ++i)
+        angle_deg[i] = 360*values[2+i]/65536.0;
+    if (freq_Hz)
+    {
+        const uint32_t fcw = (uint32_t(values[0]) << 16) | values[1];
+        *freq_Hz = GetReferenceClk_TSP(tx)*(fcw/4294967296.0);
+    }
+    return 0;
+}
+
 /** @brief Uploads given FIR coefficients to chip
     @param tx Transmitter or receiver selection
     @param GFIR_index GIR index from 0 to 2
@@ -2243,6 +2560,7 @@ isSyncedEnding:
 */
 int LMS7002M::UploadAll()
 {
+    ControlProfiler::Scope profile("UploadAll");
     checkConnection();
 
     Channel ch = this->GetActiveChannel(); //remember used channel
@@ -2295,6 +2613,7 @@ int LMS7002M::UploadAll()
 */
 int LMS7002M::DownloadAll()
 {
+    ControlProfiler::Scope profile("DownloadAll");
     checkConnection();
     int status;
     Channel ch = this->GetActiveChannel(false);
@@ -2337,6 +2656,7 @@ int LMS7002M::DownloadAll()
 */
 int LMS7002M::SetInterfaceFrequency(float_type cgen_freq_Hz, const uint8_t interpolation, const uint8_t decimation)
 {
+    ControlProfiler::Scope profile("SetInterfaceFrequency");
     int status = 0;
     LMS7002M_SelfCalState state(this);
     status = Modify_SPI_Reg_bits(LMS7param(HBD_OVR_RXTSP), decimation);
@@ -2547,6 +2867,68 @@ LMS7002M_SelfCalState::~LMS7002M_SelfCalState(void)
     rfic->ExitSelfCalibration();
 }
 
+LMS7002M_StreamRSSIState::LMS7002M_StreamRSSIState(LMS7002M *chip, const unsigned calibration):
+    rfic(nullptr),
+    channel(chip->GetActiveChannel(false) == LMS7002M::ChB ? 2 : 1),
+    interfaceChanged(false)
+{
+    //nested calibrations use stream of the outer one, also when it stopped delivering samples
+    if ((chip->mStreamRSSICalibrations & calibration) == 0 || chip->mCalibrationByMCU
+        || chip->mStreamRSSIActive || chip->mStreamRSSI != nullptr || chip->controlPort == nullptr)
+        return;
+    StreamConfig config;
+    config.channelID = 2*chip->mdevIndex + channel - 1;
+    config.format = StreamConfig::STREAM_12_BIT_IN_16;
+    config.isTx = false;
+    config.performanceLatency = 0;
+    if (chip->controlPort->SetupStream(chip->mStreamRSSIStreamID, config) != 0)
+    {
+        chip->Log(LMS7002M::LOG_WARNING, "RX stream not available, calibration uses chip RSSI");
+        return;
+    }
+    chip->mStreamRSSIActive = true;
+    rfic = chip;
+}
+
+LMS7002M_StreamRSSIState::~LMS7002M_StreamRSSIState(void)
+{
+    if (rfic == nullptr)
+        return;
+    rfic->controlPort->ControlStream(rfic->mStreamRSSIStreamID, false);
+    rfic->controlPort->CloseStream(rfic->mStreamRSSIStreamID);
+    delete rfic->mStreamRSSI;
+    rfic->mStreamRSSI = nullptr;
+    rfic->mStreamRSSIActive = false;
+    //calibration has restored registers by now
+    if (interfaceChanged && rfic->RestoreCalibrationInterface(channel) != 0)
+        rfic->Log(LMS7002M::LOG_WARNING, "Failed to restore data interface after calibration");
+}
+
+void LMS7002M_StreamRSSIState::SetupInterface(void)
+{
+    if (rfic == nullptr || not rfic->mStreamRSSIActive)
+        return;
+    interfaceChanged = true;
+    if (rfic->SetupCalibrationInterface(channel) != 0)
+    {
+        rfic->Log(LMS7002M::LOG_WARNING, "Failed to set up data interface, calibration uses chip RSSI");
+        rfic->mStreamRSSIActive = false;
+    }
+}
+
+void LMS7002M::SetStreamRSSI(const unsigned calibrations, const RSSIEstimator::Config &config)
+{
+    mStreamRSSICalibrations = calibrations;
+    mStreamRSSIConfig = config;
+}
+
+unsigned LMS7002M::GetStreamRSSI(RSSIEstimator::Config *config) const
+{
+    if (config)
+        *config = mStreamRSSIConfig;
+    return mStreamRSSICalibrations;
+}
+
 void LMS7002M::EnableValuesCache(bool enabled)
 {
     useCache = enabled;
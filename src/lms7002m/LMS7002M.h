@@ -9,16 +9,19 @@
 
 #include <LimeSuiteConfig.h>
 #include "LMS7002M_parameters.h"
+#include "RSSIEstimator.h"
 #include <cstdint>
 #include <sstream>
 #include <stdarg.h>
 #include <functional>
 #include <vector>
+#include <atomic>
 
 namespace lime{
 class IConnection;
 class LMS7002M_RegistersMap;
 class CalibrationCache;
+class CalibrationTable;
 class MCU_BD;
 class BinSearchParam;
 class GridSearchParam;
@@ -152,7 +155,10 @@ public:
     uint16_t Get_SPI_Reg_bits(uint16_t address, uint8_t msb, uint8_t lsb, bool fromChip = false);
     int Modify_SPI_Reg_bits(const LMS7Parameter &param, const uint16_t value, bool fromChip = false);
     int Modify_SPI_Reg_bits(uint16_t address, uint8_t msb, uint8_t lsb, uint16_t value, bool fromChip = false);
+    int Get_SPI_Reg_bits_batch(const LMS7Parameter* params, uint16_t* values, size_t count, bool fromChip = false);
+    int Modify_SPI_Reg_bits_batch(const LMS7Parameter* params, const uint16_t* values, size_t count, bool fromChip = false);
     int SPI_write(uint16_t address, uint16_t data);
+    int SPI_write_batch(const uint16_t* spiAddr, const uint16_t* spiData, uint16_t cnt);
     uint16_t SPI_read(uint16_t address, bool fromChip = false, int *status = 0);
     int RegistersTest(const char* fileName = "registersTest.txt");
     ///@}
@@ -169,6 +175,63 @@ public:
     ///@name Transmitter, Receiver calibrations
     int CalibrateRx(float_type bandwidth, const bool useExtLoopback = false);
     int CalibrateTx(float_type bandwidth, const bool useExtLoopback = false);
+    /*!
+     * Set flag which stops CalibrateRx()/CalibrateTx() between stages,
+     * registers are restored and calibration returns ECANCELED.
+     * @param abort flag checked during calibration, nullptr to disable
+     */
+    void SetCalibrationAbortFlag(const std::atomic<bool>* abort);
+
+    //! Search statistics of last CalibrateRx() or CalibrateTx()
+    struct CalibrationStats
+    {
+        CalibrationStats() : rssiReads(0), warmStart(false), fullSearches(0) {}
+        unsigned rssiReads;     //!< number of RSSI measurements
+        bool warmStart;         //!< searches were seeded from cached results
+        unsigned fullSearches;  //!< seeded searches repeated over full range
+    };
+    CalibrationStats GetCalibrationStats(const bool tx) const;
+    ///@}
+
+    ///@name RSSI estimated from stream
+    //! Calibrations which can measure RSSI from streamed samples
+    enum StreamRSSICalibration
+    {
+        STREAM_RSSI_CAL_TX = 1 << 0,    //!< CalibrateTx()
+        STREAM_RSSI_CAL_RX = 1 << 1,    //!< CalibrateRx()
+        STREAM_RSSI_FILTER_TX = 1 << 2, //!< TuneTxFilter()
+        STREAM_RSSI_FILTER_RX = 1 << 3, //!< TuneRxFilter()
+    };
+    /*!
+     * Selects calibrations which estimate RSSI on host from a burst of RX
+     * samples instead of reading chip RSSI registers after a fixed delay.
+     * Applies to calibrations performed by PC, MCU always uses chip RSSI.
+     * Chip RSSI is used when the RX stream of the channel can not be set up.
+     * @param calibrations mask of StreamRSSICalibration, 0 for chip RSSI
+     * @param config estimator configuration, frequency in Hz of RX sample rate
+     */
+    void SetStreamRSSI(const unsigned calibrations, const RSSIEstimator::Config &config = RSSIEstimator::Config());
+    unsigned GetStreamRSSI(RSSIEstimator::Config *config = nullptr) const;
+    ///@}
+
+    ///@name Calibration table
+    /*!
+     * In table mode DC/IQ corrections stored in calibration cache are applied
+     * whenever LO frequency or RF path changes, instead of calibrating.
+     * Table is loaded from cache when enabled, use LimeUtil --cal to fill it.
+     * SetFrequencySX(), SetPathRFE() and SetBandTRF() do not fail when table
+     * has no entry, ApplyCalibrationTable() reports the miss and corrections
+     * stay as they were.
+     */
+    int EnableCalibrationTable(const bool enable);
+    bool IsCalibrationTableEnabled() const;
+    /*!
+     * Writes table corrections for current LO frequency and path
+     * @param tx direction
+     * @param channel 0-A, 1-B, -1 both
+     * @return 0 if corrections were found for all channels
+     */
+    int ApplyCalibrationTable(const bool tx, const int channel = -1);
     ///@}
 
     ///@name Filters tuning
@@ -312,6 +375,10 @@ public:
     int SetNCOPhaseOffsetForMode0(bool tx, float_type angle_Deg);
 	int SetNCOPhaseOffset(bool tx, uint8_t index, float_type angle_Deg);
 	float_type GetNCOPhaseOffset_Deg(bool tx, uint8_t index);
+    int SetNCOFrequencies(bool tx, const float_type* freq_Hz, uint8_t count, const float_type* phaseOffset_deg = nullptr);
+    int GetNCOFrequencies(bool tx, float_type* freq_Hz, uint8_t count, float_type* phaseOffset_deg = nullptr, bool fromChip = true);
+    int SetNCOPhaseOffsets(bool tx, const float_type* angle_deg, uint8_t count, const float_type* freq_Hz = nullptr);
+    int GetNCOPhaseOffsets(bool tx, float_type* angle_deg, uint8_t count, float_type* freq_Hz = nullptr, bool fromChip = true);
 	int SetGFIRCoefficients(bool tx, uint8_t GFIR_index, const int16_t *coef, uint8_t coefCount);
 	int GetGFIRCoefficients(bool tx, uint8_t GFIR_index, int16_t *coef, uint8_t coefCount);
     float_type GetReferenceClk_TSP(bool tx);
@@ -429,9 +496,34 @@ public:
 
 protected:
     bool mCalibrationByMCU;
+    const std::atomic<bool>* mCalibrationAbort;
+    int CheckCalibrationAbort();
+    //! Cached results of near frequency used as calibration search start
+    struct CalibrationSeed
+    {
+        bool valid;
+        int gainI;
+        int gainQ;
+        int phase;
+    };
+    CalibrationSeed mCalibrationSeed;
+    CalibrationStats mCalibrationStats[2]; //!< RX and TX calibrations
+    CalibrationStats* mActiveCalibrationStats; //!< statistics of running or last calibration
+    void LoadCalibrationSeed(uint32_t boardId, double frequency, uint8_t channel, bool tx, int band_lna);
     MCU_BD *mcuControl;
     bool useCache;
     CalibrationCache *mValueCache;
+    CalibrationTable *mCalibrationTable;
+    bool mCalibrationTableEnabled;
+    bool mCalibrationRunning; //!< LO and path changes of calibration do not use table
+    unsigned mStreamRSSICalibrations;
+    RSSIEstimator::Config mStreamRSSIConfig;
+    bool mStreamRSSIActive; //!< calibration measures RSSI from stream
+    size_t mStreamRSSIStreamID;
+    RSSIEstimator* mStreamRSSI; //!< created at first measurement, after calibration setup
+    friend class LMS7002M_StreamRSSIState;
+    void ApplyTxCorrections(int dcI, int dcQ, int gainI, int gainQ, int phase);
+    void ApplyRxCorrections(int dcI, int dcQ, int gainI, int gainQ, int phase);
     LMS7002M_RegistersMap *mRegistersMap;
 
     static const uint16_t readOnlyRegisters[];
@@ -444,6 +536,9 @@ protected:
     void RestoreAllRegisters();
     uint32_t GetRSSI(RSSI_measurements *measurements = nullptr);
     uint32_t GetAvgRSSI(const int avgCount);
+    uint32_t EstimateStreamRSSI(const unsigned averages);
+    int SetupCalibrationInterface(const int ch);
+    int RestoreCalibrationInterface(const int ch);
     void SetRxDCOFF(int8_t offsetI, int8_t offsetQ);
     void CalibrateRxDC();
     void AdjustAutoDC(const uint16_t address, bool tx);
@@ -460,6 +555,7 @@ protected:
     int CalibrateTxGainSetup();
 
     void BinarySearch(BinSearchParam* args);
+    void SeededBinarySearch(BinSearchParam* args, const int16_t seed, const int16_t radius);
     void TxDcBinarySearch(BinSearchParam* args);
     void GridSearch(GridSearchParam* args);
     void CoarseSearch(const uint16_t addr, const uint8_t msb, const uint8_t lsb, int16_t &value, const uint8_t maxIterations);
@@ -472,7 +568,6 @@ protected:
     int TuneTxFilterSetup(const float_type tx_lpf_IF);
 
     int RegistersTestInterval(uint16_t startAddr, uint16_t endAddr, uint16_t pattern, std::stringstream &ss);
-    int SPI_write_batch(const uint16_t* spiAddr, const uint16_t* spiData, uint16_t cnt);
     int SPI_read_batch(const uint16_t* spiAddr, uint16_t* spiData, uint16_t cnt);
     int Modify_SPI_Reg_mask(const uint16_t *addr, const uint16_t *masks, const uint16_t *values, uint8_t start, uint8_t stop);
     ///@}
@@ -513,6 +608,28 @@ private:
     LMS7002M *rfic;
 };
 
+/*!
+ * Sets up RX stream for RSSI estimation upon construction when selected for
+ * the calibration by SetStreamRSSI(), and closes it upon exit.
+ */
+class LIME_API LMS7002M_StreamRSSIState
+{
+public:
+    LMS7002M_StreamRSSIState(LMS7002M *rfic, const unsigned calibration);
+    ~LMS7002M_StreamRSSIState(void);
+
+    /*!
+     * Reprograms data interface for the stream, called after calibration
+     * setup changed CGEN and decimation. Interface clocks are programmed
+     * again from restored registers upon exit.
+     */
+    void SetupInterface(void);
+
+private:
+    LMS7002M *rfic;
+    int channel; //!< 1 for A, 2 for B
+    bool interfaceChanged;
+};
 
 }
 #endif
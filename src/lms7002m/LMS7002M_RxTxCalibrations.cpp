@@ -1,14 +1,16 @@
 #include "LMS7002M.h"
 #include "CalibrationCache.h"
+#include "CalibrationTable.h"
 #include "ErrorReporting.h"
 #include <assert.h>
 #include "MCU_BD.h"
 #include "IConnection.h"
 #include "mcu_programs.h"
 #include "LMS64CProtocol.h"
+#include "ControlProfiler.h"
 #include <vector>
+#include <algorithm>
 #include <ciso646>
-#include <vector>
 #include <stdio.h>
 #include <cmath>
 #include <chrono>
@@ -131,7 +133,7 @@ int fftBin = 0; //which bin to use when calibrating using FFT
         GNUPlotPipe searchPlot;
         GNUPlotPipe saturationPlot;
     #endif
-    #include "kiss_fft.h"
+    #include "FFTPlanCache.h"
     #include "FPGA_common.h"
     #include <thread>
     #include <chrono>
@@ -584,54 +586,7 @@ int LMS7002M::CalibrateTxSetup(float_type bandwidth_Hz, const bool useExtLoopbac
 #ifdef ENABLE_CALIBRATION_USING_FFT
     if(useExtLoopback || useFFT)
     {
-        //limelight
-        Modify_SPI_Reg_bits(LMS7param(LML1_FIDM), 0);
-        Modify_SPI_Reg_bits(LMS7param(LML2_FIDM), 0);
-        Modify_SPI_Reg_bits(LMS7param(LML1_MODE), 0);
-        Modify_SPI_Reg_bits(LMS7param(LML2_MODE), 0);
-        if(ch == 1)
-        {
-            Modify_SPI_Reg_bits(LMS7param(LML2_S0S), 1); //pos0, AQ
-            Modify_SPI_Reg_bits(LMS7param(LML2_S1S), 0); //pos1, AI
-        }
-        else if(ch == 2)
-        {
-            Modify_SPI_Reg_bits(LMS7param(LML2_S0S), 3); //pos0, BQ
-            Modify_SPI_Reg_bits(LMS7param(LML2_S1S), 2); //pos1, BI
-        }
-        //need to update interface frequency for samples acquisition
-        //if decimation/interpolation is 0(2^1) or 7(bypass), interface clocks should not be divided
-        int decimation = Get_SPI_Reg_bits(LMS7param(HBD_OVR_RXTSP));
-        float interfaceRx_Hz = GetReferenceClk_TSP(LMS7002M::Rx);
-        //need to adjust decimation to fit into USB speed
-        float rateLimit_Bps;
-        DeviceInfo info = dataPort->GetDeviceInfo();
-        if(info.deviceName == GetDeviceName(LMS_DEV_STREAM))
-            rateLimit_Bps = 110e6;
-        else if(info.deviceName == GetDeviceName(LMS_DEV_LIMESDR))
-            rateLimit_Bps = 300e6;
-        else if(info.deviceName == GetDeviceName(LMS_DEV_ULIMESDR))
-            rateLimit_Bps = 100e6;
-        else
-            rateLimit_Bps = 100e6;
-#ifndef N_DEBUG
-        rateLimit_Bps = 50e6; //debug mode is slower to receive data
-#endif
-
-        decimation = ceil(log2((interfaceRx_Hz*3/2)/rateLimit_Bps));
-        if(decimation < 0)
-            decimation = 0;
-        if(decimation > 4)
-            decimation = 4;
-        if (decimation != 7)
-            interfaceRx_Hz /= pow(2.0, decimation);
-
-        int interpolation = Get_SPI_Reg_bits(LMS7param(HBI_OVR_TXTSP));
-        float interfaceTx_Hz = GetReferenceClk_TSP(LMS7002M::Tx);
-        if (interpolation != 7)
-            interfaceTx_Hz /= pow(2.0, interpolation);
-        SetInterfaceFrequency(GetFrequencyCGEN(), interpolation, decimation);
-        dataPort->UpdateExternalDataRate(0, interfaceTx_Hz/2, interfaceRx_Hz/2);
+        SetupCalibrationInterface(ch);
 
         GenerateWindowCoefficients(3, gFFTSize, windowF, amplitudeCorr);
         GenerateWindowCoefficients(3, gFFTSize/2, windowG, amplitudeCorrG);
@@ -651,14 +606,131 @@ int LMS7002M::CalibrateTxSetup(float_type bandwidth_Hz, const bool useExtLoopbac
     return 0;
 }
 
+/** @brief Routes channel samples to LML2 positions 0 and 1 and lowers RX
+    interface rate, so samples read during calibration fit the data link
+    @param ch channel 1 (A) or 2 (B)
+    @return 0 on success
+*/
+int LMS7002M::SetupCalibrationInterface(const int ch)
+{
+    //limelight
+    Modify_SPI_Reg_bits(LMS7param(LML1_FIDM), 0);
+    Modify_SPI_Reg_bits(LMS7param(LML2_FIDM), 0);
+    Modify_SPI_Reg_bits(LMS7param(LML1_MODE), 0);
+    Modify_SPI_Reg_bits(LMS7param(LML2_MODE), 0);
+    if(ch == 1)
+    {
+        Modify_SPI_Reg_bits(LMS7param(LML2_S0S), 1); //pos0, AQ
+        Modify_SPI_Reg_bits(LMS7param(LML2_S1S), 0); //pos1, AI
+    }
+    else if(ch == 2)
+    {
+        Modify_SPI_Reg_bits(LMS7param(LML2_S0S), 3); //pos0, BQ
+        Modify_SPI_Reg_bits(LMS7param(LML2_S1S), 2); //pos1, BI
+    }
+    //need to update interface frequency for samples acquisition
+    //if decimation/interpolation is 0(2^1) or 7(bypass), interface clocks should not be divided
+    float interfaceRx_Hz = GetReferenceClk_TSP(LMS7002M::Rx);
+    //need to adjust decimation to fit into USB speed
+    float rateLimit_Bps;
+    DeviceInfo info = controlPort->GetDeviceInfo();
+    if(info.deviceName == GetDeviceName(LMS_DEV_STREAM))
+        rateLimit_Bps = 110e6;
+    else if(info.deviceName == GetDeviceName(LMS_DEV_LIMESDR))
+        rateLimit_Bps = 200e6;
+    else if(info.deviceName == GetDeviceName(LMS_DEV_ULIMESDR))
+        rateLimit_Bps = 100e6;
+    else
+        rateLimit_Bps = 100e6;
+#ifndef N_DEBUG
+    rateLimit_Bps = 50e6; //debug mode is slower to receive data
+#endif
+
+    int decimation = ceil(log2((interfaceRx_Hz*3/2)/rateLimit_Bps));
+    if(decimation < 0)
+        decimation = 0;
+    if(decimation > 4)
+        decimation = 4;
+    interfaceRx_Hz /= pow(2.0, decimation);
+
+    int interpolation = Get_SPI_Reg_bits(LMS7param(HBI_OVR_TXTSP));
+    float interfaceTx_Hz = GetReferenceClk_TSP(LMS7002M::Tx);
+    if (interpolation != 7)
+        interfaceTx_Hz /= pow(2.0, interpolation);
+    int status = SetInterfaceFrequency(GetFrequencyCGEN(), interpolation, decimation);
+    if(status != 0)
+        return status;
+    return controlPort->UpdateExternalDataRate(mdevIndex, interfaceTx_Hz/2, interfaceRx_Hz/2);
+}
+
+/** @brief Programs interface clocks and FPGA data rate from current CGEN,
+    decimation and interpolation, like after SetupCalibrationInterface()
+    changed registers were restored
+    @param ch channel 1 (A) or 2 (B), which decimation and interpolation is used
+    @return 0 on success
+*/
+int LMS7002M::RestoreCalibrationInterface(const int ch)
+{
+    const int chBck = Get_SPI_Reg_bits(LMS7param(MAC));
+    Modify_SPI_Reg_bits(LMS7param(MAC), ch);
+    const int interpolation = Get_SPI_Reg_bits(LMS7param(HBI_OVR_TXTSP));
+    const int decimation = Get_SPI_Reg_bits(LMS7param(HBD_OVR_RXTSP));
+    int status = SetInterfaceFrequency(GetFrequencyCGEN(), interpolation, decimation);
+    float_type interfaceTx_Hz = GetReferenceClk_TSP(LMS7002M::Tx);
+    if (interpolation != 7)
+        interfaceTx_Hz /= pow(2.0, interpolation);
+    float_type interfaceRx_Hz = GetReferenceClk_TSP(LMS7002M::Rx);
+    if (decimation != 7)
+        interfaceRx_Hz /= pow(2.0, decimation);
+    Modify_SPI_Reg_bits(LMS7param(MAC), chBck);
+    if(status != 0)
+        return status;
+    return controlPort->UpdateExternalDataRate(mdevIndex, interfaceTx_Hz/2, interfaceRx_Hz/2);
+}
+
+/** @brief Estimates RSSI from streamed samples when calibration selected it
+    @param averages windows averaged, 0 for configured count
+    @return 0 when stream estimate is not available
+*/
+uint32_t LMS7002M::EstimateStreamRSSI(const unsigned averages)
+{
+    if (not mStreamRSSIActive)
+        return 0;
+    if (mStreamRSSI == nullptr)
+    {
+        //rate is known after calibration setup changed decimation
+        RSSIEstimator::Config config = mStreamRSSIConfig;
+        config.sampleRate = GetSampleRate(false, GetActiveChannel(false));
+        mStreamRSSI = new RSSIEstimator(config);
+    }
+    double amplitude;
+    if (mStreamRSSI->Measure(controlPort, mStreamRSSIStreamID, amplitude, averages) != 0)
+    {
+        //samples do not arrive, do not wait for them on every following read
+        Log(LOG_WARNING, "RX stream stopped, calibration continues with chip RSSI");
+        mStreamRSSIActive = false;
+        return 0;
+    }
+    //never 0, which means not available
+    return std::max(RSSIEstimator::AmplitudeToRSSI(amplitude), 1u);
+}
+
 /** @brief Flips the CAPTURE bit and returns digital RSSI value
 
     If calibration using FFT is enabled, GetRSSI() can return value calculated
-    from FFT result at bin selected by fftBIN
+    from FFT result at bin selected by fftBIN. When stream RSSI is selected for
+    running calibration, value is estimated from received samples.
 */
 int avgCount = 1;
 uint32_t LMS7002M::GetRSSI(RSSI_measurements *measurements)
 {
+    ++mActiveCalibrationStats->rssiReads;
+    if (mStreamRSSIActive)
+    {
+        const uint32_t rssi = EstimateStreamRSSI(0);
+        if (rssi != 0)
+            return rssi;
+    }
 #ifdef ENABLE_CALIBRATION_USING_FFT
     if(useFFT)
     {
@@ -673,25 +745,25 @@ uint32_t LMS7002M::GetRSSI(RSSI_measurements *measurements)
     const int SP  = fftSize/2;
 
     IConnection* port = dataPort;
-    kiss_fft_cfg m_fftCalcPlan = kiss_fft_alloc(fftSize, 0, 0, 0);
-    kiss_fft_cpx* m_fftCalcIn = nullptr;
-    kiss_fft_cpx* m_fftCalcOut = nullptr;
+    //plan and buffers are reused between calls
+    FFTPlan fftPlan(fftSize);
+    kiss_fft_cpx* m_fftCalcIn = fftPlan.In();
+    kiss_fft_cpx* m_fftCalcOut = fftPlan.Out();
 
-    if(calcFFT)
+    int (*xi)[2] = nullptr;    // Raw data (integer numbers)
+    // Calculated Goertzel bins, integer numbers
+    float *realf = nullptr;
+    float *imagf = nullptr;
+    if(calcGeortzelFloat)
     {
-        m_fftCalcIn = new kiss_fft_cpx[fftSize];
-        m_fftCalcOut = new kiss_fft_cpx[fftSize];
+        xi = new int[SP][2];
+        realf = new float[SP];
+        imagf = new float[SP];
     }
 
-    auto xi = new int[SP][2];    // Raw data (integer numbers)
-    // Calculated Goertzel bins, integer numbers
-    auto *realf = new float[SP];
-    auto *imagf = new float[SP];
-
-    //number of packets to skip from the buffer start
-    complex16_t *buffer = nullptr;
-    if(calcFFT || calcGeortzelFloat)
-        buffer = new complex16_t[fftSize];
+    //samples are received directly into FFT output buffer, it is overwritten by the transform
+    static_assert(sizeof(kiss_fft_cpx) >= sizeof(complex16_t), "FFT buffer too small for samples");
+    complex16_t *buffer = reinterpret_cast<complex16_t*>(m_fftCalcOut);
 
     std::vector<float> fftBins_dbFS;
     if(calcFFT)
@@ -742,7 +814,7 @@ uint32_t LMS7002M::GetRSSI(RSSI_measurements *measurements)
                 m_fftCalcIn[i].i *= windowF[i] * amplitudeCorr;
                 m_fftCalcIn[i].r *= windowF[i] * amplitudeCorr;
             }
-            kiss_fft(m_fftCalcPlan, m_fftCalcIn, m_fftCalcOut);
+            fftPlan.Execute();
             for (int i = 0; i < fftSize; ++i)
             {
                 m_fftCalcOut[i].r /= fftSize;
@@ -830,14 +902,6 @@ uint32_t LMS7002M::GetRSSI(RSSI_measurements *measurements)
     }
     spectrumPlot.flush();
 #endif
-    if(calcFFT || calcGeortzelFloat)
-        delete[] buffer;
-    if(calcFFT)
-    {
-        kiss_fft_free(m_fftCalcPlan);
-        delete[] m_fftCalcOut;
-        delete[] m_fftCalcIn;
-    }
     delete[] xi;
     delete[] realf;
     delete[] imagf;
@@ -855,12 +919,160 @@ uint32_t LMS7002M::GetRSSI(RSSI_measurements *measurements)
 /** @brief Calibrates Transmitter. DC correction, IQ gains, IQ phase correction
 @return 0-success, other-failure
 */
+void LMS7002M::SetCalibrationAbortFlag(const std::atomic<bool>* abort)
+{
+    mCalibrationAbort = abort;
+}
+
+/** @brief Checks if calibration was requested to stop
+    @return 0 to continue, ECANCELED to abort
+*/
+int LMS7002M::CheckCalibrationAbort()
+{
+    if(mCalibrationAbort && mCalibrationAbort->load())
+        return ReportError(ECANCELED, "Calibration cancelled");
+    return 0;
+}
+
+LMS7002M::CalibrationStats LMS7002M::GetCalibrationStats(const bool tx) const
+{
+    return mCalibrationStats[tx ? 1 : 0];
+}
+
+//! Marks calibration as running for the lifetime of the object
+struct CalibrationRunningFlag
+{
+    CalibrationRunningFlag(bool &flag) : flag(flag), previous(flag) {flag = true;}
+    ~CalibrationRunningFlag() {flag = previous;}
+    bool &flag;
+    const bool previous;
+};
+
+/** @brief Writes Tx DC and IQ corrections of active channel
+    @param dcI, dcQ signed DC offsets
+*/
+void LMS7002M::ApplyTxCorrections(int dcI, int dcQ, int gainI, int gainQ, int phase)
+{
+    if (Get_SPI_Reg_bits(LMS7param(MAC)) == 1)
+    {
+        Modify_SPI_Reg_bits(LMS7param(PD_DCDAC_TXA), 0);
+        Modify_SPI_Reg_bits(LMS7param(DCWR_TXAI), 0);
+        Modify_SPI_Reg_bits(LMS7param(DCWR_TXAI), 1);
+        Modify_SPI_Reg_bits(LMS7param(DC_TXAI), int2txdcreg(dcI));
+        Modify_SPI_Reg_bits(LMS7param(DCWR_TXAQ), 0);
+        Modify_SPI_Reg_bits(LMS7param(DCWR_TXAQ), 1);
+        Modify_SPI_Reg_bits(LMS7param(DC_TXAQ), int2txdcreg(dcQ));
+    }
+    else
+    {
+        Modify_SPI_Reg_bits(LMS7param(PD_DCDAC_TXB), 0);
+        Modify_SPI_Reg_bits(LMS7param(DCWR_TXBI), 0);
+        Modify_SPI_Reg_bits(LMS7param(DCWR_TXBI), 1);
+        Modify_SPI_Reg_bits(LMS7param(DC_TXBI), int2txdcreg(dcI));
+        Modify_SPI_Reg_bits(LMS7param(DCWR_TXBQ), 0);
+        Modify_SPI_Reg_bits(LMS7param(DCWR_TXBQ), 1);
+        Modify_SPI_Reg_bits(LMS7param(DC_TXBQ), int2txdcreg(dcQ));
+    }
+    Modify_SPI_Reg_bits(LMS7param(GCORRI_TXTSP), gainI);
+    Modify_SPI_Reg_bits(LMS7param(GCORRQ_TXTSP), gainQ);
+    Modify_SPI_Reg_bits(LMS7param(IQCORR_TXTSP), phase);
+    Modify_SPI_Reg_bits(0x0208, 1, 0, 0); //GC_BYP PH_BYP
+}
+
+/** @brief Writes Rx DC and IQ corrections of active channel
+    @param dcI, dcQ signed DC offsets
+*/
+void LMS7002M::ApplyRxCorrections(int dcI, int dcQ, int gainI, int gainQ, int phase)
+{
+    SetRxDCOFF(dcI, dcQ);
+    Modify_SPI_Reg_bits(LMS7param(EN_DCOFF_RXFE_RFE), 1);
+    Modify_SPI_Reg_bits(LMS7param(GCORRI_RXTSP), gainI);
+    Modify_SPI_Reg_bits(LMS7param(GCORRQ_RXTSP), gainQ);
+    Modify_SPI_Reg_bits(LMS7param(IQCORR_RXTSP), phase);
+    Modify_SPI_Reg_bits(0x040C, 2, 0, 0); //DC_BYP 0, GC_BYP 0, PH_BYP 0
+    Modify_SPI_Reg_bits(0x0110, 4, 0, 31); //ICT_LO_RFE 31
+}
+
+int LMS7002M::EnableCalibrationTable(const bool enable)
+{
+    mCalibrationTableEnabled = false;
+    mCalibrationTable->Clear();
+    if (not enable)
+        return 0;
+    if (controlPort == nullptr)
+        return ReportError(ENODEV, "Device not connected");
+    const uint32_t boardId = controlPort->GetDeviceInfo().boardSerialNumber;
+    if (mCalibrationTable->Load(mValueCache, boardId) != 0)
+        return -1;
+    Log(LOG_INFO, "Calibration table: %i entries", int(mCalibrationTable->Size()));
+    mCalibrationTableEnabled = true;
+    return 0;
+}
+
+bool LMS7002M::IsCalibrationTableEnabled() const
+{
+    return mCalibrationTableEnabled;
+}
+
+int LMS7002M::ApplyCalibrationTable(const bool tx, const int channel)
+{
+    const double freq = GetFrequencySX(tx);
+    const Channel ch = this->GetActiveChannel(false);
+    int missing = 0;
+    for (int i = 0; i < 2; ++i)
+    {
+        if (channel >= 0 && channel != i)
+            continue;
+        this->SetActiveChannel(i == 0 ? ChA : ChB);
+        //same keys as used by CalibrateRx()/CalibrateTx()
+        const int band_lna = tx ? (Get_SPI_Reg_bits(LMS7param(SEL_BAND1_TRF)) ? 0 : 1) : Get_SPI_Reg_bits(LMS7param(SEL_PATH_RFE));
+        CalibrationTable::Entry entry;
+        if (not mCalibrationTable->Lookup(freq, i, tx, band_lna, entry))
+        {
+            ++missing;
+            continue;
+        }
+        if (tx)
+            ApplyTxCorrections(entry.dcI, entry.dcQ, entry.gainI, entry.gainQ, entry.phaseOffset);
+        else
+            ApplyRxCorrections(entry.dcI, entry.dcQ, entry.gainI, entry.gainQ, entry.phaseOffset);
+    }
+    this->SetActiveChannel(ch);
+    if (missing)
+        return ReportError(ENOENT, "No %s calibration table entry near %g MHz", tx ? "Tx" : "Rx", freq/1e6);
+    return 0;
+}
+
+/** @brief Loads IQ correction of near frequency from cache to start searches from
+*/
+void LMS7002M::LoadCalibrationSeed(uint32_t boardId, double frequency, uint8_t channel, bool tx, int band_lna)
+{
+    const double maxSeedDistance = 10e6;
+    int dcI, dcQ, gainI, gainQ, phase;
+    mCalibrationSeed.valid =
+        mValueCache->GetDC_IQ_Interp(boardId, frequency, channel, tx, band_lna, &dcI, &dcQ, &gainI, &gainQ, &phase) == 0 ||
+        mValueCache->GetDC_IQ_Nearest(boardId, frequency, maxSeedDistance, channel, tx, band_lna, &dcI, &dcQ, &gainI, &gainQ, &phase) == 0;
+    if(not mCalibrationSeed.valid)
+        return;
+    mCalibrationSeed.gainI = gainI;
+    mCalibrationSeed.gainQ = gainQ;
+    mCalibrationSeed.phase = signextIqCorr(phase);
+    mActiveCalibrationStats->warmStart = true;
+    verbose_printf("Searches start from cached values: GAIN_I: %i, GAIN_Q: %i, IQCORR: %i\n",
+        gainI, gainQ, mCalibrationSeed.phase);
+}
+
 int LMS7002M::CalibrateTx(float_type bandwidth_Hz, bool useExtLoopback)
 {
+    ControlProfiler::Scope profile("CalibrateTx");
     if (TrxCalib_RF_LimitLow > bandwidth_Hz || bandwidth_Hz > TrxCalib_RF_LimitHigh)
         return ReportError(ERANGE, "Frequency out of range, available range: %g-%g MHz", TrxCalib_RF_LimitLow / 1e6, TrxCalib_RF_LimitHigh / 1e6);
     if(controlPort == nullptr)
         return ReportError(EINVAL, "Device not connected");
+    mActiveCalibrationStats = &mCalibrationStats[1];
+    *mActiveCalibrationStats = CalibrationStats();
+    mCalibrationSeed.valid = false;
+    CalibrationRunningFlag running(mCalibrationRunning);
 #ifdef __cplusplus
     auto beginTime = std::chrono::high_resolution_clock::now();
 #endif
@@ -884,30 +1096,7 @@ int LMS7002M::CalibrateTx(float_type bandwidth_Hz, bool useExtLoopback)
         bool foundInCache = (mValueCache->GetDC_IQ(boardId, txFreq, channel, true, band, &dcI, &dcQ, &gainI, &gainQ, &phOffset) == 0);
         if(foundInCache)
         {
-            if (channel == 0)
-            {
-                Modify_SPI_Reg_bits(LMS7param(PD_DCDAC_TXA), 0);
-                Modify_SPI_Reg_bits(LMS7param(DCWR_TXAI), 0);
-                Modify_SPI_Reg_bits(LMS7param(DCWR_TXAI), 1);
-                Modify_SPI_Reg_bits(LMS7param(DC_TXAI), int2txdcreg(dcI));
-                Modify_SPI_Reg_bits(LMS7param(DCWR_TXAQ), 0);
-                Modify_SPI_Reg_bits(LMS7param(DCWR_TXAQ), 1);
-                Modify_SPI_Reg_bits(LMS7param(DC_TXAQ), int2txdcreg(dcQ));
-            }
-            else
-            {
-                Modify_SPI_Reg_bits(LMS7param(PD_DCDAC_TXB), 0);
-                Modify_SPI_Reg_bits(LMS7param(DCWR_TXBI), 0);
-                Modify_SPI_Reg_bits(LMS7param(DCWR_TXBI), 1);
-                Modify_SPI_Reg_bits(LMS7param(DC_TXBI), int2txdcreg(dcI));
-                Modify_SPI_Reg_bits(LMS7param(DCWR_TXBQ), 0);
-                Modify_SPI_Reg_bits(LMS7param(DCWR_TXBQ), 1);
-                Modify_SPI_Reg_bits(LMS7param(DC_TXBQ), int2txdcreg(dcQ));
-            }
-            Modify_SPI_Reg_bits(LMS7param(GCORRI_TXTSP), gainI);
-            Modify_SPI_Reg_bits(LMS7param(GCORRQ_TXTSP), gainQ);
-            Modify_SPI_Reg_bits(LMS7param(IQCORR_TXTSP), phOffset);
-            Modify_SPI_Reg_bits(0x0208, 1, 0, 0); //GC_BYP PH_BYP
+            ApplyTxCorrections(dcI, dcQ, gainI, gainQ, phOffset);
             verbose_printf(cSquaresLine);
             verbose_printf("Tx calibration values found in cache:\n");
             verbose_printf("   | DC  | GAIN | PHASE\n");
@@ -919,6 +1108,9 @@ int LMS7002M::CalibrateTx(float_type bandwidth_Hz, bool useExtLoopback)
         }
     }
 
+    if(useCache)
+        LoadCalibrationSeed(boardId, txFreq, channel, true, band);
+
     uint16_t gcorri(0), gcorrq(0);
     int16_t dccorri(0), dccorrq(0), phaseOffset(0);
 
@@ -948,6 +1140,7 @@ int LMS7002M::CalibrateTx(float_type bandwidth_Hz, bool useExtLoopback)
     verbose_printf("Performed by: %s\n", mCalibrationByMCU ? "MCU" : "PC");
     verbose_printf(cDashLine);
     //LMS7002M_SelfCalState state(this);
+    LMS7002M_StreamRSSIState streamRSSI(this, STREAM_RSSI_CAL_TX);
     auto registersBackup = BackupRegisterMap();
     if(mCalibrationByMCU && not useExtLoopback)
     {
@@ -968,6 +1161,8 @@ int LMS7002M::CalibrateTx(float_type bandwidth_Hz, bool useExtLoopback)
         verbose_printf("MCU Ref. clock: %g MHz\n", refClk / 1e6);
         //set bandwidth for MCU to read from register, value is integer stored in MHz
         mcuControl->SetParameter(MCU_BD::MCU_BW, bandwidth_Hz);
+        if((status = CheckCalibrationAbort()) != 0)
+            return status;
         mcuControl->RunProcedure(MCU_FUNCTION_CALIBRATE_TX);
         status = mcuControl->WaitForMCU(1000);
         if(status != 0)
@@ -1024,6 +1219,7 @@ int LMS7002M::CalibrateTx(float_type bandwidth_Hz, bool useExtLoopback)
 #endif
     if(status != 0)
         goto TxCalibrationEnd; //go to ending stage to restore registers
+    streamRSSI.SetupInterface();
 #ifdef ENABLE_CALIBRATION_USING_FFT
     {
         //calculate NCO offset, that the signal would be in FFT bin
@@ -1035,6 +1231,8 @@ int LMS7002M::CalibrateTx(float_type bandwidth_Hz, bool useExtLoopback)
 #endif // ENABLE_CALIBRATION_USING_FFT
     if(useExtLoopback == false)
         CalibrateRxDCAuto();
+    if((status = CheckCalibrationAbort()) != 0)
+        goto TxCalibrationEnd;
     status = CheckSaturationTxRx(bandwidth_Hz, useExtLoopback);
     if(status != 0)
         goto TxCalibrationEnd;
@@ -1044,6 +1242,8 @@ int LMS7002M::CalibrateTx(float_type bandwidth_Hz, bool useExtLoopback)
     SetNCOFrequency(LMS7002M::Rx, 0, calibrationSXOffset_Hz - offsetNCO + (bandwidth_Hz / calibUserBwDivider));
     CalibrateTxDCAuto();
     //CalibrateTxDC(&dccorri, &dccorrq);
+    if((status = CheckCalibrationAbort()) != 0)
+        goto TxCalibrationEnd;
     //TXIQ
     SetNCOFrequency(LMS7002M::Rx, 0, calibrationSXOffset_Hz - offsetNCO);
     CalibrateIQImbalance(LMS7002M::Tx, &gcorri, &gcorrq, &phaseOffset);
@@ -1659,54 +1859,7 @@ int LMS7002M::CalibrateRxSetup(float_type bandwidth_Hz, const bool useExtLoopbac
 #ifdef ENABLE_CALIBRATION_USING_FFT
     if(useExtLoopback || useFFT)
     {
-        //limelight
-        Modify_SPI_Reg_bits(LMS7param(LML1_FIDM), 0);
-        Modify_SPI_Reg_bits(LMS7param(LML2_FIDM), 0);
-        Modify_SPI_Reg_bits(LMS7param(LML1_MODE), 0);
-        Modify_SPI_Reg_bits(LMS7param(LML2_MODE), 0);
-        if(ch == 1)
-        {
-            Modify_SPI_Reg_bits(LMS7param(LML2_S0S), 1); //pos0, AQ
-            Modify_SPI_Reg_bits(LMS7param(LML2_S1S), 0); //pos1, AI
-        }
-        else if(ch == 2)
-        {
-            Modify_SPI_Reg_bits(LMS7param(LML2_S0S), 3); //pos0, BQ
-            Modify_SPI_Reg_bits(LMS7param(LML2_S1S), 2); //pos1, BI
-        }
-        //if decimation/interpolation is 0(2^1) or 7(bypass), interface clocks should not be divided
-        int decimation = Get_SPI_Reg_bits(LMS7param(HBD_OVR_RXTSP));
-        float interfaceRx_Hz = GetReferenceClk_TSP(LMS7002M::Rx);
-        //need to adjust decimation to fit into USB speed
-        float rateLimit_Bps;
-        DeviceInfo info = dataPort->GetDeviceInfo();
-        if(info.deviceName == GetDeviceName(LMS_DEV_STREAM))
-            rateLimit_Bps = 110e6;
-        else if(info.deviceName == GetDeviceName(LMS_DEV_LIMESDR))
-            rateLimit_Bps = 200e6;
-        else if(info.deviceName == GetDeviceName(LMS_DEV_ULIMESDR))
-            rateLimit_Bps = 100e6;
-        else
-            rateLimit_Bps = 100e6;
-#ifndef N_DEBUG
-        rateLimit_Bps = 50e6; //debug mode is slower to receive data
-#endif
-
-        decimation = ceil(log2((interfaceRx_Hz*3/2)/rateLimit_Bps));
-        if(decimation < 0)
-            decimation = 0;
-        if(decimation > 4)
-            decimation = 4;
-        if (decimation != 7)
-            interfaceRx_Hz /= pow(2.0, decimation);
-        int interpolation = Get_SPI_Reg_bits(LMS7param(HBI_OVR_TXTSP));
-        float interfaceTx_Hz = GetReferenceClk_TSP(LMS7002M::Tx);
-        if (interpolation != 7)
-            interfaceTx_Hz /= pow(2.0, interpolation);
-        const int channelsCount = 2;
-        SetInterfaceFrequency(GetFrequencyCGEN(), interpolation, decimation);
-
-        dataPort->UpdateExternalDataRate(0, interfaceTx_Hz/channelsCount, interfaceRx_Hz/channelsCount);
+        SetupCalibrationInterface(ch);
 
         GenerateWindowCoefficients(3, gFFTSize, windowF, amplitudeCorr);
         GenerateWindowCoefficients(3, gFFTSize/2, windowG, amplitudeCorrG);
@@ -1731,10 +1884,15 @@ int LMS7002M::CalibrateRxSetup(float_type bandwidth_Hz, const bool useExtLoopbac
 */
 int LMS7002M::CalibrateRx(float_type bandwidth_Hz, bool useExtLoopback)
 {
+    ControlProfiler::Scope profile("CalibrateRx");
     if (TrxCalib_RF_LimitLow > bandwidth_Hz || bandwidth_Hz > TrxCalib_RF_LimitHigh)
         return ReportError(ERANGE, "Frequency out of range, available range: from %g to %g MHz", TrxCalib_RF_LimitLow / 1e6, TrxCalib_RF_LimitHigh / 1e6);
     if(controlPort == nullptr)
         return ReportError(ENODEV, "Device not connected");
+    mActiveCalibrationStats = &mCalibrationStats[0];
+    *mActiveCalibrationStats = CalibrationStats();
+    mCalibrationSeed.valid = false;
+    CalibrationRunningFlag running(mCalibrationRunning);
 #ifdef __cplusplus
     auto beginTime = std::chrono::high_resolution_clock::now();
 #endif
@@ -1799,15 +1957,9 @@ int LMS7002M::CalibrateRx(float_type bandwidth_Hz, bool useExtLoopback)
         if(foundInCache)
         {
             printf("Rx calibration: using cached values\n");
-            SetRxDCOFF(dcoffi, dcoffq);
-            Modify_SPI_Reg_bits(LMS7param(EN_DCOFF_RXFE_RFE), 1);
-            Modify_SPI_Reg_bits(LMS7param(GCORRI_RXTSP), gainI);
-            Modify_SPI_Reg_bits(LMS7param(GCORRQ_RXTSP), gainQ);
-            Modify_SPI_Reg_bits(LMS7param(IQCORR_RXTSP), phaseOffset);
-            Modify_SPI_Reg_bits(0x040C, 2, 0, 0); //DC_BYP 0, GC_BYP 0, PH_BYP 0
-            Modify_SPI_Reg_bits(0x0110, 4, 0, 31); //ICT_LO_RFE 31
             int8_t dcIsigned = (dcI & 0x3f) * (dcI&0x40 ? -1 : 1);
             int8_t dcQsigned = (dcQ & 0x3f) * (dcQ&0x40 ? -1 : 1);
+            ApplyRxCorrections(dcIsigned, dcQsigned, gainI, gainQ, phaseOffset);
             int16_t phaseSigned = phOffset << 4;
             phaseSigned >>= 4;
             verbose_printf("Rx calibration values found in cache:\n");
@@ -1820,9 +1972,13 @@ int LMS7002M::CalibrateRx(float_type bandwidth_Hz, bool useExtLoopback)
         }
     }
 
+    if(useCache)
+        LoadCalibrationSeed(boardId, rxFreq, channel, false, lna);
+
     verbose_printf("Performed by: %s\n", mCalibrationByMCU ? "MCU" : "PC");
     verbose_printf(cDashLine);
     LMS7002M_SelfCalState state(this);
+    LMS7002M_StreamRSSIState streamRSSI(this, STREAM_RSSI_CAL_RX);
     auto registersBackup = BackupRegisterMap();
     if(mCalibrationByMCU && not useExtLoopback)
     {
@@ -1843,6 +1999,8 @@ int LMS7002M::CalibrateRx(float_type bandwidth_Hz, bool useExtLoopback)
         verbose_printf("MCU Ref. clock: %g MHz\n", refClk / 1e6);
         //set bandwidth for MCU to read from register, value is integer stored in MHz
         mcuControl->SetParameter(MCU_BD::MCU_BW, bandwidth_Hz);
+        if((status = CheckCalibrationAbort()) != 0)
+            return status;
         mcuControl->RunProcedure(MCU_FUNCTION_CALIBRATE_RX);
         status = mcuControl->WaitForMCU(1000);
         if(status != 0)
@@ -1888,6 +2046,7 @@ int LMS7002M::CalibrateRx(float_type bandwidth_Hz, bool useExtLoopback)
     status = CalibrateRxSetup(bandwidth_Hz, useExtLoopback);
     if(status != 0)
         goto RxCalibrationEndStage;
+    streamRSSI.SetupInterface();
 
 #ifdef ENABLE_CALIBRATION_USING_FFT
     {
@@ -1900,6 +2059,8 @@ int LMS7002M::CalibrateRx(float_type bandwidth_Hz, bool useExtLoopback)
 #endif // ENABLE_CALIBRATION_USING_FFT
     Log("Rx DC calibration", LOG_INFO);
     CalibrateRxDCAuto();
+    if((status = CheckCalibrationAbort()) != 0)
+        goto RxCalibrationEndStage;
     if(useExtLoopback && useOnBoardLoopback)
     {
         status = SetExtLoopback(controlPort, ch, true);
@@ -1931,6 +2092,8 @@ int LMS7002M::CalibrateRx(float_type bandwidth_Hz, bool useExtLoopback)
     Modify_SPI_Reg_bits(LMS7param(MAC), ch);
 
     CheckSaturationRx(bandwidth_Hz, useExtLoopback);
+    if((status = CheckCalibrationAbort()) != 0)
+        goto RxCalibrationEndStage;
 
     if (Get_SPI_Reg_bits(LMS7_MASK, true) != 0)
         Modify_SPI_Reg_bits(LMS7param(CMIX_SC_RXTSP), 0);
@@ -2272,6 +2435,28 @@ void LMS7002M::BinarySearch(BinSearchParam* args)
 #endif
 }
 
+/** @brief Binary search in narrow window around seed value.
+    Window is limited to args min/max range. If minimum is found on window
+    edge, the target is outside of it and full range is searched.
+*/
+void LMS7002M::SeededBinarySearch(BinSearchParam* args, const int16_t seed, const int16_t radius)
+{
+    const int16_t fullMin = args->minValue;
+    const int16_t fullMax = args->maxValue;
+    args->minValue = std::max<int16_t>(fullMin, seed - radius);
+    args->maxValue = std::min<int16_t>(fullMax, seed + radius);
+    BinarySearch(args);
+    const bool atEdge = (args->result == args->minValue && args->minValue != fullMin) ||
+                        (args->result == args->maxValue && args->maxValue != fullMax);
+    args->minValue = fullMin;
+    args->maxValue = fullMax;
+    if(not atEdge)
+        return;
+    ++mActiveCalibrationStats->fullSearches;
+    verbose_printf("Seeded search missed (%i), searching full range\n", args->result);
+    BinarySearch(args);
+}
+
 void LMS7002M::CoarseSearch(const uint16_t addr, const uint8_t msb, const uint8_t lsb, int16_t &value, const uint8_t maxIterations)
 {
     const uint16_t DCOFFaddr = 0x010E;
@@ -2850,45 +3035,63 @@ void LMS7002M::CalibrateIQImbalance(const bool tx, uint16_t *gainI, uint16_t *ga
     BinSearchParam argsGain;
     GridSearchParam gridArgs;
 
+    //results of near frequency narrow the search windows
+    const bool warmStart = mCalibrationSeed.valid;
+    const int seedGain = warmStart ? std::min(mCalibrationSeed.gainI, mCalibrationSeed.gainQ) : 2047;
+
     argsPhase.param = tx ? LMS7param(IQCORR_TXTSP) : LMS7param(IQCORR_RXTSP);
     argsPhase.maxValue = 128;
     argsPhase.minValue = -128;
-    BinarySearch(&argsPhase);
+    if(warmStart)
+        SeededBinarySearch(&argsPhase, mCalibrationSeed.phase, 8);
+    else
+        BinarySearch(&argsPhase);
     phaseOffset = argsPhase.result;
     verbose_printf("Coarse search %s IQCORR: %i\n", dirName, phaseOffset);
 
     //coarse gain
-    uint32_t rssiIgain;
-    uint32_t rssiQgain;
-    Modify_SPI_Reg_bits(gcorri, 2047 - 64);
-    Modify_SPI_Reg_bits(gcorrq, 2047);
-    rssiIgain = GetRSSI();
-    Modify_SPI_Reg_bits(gcorri, 2047);
-    Modify_SPI_Reg_bits(gcorrq, 2047 - 64);
-    rssiQgain = GetRSSI();
-
+    if(seedGain < 2047)
+        argsGain.param = mCalibrationSeed.gainI < mCalibrationSeed.gainQ ? gcorri : gcorrq;
+    else
+    {
+        uint32_t rssiIgain;
+        uint32_t rssiQgain;
+        Modify_SPI_Reg_bits(gcorri, 2047 - 64);
+        Modify_SPI_Reg_bits(gcorrq, 2047);
+        rssiIgain = GetRSSI();
+        Modify_SPI_Reg_bits(gcorri, 2047);
+        Modify_SPI_Reg_bits(gcorrq, 2047 - 64);
+        rssiQgain = GetRSSI();
+
+        if(rssiIgain < rssiQgain)
+            argsGain.param = gcorri;
+        else
+            argsGain.param = gcorrq;
+    }
     Modify_SPI_Reg_bits(gcorri, 2047);
     Modify_SPI_Reg_bits(gcorrq, 2047);
-
-    if(rssiIgain < rssiQgain)
-        argsGain.param = gcorri;
-    else
-        argsGain.param = gcorrq;
     const char* chName = (argsGain.param.address == gcorri.address ? "I" : "Q");
 
     argsGain.maxValue = 2047;
     argsGain.minValue = 2047-512;
-    BinarySearch(&argsGain);
+    if(warmStart)
+        SeededBinarySearch(&argsGain, seedGain, 16);
+    else
+        BinarySearch(&argsGain);
     gain = argsGain.result;
     verbose_printf("Coarse search %s GAIN_%s: %i\n", dirName, chName, gain);
 
-    argsPhase.maxValue = phaseOffset+8;
-    argsPhase.minValue = phaseOffset-8;
-    BinarySearch(&argsPhase);
-    phaseOffset = argsPhase.result;
-    verbose_printf("Coarse search %s IQCORR: %i\n", dirName, phaseOffset);
+    //seeded phase search was already narrow
+    if(not warmStart)
+    {
+        argsPhase.maxValue = phaseOffset+8;
+        argsPhase.minValue = phaseOffset-8;
+        BinarySearch(&argsPhase);
+        phaseOffset = argsPhase.result;
+        verbose_printf("Coarse search %s IQCORR: %i\n", dirName, phaseOffset);
+    }
 
-    const uint8_t gridRadius = 2;
+    const uint8_t gridRadius = warmStart ? 1 : 2;
     gridArgs.a = argsGain;
     gridArgs.a.minValue = gain-gridRadius;
     gridArgs.a.maxValue = gain+gridRadius;
@@ -8,6 +8,7 @@
 #include "IConnection.h"
 #include "ErrorReporting.h"
 #include "CalibrationCache.h"
+#include "ControlProfiler.h"
 #include "LMS7002M_RegistersMap.h"
 #include <cmath>
 #include <iostream>
@@ -97,6 +98,16 @@ void LMS7002M::RestoreRegisterMap(LMS7002M_RegistersMap *backup)
 
 uint32_t LMS7002M::GetAvgRSSI(const int avgCount)
 {
+    if (mStreamRSSIActive)
+    {
+        //one burst of avgCount times more windows
+        const uint32_t rssi = EstimateStreamRSSI(avgCount*mStreamRSSIConfig.averages);
+        if (rssi != 0)
+        {
+            mActiveCalibrationStats->rssiReads += avgCount;
+            return rssi;
+        }
+    }
     float_type sum = 0;
     for(int i=0; i<avgCount; ++i)
         sum += GetRSSI();
@@ -105,9 +116,11 @@ uint32_t LMS7002M::GetAvgRSSI(const int avgCount)
 
 int LMS7002M::TuneRxFilter(float_type rx_lpf_freq_RF)
 {
+    ControlProfiler::Scope profile("TuneRxFilter");
     int status;
     if(RxLPF_RF_LimitLow > rx_lpf_freq_RF || rx_lpf_freq_RF > RxLPF_RF_LimitHigh)
         return ReportError(ERANGE, "RxLPF frequency out of range, available range from %g to %g MHz", RxLPF_RF_LimitLow/1e6, RxLPF_RF_LimitHigh/1e6);
+    LMS7002M_StreamRSSIState streamRSSI(this, STREAM_RSSI_FILTER_RX);
 
     if(mCalibrationByMCU)
     {
@@ -154,6 +167,7 @@ int LMS7002M::TuneRxFilter(float_type rx_lpf_freq_RF)
         RestoreRegisterMap(registersBackup);
         return status;
     }
+    streamRSSI.SetupInterface();
 
     int g_rxloopb_rfe = Get_SPI_Reg_bits(LMS7param(G_RXLOOPB_RFE));
     uint32_t rssi = GetRSSI();
@@ -868,6 +882,7 @@ int LMS7002M::TuneTxFilterSetup(const float_type tx_lpf_IF)
 
 int LMS7002M::TuneTxFilter(const float_type tx_lpf_freq_RF)
 {
+    ControlProfiler::Scope profile("TuneTxFilter");
     int status;
 
     if(tx_lpf_freq_RF < TxLPF_RF_LimitLow || tx_lpf_freq_RF > TxLPF_RF_LimitHigh)
@@ -884,6 +899,7 @@ int LMS7002M::TuneTxFilter(const float_type tx_lpf_freq_RF)
                         TxLPF_RF_LimitMidHigh/1e6);
         tx_lpf_IF = TxLPF_RF_LimitMidHigh/2;
     }
+    LMS7002M_StreamRSSIState streamRSSI(this, STREAM_RSSI_FILTER_TX);
 
     if(mCalibrationByMCU)
     {
@@ -919,6 +935,7 @@ int LMS7002M::TuneTxFilter(const float_type tx_lpf_freq_RF)
         RestoreRegisterMap(registersBackup);
         return status;
     }
+    streamRSSI.SetupInterface();
 
     Modify_SPI_Reg_bits(LMS7param(SEL_RX), 0);
     Modify_SPI_Reg_bits(LMS7param(SEL_TX), 0);
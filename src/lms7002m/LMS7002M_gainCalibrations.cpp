@@ -1,4 +1,5 @@
 #include "LMS7002M.h"
+#include "ControlProfiler.h"
 using namespace lime;
 
 int LMS7002M::CalibrateTxGainSetup()
@@ -92,6 +93,7 @@ int LMS7002M::CalibrateTxGainSetup()
 
 int LMS7002M::CalibrateTxGain(float maxGainOffset_dBFS, float *actualGain_dBFS)
 {
+    ControlProfiler::Scope profile("CalibrateTxGain");
     int status;
     int cg_iamp;
     auto registersBackup = BackupRegisterMap();
@@ -350,6 +350,33 @@ void OpenGLGraph::Pan( float dx, float dy)
 void OpenGLGraph::SetDrawingMode( eDrawingMode mode )
 {
 	settings.graphType = mode;
+	for(unsigned int i=0; i<series.size(); i++)
+		series[i]->modified = true;
+}
+
+/**
+	@brief Reduces line series to min/max envelope of data view pixel columns
+	Envelope is recalculated only when values or visible area change, so
+	drawing and buffer upload cost depends on view width, not series length.
+	Points (constellation) are drawn unchanged.
+*/
+void OpenGLGraph::DecimateSerie(cDataSerie* serie)
+{
+	const sRect<double> &area = settings.visibleArea;
+	const bool viewChanged = serie->decimatedColumns != settings.dataViewWidth
+		|| serie->decimatedArea.x1 != area.x1 || serie->decimatedArea.x2 != area.x2;
+	if(!serie->modified && !viewChanged)
+		return;
+	const unsigned int previousSize = serie->decimatedSize;
+	serie->decimatedArea = area;
+	serie->decimatedColumns = settings.dataViewWidth;
+	if(settings.graphType == GLG_LINE)
+		serie->decimatedSize = DecimateMinMax(serie->values, serie->size, area.x1, area.x2, settings.dataViewWidth, serie->decimated);
+	else
+		serie->decimatedSize = 0;
+	//buffer object holds envelope of previous view
+	if(serie->decimatedSize > 0 || previousSize > 0)
+		serie->modified = true;
 }
 
 /**
@@ -689,70 +716,60 @@ void OpenGLGraph::Draw()
 	//draw series data
 
 	switchToDataView();
-	if(settings.useVBO && GLEW_VERSION_1_5)
+	const bool useVBO = settings.useVBO && GLEW_VERSION_1_5;
+	glEnableClientState(GL_VERTEX_ARRAY);
+	for(unsigned int i=0; i<series.size(); i++)
 	{
-		for(unsigned int i=0; i<series.size(); i++)
+		cDataSerie* serie = series[i];
+		if(serie->size == 0 || !serie->visible)
+			continue;
+		glColor3f(serie->color.red, serie->color.green, serie->color.blue);
+		DecimateSerie(serie);
+		const bool decimated = serie->decimatedSize > 0;
+		const float* drawValues = decimated ? serie->decimated.data() : serie->values;
+		const unsigned int drawSize = decimated ? serie->decimatedSize : serie->size;
+		if(useVBO)
 		{
-			glColor3f(series[i]->color.red, series[i]->color.green, series[i]->color.blue);
-			if(series[i]->size > 0 && series[i]->visible)
+			if( serie->vboIndex == 0) //check if data series buffer is initialized
 			{
-				if( series[i]->vboIndex == 0) //check if data series buffer is initialized
-				{
-					glGenBuffersARB(1, &series[i]->vboIndex);
-				}
-				//bind buffer for filling
-				glBindBufferARB(GL_ARRAY_BUFFER_ARB, series[i]->vboIndex);
-				if(series[i]->modified) //check if buffer needs to be modified
-				{
-					glBufferDataARB(GL_ARRAY_BUFFER_ARB, sizeof(float)*series[i]->size*2, NULL, GL_DYNAMIC_DRAW_ARB);
-					glBufferDataARB(GL_ARRAY_BUFFER_ARB, sizeof(float)*series[i]->size*2, series[i]->values, GL_DYNAMIC_DRAW_ARB);
-					series[i]->modified = false;
-				}
-				glEnableClientState(GL_VERTEX_ARRAY);
-				glEnableClientState(GL_COLOR);
-				glVertexPointer(2, GL_FLOAT, 0, 0);
-				if(settings.graphType == GLG_POINTS)
-				{
-					glPointSize(settings.pointsSize);
-					glDrawArrays(GL_POINTS, 0, series[i]->size);
-				}
-				else
-				{
-					glPointSize(1);
-					glDrawArrays(GL_LINE_STRIP, 0, series[i]->size);
-				}
-				glDisableClientState(GL_VERTEX_ARRAY);
-				glDisableClientState(GL_COLOR);
-				glBindBufferARB(GL_ARRAY_BUFFER, 0);
+				glGenBuffersARB(1, &serie->vboIndex);
 			}
-		}
-	}
-	else  //backup case if VBO is not supported
-	{
-		for(unsigned int i=0; i<series.size(); i++)
-		{
-			glColor3f(series[i]->color.red, series[i]->color.green, series[i]->color.blue);
-			if(series[i]->size > 0 && series[i]->visible)
+			glBindBufferARB(GL_ARRAY_BUFFER_ARB, serie->vboIndex);
+			if(serie->modified) //check if buffer needs to be modified
 			{
-				if(settings.graphType == GLG_POINTS)
+				const unsigned int bytes = sizeof(float)*drawSize*2;
+				if(bytes > serie->vboCapacity)
 				{
-					glPointSize(settings.pointsSize);
-					glBegin(GL_POINTS);
+					serie->vboCapacity = bytes;
+					glBufferDataARB(GL_ARRAY_BUFFER_ARB, bytes, drawValues, GL_STREAM_DRAW_ARB);
 				}
 				else
 				{
-					glPointSize(1);
-					glBegin(GL_LINE_STRIP);
+					//orphan storage, driver does not wait for previous frame drawing
+					glBufferDataARB(GL_ARRAY_BUFFER_ARB, serie->vboCapacity, NULL, GL_STREAM_DRAW_ARB);
+					glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, 0, bytes, drawValues);
 				}
-				for(unsigned int j=0; j<series[i]->size; j++)
-				{
-					glVertex3f( series[i]->values[2*j], series[i]->values[2*j+1], 1.0);
-				}
-				glEnd();
 			}
+			glVertexPointer(2, GL_FLOAT, 0, 0);
 		}
-		glFlush();
+		else //backup case if VBO is not supported, vertex array from memory
+			glVertexPointer(2, GL_FLOAT, 0, drawValues);
+		serie->modified = false;
+
+		if(settings.graphType == GLG_POINTS)
+		{
+			glPointSize(settings.pointsSize);
+			glDrawArrays(GL_POINTS, 0, drawSize);
+		}
+		else
+		{
+			glPointSize(1);
+			glDrawArrays(GL_LINE_STRIP, 0, drawSize);
+		}
+		if(useVBO)
+			glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
 	}
+	glDisableClientState(GL_VERTEX_ARRAY);
 	//draw measuring markers
 	DrawMarkers();
 	switchToWindowView();
@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 #include "string.h"
+#include "SeriesDecimation.h"
 
 enum eOGLGMouseButton
 {
@@ -107,7 +108,9 @@ struct GLG_color
 class cDataSerie
 {
 public:
-	cDataSerie() : size(0), allocatedSize(0), vboIndex(0), visible(true), modified(true), values(NULL)
+	cDataSerie() : size(0), allocatedSize(0), vboIndex(0), vboCapacity(0),
+		decimatedSize(0), decimatedArea(0, 0, 0, 0), decimatedColumns(0),
+		visible(true), modified(true), values(NULL)
 	{
 		color = 0x000000FF;
 		Initialize(10);
@@ -189,6 +192,14 @@ public:
 	unsigned int size;
 	unsigned int allocatedSize;
 	unsigned int vboIndex;
+	unsigned int vboCapacity; //allocated buffer object size in bytes
+
+	//min/max envelope drawn instead of values when decimatedSize > 0
+	std::vector<float> decimated;
+	unsigned int decimatedSize;
+	sRect<double> decimatedArea;
+	int decimatedColumns;
+
 	GLG_color color;
 	bool visible;
 	bool modified;
@@ -380,6 +391,7 @@ private:
 
 	void DrawStaticElements();
 	void DrawMarkers();
+	void DecimateSerie(cDataSerie* serie);
 	void CalculateGrid();
 
 	void switchToWindowView();
@@ -0,0 +1,299 @@
+/**
+    @file AsyncBlockIO.cpp
+    @author Lime Microsystems
+    @brief Multi-buffered background reading and writing of fixed size blocks
+*/
+
+#include "AsyncBlockIO.h"
+#include <chrono>
+#include <ciso646>
+#ifdef __unix__
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#endif
+
+using namespace lime;
+
+//single transfer call timeout, limits Stop() latency
+static const int transferTimeout_ms = 100;
+
+#ifdef __unix__
+static int PollTransfer(const int fd, char* buffer, const int length, const int timeout_ms, const bool write)
+{
+    int total = 0;
+    auto t1 = std::chrono::steady_clock::now();
+    while (total < length)
+    {
+        int ret = write ? ::write(fd, buffer + total, length - total) : ::read(fd, buffer + total, length - total);
+        if (ret > 0)
+        {
+            total += ret;
+            continue;
+        }
+        if (ret == 0 and not write) //end of file
+            return total > 0 ? total : -1;
+        if (ret < 0 and errno != EAGAIN and errno != EWOULDBLOCK and errno != EINTR)
+            return total > 0 ? total : -1;
+
+        //wait for device to become ready instead of retrying
+        int elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t1).count();
+        if (elapsed >= timeout_ms)
+            break;
+        pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = write ? POLLOUT : POLLIN;
+        pfd.revents = 0;
+        ret = poll(&pfd, 1, timeout_ms - elapsed);
+        if (ret == 0)
+            break;
+        if (ret < 0 and errno != EINTR)
+            return total > 0 ? total : -1;
+    }
+    return total;
+}
+
+int lime::PollRead(const int fd, char* buffer, const int length, const int timeout_ms)
+{
+    return PollTransfer(fd, buffer, length, timeout_ms, false);
+}
+
+int lime::PollWrite(const int fd, const char* buffer, const int length, const int timeout_ms)
+{
+    return PollTransfer(fd, const_cast<char*>(buffer), length, timeout_ms, true);
+}
+#endif
+
+/***********************************************************************
+ * AsyncBlockReader
+ **********************************************************************/
+AsyncBlockReader::AsyncBlockReader(const TransferFunction &read, const size_t blockSize, const unsigned blockCount) :
+    mRead(read),
+    mBlockSize(blockSize),
+    mBlocks(blockCount < 2 ? 2 : blockCount, std::vector<char>(blockSize)),
+    mFilled(mBlocks.size(), 0),
+    mHead(0),
+    mTail(0),
+    mCount(0),
+    mAcquired(false),
+    mTerminate(true),
+    mBytes(0)
+{
+}
+
+AsyncBlockReader::~AsyncBlockReader()
+{
+    Stop();
+}
+
+void AsyncBlockReader::Start()
+{
+    Stop();
+    mHead = mTail = mCount = 0;
+    mAcquired = false;
+    mBytes = 0;
+    mTerminate = false;
+    mThread = std::thread(&AsyncBlockReader::ReadLoop, this);
+}
+
+void AsyncBlockReader::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mTerminate = true;
+    }
+    mCond.notify_all();
+    if (mThread.joinable())
+        mThread.join();
+}
+
+void AsyncBlockReader::ReadLoop()
+{
+    while (true)
+    {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mLock);
+            while (mCount == mBlocks.size() and not mTerminate)
+                mCond.wait(lock);
+            if (mTerminate)
+                return;
+            index = mHead;
+        }
+
+        //fill whole block, partial blocks are returned only on error
+        char* block = mBlocks[index].data();
+        int filled = 0;
+        bool failed = false;
+        while (filled < int(mBlockSize) and not mTerminate)
+        {
+            int ret = mRead(block + filled, mBlockSize - filled, transferTimeout_ms);
+            if (ret < 0)
+            {
+                failed = true;
+                break;
+            }
+            filled += ret;
+        }
+        if (mTerminate)
+            return;
+        mBytes += filled;
+
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            mFilled[index] = (failed and filled == 0) ? -1 : filled;
+            mHead = (mHead + 1) % mBlocks.size();
+            ++mCount;
+        }
+        mCond.notify_all();
+        if (failed) //do not flood reader with errors
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+int AsyncBlockReader::Acquire(const char* &data, const int timeout_ms)
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    if (not mCond.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]{return mCount > 0 or mTerminate;}))
+        return 0;
+    if (mCount == 0)
+        return 0;
+    mAcquired = true;
+    data = mBlocks[mTail].data();
+    return mFilled[mTail];
+}
+
+void AsyncBlockReader::Release()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (not mAcquired)
+            return;
+        mAcquired = false;
+        mTail = (mTail + 1) % mBlocks.size();
+        --mCount;
+    }
+    mCond.notify_all();
+}
+
+uint64_t AsyncBlockReader::GetBytesTransferred() const
+{
+    return mBytes;
+}
+
+/***********************************************************************
+ * AsyncBlockWriter
+ **********************************************************************/
+AsyncBlockWriter::AsyncBlockWriter(const TransferFunction &write, const size_t blockSize, const unsigned blockCount) :
+    mWrite(write),
+    mBlockSize(blockSize),
+    mBlocks(blockCount < 2 ? 2 : blockCount, std::vector<char>(blockSize)),
+    mLength(mBlocks.size(), 0),
+    mHead(0),
+    mTail(0),
+    mCount(0),
+    mAcquired(false),
+    mTerminate(true),
+    mFailed(0),
+    mBytes(0)
+{
+}
+
+AsyncBlockWriter::~AsyncBlockWriter()
+{
+    Stop();
+}
+
+void AsyncBlockWriter::Start()
+{
+    Stop();
+    mHead = mTail = mCount = 0;
+    mAcquired = false;
+    mFailed = 0;
+    mBytes = 0;
+    mTerminate = false;
+    mThread = std::thread(&AsyncBlockWriter::WriteLoop, this);
+}
+
+void AsyncBlockWriter::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mTerminate = true;
+    }
+    mCond.notify_all();
+    if (mThread.joinable())
+        mThread.join();
+}
+
+void AsyncBlockWriter::WriteLoop()
+{
+    while (true)
+    {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mLock);
+            while (mCount == 0 and not mTerminate)
+                mCond.wait(lock);
+            if (mTerminate)
+                return;
+            index = mTail;
+        }
+
+        const char* block = mBlocks[index].data();
+        const int length = mLength[index];
+        int written = 0;
+        while (written < length and not mTerminate)
+        {
+            int ret = mWrite(block + written, length - written, transferTimeout_ms);
+            if (ret < 0)
+                break;
+            written += ret;
+        }
+        if (written < length)
+            ++mFailed;
+        mBytes += written;
+
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            mTail = (mTail + 1) % mBlocks.size();
+            --mCount;
+        }
+        mCond.notify_all();
+    }
+}
+
+char* AsyncBlockWriter::Acquire(const int timeout_ms)
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    if (not mCond.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]{return mCount < mBlocks.size() or mTerminate;}))
+        return nullptr;
+    if (mCount == mBlocks.size())
+        return nullptr;
+    mAcquired = true;
+    return mBlocks[mHead].data();
+}
+
+void AsyncBlockWriter::Commit(const size_t length)
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (not mAcquired)
+            return;
+        mAcquired = false;
+        mLength[mHead] = length < mBlockSize ? length : mBlockSize;
+        mHead = (mHead + 1) % mBlocks.size();
+        ++mCount;
+    }
+    mCond.notify_all();
+}
+
+uint32_t AsyncBlockWriter::GetFailedWrites() const
+{
+    return mFailed;
+}
+
+uint64_t AsyncBlockWriter::GetBytesTransferred() const
+{
+    return mBytes;
+}
@@ -0,0 +1,132 @@
+/**
+    @file AsyncBlockIO.h
+    @author Lime Microsystems
+    @brief Multi-buffered background reading and writing of fixed size blocks
+*/
+
+#ifndef LIME_ASYNC_BLOCK_IO_H
+#define LIME_ASYNC_BLOCK_IO_H
+
+#include "LimeSuiteConfig.h"
+#include <functional>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+namespace lime
+{
+
+/** @brief Reads up to length bytes from non-blocking file descriptor.
+    Waits for data with poll(), does not spin on EAGAIN.
+    @return number of bytes read, -1 on error before any data was read
+*/
+LIME_API int PollRead(const int fd, char* buffer, const int length, const int timeout_ms);
+
+/** @brief Writes up to length bytes to non-blocking file descriptor.
+    Waits for space with poll(), does not spin on EAGAIN.
+    @return number of bytes written, -1 on error before any data was written
+*/
+LIME_API int PollWrite(const int fd, const char* buffer, const int length, const int timeout_ms);
+
+/** @brief Reads blocks in background thread into a ring of buffers.
+    Device I/O of next blocks overlaps processing of the acquired one.
+    The transfer function is called with remaining part of the block until it
+    is full, it should return after timeout so that Stop() is not delayed.
+*/
+class LIME_API AsyncBlockReader
+{
+public:
+    //! Reads up to length bytes, returns bytes read or negative on error
+    typedef std::function<int(char* buffer, int length, int timeout_ms)> TransferFunction;
+
+    AsyncBlockReader(const TransferFunction &read, const size_t blockSize, const unsigned blockCount = 3);
+    ~AsyncBlockReader();
+
+    void Start();
+    //! Stops reading thread, filled blocks are discarded
+    void Stop();
+
+    /** @brief Waits for next filled block
+        @param [out] data block data, valid until Release()
+        @return number of bytes in block, 0 on timeout, -1 when reading failed
+    */
+    int Acquire(const char* &data, const int timeout_ms);
+
+    //! Returns acquired block for refilling
+    void Release();
+
+    //! Total number of bytes read from device
+    uint64_t GetBytesTransferred() const;
+
+private:
+    void ReadLoop();
+
+    TransferFunction mRead;
+    const size_t mBlockSize;
+    std::vector<std::vector<char>> mBlocks;
+    std::vector<int> mFilled;       //!< bytes in block, -1 on error
+    size_t mHead;                   //!< next block to fill
+    size_t mTail;                   //!< next block to acquire
+    size_t mCount;                  //!< filled blocks
+    bool mAcquired;
+    std::mutex mLock;
+    std::condition_variable mCond;
+    std::atomic<bool> mTerminate;
+    std::atomic<uint64_t> mBytes;
+    std::thread mThread;
+};
+
+/** @brief Writes blocks in background thread from a ring of buffers.
+    Caller fills next block while previous ones are being written.
+*/
+class LIME_API AsyncBlockWriter
+{
+public:
+    //! Writes up to length bytes, returns bytes written or negative on error
+    typedef std::function<int(const char* buffer, int length, int timeout_ms)> TransferFunction;
+
+    AsyncBlockWriter(const TransferFunction &write, const size_t blockSize, const unsigned blockCount = 3);
+    ~AsyncBlockWriter();
+
+    void Start();
+    //! Stops writing thread, queued blocks are discarded
+    void Stop();
+
+    /** @brief Waits for free block to fill
+        @return block of blockSize bytes, nullptr on timeout
+    */
+    char* Acquire(const int timeout_ms);
+
+    //! Queues acquired block for writing
+    void Commit(const size_t length);
+
+    //! Number of blocks which were not written completely
+    uint32_t GetFailedWrites() const;
+
+    //! Total number of bytes written to device
+    uint64_t GetBytesTransferred() const;
+
+private:
+    void WriteLoop();
+
+    TransferFunction mWrite;
+    const size_t mBlockSize;
+    std::vector<std::vector<char>> mBlocks;
+    std::vector<size_t> mLength;
+    size_t mHead;                   //!< next block to fill
+    size_t mTail;                   //!< next block to write
+    size_t mCount;                  //!< queued blocks, including the one being written
+    bool mAcquired;
+    std::mutex mLock;
+    std::condition_variable mCond;
+    std::atomic<bool> mTerminate;
+    std::atomic<uint32_t> mFailed;
+    std::atomic<uint64_t> mBytes;
+    std::thread mThread;
+};
+
+}
+#endif
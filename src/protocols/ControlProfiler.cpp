@@ -0,0 +1,204 @@
+/**
+    @file ControlProfiler.cpp
+    @author Lime Microsystems
+    @brief Attribution of control transactions to high level operations
+*/
+
+#include "ControlProfiler.h"
+#include "ErrorReporting.h"
+#include <atomic>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <cerrno>
+#include <cstring>
+#include <ciso646>
+
+#ifdef _MSC_VER
+    #define thread_local __declspec( thread )
+#endif
+
+#ifdef __APPLE__
+    #define thread_local __thread
+#endif
+
+using namespace lime;
+
+static const char* noOperation = "(none)";
+
+//deeper nesting is still tracked, but not attributed
+static const int maxDepth = 16;
+thread_local static const char* opStack[maxDepth];
+thread_local static int opDepth;
+
+static std::atomic<bool> profilerEnabled(false);
+static std::mutex statsLock;
+static std::map<std::string, ControlProfiler::OperationStats> &GetStatsMap()
+{
+    static std::map<std::string, ControlProfiler::OperationStats> stats;
+    return stats;
+}
+
+ControlProfiler::OperationStats::OperationStats() :
+    calls(0), callTime(0), callTimeMax(0),
+    transactions(0), ownTransactions(0), bytesOut(0), bytesIn(0),
+    latency(0), latencyMin(0), latencyMax(0)
+{
+    for (int i = 0; i < histogramBins; ++i)
+        histogram[i] = 0;
+}
+
+ControlProfiler::Scope::Scope(const char* operation) :
+    active(profilerEnabled.load(std::memory_order_relaxed))
+{
+    if (not active)
+        return;
+    if (opDepth < maxDepth)
+        opStack[opDepth] = operation;
+    ++opDepth;
+    start = std::chrono::steady_clock::now();
+}
+
+ControlProfiler::Scope::~Scope()
+{
+    if (not active)
+        return;
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    --opDepth;
+    if (opDepth >= maxDepth)
+        return;
+    //recursive operations are counted once
+    for (int i = 0; i < opDepth; ++i)
+        if (strcmp(opStack[i], opStack[opDepth]) == 0)
+            return;
+    std::lock_guard<std::mutex> lock(statsLock);
+    OperationStats &op = GetStatsMap()[opStack[opDepth]];
+    ++op.calls;
+    op.callTime += elapsed;
+    if (elapsed > op.callTimeMax)
+        op.callTimeMax = elapsed;
+}
+
+void ControlProfiler::Enable(const bool enable)
+{
+    profilerEnabled.store(enable);
+}
+
+bool ControlProfiler::IsEnabled()
+{
+    return profilerEnabled.load(std::memory_order_relaxed);
+}
+
+void ControlProfiler::Reset()
+{
+    std::lock_guard<std::mutex> lock(statsLock);
+    GetStatsMap().clear();
+}
+
+static int HistogramBin(const double latency)
+{
+    const double us = latency*1e6;
+    int bin = 0;
+    for (double bound = 1.0; us >= bound and bin < ControlProfiler::histogramBins-1; bound *= 2)
+        ++bin;
+    return bin;
+}
+
+void ControlProfiler::RecordTransaction(const size_t bytesOut, const size_t bytesIn, const double latency)
+{
+    if (not IsEnabled())
+        return;
+    const int bin = HistogramBin(latency);
+    const int depth = opDepth < maxDepth ? opDepth : maxDepth;
+    const char* innermost = depth > 0 ? opStack[depth-1] : noOperation;
+
+    std::lock_guard<std::mutex> lock(statsLock);
+    auto &stats = GetStatsMap();
+    for (int i = 0; i < (depth > 0 ? depth : 1); ++i)
+    {
+        const char* name = depth > 0 ? opStack[i] : noOperation;
+        //recursive operations are counted once
+        bool duplicate = false;
+        for (int j = 0; j < i; ++j)
+            duplicate |= strcmp(opStack[j], name) == 0;
+        if (duplicate)
+            continue;
+        OperationStats &op = stats[name];
+        if (op.transactions == 0 or latency < op.latencyMin)
+            op.latencyMin = latency;
+        if (latency > op.latencyMax)
+            op.latencyMax = latency;
+        ++op.transactions;
+        if (strcmp(name, innermost) == 0)
+            ++op.ownTransactions;
+        op.bytesOut += bytesOut;
+        op.bytesIn += bytesIn;
+        op.latency += latency;
+        ++op.histogram[bin];
+    }
+}
+
+std::map<std::string, ControlProfiler::OperationStats> ControlProfiler::GetStats()
+{
+    std::lock_guard<std::mutex> lock(statsLock);
+    return GetStatsMap();
+}
+
+static std::string EscapeJSON(const std::string &str)
+{
+    std::string out;
+    for (char c : str)
+    {
+        if (c == '"' or c == '\\')
+            out.push_back('\\');
+        out.push_back(c);
+    }
+    return out;
+}
+
+std::string ControlProfiler::ExportJSON()
+{
+    const auto stats = GetStats();
+    std::ostringstream ss;
+    ss << "{";
+    bool first = true;
+    for (const auto &entry : stats)
+    {
+        const OperationStats &op = entry.second;
+        ss << (first ? "\n" : ",\n");
+        first = false;
+        ss << "  \"" << EscapeJSON(entry.first) << "\": {";
+        ss << "\"calls\": " << op.calls;
+        ss << ", \"call_time_ms\": " << op.callTime*1e3;
+        ss << ", \"call_time_max_ms\": " << op.callTimeMax*1e3;
+        ss << ", \"transactions\": " << op.transactions;
+        ss << ", \"own_transactions\": " << op.ownTransactions;
+        ss << ", \"bytes_out\": " << op.bytesOut;
+        ss << ", \"bytes_in\": " << op.bytesIn;
+        ss << ", \"latency_ms\": " << op.latency*1e3;
+        ss << ", \"latency_min_us\": " << op.latencyMin*1e6;
+        ss << ", \"latency_max_us\": " << op.latencyMax*1e6;
+        //non empty bins as [upper bound us, count]
+        ss << ", \"latency_histogram_us\": [";
+        bool firstBin = true;
+        for (int i = 0; i < histogramBins; ++i)
+        {
+            if (op.histogram[i] == 0)
+                continue;
+            ss << (firstBin ? "" : ", ") << "[" << (uint64_t(1) << i) << ", " << op.histogram[i] << "]";
+            firstBin = false;
+        }
+        ss << "]}";
+    }
+    ss << "\n}\n";
+    return ss.str();
+}
+
+int ControlProfiler::ExportJSON(const std::string &filename)
+{
+    std::ofstream file(filename);
+    if (not file.is_open())
+        return ReportError(errno, "Failed to open %s", filename.c_str());
+    file << ExportJSON();
+    return file.good() ? 0 : ReportError(EIO, "Failed to write %s", filename.c_str());
+}
@@ -0,0 +1,86 @@
+/**
+    @file ControlProfiler.h
+    @author Lime Microsystems
+    @brief Attribution of control transactions to high level operations
+*/
+
+#ifndef LIME_CONTROL_PROFILER_H
+#define LIME_CONTROL_PROFILER_H
+
+#include "LimeSuiteConfig.h"
+#include <chrono>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+namespace lime
+{
+
+/** @brief Opt-in profiler of control port traffic.
+    Operations are marked with Scope objects, every control transaction is
+    counted in all operations active on the calling thread. Outermost
+    operation shows total cost of API call, innermost one gets it as own cost.
+    When disabled, Scope and RecordTransaction only check an atomic flag.
+*/
+class LIME_API ControlProfiler
+{
+public:
+    //! Number of latency histogram bins, bin i holds latencies below 2^i us, last one the rest
+    static const int histogramBins = 24;
+
+    struct OperationStats
+    {
+        OperationStats();
+        uint64_t calls;
+        double callTime;            //!< total time spent in operation, seconds
+        double callTimeMax;         //!< longest single call, seconds
+        uint64_t transactions;      //!< transactions including nested operations
+        uint64_t ownTransactions;   //!< transactions not in any nested operation
+        uint64_t bytesOut;
+        uint64_t bytesIn;
+        double latency;             //!< total transaction latency, seconds
+        double latencyMin;
+        double latencyMax;
+        uint64_t histogram[histogramBins]; //!< transaction latencies
+    };
+
+    //! Marks operation for the lifetime of object, name must be string literal
+    class LIME_API Scope
+    {
+    public:
+        Scope(const char* operation);
+        ~Scope();
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+        bool active;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    static void Enable(const bool enable);
+    static bool IsEnabled();
+
+    //! Clears gathered statistics
+    static void Reset();
+
+    /** @brief Records single control port request/response
+        @param bytesOut bytes sent to device
+        @param bytesIn bytes received from device
+        @param latency time spent in transfer, seconds
+    */
+    static void RecordTransaction(const size_t bytesOut, const size_t bytesIn, const double latency);
+
+    //! Returns statistics of operations, transactions outside operations are under "(none)"
+    static std::map<std::string, OperationStats> GetStats();
+
+    //! Returns statistics as JSON object keyed by operation name
+    static std::string ExportJSON();
+
+    //! Writes statistics to file as JSON, returns 0 on success
+    static int ExportJSON(const std::string &filename);
+};
+
+}
+
+#endif
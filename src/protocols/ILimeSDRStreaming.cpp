@@ -326,14 +326,22 @@ IStreamChannel::Info ILimeSDRStreaming::StreamChannel::GetInfo()
     stats.active = mActive;
     stats.droppedPackets = pktLost;
     stats.overrun = overflow;
-    stats.overrun = underflow;
+    stats.underrun = underflow;
     pktLost = 0;
     overflow = 0;
     underflow = 0;
     if(config.isTx)
+    {
         stats.linkRate = mStreamer->txDataRate_Bps.load();
+        stats.zeroCopy = mStreamer->txZeroCopy.load();
+    }
     else
+    {
         stats.linkRate = mStreamer->rxDataRate_Bps.load();
+        stats.zeroCopy = mStreamer->rxZeroCopy.load();
+        stats.decodeQueue = mStreamer->rxDecodeQueue.load();
+        stats.reorderQueue = mStreamer->rxReorderQueue.load();
+    }
     return stats;
 }
 
@@ -371,8 +379,13 @@ ILimeSDRStreaming::Streamer::Streamer(ILimeSDRStreaming* port)
     txRunning = false;
     rxDataRate_Bps = 0;
     txDataRate_Bps = 0;
+    rxZeroCopy = false;
+    txZeroCopy = false;
     txBatchSize = 1;
     rxBatchSize = 1;
+    rxDecodeWorkers = 0;
+    rxDecodeQueue = 0;
+    rxReorderQueue = 0;
     mChipID = dataPort->mStreamers.size();
 }
 
@@ -394,7 +407,11 @@ int ILimeSDRStreaming::Streamer::SetupStream(size_t& streamID, const StreamConfi
     if(config.isTx)
         mTxStreams.push_back(stream);
     else
+    {
         mRxStreams.push_back(stream);
+        if (config.decodeWorkers > rxDecodeWorkers)
+            rxDecodeWorkers = config.decodeWorkers;
+    }
     streamID = size_t(stream);
     LMS7002M lms;
     lms.SetConnection(dataPort, mChipID);
@@ -495,6 +512,45 @@ void ILimeSDRStreaming::Streamer::SetHardwareTimestamp(const uint64_t now)
     mTimestampOffset = now - rxLastTimestamp.load();
 }
 
+void ILimeSDRStreaming::Streamer::PushRxSamples(const uint64_t timestamp, complex16_t* const* samples, const int count)
+{
+    for(size_t ch=0; ch<mRxStreams.size(); ++ch)
+    {
+        IStreamChannel::Metadata meta;
+        meta.timestamp = timestamp;
+        meta.flags = RingFIFO::OVERWRITE_OLD;
+        int samplesPushed = mRxStreams[ch]->Write((const void*)samples[ch], count, &meta, 100);
+        if(samplesPushed != count)
+            mRxStreams[ch]->overflow++;
+    }
+}
+
+std::unique_ptr<RxDecodePipeline> ILimeSDRStreaming::Streamer::CreateRxDecoder(const size_t maxBlockBytes)
+{
+    rxDecodeQueue = 0;
+    rxReorderQueue = 0;
+    if (rxDecodeWorkers == 0 or mRxStreams.empty())
+        return nullptr;
+    const bool packed = mRxStreams[0]->config.linkFormat == StreamConfig::STREAM_12_BIT_COMPRESSED;
+    std::unique_ptr<RxDecodePipeline> decoder(new RxDecodePipeline(
+        std::bind(&Streamer::PushRxSamples, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+        mRxStreams.size(), packed, rxDecodeWorkers, maxBlockBytes));
+    decoder->Start();
+    return decoder;
+}
+
+void ILimeSDRStreaming::Streamer::SubmitRxPackets(RxDecodePipeline* decoder, const FPGA_DataPacket* packets, const size_t count)
+{
+    if (count == 0)
+        return;
+    if (not decoder->Submit(packets, count))
+        for(auto value: mRxStreams)
+            value->overflow++;
+    RxDecodePipeline::Stats stats = decoder->GetStats();
+    rxDecodeQueue.store(stats.decodeQueue);
+    rxReorderQueue.store(stats.reorderQueue);
+}
+
 int ILimeSDRStreaming::Streamer::UpdateThreads(bool stopAll)
 {
     bool needTx = false;
@@ -10,6 +10,8 @@
 #include "dataTypes.h"
 #include "fifo.h"
 #include "LMS64CProtocol.h"
+#include "RxDecodePipeline.h"
+#include <memory>
 
 namespace lime
 {
@@ -67,8 +69,17 @@ public:
         void SetHardwareTimestamp(const uint64_t now);
         int UpdateThreads(bool stopAll = false);
 
+        //! Writes samples of received packet to RX channels
+        void PushRxSamples(const uint64_t timestamp, complex16_t* const* samples, const int count);
+        //! Creates decode pipeline if workers were requested, nullptr otherwise
+        std::unique_ptr<RxDecodePipeline> CreateRxDecoder(const size_t maxBlockBytes);
+        //! Queues packets to decoder and updates queue metrics
+        void SubmitRxPackets(RxDecodePipeline* decoder, const FPGA_DataPacket* packets, const size_t count);
+
         std::atomic<uint32_t> rxDataRate_Bps;
         std::atomic<uint32_t> txDataRate_Bps;
+        std::atomic<bool> rxZeroCopy;
+        std::atomic<bool> txZeroCopy;
         ILimeSDRStreaming* dataPort;
         std::thread rxThread;
         std::thread txThread;
@@ -85,6 +96,9 @@ public:
         int mChipID;
         unsigned txBatchSize;
         unsigned rxBatchSize;
+        unsigned rxDecodeWorkers;
+        std::atomic<uint32_t> rxDecodeQueue;
+        std::atomic<uint32_t> rxReorderQueue;
     };
 
     ILimeSDRStreaming();
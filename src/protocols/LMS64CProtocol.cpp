@@ -12,8 +12,10 @@
 #include <assert.h>
 #include <math.h>
 #include <algorithm>
+#include <deque>
 #include <iso646.h> // alternative operators for visual c++: not, and, or...
 #include <ADCUnits.h>
+#include "ControlProfiler.h"
 #include <sstream>
 using namespace lime;
 
@@ -213,13 +215,14 @@ int LMS64CProtocol::ReadSi5351I2C(const size_t numBytes, std::string &data)
     GenericPacket pkt;
     pkt.cmd = CMD_SI5351_RD;
 
-    int status = this->TransferPacket(pkt);
-
+    //register addresses to read
     for (size_t i = 0; i < data.size(); i++)
     {
         pkt.outBuffer.push_back(data.at(i));
     }
 
+    int status = this->TransferPacket(pkt);
+
     data.clear();
     for (size_t i = 0; i < pkt.inBuffer.size(); ++i)
     {
@@ -389,6 +392,10 @@ int LMS64CProtocol::TransferPacket(GenericPacket& pkt)
     std::lock_guard<std::mutex> lock(mControlPortLock);
     int status = 0;
     if(IsOpen() == false) ReportError(ENOTCONN, "connection is not open");
+    const bool profile = ControlProfiler::IsEnabled();
+    std::chrono::steady_clock::time_point t1;
+    if (profile)
+        t1 = std::chrono::steady_clock::now();
 
     int packetLen;
     eLMS_PROTOCOL protocol = LMS_PROTOCOL_UNDEFINED;
@@ -467,33 +474,48 @@ int LMS64CProtocol::TransferPacket(GenericPacket& pkt)
     }
     else
     {
-        for(int i=0; i<outLen; i+=packetLen)
+        //next packets are sent before replies of previous ones arrive
+        const int window = std::max(1, GetMaxPacketsInFlight());
+        int inFlight = 0;
+        while (inDataPos < outLen)
         {
-            int bytesToSend = packetLen;
-            if (callback_logData)
-                callback_logData(true, &outBuffer[outBufPos], bytesToSend);
-            if( Write(&outBuffer[outBufPos], bytesToSend) )
+            if (outBufPos < outLen && inFlight < window)
             {
-                outBufPos += packetLen;
-                long readLen = packetLen;
-                int bread = Read(&inBuffer[inDataPos], readLen);
-                if(bread != readLen && protocol != LMS_PROTOCOL_NOVENA)
+                int bytesToSend = packetLen;
+                if (callback_logData)
+                    callback_logData(true, &outBuffer[outBufPos], bytesToSend);
+                if (Write(&outBuffer[outBufPos], bytesToSend) == 0)
                 {
-                    status = ReportError(EIO, "Read(%d bytes) failed", (int)readLen);
+                    status = ReportError(EIO, "Write(%d bytes) failed", (int)bytesToSend);
                     break;
                 }
-                if (callback_logData)
-                    callback_logData(false, &inBuffer[inDataPos], bread);
-                inDataPos += bread;
+                outBufPos += packetLen;
+                ++inFlight;
+                continue;
             }
-            else
+            long readLen = packetLen;
+            int bread = Read(&inBuffer[inDataPos], readLen);
+            if(bread != readLen && protocol != LMS_PROTOCOL_NOVENA)
             {
-                status = ReportError(EIO, "Write(%d bytes) failed", (int)bytesToSend);
+                status = ReportError(EIO, "Read(%d bytes) failed", (int)readLen);
                 break;
             }
+            if (callback_logData)
+                callback_logData(false, &inBuffer[inDataPos], bread);
+            inDataPos += bread;
+            --inFlight;
+        }
+        //collect replies of packets already sent, so they are not taken for replies of next commands
+        if (status != 0)
+        {
+            unsigned char reply[ProtocolNovena::pktLength];
+            for ( ; inFlight > 0; --inFlight)
+                Read(reply, packetLen);
         }
         ParsePacket(pkt, inBuffer, inDataPos, protocol);
     }
+    if (profile)
+        ControlProfiler::RecordTransaction(outLen, inDataPos, std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count());
     delete[] outBuffer;
     delete[] inBuffer;
     return convertStatus(status, pkt);
@@ -706,63 +728,78 @@ int LMS64CProtocol::ProgramWrite(const char *data_src, const size_t length, cons
     ctrbuf[1] = 0;
     ctrbuf[2] = 56;
 
-    for (portionNumber = 0; portionNumber<portionsCount && !abortProgramming; ++portionNumber)
-    {
-        int offset = 8;
-        memset(&ctrbuf[offset], 0, 56);
-        ctrbuf[offset+0] = prog_mode;
-        ctrbuf[offset+1] = (portionNumber >> 24) & 0xFF;
-        ctrbuf[offset+2] = (portionNumber >> 16) & 0xFF;
-        ctrbuf[offset+3] = (portionNumber >> 8) & 0xFF;
-        ctrbuf[offset+4] = portionNumber & 0xFF;
-        unsigned char data_cnt = data_left > pktSize ? pktSize : data_left;
-        ctrbuf[offset+5] = data_cnt;
-        if(cmd == CMD_MEMORY_WR)
-        {
-            ctrbuf[offset+6] = 0;
-            ctrbuf[offset+7] = 0;
-            ctrbuf[offset+8] = 0;
-            ctrbuf[offset+9] = 0;
+    //several packets are kept in flight, acknowledgements are read in order
+    const int window = needsData ? std::max(1, GetMaxPacketsInFlight()) : 1;
+    const int portionsToSend = needsData ? portionsCount : 1; //only one packet is needed to initiate bitstream from flash
+    std::deque<int> inFlight; //data bytes of packets waiting for acknowledgement
 
-            ctrbuf[offset+10] = (device >> 8) & 0xFF;
-            ctrbuf[offset+11] = device & 0xFF;
-        }
-        if(data_src != NULL)
+    for (portionNumber = 0; portionNumber<portionsToSend || !inFlight.empty(); ++portionNumber)
+    {
+        if (portionNumber < portionsToSend && !abortProgramming)
         {
-            memcpy(&ctrbuf[offset + 24], data_src, data_cnt);
-            data_src += data_cnt;
-        }
+            int offset = 8;
+            memset(&ctrbuf[offset], 0, 56);
+            ctrbuf[offset+0] = prog_mode;
+            ctrbuf[offset+1] = (portionNumber >> 24) & 0xFF;
+            ctrbuf[offset+2] = (portionNumber >> 16) & 0xFF;
+            ctrbuf[offset+3] = (portionNumber >> 8) & 0xFF;
+            ctrbuf[offset+4] = portionNumber & 0xFF;
+            unsigned char data_cnt = data_left > pktSize ? pktSize : data_left;
+            ctrbuf[offset+5] = data_cnt;
+            if(cmd == CMD_MEMORY_WR)
+            {
+                ctrbuf[offset+6] = 0;
+                ctrbuf[offset+7] = 0;
+                ctrbuf[offset+8] = 0;
+                ctrbuf[offset+9] = 0;
 
-        if(Write(ctrbuf, sizeof(ctrbuf)) != sizeof(ctrbuf))
-        {
-            if(callback)
-                callback(bytesSent, length, "Programming failed! Write operation failed");
-            return ReportError(EIO, "Programming failed! Write operation failed");
+                ctrbuf[offset+10] = (device >> 8) & 0xFF;
+                ctrbuf[offset+11] = device & 0xFF;
+            }
+            if(data_src != NULL)
+            {
+                memcpy(&ctrbuf[offset + 24], data_src, data_cnt);
+                data_src += data_cnt;
+            }
+
+            if(Write(ctrbuf, sizeof(ctrbuf)) != sizeof(ctrbuf))
+            {
+                if(callback)
+                    callback(bytesSent, length, "Programming failed! Write operation failed");
+                return ReportError(EIO, "Programming failed! Write operation failed");
+            }
+            data_left -= data_cnt;
+            inFlight.push_back(data_cnt);
+            if (int(inFlight.size()) < window && portionNumber+1 < portionsToSend)
+                continue;
         }
+        else if (inFlight.empty())
+            break;
+
         if(Read(inbuf, sizeof(inbuf), progTimeout_ms) != sizeof(ctrbuf))
         {
             if(callback)
                 callback(bytesSent, length, "Programming failed! Read operation failed");
             return ReportError(EIO, "Programming failed! Read operation failed");
         }
-        data_left -= data_cnt;
         status = inbuf[1];
-        bytesSent += data_cnt;
+        bytesSent += inFlight.front();
+        inFlight.pop_front();
 
         if(status != STATUS_COMPLETED_CMD)
         {
+            //collect replies of remaining packets, so they are not taken for replies of next commands
+            for (size_t i = 0; i < inFlight.size(); ++i)
+                Read(inbuf, sizeof(inbuf), progTimeout_ms);
             sprintf(progressMsg, "Programming failed! %s", status2string(status));
             if(callback)
                 abortProgramming = callback(bytesSent, length, progressMsg);
             return ReportError(EPROTO, progressMsg);
         }
-        if(needsData == false) //only one packet is needed to initiate bitstream from flash
-        {
+        if(needsData == false)
             bytesSent = length;
-            break;
-        }
-        if(callback)
-            abortProgramming = callback(bytesSent, length, progressMsg);
+        else if(callback)
+            abortProgramming |= callback(bytesSent, length, progressMsg);
     }
     if (abortProgramming == true)
     {
@@ -178,6 +178,17 @@ public:
 
     virtual int ProgramWrite(const char *buffer, const size_t length, const int programmingMode, const int device, ProgrammingCallback callback = nullptr);
 
+    /*!
+     * Number of packets sent before waiting for reply, used by ProgramWrite
+     * and multi-packet TransferPacket. Transports that deliver requests and
+     * replies in order may return more than 1 to keep the device busy while
+     * replies travel back.
+     */
+    virtual int GetMaxPacketsInFlight(void) const
+    {
+        return 1;
+    }
+
     virtual int CustomParameterRead(const uint8_t *ids, double *values, const size_t count, std::string* units);
     virtual int CustomParameterWrite(const uint8_t *ids, const double *values, const size_t count, const std::string* units);
 
@@ -0,0 +1,179 @@
+/**
+    @file RxDecodePipeline.cpp
+    @author Lime Microsystems
+    @brief Parallel decoding of received FPGA packets
+*/
+
+#include "RxDecodePipeline.h"
+#include "FPGA_common.h"
+#include <cstring>
+#include <ciso646>
+
+using namespace lime;
+
+//maximum samples of one channel in FPGA packet
+static const int maxSamplesInPacket = 1360;
+
+RxDecodePipeline::RxDecodePipeline(const OutputFunction &output, const int channels, const bool compressed, const unsigned workers, const size_t maxBlockBytes, const unsigned slots) :
+    mOutput(output),
+    mChannels(channels),
+    mCompressed(compressed),
+    mWorkersCount(workers == 0 ? 1 : workers),
+    mSlots(slots < 2 ? 2 : slots),
+    mNextSubmit(0),
+    mNextDecode(0),
+    mNextOutput(0),
+    mDone(0),
+    mTerminate(true)
+{
+    const size_t packets = (maxBlockBytes + sizeof(FPGA_DataPacket) - 1) / sizeof(FPGA_DataPacket);
+    for (auto &slot : mSlots)
+    {
+        slot.state = SLOT_FREE;
+        slot.count = 0;
+        slot.packets.resize(packets);
+        slot.samplesCount.resize(packets);
+        slot.samples.resize(channels);
+        for (auto &ch : slot.samples)
+            ch.resize(packets*maxSamplesInPacket);
+    }
+    memset(&mStats, 0, sizeof(mStats));
+}
+
+RxDecodePipeline::~RxDecodePipeline()
+{
+    Stop();
+}
+
+void RxDecodePipeline::Start()
+{
+    Stop();
+    for (auto &slot : mSlots)
+        slot.state = SLOT_FREE;
+    mNextSubmit = mNextDecode = mNextOutput = 0;
+    mDone = 0;
+    memset(&mStats, 0, sizeof(mStats));
+    mTerminate = false;
+    for (unsigned i = 0; i < mWorkersCount; ++i)
+        mWorkers.push_back(std::thread(&RxDecodePipeline::WorkerLoop, this));
+}
+
+void RxDecodePipeline::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mTerminate = true;
+    }
+    mHasWork.notify_all();
+    for (auto &worker : mWorkers)
+        worker.join();
+    mWorkers.clear();
+}
+
+bool RxDecodePipeline::Submit(const FPGA_DataPacket* packets, const size_t count)
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    Slot &slot = mSlots[mNextSubmit % mSlots.size()];
+    if (slot.state != SLOT_FREE or count > slot.packets.size())
+    {
+        ++mStats.dropped;
+        return false;
+    }
+    slot.state = SLOT_QUEUED;
+    lock.unlock();
+
+    //slot is owned by this thread until sequence number is published
+    memcpy(slot.packets.data(), packets, count*sizeof(FPGA_DataPacket));
+    slot.count = count;
+
+    lock.lock();
+    ++mNextSubmit;
+    const unsigned queued = mNextSubmit - mNextDecode;
+    if (queued > mStats.maxDecodeQueue)
+        mStats.maxDecodeQueue = queued;
+    lock.unlock();
+    mHasWork.notify_one();
+    return true;
+}
+
+RxDecodePipeline::Stats RxDecodePipeline::GetStats()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    Stats stats = mStats;
+    stats.decodeQueue = mNextSubmit - mNextDecode;
+    stats.reorderQueue = mDone;
+    return stats;
+}
+
+void RxDecodePipeline::Decode(Slot &slot)
+{
+    std::vector<complex16_t*> dest(mChannels);
+    size_t offset = 0;
+    for (size_t i = 0; i < slot.count; ++i)
+    {
+        for (int ch = 0; ch < mChannels; ++ch)
+            dest[ch] = &slot.samples[ch][offset];
+        const uint8_t* payload = slot.packets[i].data;
+        slot.samplesCount[i] = fpga::FPGAPacketPayload2Samples(payload, sizeof(slot.packets[i].data), mChannels == 2, mCompressed, dest.data());
+        offset += slot.samplesCount[i];
+    }
+}
+
+void RxDecodePipeline::WorkerLoop()
+{
+    std::vector<complex16_t*> src(mChannels);
+    while (true)
+    {
+        Slot* slot;
+        {
+            std::unique_lock<std::mutex> lock(mLock);
+            while (mNextDecode == mNextSubmit and not mTerminate)
+                mHasWork.wait(lock);
+            if (mTerminate)
+                return;
+            slot = &mSlots[mNextDecode % mSlots.size()];
+            slot->state = SLOT_DECODING;
+            ++mNextDecode;
+        }
+
+        Decode(*slot);
+
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            slot->state = SLOT_DONE;
+            ++mDone;
+        }
+
+        //pass all consecutive decoded blocks to output, one thread at a time
+        std::lock_guard<std::mutex> outputLock(mOutputLock);
+        while (true)
+        {
+            Slot* next;
+            {
+                std::lock_guard<std::mutex> lock(mLock);
+                if (mNextOutput == mNextSubmit)
+                    break;
+                next = &mSlots[mNextOutput % mSlots.size()];
+                if (next->state != SLOT_DONE)
+                    break;
+            }
+
+            size_t offset = 0;
+            for (size_t i = 0; i < next->count; ++i)
+            {
+                for (int ch = 0; ch < mChannels; ++ch)
+                    src[ch] = &next->samples[ch][offset];
+                mOutput(next->packets[i].counter, src.data(), next->samplesCount[i]);
+                offset += next->samplesCount[i];
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mLock);
+                next->state = SLOT_FREE;
+                ++mNextOutput;
+                --mDone;
+                ++mStats.blocks;
+            }
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/**
+    @file RxDecodePipeline.h
+    @author Lime Microsystems
+    @brief Parallel decoding of received FPGA packets
+*/
+
+#ifndef LIME_RX_DECODE_PIPELINE_H
+#define LIME_RX_DECODE_PIPELINE_H
+
+#include "LimeSuiteConfig.h"
+#include "dataTypes.h"
+#include <functional>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace lime
+{
+
+/** @brief Moves sample decoding out of the transfer thread.
+
+    The transfer thread copies received blocks of FPGA_DataPacket with
+    Submit() and can resubmit its transfer immediately. Worker threads
+    convert packet payloads to samples, finished blocks are passed to the
+    output function strictly in submission (packet counter) order.
+*/
+class LIME_API RxDecodePipeline
+{
+public:
+    /** @brief Receives samples of one packet, called in packet order
+        @param timestamp packet counter
+        @param samples decoded samples of each channel
+        @param count number of samples per channel
+    */
+    typedef std::function<void(const uint64_t timestamp, complex16_t* const* samples, const int count)> OutputFunction;
+
+    //! Queue depth metrics
+    struct Stats
+    {
+        unsigned decodeQueue;       //!< blocks waiting for a worker
+        unsigned reorderQueue;      //!< decoded blocks waiting for earlier blocks
+        unsigned maxDecodeQueue;    //!< highest decodeQueue since Start()
+        uint64_t blocks;            //!< blocks passed to output
+        unsigned dropped;           //!< blocks dropped because all slots were busy
+    };
+
+    /** @param output function receiving decoded samples
+        @param channels number of channels in packets
+        @param compressed packets contain 12 bit compressed samples
+        @param workers number of decoding threads
+        @param maxBlockBytes largest block passed to Submit()
+        @param slots number of blocks that can be queued
+    */
+    RxDecodePipeline(const OutputFunction &output, const int channels, const bool compressed, const unsigned workers, const size_t maxBlockBytes, const unsigned slots = 32);
+    ~RxDecodePipeline();
+
+    void Start();
+    //! Stops workers, queued blocks are discarded
+    void Stop();
+
+    /** @brief Copies block of packets for decoding, never blocks
+        @return false if block was dropped because queue is full
+    */
+    bool Submit(const FPGA_DataPacket* packets, const size_t count);
+
+    Stats GetStats();
+
+private:
+    enum SlotState
+    {
+        SLOT_FREE,
+        SLOT_QUEUED,
+        SLOT_DECODING,
+        SLOT_DONE,
+    };
+
+    struct Slot
+    {
+        SlotState state;
+        std::vector<FPGA_DataPacket> packets;
+        size_t count;
+        std::vector<std::vector<complex16_t>> samples;  //!< per channel, all packets of block
+        std::vector<int> samplesCount;                  //!< per packet
+    };
+
+    void WorkerLoop();
+    void Decode(Slot &slot);
+
+    OutputFunction mOutput;
+    const int mChannels;
+    const bool mCompressed;
+    const unsigned mWorkersCount;
+    std::vector<Slot> mSlots;
+    uint64_t mNextSubmit;           //!< sequence number of next submitted block
+    uint64_t mNextDecode;           //!< next block to give to a worker
+    uint64_t mNextOutput;           //!< next block to pass to output
+    unsigned mDone;                 //!< decoded blocks not yet passed to output
+    bool mTerminate;
+    Stats mStats;
+    std::mutex mLock;
+    std::mutex mOutputLock;
+    std::condition_variable mHasWork;
+    std::vector<std::thread> mWorkers;
+};
+
+}
+#endif
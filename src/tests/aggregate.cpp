@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+#include "ConnectionAggregate.h"
+#include "dataTypes.h"
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+using namespace std;
+using namespace lime;
+
+/** @brief Connection producing samples of common signal without hardware.
+    Sample value is the host time in samples, so time aligned channels of all
+    devices must contain equal values. Like hardware, stream timestamps are raw
+    counter values, SetHardwareTimestamp() offset is not applied to them.
+*/
+class EmulatedConnection : public IConnection
+{
+public:
+    EmulatedConnection(const double rate, const int64_t counterOffset) :
+        mRate(rate), mCounterOffset(counterOffset), mTimestampOffset(0)
+    {
+        mStart = chrono::high_resolution_clock::now();
+    }
+
+    int WriteLMS7002MSPI(const uint32_t *writeData, size_t size, unsigned periphID) override {return 0;}
+    int ReadLMS7002MSPI(const uint32_t *writeData, uint32_t *readData, size_t size, unsigned periphID) override {return 0;}
+    int ProgramMCU(const uint8_t *buffer, const size_t length, const MCU_PROG_MODE mode, ProgrammingCallback callback) override {return 0;}
+    bool IsOpen(void) override {return true;}
+
+    uint64_t GetHardwareTimestamp(void) override {return RawCounter() + mTimestampOffset;}
+    void SetHardwareTimestamp(const uint64_t now) override {mTimestampOffset = now - RawCounter();}
+    double GetHardwareTimestampRate(void) override {return mRate;}
+
+    int SetupStream(size_t &streamID, const StreamConfig &config) override
+    {
+        mNext.push_back(0);
+        streamID = mNext.size();
+        return 0;
+    }
+    int CloseStream(const size_t streamID) override {return 0;}
+    int ControlStream(const size_t streamID, const bool enable) override
+    {
+        mNext[streamID-1] = RawCounter();
+        return 0;
+    }
+
+    int ReadStream(const size_t streamID, void* buffer, const size_t length, const long timeout_ms, StreamMetadata &metadata) override
+    {
+        uint64_t &next = mNext[streamID-1];
+        while (RawCounter() < next + length)
+            this_thread::sleep_for(chrono::microseconds(200));
+        complex16_t* samples = (complex16_t*)buffer;
+        for (size_t i = 0; i < length; ++i)
+        {
+            const int64_t t = next + i - mCounterOffset;
+            samples[i].i = t & 0x7FFF;
+            samples[i].q = (t >> 15) & 0x7FFF;
+        }
+        metadata.timestamp = next;
+        metadata.hasTimestamp = true;
+        next += length;
+        return length;
+    }
+
+private:
+    uint64_t RawCounter()
+    {
+        const double elapsed = chrono::duration<double>(chrono::high_resolution_clock::now() - mStart).count();
+        return uint64_t(elapsed*mRate) + mCounterOffset;
+    }
+
+    double mRate;
+    int64_t mCounterOffset;
+    atomic<int64_t> mTimestampOffset;
+    chrono::high_resolution_clock::time_point mStart;
+    vector<uint64_t> mNext;
+};
+
+static int64_t SampleTime(const complex16_t &s)
+{
+    return int64_t(s.q) << 15 | s.i;
+}
+
+TEST(ConnectionAggregate, alignsEmulatedDevices)
+{
+    const double rate = 1e6;
+    EmulatedConnection dev0(rate, 1000000);
+    EmulatedConnection dev1(rate, 37);
+    EmulatedConnection dev2(rate, 5000000);
+
+    ConnectionAggregate aggregate;
+    ASSERT_EQ(0, aggregate.Attach({&dev0, &dev1, &dev2}));
+    ASSERT_EQ(0, aggregate.SetupStreams(2, StreamConfig::STREAM_12_BIT_IN_16, 1000));
+    ASSERT_EQ(6u, aggregate.GetChannelsCount());
+    ASSERT_EQ(0, aggregate.Start());
+
+    //host based measurement of counter offsets should be within a few milliseconds
+    auto align = aggregate.GetAlignInfo();
+    ASSERT_EQ(3u, align.offset.size());
+    EXPECT_LT(llabs(align.offset[1] - align.offset[0] - (1000000-37)), int64_t(rate/100));
+    EXPECT_LT(llabs(align.offset[2] - align.offset[0] - (1000000-5000000)), int64_t(rate/100));
+
+    const size_t count = 2500;
+    vector<vector<complex16_t>> buffers(6, vector<complex16_t>(count));
+    vector<complex16_t*> ptrs;
+    for (auto &buf : buffers)
+        ptrs.push_back(buf.data());
+
+    //devices differ only by constant residual error of offset measurement
+    const int64_t tolerance = rate/100;
+    int64_t residual1 = 0;
+    int64_t residual2 = 0;
+    uint64_t lastTimestamp = 0;
+    for (int n = 0; n < 20; ++n)
+    {
+        uint64_t timestamp = 0;
+        int ret = aggregate.Read(ptrs.data(), count, timestamp, 1000);
+        ASSERT_GT(ret, 0);
+        EXPECT_GE(timestamp, align.timestamp);
+        if (n > 0)
+        {
+            EXPECT_EQ(lastTimestamp, timestamp);
+        }
+        lastTimestamp = timestamp + ret;
+        if (n == 0)
+        {
+            residual1 = SampleTime(buffers[2][0]) - SampleTime(buffers[0][0]);
+            residual2 = SampleTime(buffers[4][0]) - SampleTime(buffers[0][0]);
+            EXPECT_LT(llabs(residual1), tolerance);
+            EXPECT_LT(llabs(residual2), tolerance);
+        }
+
+        for (int i = 0; i < ret; ++i)
+        {
+            //channels of one device are sample exact
+            EXPECT_EQ(SampleTime(buffers[0][i]), SampleTime(buffers[1][i]));
+            EXPECT_EQ(SampleTime(buffers[2][i]), SampleTime(buffers[3][i]));
+            EXPECT_EQ(SampleTime(buffers[4][i]), SampleTime(buffers[5][i]));
+            EXPECT_EQ(residual1, SampleTime(buffers[2][i]) - SampleTime(buffers[0][i]));
+            EXPECT_EQ(residual2, SampleTime(buffers[4][i]) - SampleTime(buffers[0][i]));
+        }
+    }
+    aggregate.Stop();
+
+    auto stats = aggregate.GetStats();
+    ASSERT_EQ(6u, stats.size());
+    for (auto &s : stats)
+        EXPECT_EQ(0u, s.overruns);
+}
@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+#include "AsyncBlockIO.h"
+#include <chrono>
+#include <thread>
+#include <ctime>
+#ifdef __unix__
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+using namespace std;
+using namespace lime;
+
+#ifdef __unix__
+//! Non-blocking pipe standing in for device stream node
+class NonBlockingPipe
+{
+public:
+    NonBlockingPipe()
+    {
+        if (pipe(fds) != 0)
+            fds[0] = fds[1] = -1;
+        for (int fd : fds)
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+    ~NonBlockingPipe()
+    {
+        CloseWrite();
+        if (fds[0] >= 0) close(fds[0]);
+    }
+    void CloseWrite()
+    {
+        if (fds[1] >= 0) close(fds[1]);
+        fds[1] = -1;
+    }
+    int ReadFd() const {return fds[0];}
+    int WriteFd() const {return fds[1];}
+private:
+    int fds[2];
+};
+
+TEST(AsyncBlockIO, pollReadWaitsWithoutSpinning)
+{
+    NonBlockingPipe p;
+    ASSERT_GE(p.ReadFd(), 0);
+    char buffer[16];
+    const clock_t cpu0 = clock();
+    auto t0 = chrono::steady_clock::now();
+    EXPECT_EQ(0, PollRead(p.ReadFd(), buffer, sizeof(buffer), 200));
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - t0).count();
+    const double cpuSeconds = double(clock() - cpu0) / CLOCKS_PER_SEC;
+    EXPECT_GE(elapsed, 190);
+    EXPECT_LT(cpuSeconds, 0.05);
+
+    ASSERT_EQ(4, write(p.WriteFd(), "abcd", 4));
+    EXPECT_EQ(4, PollRead(p.ReadFd(), buffer, sizeof(buffer), 50));
+    p.CloseWrite();
+    EXPECT_EQ(-1, PollRead(p.ReadFd(), buffer, sizeof(buffer), 50));
+}
+
+TEST(AsyncBlockIO, readerDeliversFullBlocksInOrder)
+{
+    NonBlockingPipe p;
+    const int blockSize = 4096;
+    const int blocks = 64;
+    thread producer([&p]()
+    {
+        //device delivers data in uneven chunks
+        vector<char> data(blockSize*blocks);
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = char(i * 7);
+        size_t sent = 0;
+        size_t chunk = 1000;
+        while (sent < data.size())
+        {
+            size_t n = min(chunk, data.size() - sent);
+            int ret = PollWrite(p.WriteFd(), &data[sent], n, 1000);
+            if (ret <= 0)
+                break;
+            sent += ret;
+            chunk = chunk % 3000 + 777;
+            if (sent % 5 == 0)
+                this_thread::sleep_for(chrono::microseconds(500));
+        }
+    });
+
+    AsyncBlockReader reader([&p](char* buffer, int length, int timeout_ms)
+    {
+        return PollRead(p.ReadFd(), buffer, length, timeout_ms);
+    }, blockSize, 3);
+    reader.Start();
+    size_t offset = 0;
+    for (int b = 0; b < blocks; ++b)
+    {
+        const char* data = nullptr;
+        ASSERT_EQ(blockSize, reader.Acquire(data, 1000));
+        for (int i = 0; i < blockSize; ++i, ++offset)
+            ASSERT_EQ(char(offset * 7), data[i]);
+        reader.Release();
+    }
+    producer.join();
+    const char* data = nullptr;
+    EXPECT_EQ(0, reader.Acquire(data, 50));
+    reader.Stop();
+    EXPECT_EQ(uint64_t(blockSize*blocks), reader.GetBytesTransferred());
+}
+
+TEST(AsyncBlockIO, writerOverlapsFillingAndWriting)
+{
+    NonBlockingPipe p;
+    const int blockSize = 8192;
+    const int blocks = 32;
+    vector<char> received;
+    thread consumer([&p, &received]()
+    {
+        vector<char> buffer(blockSize);
+        while (received.size() < size_t(blockSize*blocks))
+        {
+            int ret = PollRead(p.ReadFd(), buffer.data(), buffer.size(), 1000);
+            if (ret <= 0)
+                break;
+            received.insert(received.end(), buffer.begin(), buffer.begin() + ret);
+        }
+    });
+
+    AsyncBlockWriter writer([&p](const char* buffer, int length, int timeout_ms)
+    {
+        return PollWrite(p.WriteFd(), buffer, length, timeout_ms);
+    }, blockSize, 3);
+    writer.Start();
+    for (int b = 0; b < blocks; ++b)
+    {
+        char* block = writer.Acquire(1000);
+        ASSERT_NE(nullptr, block);
+        for (int i = 0; i < blockSize; ++i)
+            block[i] = char(b + i);
+        writer.Commit(blockSize);
+    }
+    consumer.join();
+    writer.Stop();
+
+    ASSERT_EQ(size_t(blockSize*blocks), received.size());
+    for (int b = 0; b < blocks; ++b)
+        for (int i = 0; i < blockSize; ++i)
+            ASSERT_EQ(char(b + i), received[b*blockSize + i]);
+    EXPECT_EQ(0u, writer.GetFailedWrites());
+    EXPECT_EQ(uint64_t(blockSize*blocks), writer.GetBytesTransferred());
+}
+#endif
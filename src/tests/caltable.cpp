@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+#include "CalibrationTable.h"
+using namespace lime;
+
+static CalibrationTable::Entry MakeEntry(int value)
+{
+    CalibrationTable::Entry entry;
+    entry.dcI = value;
+    entry.dcQ = -value;
+    entry.gainI = 2047 - value;
+    entry.gainQ = 2047;
+    entry.phaseOffset = value/2;
+    return entry;
+}
+
+TEST(CalibrationTable, ExactAndInterpolated)
+{
+    CalibrationTable table;
+    table.Insert(100e6, 0, false, 1, MakeEntry(10));
+    table.Insert(110e6, 0, false, 1, MakeEntry(20));
+    EXPECT_EQ(2u, table.Size());
+
+    CalibrationTable::Entry result;
+    ASSERT_TRUE(table.Lookup(100e6, 0, false, 1, result));
+    EXPECT_EQ(10, result.dcI);
+    EXPECT_EQ(-10, result.dcQ);
+    EXPECT_EQ(5, result.phaseOffset);
+
+    ASSERT_TRUE(table.Lookup(105e6, 0, false, 1, result));
+    EXPECT_EQ(15, result.dcI);
+    EXPECT_EQ(-15, result.dcQ);
+    EXPECT_EQ(2032, result.gainI);
+    EXPECT_EQ(2047, result.gainQ);
+}
+
+TEST(CalibrationTable, NearestWithinDistance)
+{
+    CalibrationTable table;
+    table.Insert(100e6, 1, true, 2, MakeEntry(30));
+
+    CalibrationTable::Entry result;
+    ASSERT_TRUE(table.Lookup(95e6, 1, true, 2, result));
+    EXPECT_EQ(30, result.dcI);
+    ASSERT_TRUE(table.Lookup(108e6, 1, true, 2, result));
+    EXPECT_EQ(30, result.dcI);
+    EXPECT_FALSE(table.Lookup(120e6, 1, true, 2, result));
+    EXPECT_TRUE(table.Lookup(120e6, 1, true, 2, result, 30e6));
+
+    //neighbour too far away is not interpolated with
+    table.Insert(200e6, 1, true, 2, MakeEntry(90));
+    ASSERT_TRUE(table.Lookup(102e6, 1, true, 2, result));
+    EXPECT_EQ(30, result.dcI);
+}
+
+TEST(CalibrationTable, KeysAreSeparate)
+{
+    CalibrationTable table;
+    table.Insert(100e6, 0, true, 1, MakeEntry(1));
+    CalibrationTable::Entry result;
+    EXPECT_FALSE(table.Lookup(100e6, 1, true, 1, result));
+    EXPECT_FALSE(table.Lookup(100e6, 0, false, 1, result));
+    EXPECT_FALSE(table.Lookup(100e6, 0, true, 2, result));
+    table.Clear();
+    EXPECT_EQ(0u, table.Size());
+    EXPECT_FALSE(table.Lookup(100e6, 0, true, 1, result));
+}
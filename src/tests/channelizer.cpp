@@ -0,0 +1,307 @@
+#include "gtest/gtest.h"
+#include "StreamDSP.h"
+#include "lime/LimeSuite.h"
+#include <cmath>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+using namespace lime;
+
+static vector<complex32f_t> Tone(const double freq, const size_t count, const float amplitude = 0.5f)
+{
+    vector<complex32f_t> samples(count);
+    for (size_t n = 0; n < count; ++n)
+    {
+        const double angle = 2*M_PI*fmod(freq*n, 1.0);
+        samples[n].i = amplitude*cos(angle);
+        samples[n].q = amplitude*sin(angle);
+    }
+    return samples;
+}
+
+static double Power(const complex32f_t* samples, const size_t count)
+{
+    double sum = 0;
+    for (size_t n = 0; n < count; ++n)
+        sum += samples[n].i*samples[n].i + samples[n].q*samples[n].q;
+    return sum/count;
+}
+
+/** @brief Receive stream generating complex tone, I16 format.
+    Samples are produced as fast as they are read.
+*/
+class ToneSource : public IStreamChannel
+{
+public:
+    ToneSource(const double freq) : freq(freq), position(0), running(false) {}
+    int Start() override {running = true; return 0;}
+    int Stop() override {running = false; return 0;}
+    int Read(void* samples, const uint32_t count, Metadata* metadata, const int32_t timeout_ms) override
+    {
+        if (not running)
+        {
+            this_thread::sleep_for(chrono::milliseconds(1));
+            return 0;
+        }
+        int16_t* dst = (int16_t*)samples;
+        for (uint32_t n = 0; n < count; ++n)
+        {
+            const double angle = 2*M_PI*fmod(freq*(position+n), 1.0);
+            dst[2*n] = int16_t(16000*cos(angle));
+            dst[2*n+1] = int16_t(16000*sin(angle));
+        }
+        metadata->timestamp = position;
+        position += count;
+        return count;
+    }
+    int Write(const void* samples, const uint32_t count, const Metadata* metadata, const int32_t timeout_ms) override {return -1;}
+    Info GetInfo() override {Info info; memset(&info, 0, sizeof(info)); return info;}
+
+    const double freq;
+    uint64_t position;
+    atomic<bool> running;
+};
+
+TEST(StreamDSP, MixerShiftsTone)
+{
+    const size_t count = 5000;
+    auto samples = Tone(0.1, count);
+    NCOMixer mixer(-0.1);
+    //odd block sizes check phase continuity
+    mixer.Process(samples.data(), samples.data(), 333);
+    mixer.Process(&samples[333], &samples[333], count-333);
+    for (size_t n = 0; n < count; n += 97)
+    {
+        EXPECT_NEAR(0.5f, samples[n].i, 1e-4);
+        EXPECT_NEAR(0.0f, samples[n].q, 1e-4);
+    }
+}
+
+TEST(StreamDSP, DecimationChainPassesBaseband)
+{
+    StreamDSP::Config config;
+    config.sampleRate = 1e6;
+    config.decimation = 16;
+    config.format = StreamConfig::STREAM_COMPLEX_FLOAT32;
+    StreamDSP dsp(nullptr, config);
+    ASSERT_EQ(1u, dsp.GetChannelsCount());
+    EXPECT_DOUBLE_EQ(62500, dsp.GetChannelRate());
+    IStreamChannel* channel = dsp.GetChannel(0);
+    ASSERT_EQ(0, channel->Start());
+
+    //in band tone passes, tone above output Nyquist is rejected
+    const size_t count = 160000;
+    auto inBand = Tone(2000/1e6, count);
+    dsp.Process(inBand.data(), count, 0);
+    vector<complex32f_t> out(count/16);
+    IStreamChannel::Metadata meta;
+    int received = channel->Read(out.data(), out.size(), &meta, 0);
+    EXPECT_GE(received, int(count/16) - 2);
+    EXPECT_EQ(0u, meta.timestamp);
+    EXPECT_NEAR(0.25, Power(&out[100], received-100), 0.01);
+
+    auto outBand = Tone(100e3/1e6, count);
+    dsp.Process(outBand.data(), count, count);
+    received = channel->Read(out.data(), out.size(), &meta, 0);
+    EXPECT_GE(meta.timestamp, uint64_t(count-32));
+    EXPECT_LT(Power(&out[100], received-100), 0.25*1e-4);
+}
+
+TEST(StreamDSP, DecimationLimitedByCIC)
+{
+    //CIC factor left after half-bands must not exceed 1024
+    EXPECT_FALSE(StreamDSP::IsValidDecimation(0));
+    EXPECT_TRUE(StreamDSP::IsValidDecimation(1));
+    EXPECT_TRUE(StreamDSP::IsValidDecimation(1023));
+    EXPECT_TRUE(StreamDSP::IsValidDecimation(1024));
+    EXPECT_FALSE(StreamDSP::IsValidDecimation(1025));
+    EXPECT_TRUE(StreamDSP::IsValidDecimation(2046));
+    EXPECT_TRUE(StreamDSP::IsValidDecimation(2048));
+    EXPECT_FALSE(StreamDSP::IsValidDecimation(2050));
+    EXPECT_FALSE(StreamDSP::IsValidDecimation(4095));
+    EXPECT_TRUE(StreamDSP::IsValidDecimation(4092));
+    EXPECT_TRUE(StreamDSP::IsValidDecimation(4096));
+    EXPECT_FALSE(StreamDSP::IsValidDecimation(4100));
+    for (unsigned decimation = 1; decimation <= 4096; decimation *= 2)
+        EXPECT_TRUE(StreamDSP::IsValidDecimation(decimation));
+
+    //largest CIC factor keeps DC gain
+    StreamDSP::Config config;
+    config.decimation = 4096;
+    config.format = StreamConfig::STREAM_COMPLEX_FLOAT32;
+    StreamDSP dsp(nullptr, config);
+    IStreamChannel* channel = dsp.GetChannel(0);
+    ASSERT_EQ(0, channel->Start());
+    vector<complex32f_t> in(4096*40);
+    for (auto &x : in)
+    {
+        x.i = 0.9;
+        x.q = -0.9;
+    }
+    dsp.Process(in.data(), in.size(), 0);
+    vector<complex32f_t> out(40);
+    IStreamChannel::Metadata meta;
+    const int received = channel->Read(out.data(), out.size(), &meta, 0);
+    ASSERT_GE(received, 30);
+    EXPECT_NEAR(0.9, out[received-1].i, 1e-3);
+    EXPECT_NEAR(-0.9, out[received-1].q, 1e-3);
+}
+
+static double ToneFrequency(const vector<complex32f_t> &samples, const size_t from, const size_t to)
+{
+    //average phase step, cycles per sample
+    double sum = 0;
+    for (size_t n = from; n < to; ++n)
+    {
+        const complex32f_t x0 = samples[n];
+        const complex32f_t x1 = samples[n+1];
+        sum += atan2(x1.q*x0.i - x1.i*x0.q, x1.i*x0.i + x1.q*x0.q);
+    }
+    return sum/(to-from)/(2*M_PI);
+}
+
+TEST(StreamDSP, ResamplerKeepsToneFrequency)
+{
+    const size_t count = 50000;
+    const double ratios[] = {0.75, 1.6, 0.5123};
+    for (double ratio : ratios)
+    {
+        PolyphaseResampler resampler(ratio);
+        auto in = Tone(0.05, count);
+        vector<complex32f_t> out(size_t(count*ratio) + 2);
+        //uneven blocks
+        size_t produced = resampler.Process(in.data(), 777, out.data());
+        produced += resampler.Process(&in[777], count-777, &out[produced]);
+        EXPECT_NEAR(count*ratio, produced, 2) << "ratio " << ratio;
+        EXPECT_NEAR(0.05/ratio, ToneFrequency(out, 100, produced-1), 1e-6) << "ratio " << ratio;
+        EXPECT_NEAR(0.25, Power(&out[100], produced-100), 0.0025) << "ratio " << ratio;
+    }
+}
+
+TEST(StreamDSP, ResamplerRejectsAliases)
+{
+    //tone above output Nyquist must not fold into output band
+    const size_t count = 50000;
+    PolyphaseResampler resampler(0.6);
+    auto in = Tone(0.4, count);
+    vector<complex32f_t> out(count);
+    const size_t produced = resampler.Process(in.data(), count, out.data());
+    EXPECT_LT(Power(&out[100], produced-100), 0.25*1e-4);
+}
+
+TEST(StreamDSP, OutputRateOffHardwareGrid)
+{
+    StreamDSP::Config config;
+    config.sampleRate = 1e6;
+    config.outputRate = 300e3;
+    config.decimation = StreamDSP::SelectDecimation(config.sampleRate, config.outputRate);
+    EXPECT_EQ(2u, config.decimation);
+    EXPECT_EQ(8u, StreamDSP::SelectDecimation(30.72e6, 1e6, 3));
+    config.format = StreamConfig::STREAM_COMPLEX_FLOAT32;
+    StreamDSP dsp(nullptr, config);
+    EXPECT_DOUBLE_EQ(300e3, dsp.GetChannelRate());
+    IStreamChannel* channel = dsp.GetChannel(0);
+    ASSERT_EQ(0, channel->Start());
+
+    const size_t count = 100000;
+    auto in = Tone(30e3/1e6, count);
+    dsp.Process(in.data(), count, 1000);
+    vector<complex32f_t> out(count);
+    IStreamChannel::Metadata meta;
+    const int received = channel->Read(out.data(), count, &meta, 0);
+    EXPECT_NEAR(count*0.3, received, 4);
+    EXPECT_EQ(1000u, meta.timestamp);
+    EXPECT_NEAR(0.1, ToneFrequency(out, 100, received-1), 1e-6);
+    //timestamp after last sample
+    EXPECT_EQ(uint64_t(llround(1000 + received/0.3)), channel->GetInfo().timestamp);
+}
+
+TEST(StreamDSP, ChannelizerSeparatesTones)
+{
+    const int channels = 8;
+    PolyphaseChannelizer channelizer(channels);
+    //tones in channels 2 and -1 (index 7), offset from channel centers
+    const size_t count = 64000;
+    auto a = Tone(2.0/channels + 0.002, count);
+    auto b = Tone(-1.0/channels - 0.004, count, 0.25f);
+    for (size_t n = 0; n < count; ++n)
+    {
+        a[n].i += b[n].i;
+        a[n].q += b[n].q;
+    }
+    vector<vector<complex32f_t>> outs(channels, vector<complex32f_t>(count/channels+1));
+    vector<complex32f_t*> ptrs;
+    for (auto &out : outs)
+        ptrs.push_back(out.data());
+    const size_t produced = channelizer.Process(a.data(), count, ptrs.data());
+    ASSERT_EQ(count/channels, produced);
+
+    for (int k = 0; k < channels; ++k)
+    {
+        const double power = Power(&outs[k][100], produced-100);
+        if (k == 2)
+            EXPECT_NEAR(0.25, power, 0.01);
+        else if (k == 7)
+            EXPECT_NEAR(0.0625, power, 0.005);
+        else
+            EXPECT_LT(power, 0.25*1e-4) << "channel " << k;
+    }
+    //residual frequency of channel 2 is 0.002*channels cycles per output sample
+    const complex32f_t x0 = outs[2][1000];
+    const complex32f_t x1 = outs[2][1001];
+    const double angle = atan2(x1.q*x0.i - x1.i*x0.q, x1.i*x0.i + x1.q*x0.q);
+    EXPECT_NEAR(2*M_PI*0.002*channels, angle, 1e-3);
+}
+
+TEST(StreamDSP, SubStreamsReadByRecvStream)
+{
+    const double rate = 4e6;
+    ToneSource source(600e3/rate);
+    StreamDSP::Config config;
+    config.sampleRate = rate;
+    config.ncoFrequency = 100e3;
+    config.decimation = 2;
+    config.channels = 4;
+    StreamDSP dsp(&source, config);
+    //channels 500 kHz wide: 100k, 600k, -900k/1100k, -400k
+    EXPECT_DOUBLE_EQ(600e3, dsp.GetChannelFrequency(1));
+    EXPECT_DOUBLE_EQ(-400e3, dsp.GetChannelFrequency(3));
+
+    lms_stream_t streams[2];
+    streams[0].handle = size_t(dsp.GetChannel(1));
+    streams[1].handle = size_t(dsp.GetChannel(0));
+    ASSERT_EQ(0, LMS_StartStream(&streams[0]));
+    ASSERT_EQ(0, LMS_StartStream(&streams[1]));
+    EXPECT_TRUE(source.running);
+
+    const int count = 20000;
+    vector<int16_t> tone(2*count), other(2*count);
+    lms_stream_meta_t meta;
+    ASSERT_EQ(count, LMS_RecvStream(&streams[0], tone.data(), count, &meta, 1000));
+    const uint64_t firstTimestamp = meta.timestamp;
+    ASSERT_EQ(count, LMS_RecvStream(&streams[0], tone.data(), count, &meta, 1000));
+    EXPECT_EQ(firstTimestamp + count*8u, meta.timestamp);
+    ASSERT_EQ(count, LMS_RecvStream(&streams[1], other.data(), count, &meta, 1000));
+
+    lms_stream_status_t status;
+    ASSERT_EQ(0, LMS_GetStreamStatus(&streams[0], &status));
+    EXPECT_TRUE(status.active);
+    EXPECT_DOUBLE_EQ(500e3, status.sampleRate);
+
+    ASSERT_EQ(0, LMS_StopStream(&streams[1]));
+    EXPECT_TRUE(source.running);
+    ASSERT_EQ(0, LMS_StopStream(&streams[0]));
+    EXPECT_FALSE(source.running);
+
+    double tonePower = 0, otherPower = 0;
+    for (int n = 2000; n < 2*count; ++n)
+    {
+        tonePower += double(tone[n])*tone[n];
+        otherPower += double(other[n])*other[n];
+    }
+    EXPECT_GT(tonePower, 1e4*otherPower);
+    EXPECT_NEAR(16000.0*16000, tonePower/(count-1000), 16000.0*16000*0.05);
+}
@@ -0,0 +1,75 @@
+#include "gtest/gtest.h"
+#include "lms7_device.h"
+#include "emulatedRFICs.h"
+#include <chrono>
+#include <thread>
+#include <future>
+using namespace std;
+using namespace lime;
+
+//! Device with two chips on emulated connection
+class TwoChipDevice : public LMS7_Device
+{
+public:
+    TwoChipDevice(IConnection* conn)
+    {
+        _Initialize(conn);
+    }
+    size_t GetNumChannels(const bool tx) const override {return 4;}
+    using LMS7_Device::GetChipLock;
+};
+
+TEST(ChipLock, OtherChipNotBlocked)
+{
+    EmulatedRFICs conn(2, 20);
+    TwoChipDevice device(&conn);
+
+    //long operation, like calibration, holds chip 0
+    unique_lock<recursive_mutex> busy(device.GetChipLock(0));
+
+    auto otherChip = async(launch::async, [&device]{return device.SetGain(false, 2, 30);});
+    ASSERT_EQ(future_status::ready, otherChip.wait_for(chrono::seconds(5)));
+    EXPECT_EQ(0, otherChip.get());
+
+    auto sameChip = async(launch::async, [&device]{return device.SetGain(false, 1, 30);});
+    EXPECT_EQ(future_status::timeout, sameChip.wait_for(chrono::milliseconds(100)));
+    busy.unlock();
+    ASSERT_EQ(future_status::ready, sameChip.wait_for(chrono::seconds(5)));
+    EXPECT_EQ(0, sameChip.get());
+}
+
+TEST(ChipLock, ConcurrentChannelSettings)
+{
+    EmulatedRFICs conn(2, 20);
+    TwoChipDevice device(&conn);
+
+    //gain read back from single thread use
+    vector<int> expected(71);
+    for (unsigned gain = 0; gain < expected.size(); ++gain)
+    {
+        ASSERT_EQ(0, device.SetGain(false, 0, gain));
+        expected[gain] = device.GetGain(false, 0);
+    }
+
+    //every channel is driven by own thread, channels of a chip share MAC
+    const int iterations = 100;
+    vector<future<int>> results;
+    for (size_t chan = 0; chan < device.GetNumChannels(false); ++chan)
+    {
+        results.push_back(async(launch::async, [&device, &expected, chan]
+        {
+            int mismatches = 0;
+            for (int i = 0; i < iterations; ++i)
+            {
+                const unsigned gain = (i*7 + chan*17) % expected.size();
+                if (device.SetGain(false, chan, gain) != 0)
+                    ++mismatches;
+                else if (device.GetGain(false, chan) != expected[gain])
+                    ++mismatches;
+            }
+            return mismatches;
+        }));
+    }
+    for (auto &result : results)
+        EXPECT_EQ(0, result.get());
+}
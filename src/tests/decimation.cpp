@@ -0,0 +1,73 @@
+#include "gtest/gtest.h"
+#include "SeriesDecimation.h"
+#include <cmath>
+#include <vector>
+using namespace std;
+
+static vector<float> Waveform(const size_t count)
+{
+    vector<float> xy(2*count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        xy[2*i] = i;
+        xy[2*i+1] = 1000*sin(i*0.001) + (i*7919 % 101) - 50;
+    }
+    return xy;
+}
+
+TEST(SeriesDecimation, KeepsColumnEnvelope)
+{
+    const size_t count = 100000;
+    const int columns = 640;
+    vector<float> xy = Waveform(count);
+    xy[2*31337+1] = 5000; //single sample spike
+    const double x1 = 1000.5;
+    const double x2 = 90000;
+
+    vector<float> out;
+    const size_t decimated = DecimateMinMax(xy.data(), count, x1, x2, columns, out);
+    ASSERT_GT(decimated, 0u);
+    EXPECT_LE(decimated, size_t(2*columns+2));
+    EXPECT_EQ(2*decimated, out.size());
+
+    //points on both sides of view, X order preserved
+    EXPECT_EQ(1000, out[0]);
+    EXPECT_EQ(90001, out[2*(decimated-1)]);
+    for (size_t i = 1; i < decimated; ++i)
+        EXPECT_LE(out[2*(i-1)], out[2*i]);
+
+    //each column has the same minimum and maximum as all points
+    vector<float> minY(columns, 1e9), maxY(columns, -1e9);
+    for (size_t i = 1001; i <= 90000; ++i)
+    {
+        const int c = min(columns-1, int((xy[2*i]-x1)*columns/(x2-x1)));
+        minY[c] = min(minY[c], xy[2*i+1]);
+        maxY[c] = max(maxY[c], xy[2*i+1]);
+    }
+    vector<float> outMin(columns, 1e9), outMax(columns, -1e9);
+    for (size_t i = 1; i+1 < decimated; ++i)
+    {
+        const int c = min(columns-1, int((out[2*i]-x1)*columns/(x2-x1)));
+        outMin[c] = min(outMin[c], out[2*i+1]);
+        outMax[c] = max(outMax[c], out[2*i+1]);
+    }
+    EXPECT_EQ(minY, outMin);
+    EXPECT_EQ(maxY, outMax);
+}
+
+TEST(SeriesDecimation, DrawsUnchanged)
+{
+    vector<float> out;
+    //fits into columns
+    vector<float> xy = Waveform(1000);
+    EXPECT_EQ(0u, DecimateMinMax(xy.data(), 1000, 0, 1000, 640, out));
+    //X not increasing, like constellation
+    xy = Waveform(10000);
+    xy[2*5000] = -1;
+    EXPECT_EQ(0u, DecimateMinMax(xy.data(), 10000, 0, 10000, 640, out));
+    //zoomed in, only visible points with neighbours
+    xy = Waveform(10000);
+    EXPECT_EQ(13u, DecimateMinMax(xy.data(), 10000, 100, 110, 640, out));
+    EXPECT_EQ(99, out[0]);
+    EXPECT_EQ(111, out[24]);
+}
@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include "RxDecodePipeline.h"
+#include "FPGA_common.h"
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <cstring>
+using namespace std;
+using namespace lime;
+
+static const int samplesInPacket = 510; //mimo, 12 bit in 16
+
+//! Fills packets with samples whose values encode packet counter
+static void FillBlock(vector<FPGA_DataPacket> &packets, uint64_t &counter)
+{
+    vector<complex16_t> a(samplesInPacket), b(samplesInPacket);
+    complex16_t* src[2] = {a.data(), b.data()};
+    for (auto &pkt : packets)
+    {
+        memset(&pkt, 0, sizeof(pkt));
+        for (int i = 0; i < samplesInPacket; ++i)
+        {
+            a[i].i = (counter + i) & 0x7FF;
+            a[i].q = i & 0x7FF;
+            b[i].i = -a[i].i;
+            b[i].q = -a[i].q;
+        }
+        pkt.counter = counter;
+        fpga::Samples2FPGAPacketPayload(src, samplesInPacket, true, false, pkt.data);
+        counter += samplesInPacket;
+    }
+}
+
+TEST(RxDecodePipeline, OutputsInPacketOrder)
+{
+    const int blocks = 200;
+    const int packetsPerBlock = 4;
+    mutex lock;
+    vector<uint64_t> timestamps;
+    bool samplesValid = true;
+    auto output = [&](const uint64_t timestamp, complex16_t* const* samples, const int count)
+    {
+        lock_guard<mutex> guard(lock);
+        timestamps.push_back(timestamp);
+        if (count != samplesInPacket)
+            samplesValid = false;
+        for (int i = 0; i < count; ++i)
+        {
+            if (samples[0][i].i != int16_t((timestamp + i) & 0x7FF) or samples[1][i].q != -int16_t(i & 0x7FF))
+                samplesValid = false;
+        }
+    };
+
+    RxDecodePipeline pipeline(output, 2, false, 4, packetsPerBlock*sizeof(FPGA_DataPacket), blocks);
+    pipeline.Start();
+    vector<FPGA_DataPacket> packets(packetsPerBlock);
+    uint64_t counter = 0;
+    for (int i = 0; i < blocks; ++i)
+    {
+        FillBlock(packets, counter);
+        EXPECT_TRUE(pipeline.Submit(packets.data(), packets.size()));
+    }
+
+    auto t1 = chrono::steady_clock::now();
+    while (pipeline.GetStats().blocks < blocks and chrono::steady_clock::now() - t1 < chrono::seconds(5))
+        this_thread::sleep_for(chrono::milliseconds(1));
+    RxDecodePipeline::Stats stats = pipeline.GetStats();
+    pipeline.Stop();
+
+    EXPECT_EQ(uint64_t(blocks), stats.blocks);
+    EXPECT_EQ(0u, stats.dropped);
+    EXPECT_EQ(0u, stats.decodeQueue);
+    EXPECT_EQ(0u, stats.reorderQueue);
+    EXPECT_GT(stats.maxDecodeQueue, 0u);
+    EXPECT_TRUE(samplesValid);
+    ASSERT_EQ(size_t(blocks*packetsPerBlock), timestamps.size());
+    for (size_t i = 0; i < timestamps.size(); ++i)
+        EXPECT_EQ(i*samplesInPacket, timestamps[i]);
+}
+
+TEST(RxDecodePipeline, DropsWhenQueueFull)
+{
+    const int slots = 4;
+    auto output = [](const uint64_t, complex16_t* const*, const int){};
+    RxDecodePipeline pipeline(output, 2, false, 1, sizeof(FPGA_DataPacket), slots);
+    //not started, nothing is consumed
+    vector<FPGA_DataPacket> packets(1);
+    uint64_t counter = 0;
+    FillBlock(packets, counter);
+    for (int i = 0; i < slots; ++i)
+        EXPECT_TRUE(pipeline.Submit(packets.data(), 1));
+    EXPECT_FALSE(pipeline.Submit(packets.data(), 1));
+    EXPECT_FALSE(pipeline.Submit(packets.data(), 2)); //larger than maxBlockBytes
+    RxDecodePipeline::Stats stats = pipeline.GetStats();
+    EXPECT_EQ(2u, stats.dropped);
+    EXPECT_EQ(unsigned(slots), stats.decodeQueue);
+}
@@ -0,0 +1,78 @@
+#ifndef EMULATED_RFICS_H
+#define EMULATED_RFICS_H
+
+#include "IConnection.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** @brief Connection emulating LMS7002M register space of several chips.
+    Registers from 0x0100 are banked by MAC like in the chip. Transactions
+    can be delayed to make interleaving of threads likely.
+*/
+class EmulatedRFICs : public lime::IConnection
+{
+public:
+    EmulatedRFICs(const int chips = 1, const int delay_us = 0) : mDelay_us(delay_us), mChips(chips) {}
+
+    int ProgramMCU(const uint8_t *buffer, const size_t length, const MCU_PROG_MODE mode, ProgrammingCallback callback) override {return 0;}
+    bool IsOpen(void) override {return true;}
+
+    int WriteLMS7002MSPI(const uint32_t *writeData, size_t size, unsigned periphID) override
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        Delay();
+        auto &regs = mChips.at(periphID).banks;
+        for (size_t i = 0; i < size; ++i)
+        {
+            const uint16_t addr = (writeData[i] >> 16) & 0x7FFF;
+            const uint16_t value = writeData[i] & 0xFFFF;
+            const int mac = regs[0][0x0020] & 0x3;
+            if (addr < 0x0100 or (mac & 0x1))
+                regs[0][addr] = value;
+            if (addr >= 0x0100 and (mac & 0x2))
+                regs[1][addr] = value;
+        }
+        return 0;
+    }
+
+    int ReadLMS7002MSPI(const uint32_t *writeData, uint32_t *readData, size_t size, unsigned periphID) override
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        Delay();
+        auto &regs = mChips.at(periphID).banks;
+        for (size_t i = 0; i < size; ++i)
+        {
+            const uint16_t addr = (writeData[i] >> 16) & 0x7FFF;
+            const int mac = regs[0][0x0020] & 0x3;
+            const int bank = (addr >= 0x0100 and mac == 2) ? 1 : 0;
+            readData[i] = regs[bank][addr];
+        }
+        return 0;
+    }
+
+    //! registers of channel A (bank 0) or B (bank 1), not synchronized with transactions
+    std::map<uint16_t, uint16_t> &Bank(const int bank, const unsigned chip = 0)
+    {
+        return mChips.at(chip).banks[bank];
+    }
+
+private:
+    void Delay(void)
+    {
+        if (mDelay_us > 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(mDelay_us));
+    }
+
+    struct Chip
+    {
+        std::map<uint16_t, uint16_t> banks[2];
+    };
+    const int mDelay_us;
+    std::mutex mLock;
+    std::vector<Chip> mChips;
+};
+
+#endif
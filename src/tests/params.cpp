@@ -0,0 +1,162 @@
+#include "gtest/gtest.h"
+#include "LMS7002M.h"
+#include "LMS7002M_parameters.h"
+#include "emulatedRFICs.h"
+using namespace std;
+using namespace lime;
+
+/** @brief Emulated LMS7002M counting transactions.
+    Write transactions touching NCO frequency registers are counted separately.
+*/
+class CountingRFIC : public EmulatedRFICs
+{
+public:
+    CountingRFIC() : writes(0), reads(0), registersWritten(0), ncoWrites(0) {}
+
+    int WriteLMS7002MSPI(const uint32_t *writeData, size_t size, unsigned periphID) override
+    {
+        ++writes;
+        registersWritten += size;
+        bool nco = false;
+        for (size_t i = 0; i < size; ++i)
+        {
+            const uint16_t addr = (writeData[i] >> 16) & 0x7FFF;
+            nco |= (addr >= 0x0242 and addr <= 0x0261) or (addr >= 0x0442 and addr <= 0x0461);
+        }
+        ncoWrites += nco;
+        return EmulatedRFICs::WriteLMS7002MSPI(writeData, size, periphID);
+    }
+
+    int ReadLMS7002MSPI(const uint32_t *writeData, uint32_t *readData, size_t size, unsigned periphID) override
+    {
+        ++reads;
+        return EmulatedRFICs::ReadLMS7002MSPI(writeData, readData, size, periphID);
+    }
+
+    int writes;
+    int reads;
+    size_t registersWritten;
+    int ncoWrites;
+};
+
+TEST(LMS7002M, ModifyParamsMergesRegisters)
+{
+    CountingRFIC conn;
+    LMS7002M chip;
+    chip.SetConnection(&conn, 0);
+    chip.Modify_SPI_Reg_bits(LMS7param(MAC), 1);
+
+    //G_LNA_RFE and G_TIA_RFE are in 0x0113, G_PGA_RBB in 0x0119
+    const LMS7Parameter params[] = {LMS7param(G_LNA_RFE), LMS7param(G_TIA_RFE), LMS7param(G_PGA_RBB)};
+    const uint16_t values[] = {10, 2, 17};
+    conn.writes = 0;
+    conn.registersWritten = 0;
+    ASSERT_EQ(0, chip.Modify_SPI_Reg_bits_batch(params, values, 3));
+    EXPECT_EQ(1, conn.writes);
+    EXPECT_EQ(2u, conn.registersWritten);
+
+    uint16_t readback[3] = {0};
+    conn.reads = 0;
+    ASSERT_EQ(0, chip.Get_SPI_Reg_bits_batch(params, readback, 3, true));
+    EXPECT_EQ(1, conn.reads);
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(values[i], readback[i]);
+        EXPECT_EQ(values[i], chip.Get_SPI_Reg_bits(params[i], true));
+    }
+}
+
+TEST(LMS7002M, ModifyParamsFollowsMAC)
+{
+    CountingRFIC conn;
+    LMS7002M chip;
+    chip.SetConnection(&conn, 0);
+
+    const LMS7Parameter params[] = {LMS7param(MAC), LMS7param(G_PGA_RBB), LMS7param(MAC), LMS7param(G_PGA_RBB)};
+    const uint16_t values[] = {1, 5, 2, 25};
+    ASSERT_EQ(0, chip.Modify_SPI_Reg_bits_batch(params, values, 4));
+    EXPECT_EQ(5, conn.Bank(0)[LMS7param(G_PGA_RBB).address] & 0x1F);
+    EXPECT_EQ(25, conn.Bank(1)[LMS7param(G_PGA_RBB).address] & 0x1F);
+
+    //register cache follows the same channel selection
+    chip.Modify_SPI_Reg_bits(LMS7param(MAC), 1);
+    EXPECT_EQ(5, chip.Get_SPI_Reg_bits(LMS7param(G_PGA_RBB)));
+    chip.Modify_SPI_Reg_bits(LMS7param(MAC), 2);
+    EXPECT_EQ(25, chip.Get_SPI_Reg_bits(LMS7param(G_PGA_RBB)));
+}
+
+TEST(LMS7002M, NCOFrequenciesSingleTransaction)
+{
+    CountingRFIC conn;
+    LMS7002M chip;
+    chip.SetConnection(&conn, 0);
+    chip.Modify_SPI_Reg_bits(LMS7param(MAC), 1);
+
+    float_type freqs[16];
+    for (int i = 0; i < 16; ++i)
+        freqs[i] = 1e5*(i+1);
+    const float_type pho = 90;
+    conn.writes = 0;
+    conn.registersWritten = 0;
+    ASSERT_EQ(0, chip.SetNCOFrequencies(LMS7002M::Tx, freqs, 16, &pho));
+    EXPECT_EQ(1, conn.writes);
+    EXPECT_EQ(33u, conn.registersWritten);
+
+    float_type readback[16];
+    float_type phoReadback = 0;
+    ASSERT_EQ(0, chip.GetNCOFrequencies(LMS7002M::Tx, readback, 16, &phoReadback));
+    for (int i = 0; i < 16; ++i)
+    {
+        EXPECT_NEAR(freqs[i], readback[i], 0.1);
+        EXPECT_EQ(chip.GetNCOFrequency(LMS7002M::Tx, i), readback[i]);
+    }
+    EXPECT_NEAR(pho, phoReadback, 0.01);
+
+    const float_type phases[3] = {0, 45, 180};
+    const float_type fcw = 1e6;
+    conn.writes = 0;
+    ASSERT_EQ(0, chip.SetNCOPhaseOffsets(LMS7002M::Rx, phases, 3, &fcw));
+    EXPECT_EQ(1, conn.writes);
+    float_type phasesReadback[3];
+    float_type fcwReadback = 0;
+    ASSERT_EQ(0, chip.GetNCOPhaseOffsets(LMS7002M::Rx, phasesReadback, 3, &fcwReadback));
+    for (int i = 0; i < 3; ++i)
+        EXPECT_NEAR(phases[i], phasesReadback[i], 0.01);
+    EXPECT_NEAR(fcw, fcwReadback, 0.1);
+}
+
+TEST(LMS7002M, CGENRetainsNCOFrequencies)
+{
+    CountingRFIC conn;
+    LMS7002M chip;
+    chip.SetConnection(&conn, 0);
+    chip.SetFrequencyCGEN(100e6);
+
+    float_type freqs[2][16];
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        chip.Modify_SPI_Reg_bits(LMS7param(MAC), ch+1);
+        for (int i = 0; i < 16; ++i)
+            freqs[ch][i] = 1e5*(i+1) + ch*1e4;
+        ASSERT_EQ(0, chip.SetNCOFrequencies(LMS7002M::Rx, freqs[ch], 16));
+        ASSERT_EQ(0, chip.SetNCOFrequencies(LMS7002M::Tx, freqs[ch], 16));
+    }
+
+    //VCO tuning does not pass without comparators, NCO are updated before it
+    conn.ncoWrites = 0;
+    chip.SetFrequencyCGEN(120e6, true);
+    EXPECT_EQ(1, conn.ncoWrites);
+    EXPECT_EQ(2, chip.Get_SPI_Reg_bits(LMS7param(MAC), true));
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        chip.Modify_SPI_Reg_bits(LMS7param(MAC), ch+1);
+        float_type readback[16];
+        ASSERT_EQ(0, chip.GetNCOFrequencies(LMS7002M::Rx, readback, 16));
+        for (int i = 0; i < 16; ++i)
+            EXPECT_NEAR(freqs[ch][i], readback[i], 1);
+        ASSERT_EQ(0, chip.GetNCOFrequencies(LMS7002M::Tx, readback, 16));
+        for (int i = 0; i < 16; ++i)
+            EXPECT_NEAR(freqs[ch][i], readback[i], 1);
+    }
+}
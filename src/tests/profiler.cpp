@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+#include "LMS64CProtocol.h"
+#include "ControlProfiler.h"
+#include "LMS7002M.h"
+#include <cstring>
+#include <map>
+using namespace std;
+using namespace lime;
+
+/** @brief LMS64C connection answering LMS7002M register access from memory.
+    Packets are processed like by boardEmulator, without any transport.
+*/
+class LoopbackLMS64C : public LMS64CProtocol
+{
+public:
+    bool IsOpen(void) override {return true;}
+    eConnectionType GetType(void) override {return USB_PORT;}
+
+    int Write(const unsigned char *buffer, int length, int timeout_ms) override
+    {
+        memcpy(response, buffer, sizeof(response));
+        const int blockCount = buffer[2];
+        const unsigned char* data = &buffer[8];
+        unsigned char* outData = &response[8];
+        switch (buffer[0])
+        {
+        case CMD_LMS7002_WR:
+            for (int i = 0; i < blockCount; ++i)
+                regs[(data[4*i] << 8) | data[4*i+1]] = (data[4*i+2] << 8) | data[4*i+3];
+            break;
+        case CMD_LMS7002_RD:
+            for (int i = 0; i < blockCount; ++i)
+            {
+                const uint16_t addr = (data[2*i] << 8) | data[2*i+1];
+                const uint16_t value = regs[addr];
+                outData[4*i] = addr >> 8;
+                outData[4*i+1] = addr & 0xFF;
+                outData[4*i+2] = value >> 8;
+                outData[4*i+3] = value & 0xFF;
+            }
+            break;
+        }
+        response[1] = STATUS_COMPLETED_CMD;
+        return length;
+    }
+
+    int Read(unsigned char *buffer, int length, int timeout_ms) override
+    {
+        memcpy(buffer, response, length);
+        return length;
+    }
+
+    map<uint16_t, uint16_t> regs;
+private:
+    unsigned char response[64];
+};
+
+TEST(ControlProfiler, DisabledRecordsNothing)
+{
+    LoopbackLMS64C conn;
+    ControlProfiler::Enable(false);
+    ControlProfiler::Reset();
+    {
+        ControlProfiler::Scope profile("Operation");
+        const uint32_t data = (1u << 31) | (0x0020 << 16) | 0xFFFD;
+        ASSERT_EQ(0, conn.WriteLMS7002MSPI(&data, 1));
+    }
+    EXPECT_TRUE(ControlProfiler::GetStats().empty());
+}
+
+TEST(ControlProfiler, AttributesNestedOperations)
+{
+    LoopbackLMS64C conn;
+    ControlProfiler::Enable(true);
+    ControlProfiler::Reset();
+
+    const uint32_t data = (1u << 31) | (0x0020 << 16) | 0xFFFD;
+    ASSERT_EQ(0, conn.WriteLMS7002MSPI(&data, 1));
+    {
+        ControlProfiler::Scope outer("Outer");
+        ASSERT_EQ(0, conn.WriteLMS7002MSPI(&data, 1));
+        {
+            ControlProfiler::Scope inner("Inner");
+            //read packet has 14 addresses, needs 3 packets
+            uint32_t addrs[40];
+            uint32_t values[40];
+            for (int i = 0; i < 40; ++i)
+                addrs[i] = 0x0020 << 16;
+            ASSERT_EQ(0, conn.ReadLMS7002MSPI(addrs, values, 40));
+            EXPECT_EQ(0xFFFDu, values[39]);
+        }
+    }
+    ControlProfiler::Enable(false);
+
+    auto stats = ControlProfiler::GetStats();
+    ASSERT_EQ(3u, stats.size());
+    EXPECT_EQ(0u, stats["(none)"].calls);
+    EXPECT_EQ(1u, stats["(none)"].transactions);
+
+    EXPECT_EQ(1u, stats["Outer"].calls);
+    EXPECT_EQ(2u, stats["Outer"].transactions);
+    EXPECT_EQ(1u, stats["Outer"].ownTransactions);
+
+    const auto &inner = stats["Inner"];
+    EXPECT_EQ(1u, inner.calls);
+    EXPECT_EQ(1u, inner.transactions);
+    EXPECT_EQ(1u, inner.ownTransactions);
+    EXPECT_EQ(3*64u, inner.bytesOut);
+    EXPECT_EQ(3*64u, inner.bytesIn);
+    uint64_t histogramTotal = 0;
+    for (auto count : inner.histogram)
+        histogramTotal += count;
+    EXPECT_EQ(inner.transactions, histogramTotal);
+    EXPECT_LE(inner.latencyMin, inner.latencyMax);
+
+    const string json = ControlProfiler::ExportJSON();
+    EXPECT_NE(string::npos, json.find("\"Outer\": {\"calls\": 1"));
+    EXPECT_NE(string::npos, json.find("\"latency_histogram_us\""));
+}
+
+TEST(ControlProfiler, ChipOperations)
+{
+    LoopbackLMS64C conn;
+    LMS7002M chip;
+    chip.SetConnection(&conn, 0);
+    ControlProfiler::Enable(true);
+    ControlProfiler::Reset();
+    chip.SetFrequencySX(LMS7002M::Tx, 1e9);
+    ControlProfiler::Enable(false);
+
+    auto stats = ControlProfiler::GetStats();
+    EXPECT_EQ(1u, stats["SetFrequencySX"].calls);
+    EXPECT_GT(stats["SetFrequencySX"].transactions, 0u);
+    EXPECT_GE(stats["SetFrequencySX"].transactions, stats["TuneVCO"].transactions + stats["SetFrequencySX"].ownTransactions);
+    EXPECT_EQ(0u, stats["(none)"].transactions);
+}
@@ -0,0 +1,149 @@
+#include "gtest/gtest.h"
+#include "LMS64CProtocol.h"
+#include <cstring>
+#include <deque>
+#include <vector>
+using namespace std;
+using namespace lime;
+
+/** @brief LMS64C connection acknowledging packets like boardEmulator.
+    Replies are queued, so several requests can be in flight.
+*/
+class QueuedLoopback : public LMS64CProtocol
+{
+public:
+    QueuedLoopback(const int window) : window(window), maxInFlight(0), failPortion(-1), failWrite(-1), writes(0) {}
+
+    bool IsOpen(void) override {return true;}
+    eConnectionType GetType(void) override {return USB_PORT;}
+    int GetMaxPacketsInFlight(void) const override {return window;}
+
+    int Write(const unsigned char *buffer, int length, int timeout_ms) override
+    {
+        if (writes++ == failWrite)
+            return 0;
+        vector<unsigned char> reply(buffer, buffer+64);
+        reply[1] = STATUS_COMPLETED_CMD;
+        replies.push_back(reply);
+        maxInFlight = max(maxInFlight, replies.size());
+        if (buffer[0] != CMD_ALTERA_FPGA_GW_WR)
+            return length;
+
+        const int portion = (buffer[9] << 24) | (buffer[10] << 16) | (buffer[11] << 8) | buffer[12];
+        const int count = buffer[13];
+        if (portion != int(portions.size()) or portion == failPortion)
+            replies.back()[1] = STATUS_ERROR_CMD;
+        portions.push_back(portion);
+        image.insert(image.end(), &buffer[32], &buffer[32+count]);
+        return length;
+    }
+
+    int Read(unsigned char *buffer, int length, int timeout_ms) override
+    {
+        if (replies.empty())
+            return 0;
+        memcpy(buffer, replies.front().data(), length);
+        replies.pop_front();
+        return length;
+    }
+
+    const int window;
+    size_t maxInFlight;
+    int failPortion;
+    int failWrite;
+    int writes;
+    vector<int> portions;
+    vector<char> image;
+    deque<vector<unsigned char>> replies;
+};
+
+static vector<char> TestImage(const size_t size)
+{
+    vector<char> data(size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = char(i*7 + (i >> 8));
+    return data;
+}
+
+TEST(ProgramWrite, Sequential)
+{
+    QueuedLoopback conn(1);
+    const auto data = TestImage(1000);
+    ASSERT_EQ(0, conn.ProgramWrite(data.data(), data.size(), 1, LMS64CProtocol::FPGA));
+    EXPECT_EQ(1u, conn.maxInFlight);
+    EXPECT_EQ(data, conn.image);
+    EXPECT_EQ(1000u/32 + 2, conn.portions.size()); //partial and end packets
+}
+
+TEST(ProgramWrite, Pipelined)
+{
+    QueuedLoopback conn(8);
+    const auto data = TestImage(10000);
+    int lastSent = 0;
+    bool progressOrdered = true;
+    auto callback = [&](int bsent, int btotal, const char* msg)
+    {
+        progressOrdered &= bsent >= lastSent and bsent <= btotal;
+        lastSent = bsent;
+        return false;
+    };
+    ASSERT_EQ(0, conn.ProgramWrite(data.data(), data.size(), 1, LMS64CProtocol::FPGA, callback));
+    EXPECT_EQ(8u, conn.maxInFlight);
+    EXPECT_TRUE(conn.replies.empty());
+    EXPECT_EQ(data, conn.image);
+    for (size_t i = 0; i < conn.portions.size(); ++i)
+        EXPECT_EQ(int(i), conn.portions[i]);
+    EXPECT_TRUE(progressOrdered);
+    EXPECT_EQ(int(data.size()), lastSent);
+}
+
+TEST(ProgramWrite, PipelinedFailure)
+{
+    QueuedLoopback conn(4);
+    conn.failPortion = 5;
+    const auto data = TestImage(1000);
+    EXPECT_NE(0, conn.ProgramWrite(data.data(), data.size(), 1, LMS64CProtocol::FPGA));
+    //no more packets are sent after failure is noticed
+    EXPECT_EQ(5u+4, conn.portions.size());
+    EXPECT_TRUE(conn.replies.empty());
+}
+
+TEST(ProgramWrite, PipelinedAbort)
+{
+    QueuedLoopback conn(4);
+    const auto data = TestImage(1000);
+    auto callback = [](int bsent, int btotal, const char* msg)
+    {
+        return bsent >= 64;
+    };
+    EXPECT_NE(0, conn.ProgramWrite(data.data(), data.size(), 1, LMS64CProtocol::FPGA, callback));
+    //packets in flight are acknowledged before returning
+    EXPECT_TRUE(conn.replies.empty());
+    EXPECT_LT(conn.portions.size(), 10u);
+}
+
+TEST(TransferPacket, Pipelined)
+{
+    QueuedLoopback conn(4);
+    //14 registers fit in one packet
+    vector<uint32_t> data(64);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = (1u << 31) | (0x0100+i) << 16 | i;
+    ASSERT_EQ(0, conn.WriteLMS7002MSPI(data.data(), data.size()));
+    EXPECT_EQ(4u, conn.maxInFlight);
+    EXPECT_TRUE(conn.replies.empty());
+}
+
+TEST(TransferPacket, PipelinedWriteFailure)
+{
+    QueuedLoopback conn(4);
+    conn.failWrite = 3;
+    vector<uint32_t> data(64);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = (1u << 31) | (0x0100+i) << 16 | i;
+    EXPECT_NE(0, conn.WriteLMS7002MSPI(data.data(), data.size()));
+    //replies of packets sent before failure are collected
+    EXPECT_TRUE(conn.replies.empty());
+    EXPECT_EQ(0, conn.WriteLMS7002MSPI(data.data(), 1));
+    EXPECT_TRUE(conn.replies.empty());
+}
@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+#include "ConnectionRegistry.h"
+#include <chrono>
+#include <thread>
+#include <atomic>
+using namespace std;
+using namespace lime;
+
+static atomic<int> activeEnumerations(0);
+static atomic<int> maxActiveEnumerations(0);
+
+//! Registry entry with one slow to enumerate device
+class SlowEntry : public ConnectionRegistryEntry
+{
+public:
+    SlowEntry(const string &name, const bool hotplug) :
+        ConnectionRegistryEntry(name), enumerations(0)
+    {
+        setHotplugSupported(hotplug);
+    }
+
+    vector<ConnectionHandle> enumerate(const ConnectionHandle &hint) override
+    {
+        enumerations++;
+        int active = ++activeEnumerations;
+        int prevMax = maxActiveEnumerations;
+        while (active > prevMax and not maxActiveEnumerations.compare_exchange_weak(prevMax, active));
+        this_thread::sleep_for(chrono::milliseconds(100));
+        activeEnumerations--;
+
+        vector<ConnectionHandle> handles;
+        ConnectionHandle handle;
+        handle.media = "Emulated";
+        handle.name = "SlowDevice";
+        handle.serial = "0001";
+        if (hint.serial.empty() or hint.serial == handle.serial)
+            handles.push_back(handle);
+        return handles;
+    }
+
+    IConnection* make(const ConnectionHandle &handle) override {return nullptr;}
+
+    using ConnectionRegistryEntry::hotplugEvent;
+    atomic<int> enumerations;
+};
+
+TEST(ConnectionRegistry, cachesEnumerationUntilHotplug)
+{
+    SlowEntry entry("SlowHotplug", true);
+    ConnectionHandle hint;
+    hint.module = "SlowHotplug";
+
+    auto handles = ConnectionRegistry::findConnections(hint);
+    ASSERT_EQ(1u, handles.size());
+    EXPECT_EQ(1, entry.enumerations);
+
+    //repeated lookups and lookup by complete handle are served from cache
+    auto t0 = chrono::high_resolution_clock::now();
+    auto cached = ConnectionRegistry::findConnections(hint);
+    ASSERT_EQ(1u, cached.size());
+    EXPECT_EQ(handles[0].serialize(), cached[0].serialize());
+    cached = ConnectionRegistry::findConnections(handles[0]);
+    ASSERT_EQ(1u, cached.size());
+    EXPECT_EQ(handles[0].serialize(), cached[0].serialize());
+    auto t1 = chrono::high_resolution_clock::now();
+    EXPECT_EQ(1, entry.enumerations);
+    EXPECT_LT(chrono::duration_cast<chrono::milliseconds>(t1-t0).count(), 50);
+
+    //unknown hint is enumerated once
+    hint.serial = "0002";
+    EXPECT_TRUE(ConnectionRegistry::findConnections(hint).empty());
+    EXPECT_TRUE(ConnectionRegistry::findConnections(hint).empty());
+    EXPECT_EQ(2, entry.enumerations);
+
+    entry.hotplugEvent();
+    EXPECT_TRUE(ConnectionRegistry::findConnections(hint).empty());
+    EXPECT_EQ(1u, ConnectionRegistry::findConnections(handles[0]).size());
+    EXPECT_EQ(4, entry.enumerations);
+}
+
+TEST(ConnectionRegistry, enumeratesEntriesInParallel)
+{
+    SlowEntry entryA("SlowA", false);
+    SlowEntry entryB("SlowB", false);
+    maxActiveEnumerations = 0;
+
+    auto handles = ConnectionRegistry::findConnections();
+    int found = 0;
+    for (auto &handle : handles)
+        if (handle.module == "SlowA" or handle.module == "SlowB")
+            ++found;
+    EXPECT_EQ(2, found);
+    EXPECT_EQ(1, entryA.enumerations);
+    EXPECT_EQ(1, entryB.enumerations);
+    EXPECT_EQ(2, maxActiveEnumerations);
+}
@@ -0,0 +1,288 @@
+#include "gtest/gtest.h"
+#include "RSSIEstimator.h"
+#include "IConnection.h"
+#include "LMS7002M.h"
+#include "LMS7002M_parameters.h"
+#include "dataTypes.h"
+#include "emulatedRFICs.h"
+#include <cmath>
+#include <vector>
+using namespace std;
+using namespace lime;
+
+//two tones and small DC offset, 12 bit samples
+static vector<complex16_t> Signal(const size_t count, const double freqA, const double ampA,
+    const double freqB, const double ampB, const size_t offset = 0)
+{
+    vector<complex16_t> samples(count);
+    for (size_t n = 0; n < count; ++n)
+    {
+        const double a = 2*M_PI*fmod(freqA*(n+offset), 1.0);
+        const double b = 2*M_PI*fmod(freqB*(n+offset), 1.0);
+        samples[n].i = int16_t(lround(ampA*cos(a) + ampB*cos(b) + 20));
+        samples[n].q = int16_t(lround(ampA*sin(a) + ampB*sin(b) - 10));
+    }
+    return samples;
+}
+
+/** @brief Connection streaming a tone, amplitude is changed like by register writes.
+    Samples received before the change are still delivered after restart.
+*/
+class ToneConnection : public IConnection
+{
+public:
+    ToneConnection() : amplitude(0), oldAmplitude(0), staleSamples(2000), position(0), stale(0), starts(0) {}
+
+    int WriteLMS7002MSPI(const uint32_t *writeData, size_t size, unsigned periphID) override {return 0;}
+    int ReadLMS7002MSPI(const uint32_t *writeData, uint32_t *readData, size_t size, unsigned periphID) override {return 0;}
+    int ProgramMCU(const uint8_t *buffer, const size_t length, const MCU_PROG_MODE mode, ProgrammingCallback callback) override {return 0;}
+    bool IsOpen(void) override {return true;}
+
+    int ControlStream(const size_t streamID, const bool enable) override
+    {
+        if (enable)
+        {
+            ++starts;
+            stale = staleSamples;
+        }
+        return 0;
+    }
+
+    int ReadStream(const size_t streamID, void* buffer, const size_t length, const long timeout_ms, StreamMetadata &metadata) override
+    {
+        complex16_t* samples = (complex16_t*)buffer;
+        for (size_t n = 0; n < length; ++n, ++position)
+        {
+            const double amp = stale ? oldAmplitude : amplitude;
+            if (stale)
+                --stale;
+            const double angle = 2*M_PI*fmod(0.05*position, 1.0);
+            samples[n].i = int16_t(lround(amp*cos(angle)));
+            samples[n].q = int16_t(lround(amp*sin(angle)));
+        }
+        metadata.timestamp = position - length;
+        return length;
+    }
+
+    void SetAmplitude(const double amp)
+    {
+        oldAmplitude = amplitude;
+        amplitude = amp;
+    }
+
+    double amplitude;
+    double oldAmplitude;
+    size_t staleSamples;
+    uint64_t position;
+    size_t stale;
+    int starts;
+};
+
+TEST(RSSIEstimator, PowerIsRMSAmplitude)
+{
+    RSSIEstimator::Config config;
+    config.windowSize = 4096;
+    RSSIEstimator estimator(config);
+    auto samples = Signal(4096, 0.1, 1000, -0.23, 500);
+    const double rms = sqrt(1000.0*1000 + 500*500 + 20*20 + 10*10);
+    EXPECT_NEAR(rms, estimator.Estimate(samples.data()), rms*1e-3);
+}
+
+TEST(RSSIEstimator, GoertzelMeasuresSingleTone)
+{
+    //tones between FFT bins, negative frequency and rate in Hz
+    RSSIEstimator::Config config;
+    config.method = RSSIEstimator::GOERTZEL;
+    config.sampleRate = 10e6;
+    config.windowSize = 3000;
+    auto samples = Signal(config.windowSize, 0.1234, 1000, -0.0577, 250);
+    config.frequency = 0.1234*config.sampleRate;
+    EXPECT_NEAR(1000, RSSIEstimator(config).Estimate(samples.data()), 1);
+    config.frequency = -0.0577*config.sampleRate;
+    EXPECT_NEAR(250, RSSIEstimator(config).Estimate(samples.data()), 1);
+    config.frequency = 0;
+    EXPECT_NEAR(sqrt(20.0*20 + 10*10), RSSIEstimator(config).Estimate(samples.data()), 0.5);
+    //no tone, window sidelobes keep leakage low
+    config.frequency = 0.3*config.sampleRate;
+    EXPECT_LT(RSSIEstimator(config).Estimate(samples.data()), 0.5);
+}
+
+TEST(RSSIEstimator, FFTBinMatchesGoertzel)
+{
+    RSSIEstimator::Config config;
+    config.windowSize = 4096;
+    const double freq = 300.0/config.windowSize;
+    auto samples = Signal(config.windowSize, freq, 800, 0.4, 800);
+    config.frequency = freq;
+    config.method = RSSIEstimator::GOERTZEL;
+    const double goertzel = RSSIEstimator(config).Estimate(samples.data());
+    config.method = RSSIEstimator::FFT_BIN;
+    const double fft = RSSIEstimator(config).Estimate(samples.data());
+    EXPECT_NEAR(800, goertzel, 1);
+    EXPECT_NEAR(goertzel, fft, 0.5);
+}
+
+TEST(RSSIEstimator, MeasureSkipsStaleSamples)
+{
+    ToneConnection port;
+    RSSIEstimator::Config config;
+    config.method = RSSIEstimator::GOERTZEL;
+    config.frequency = 0.05;
+    config.windowSize = 1024;
+    config.averages = 4;
+    config.skipSamples = 2048;
+    RSSIEstimator estimator(config);
+
+    double amplitude = 0;
+    port.SetAmplitude(1000);
+    ASSERT_EQ(0, estimator.Measure(&port, 1, amplitude));
+    EXPECT_NEAR(1000, amplitude, 1);
+    EXPECT_EQ(1, port.starts);
+    EXPECT_EQ(uint64_t(2048 + 4*1024), port.position);
+
+    port.SetAmplitude(100);
+    ASSERT_EQ(0, estimator.Measure(&port, 1, amplitude, 2));
+    EXPECT_NEAR(100, amplitude, 1);
+    EXPECT_EQ(uint64_t(2*2048 + 6*1024), port.position);
+}
+
+TEST(RSSIEstimator, RSSIScale)
+{
+    //full scale near 0x10000 and -3 dB near 0x0B000 like chip RSSI
+    EXPECT_NEAR(0x10000, RSSIEstimator::AmplitudeToRSSI(2048), 32);
+    EXPECT_NEAR(0x0B000, RSSIEstimator::AmplitudeToRSSI(2048*pow(10, -3.25/20)), 0x400);
+    EXPECT_EQ(0x3FFFFu, RSSIEstimator::AmplitudeToRSSI(1e6));
+}
+
+/** @brief Emulated chip with RX stream of constant amplitude tone.
+    Stream can stop delivering samples, data rate updates are recorded.
+*/
+class StreamingRFIC : public EmulatedRFICs
+{
+public:
+    StreamingRFIC() : amplitude(0), streaming(true), position(0), setups(0), closes(0), starts(0), rateUpdates(0), rxRate(0) {}
+
+    int SetupStream(size_t &streamID, const StreamConfig &config) override
+    {
+        ++setups;
+        streamID = 5;
+        return 0;
+    }
+
+    int CloseStream(const size_t streamID) override
+    {
+        ++closes;
+        return 0;
+    }
+
+    int ControlStream(const size_t streamID, const bool enable) override
+    {
+        starts += enable;
+        return 0;
+    }
+
+    int ReadStream(const size_t streamID, void* buffer, const size_t length, const long timeout_ms, StreamMetadata &metadata) override
+    {
+        if (not streaming)
+            return 0;
+        complex16_t* samples = (complex16_t*)buffer;
+        for (size_t n = 0; n < length; ++n, ++position)
+        {
+            const double angle = 2*M_PI*fmod(0.05*position, 1.0);
+            samples[n].i = int16_t(lround(amplitude*cos(angle)));
+            samples[n].q = int16_t(lround(amplitude*sin(angle)));
+        }
+        metadata.timestamp = position - length;
+        return length;
+    }
+
+    int UpdateExternalDataRate(const size_t channel, const double txRate, const double rxRate) override
+    {
+        ++rateUpdates;
+        this->rxRate = rxRate;
+        return 0;
+    }
+
+    double amplitude;
+    bool streaming;
+    uint64_t position;
+    int setups;
+    int closes;
+    int starts;
+    int rateUpdates;
+    double rxRate;
+};
+
+//! Chip exposing RSSI reads of calibrations
+class CalibratingChip : public LMS7002M
+{
+public:
+    using LMS7002M::GetRSSI;
+    using LMS7002M::GetAvgRSSI;
+};
+
+TEST(RSSIEstimator, CalibrationReadsStreamUntilItStops)
+{
+    StreamingRFIC conn;
+    CalibratingChip chip;
+    chip.SetConnection(&conn, 0);
+    chip.EnableCalibrationByMCU(false);
+    chip.Modify_SPI_Reg_bits(LMS7param(MAC), 1);
+    //chip RSSI 0x2000, CGEN VCO reports lock
+    conn.Bank(0)[0x040F] = 0x0800;
+    conn.Bank(0)[LMS7param(VCO_CMPHO_CGEN).address] = 0x2000;
+    ASSERT_EQ(0, chip.SetFrequencyCGEN(491.52e6));
+    chip.Modify_SPI_Reg_bits(LMS7param(HBD_OVR_RXTSP), 1);
+    const double sampleRate = chip.GetSampleRate(false, LMS7002M::ChA);
+
+    RSSIEstimator::Config config;
+    config.windowSize = 1024;
+    config.skipSamples = 1024;
+    chip.SetStreamRSSI(LMS7002M::STREAM_RSSI_CAL_RX, config);
+    conn.amplitude = 1000;
+    const uint32_t streamRSSI = RSSIEstimator::AmplitudeToRSSI(1000);
+    EXPECT_EQ(0x2000u, chip.GetRSSI());
+    {
+        //not selected calibration
+        LMS7002M_StreamRSSIState state(&chip, LMS7002M::STREAM_RSSI_CAL_TX);
+        EXPECT_EQ(0, conn.setups);
+        EXPECT_EQ(0x2000u, chip.GetRSSI());
+    }
+    {
+        LMS7002M_StreamRSSIState state(&chip, LMS7002M::STREAM_RSSI_CAL_RX);
+        EXPECT_EQ(1, conn.setups);
+        //interface follows decimation lowered to fit the link
+        state.SetupInterface();
+        EXPECT_EQ(1, conn.rateUpdates);
+        EXPECT_LT(conn.rxRate, sampleRate);
+        EXPECT_DOUBLE_EQ(chip.GetSampleRate(false, LMS7002M::ChA), conn.rxRate);
+
+        EXPECT_NEAR(streamRSSI, chip.GetRSSI(), streamRSSI*1e-3);
+        EXPECT_EQ(1, conn.starts);
+        EXPECT_EQ(uint64_t(1024 + 1024), conn.position);
+        //averages are read in one burst
+        EXPECT_NEAR(streamRSSI, chip.GetAvgRSSI(5), streamRSSI*1e-3);
+        EXPECT_EQ(2, conn.starts);
+        EXPECT_EQ(uint64_t(2*1024 + 1024 + 5*1024), conn.position);
+
+        //first failure switches to chip RSSI for rest of calibration
+        conn.streaming = false;
+        EXPECT_EQ(0x2000u, chip.GetRSSI());
+        EXPECT_EQ(3, conn.starts);
+        EXPECT_EQ(0x2000u, chip.GetAvgRSSI(5));
+        EXPECT_EQ(0x2000u, chip.GetRSSI());
+        EXPECT_EQ(3, conn.starts);
+
+        //calibration restores registers before exit
+        chip.Modify_SPI_Reg_bits(LMS7param(HBD_OVR_RXTSP), 1);
+    }
+    EXPECT_EQ(1, conn.closes);
+    EXPECT_EQ(2, conn.rateUpdates);
+    EXPECT_DOUBLE_EQ(sampleRate, conn.rxRate);
+
+    //next calibration starts with stream again
+    conn.streaming = true;
+    LMS7002M_StreamRSSIState state(&chip, LMS7002M::STREAM_RSSI_CAL_RX);
+    EXPECT_EQ(2, conn.setups);
+    EXPECT_NEAR(streamRSSI, chip.GetRSSI(), streamRSSI*1e-3);
+}
@@ -0,0 +1,226 @@
+#include "gtest/gtest.h"
+#include "SharedStream.h"
+#include "lime/LimeSuite.h"
+#include <unistd.h>
+#include <vector>
+using namespace std;
+using namespace lime;
+
+//unique per process, tests may run in parallel
+static string StreamName(const char* test)
+{
+    return string("test-") + test + "-" + to_string(getpid());
+}
+
+//sample value encodes its index, so integrity can be checked
+static vector<int16_t> Ramp(const uint64_t first, const size_t count)
+{
+    vector<int16_t> samples(2*count);
+    for (size_t n = 0; n < count; ++n)
+    {
+        samples[2*n] = int16_t(first+n);
+        samples[2*n+1] = int16_t(~(first+n));
+    }
+    return samples;
+}
+
+static bool IsRamp(const vector<int16_t> &samples, const uint64_t first, const size_t count)
+{
+    for (size_t n = 0; n < count; ++n)
+        if (samples[2*n] != int16_t(first+n) or samples[2*n+1] != int16_t(~(first+n)))
+            return false;
+    return true;
+}
+
+TEST(SharedStream, ReadersGetAllSamples)
+{
+    const string name = StreamName("all");
+    SharedStreamPublisher publisher;
+    ASSERT_EQ(0, publisher.Open(name, 5000, StreamConfig::STREAM_12_BIT_IN_16, 1e6));
+    SharedStreamReader readers[2];
+    for (auto &reader : readers)
+    {
+        ASSERT_EQ(0, reader.Open(name));
+        EXPECT_EQ(8192u, reader.GetCapacity());
+        EXPECT_DOUBLE_EQ(1e6, reader.GetSampleRate());
+        ASSERT_EQ(0, reader.Start());
+    }
+
+    //blocks wrap the ring several times, readers follow at different pace
+    const uint64_t timestamp = 100000;
+    uint64_t published = 0;
+    uint64_t positions[2] = {0, 0};
+    vector<int16_t> buffer(2*3000);
+    for (int block = 0; block < 20; ++block)
+    {
+        const size_t count = 1500 + 77*block;
+        auto samples = Ramp(published, count);
+        publisher.Publish(samples.data(), count, timestamp + published);
+        published += count;
+        for (int r = 0; r < 2; ++r)
+        {
+            const uint32_t readSize = r == 0 ? 1000 : 2900;
+            while (published - positions[r] >= readSize)
+            {
+                IStreamChannel::Metadata meta;
+                meta.flags = 0;
+                ASSERT_EQ(int(readSize), readers[r].Read(buffer.data(), readSize, &meta, 0));
+                EXPECT_EQ(timestamp + positions[r], meta.timestamp);
+                EXPECT_EQ(0u, meta.flags & IStreamChannel::Metadata::DROPPED_SAMPLES);
+                EXPECT_TRUE(IsRamp(buffer, positions[r], readSize)) << "reader " << r << " at " << positions[r];
+                positions[r] += readSize;
+            }
+        }
+    }
+    EXPECT_EQ(published, publisher.GetPublishedCount());
+    for (auto &reader : readers)
+    {
+        EXPECT_EQ(0u, reader.GetLostCount());
+        EXPECT_EQ(0u, reader.GetInfo().overrun);
+    }
+}
+
+TEST(SharedStream, SlowReaderLosesSamples)
+{
+    const string name = StreamName("slow");
+    SharedStreamPublisher publisher;
+    ASSERT_EQ(0, publisher.Open(name, 4096, StreamConfig::STREAM_12_BIT_IN_16, 1e6));
+    SharedStreamReader reader;
+    ASSERT_EQ(0, reader.Open(name));
+    ASSERT_EQ(0, reader.Start());
+
+    //more than ring size published before reading
+    const size_t count = 10000;
+    auto samples = Ramp(0, count);
+    publisher.Publish(samples.data(), count, 0);
+
+    vector<int16_t> buffer(2*1000);
+    IStreamChannel::Metadata meta;
+    meta.flags = 0;
+    ASSERT_EQ(1000, reader.Read(buffer.data(), 1000, &meta, 0));
+    EXPECT_NE(0u, meta.flags & IStreamChannel::Metadata::DROPPED_SAMPLES);
+    EXPECT_GT(reader.GetLostCount(), 0u);
+    //reading continues from valid samples with matching timestamp
+    EXPECT_EQ(reader.GetLostCount(), meta.timestamp);
+    EXPECT_TRUE(IsRamp(buffer, meta.timestamp, 1000));
+    EXPECT_EQ(1u, reader.GetInfo().overrun);
+
+    meta.flags = 0;
+    const uint64_t next = meta.timestamp + 1000;
+    ASSERT_EQ(1000, reader.Read(buffer.data(), 1000, &meta, 0));
+    EXPECT_EQ(0u, meta.flags & IStreamChannel::Metadata::DROPPED_SAMPLES);
+    EXPECT_EQ(next, meta.timestamp);
+}
+
+TEST(SharedStream, LateReaderStartsAtNewSamples)
+{
+    const string name = StreamName("late");
+    SharedStreamPublisher publisher;
+    ASSERT_EQ(0, publisher.Open(name, 4096, StreamConfig::STREAM_12_BIT_IN_16, 1e6));
+    auto samples = Ramp(0, 3000);
+    publisher.Publish(samples.data(), 3000, 0);
+
+    SharedStreamReader reader;
+    ASSERT_EQ(0, reader.Open(name));
+    ASSERT_EQ(0, reader.Start());
+    vector<int16_t> buffer(2*3000);
+    IStreamChannel::Metadata meta;
+    //nothing new, times out with partial result
+    EXPECT_EQ(0, reader.Read(buffer.data(), 100, &meta, 5));
+
+    samples = Ramp(3000, 3000);
+    publisher.Publish(samples.data(), 3000, 3000);
+    ASSERT_EQ(3000, reader.Read(buffer.data(), 3000, &meta, 0));
+    EXPECT_EQ(3000u, meta.timestamp);
+    EXPECT_TRUE(IsRamp(buffer, 3000, 3000));
+}
+
+TEST(SharedStream, TimestampsAfterGap)
+{
+    const string name = StreamName("gap");
+    SharedStreamPublisher publisher;
+    ASSERT_EQ(0, publisher.Open(name, 4096, StreamConfig::STREAM_12_BIT_IN_16, 1e6));
+    SharedStreamReader reader;
+    ASSERT_EQ(0, reader.Open(name));
+    ASSERT_EQ(0, reader.Start());
+
+    //read stops at timestamp jump inside a chunk
+    auto samples = Ramp(0, 100);
+    publisher.Publish(samples.data(), 100, 0);
+    samples = Ramp(5000, 100);
+    publisher.Publish(samples.data(), 100, 5000);
+    vector<int16_t> buffer(2*1000);
+    IStreamChannel::Metadata meta;
+    meta.flags = 0;
+    ASSERT_EQ(100, reader.Read(buffer.data(), 200, &meta, 0));
+    EXPECT_EQ(0u, meta.timestamp);
+    EXPECT_TRUE(IsRamp(buffer, 0, 100));
+    ASSERT_EQ(100, reader.Read(buffer.data(), 200, &meta, 0));
+    EXPECT_EQ(5000u, meta.timestamp);
+    EXPECT_TRUE(IsRamp(buffer, 5000, 100));
+
+    //continuous blocks are read at once, also across chunks
+    samples = Ramp(5100, 100);
+    publisher.Publish(samples.data(), 100, 5100);
+    samples = Ramp(5200, 400);
+    publisher.Publish(samples.data(), 400, 5200);
+    ASSERT_EQ(500, reader.Read(buffer.data(), 500, &meta, 0));
+    EXPECT_EQ(5100u, meta.timestamp);
+    EXPECT_TRUE(IsRamp(buffer, 5100, 500));
+
+    //jumps at and between chunk boundaries while ring wraps
+    uint64_t timestamp = 8000;
+    for (int block = 0; block < 40; ++block)
+    {
+        const size_t count = 56 + 137*(block % 7);
+        samples = Ramp(timestamp, count);
+        publisher.Publish(samples.data(), count, timestamp);
+        ASSERT_EQ(int(count), reader.Read(buffer.data(), 1000, &meta, 0)) << "block " << block;
+        EXPECT_EQ(timestamp, meta.timestamp);
+        EXPECT_TRUE(IsRamp(buffer, timestamp, count)) << "block " << block;
+        timestamp += count + (block % 3 ? 1000 + block : 0);
+    }
+    EXPECT_EQ(0u, meta.flags & IStreamChannel::Metadata::DROPPED_SAMPLES);
+    EXPECT_EQ(0u, reader.GetLostCount());
+}
+
+TEST(SharedStream, ReaderWaitsForPublisherThread)
+{
+    const string name = StreamName("wait");
+    SharedStreamPublisher publisher;
+    ASSERT_EQ(0, publisher.Open(name, 65536, StreamConfig::STREAM_12_BIT_IN_16, 1e6));
+    lms_stream_t stream;
+    ASSERT_EQ(0, LMS_OpenSharedStream(name.c_str(), &stream));
+    EXPECT_EQ(lms_stream_t::LMS_FMT_I16, stream.dataFmt);
+    EXPECT_EQ(65536u, stream.fifoSize);
+    ASSERT_EQ(0, LMS_StartStream(&stream));
+
+    thread producer([&]{
+        for (int i = 0; i < 10; ++i)
+        {
+            this_thread::sleep_for(chrono::milliseconds(2));
+            auto samples = Ramp(i*500, 500);
+            publisher.Publish(samples.data(), 500, i*500);
+        }
+    });
+    vector<int16_t> buffer(2*5000);
+    lms_stream_meta_t meta;
+    meta.waitForTimestamp = false;
+    EXPECT_EQ(5000, LMS_RecvStream(&stream, buffer.data(), 5000, &meta, 1000));
+    producer.join();
+    EXPECT_EQ(0u, meta.timestamp);
+    EXPECT_TRUE(IsRamp(buffer, 0, 5000));
+
+    lms_stream_status_t status;
+    ASSERT_EQ(0, LMS_GetStreamStatus(&stream, &status));
+    EXPECT_TRUE(status.active);
+    EXPECT_EQ(0u, status.overrun);
+    EXPECT_DOUBLE_EQ(1e6, status.sampleRate);
+
+    //publisher gone, reader sees inactive stream
+    publisher.Close();
+    EXPECT_EQ(0, LMS_RecvStream(&stream, buffer.data(), 100, &meta, 1000));
+    ASSERT_EQ(0, LMS_GetStreamStatus(&stream, &status));
+    EXPECT_FALSE(status.active);
+    EXPECT_EQ(0, LMS_CloseSharedStream(&stream));
+}
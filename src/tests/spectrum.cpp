@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "SpectrumPipeline.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+using namespace std;
+using namespace lime;
+
+static vector<complex16_t> Tone(const int size, const int bin, const int amplitude)
+{
+    vector<complex16_t> samples(size);
+    for (int i = 0; i < size; ++i)
+    {
+        const double phase = 2*M_PI*bin*i/size;
+        samples[i].i = int16_t(amplitude*cos(phase));
+        samples[i].q = int16_t(amplitude*sin(phase));
+    }
+    return samples;
+}
+
+TEST(SpectrumKernels, PowerToDB)
+{
+    vector<float> power;
+    for (double p = 1e-20; p < 1e20; p *= 3.7)
+        power.push_back(p);
+    power.push_back(0);
+    vector<float> dB(power.size());
+    PowerToDB(power.data(), dB.data(), power.size(), 10);
+    for (size_t i = 0; i+1 < power.size(); ++i)
+        EXPECT_NEAR(10*log10(power[i]) - 10, dB[i], 1e-4) << power[i];
+    EXPECT_EQ(-300, dB.back());
+}
+
+TEST(SpectrumPipeline, AveragesTone)
+{
+    const int fftSize = 256;
+    const int bin = 10;
+    const vector<complex16_t> ch0 = Tone(fftSize, bin, 1000);
+    const vector<complex16_t> ch1 = Tone(fftSize, -bin, 1000);
+    const complex16_t* samples[] = {ch0.data(), ch1.data()};
+
+    SpectrumPipeline pipeline(fftSize, 2, 3, 16);
+    pipeline.SetAverageCount(8);
+    for (int i = 0; i < 8; ++i)
+    {
+        while (not pipeline.Push(samples))
+            pipeline.Flush();
+    }
+    vector<float> bins[2];
+    ASSERT_TRUE(pipeline.GetSpectrum(bins, 1000));
+    EXPECT_EQ(8u, pipeline.GetProcessedCount());
+
+    //positive frequency bin k is at fftSize/2-1+k
+    const int center = fftSize/2 - 1;
+    ASSERT_EQ(size_t(fftSize), bins[0].size());
+    const int peak0 = max_element(bins[0].begin(), bins[0].end()) - bins[0].begin();
+    const int peak1 = max_element(bins[1].begin(), bins[1].end()) - bins[1].begin();
+    EXPECT_EQ(center + bin, peak0);
+    EXPECT_EQ(center - bin, peak1);
+    //normalized power of tone equals amplitude squared, less quantization
+    EXPECT_NEAR(1e6, bins[0][peak0], 1e4);
+    EXPECT_FALSE(pipeline.GetSpectrum(bins, 0));
+}
+
+TEST(SpectrumPipeline, WindowChangeRestartsAveraging)
+{
+    const int fftSize = 512;
+    const vector<complex16_t> tone = Tone(fftSize, 3, 2000);
+    const complex16_t* samples[] = {tone.data()};
+
+    SpectrumPipeline pipeline(fftSize, 1, 2, 4);
+    pipeline.SetAverageCount(4);
+    for (int i = 0; i < 3; ++i)
+    {
+        while (not pipeline.Push(samples))
+            pipeline.Flush();
+    }
+    pipeline.Flush();
+    pipeline.SetWindow(1);
+    vector<float> bins[1];
+    EXPECT_FALSE(pipeline.GetSpectrum(bins, 0));
+    for (int i = 0; i < 4; ++i)
+    {
+        while (not pipeline.Push(samples))
+            pipeline.Flush();
+    }
+    ASSERT_TRUE(pipeline.GetSpectrum(bins, 1000));
+    const int peak = max_element(bins[0].begin(), bins[0].end()) - bins[0].begin();
+    EXPECT_EQ(fftSize/2 - 1 + 3, peak);
+}
@@ -0,0 +1,112 @@
+#include "gtest/gtest.h"
+#include "StreamRecorder.h"
+#include "StreamPlayer.h"
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <vector>
+using namespace std;
+using namespace lime;
+
+//unique per process, tests may run in parallel
+static string RecordingName(const char* test)
+{
+    return string("test-") + test + "-" + to_string(getpid());
+}
+
+//covers whole 12 bit range, channels differ
+static complex16_t Sample(const unsigned ch, const size_t n)
+{
+    complex16_t s;
+    s.i = int16_t(int((n*7 + ch*1000) % 4096) - 2048);
+    s.q = int16_t(2047 - int((n*13 + ch*500) % 4096));
+    return s;
+}
+
+//! Transmit channel collecting written samples
+class CollectingChannel : public IStreamChannel
+{
+public:
+    int Start() override {return 0;}
+    int Stop() override {return 0;}
+    int Read(void* samples, const uint32_t count, Metadata* metadata, const int32_t timeout_ms) override {return 0;}
+    int Write(const void* samples, const uint32_t count, const Metadata* metadata, const int32_t timeout_ms) override
+    {
+        const complex16_t* s = (const complex16_t*)samples;
+        received.insert(received.end(), s, s+count);
+        return count;
+    }
+    Info GetInfo() override {return Info();}
+
+    vector<complex16_t> received;
+};
+
+static void RecordAndPlay(const StreamRecorder::SampleFormat format, const int fileScale)
+{
+    const string name = RecordingName(format == StreamRecorder::FORMAT_CS16 ? "cs16" : "cs12");
+    const size_t count = 10000;
+    vector<vector<complex16_t>> samples(2, vector<complex16_t>(count));
+    for (unsigned ch = 0; ch < 2; ++ch)
+        for (size_t n = 0; n < count; ++n)
+            samples[ch][n] = Sample(ch, n);
+
+    StreamRecorder recorder;
+    StreamRecorder::Config recConfig;
+    recConfig.filename = name;
+    recConfig.channels = 2;
+    recConfig.format = format;
+    recConfig.directIO = false;
+    ASSERT_EQ(0, recorder.Open(recConfig));
+    const complex16_t* ptrs[] = {samples[0].data(), samples[1].data()};
+    for (size_t n = 0; n < count; n += 1000)
+    {
+        const complex16_t* block[] = {ptrs[0]+n, ptrs[1]+n};
+        ASSERT_EQ(1000, recorder.Write(block, 1000, n));
+    }
+    ASSERT_EQ(0, recorder.Close());
+
+    //file holds interleaved channels at declared scale
+    string dataFile, metaFile;
+    SigMFMeta::FileNames(name, dataFile, metaFile);
+    int16_t first[4];
+    ifstream(dataFile.c_str(), ios::binary).read((char*)first, sizeof(first));
+    EXPECT_EQ(samples[0][0].i*fileScale, first[0]);
+    EXPECT_EQ(samples[1][0].q*fileScale, first[3]);
+
+    StreamPlayer player;
+    StreamPlayer::Config playConfig;
+    playConfig.filename = name;
+    ASSERT_EQ(0, player.Open(playConfig));
+    ASSERT_EQ(2u, player.GetChannelsCount());
+    CollectingChannel tx[2];
+    ASSERT_EQ(0, player.Start({&tx[0], &tx[1]}, StreamConfig::STREAM_12_BIT_IN_16));
+    for (int i = 0; i < 100 && player.IsActive(); ++i)
+        this_thread::sleep_for(chrono::milliseconds(10));
+    EXPECT_FALSE(player.IsActive());
+    EXPECT_EQ(0u, player.GetStats().loops);
+    player.Close();
+
+    for (unsigned ch = 0; ch < 2; ++ch)
+    {
+        ASSERT_EQ(count, tx[ch].received.size());
+        for (size_t n = 0; n < count; ++n)
+        {
+            ASSERT_EQ(samples[ch][n].i, tx[ch].received[n].i) << "channel " << ch << " sample " << n;
+            ASSERT_EQ(samples[ch][n].q, tx[ch].received[n].q) << "channel " << ch << " sample " << n;
+        }
+    }
+    remove(dataFile.c_str());
+    remove(metaFile.c_str());
+}
+
+TEST(StreamFiles, RoundTripCS16)
+{
+    RecordAndPlay(StreamRecorder::FORMAT_CS16, 16);
+}
+
+TEST(StreamFiles, RoundTripCS12)
+{
+    RecordAndPlay(StreamRecorder::FORMAT_CS12, 1);
+}
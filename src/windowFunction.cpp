@@ -1,5 +1,8 @@
 #include "windowFunction.h"
 #include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
 
 void GenerateWindowCoefficients(int func, int N /*coef count*/, std::vector<float> &windowFcoefs, float amplitudeCorrection)
 {
@@ -40,3 +43,16 @@ void GenerateWindowCoefficients(int func, int N /*coef count*/, std::vector<floa
         windowFcoefs[i] *= amplitudeCorrection;
 
 }
+
+const std::vector<float> &GetWindowCoefficients(int func, int N)
+{
+    static std::mutex cacheLock;
+    static std::map<std::pair<int, int>, std::vector<float>> cache;
+    std::lock_guard<std::mutex> lock(cacheLock);
+    auto iter = cache.find(std::make_pair(func, N));
+    if (iter != cache.end())
+        return iter->second;
+    std::vector<float> &coefs = cache[std::make_pair(func, N)];
+    GenerateWindowCoefficients(func, N, coefs, 1);
+    return coefs;
+}
@@ -1,8 +1,15 @@
 #ifndef WINDOW_FUNCTION_GEN_H
 #define WINDOW_FUNCTION_GEN_H
 
+#include "LimeSuiteConfig.h"
 #include <vector>
 
 void GenerateWindowCoefficients(int func, int fftsize, std::vector<float> &windowFcoefs, float amplitudeCorrection);
 
-#endif
\ No newline at end of file
+/** @brief Returns window coefficients with default amplitude correction.
+    Windows are generated once per function and size, returned reference stays
+    valid for the lifetime of the program. Thread safe.
+*/
+LIME_API const std::vector<float> &GetWindowCoefficients(int func, int fftsize);
+
+#endif